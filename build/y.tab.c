@@ -0,0 +1,3766 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison implementation for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* C LALR(1) parser skeleton written by Richard Stallman, by
+   simplifying the original so-called "semantic" parser.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+/* All symbols defined below should begin with yy or YY, to avoid
+   infringing on user name space.  This should be done even for local
+   variables, as they might otherwise be expanded by user macros.
+   There are some unavoidable exceptions within include files to
+   define necessary library symbols; they are noted "INFRINGES ON
+   USER NAME SPACE" below.  */
+
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
+
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
+
+/* Skeleton name.  */
+#define YYSKELETON_NAME "yacc.c"
+
+/* Pure parsers.  */
+#define YYPURE 0
+
+/* Push parsers.  */
+#define YYPUSH 0
+
+/* Pull parsers.  */
+#define YYPULL 1
+
+
+
+
+/* First part of user prologue.  */
+#line 1 "src/parser.y"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "ast.h"
+#include "parser_typedefs.h"
+#include "symbol_table.h"
+#include "semantic.h"
+#include "ir_gen.h"
+#include "loop_nest.h"
+#include "ir_opt.h"
+#include "reg_alloc.h"
+#include "ir_sched.h"
+#include "riscv_gen.h"
+#include "compiler_metrics.h"
+#include "profile.h"
+
+void print_vtables() {
+    Scope *global = current_scope;
+    while (global && global->level > 0) global = global->parent;
+    if (!global) return;
+    for (int i = 0; i < TABLE_SIZE; i++) {
+        Symbol *sym = global->table[i];
+        while (sym) {
+            if (sym->kind == SYM_STRUCT && sym->virtual_methods) {
+                printf("vtable_%s:\n", sym->name);
+                Symbol *m = sym->virtual_methods;
+                int idx = 0;
+                while (m) {
+                    printf("  .word %s\n", m->name);
+                    idx++;
+                    m = m->next_member;
+                }
+            }
+            sym = sym->next;
+        }
+    }
+}
+
+// Declarations from Flex
+extern int yylex();
+extern int line_num;
+extern int col_num;
+extern char *yytext;
+extern FILE *yyin;
+
+void yyerror(const char *s);
+
+#define SET_LINE(n) (n)->line_number = line_num;
+
+
+// Global Root
+ASTNode *root = NULL;
+
+static void register_typedef_declarator_list(ASTNode *list) {
+    for (ASTNode *n = list; n; n = n->next) {
+        if (n->str_val && *n->str_val) {
+            parser_register_typedef_name(n->str_val);
+        }
+    }
+}
+
+static int min3(int a, int b, int c) {
+    int m = (a < b) ? a : b;
+    return (m < c) ? m : c;
+}
+
+static int edit_distance_ci(const char *a, const char *b) {
+    int la = (int)strlen(a);
+    int lb = (int)strlen(b);
+    int *dp = (int*)malloc(sizeof(int) * (lb + 1));
+    if (!dp) return 999;
+
+    for (int j = 0; j <= lb; ++j) dp[j] = j;
+    for (int i = 1; i <= la; ++i) {
+        int prev = dp[0];
+        dp[0] = i;
+        for (int j = 1; j <= lb; ++j) {
+            int old = dp[j];
+            int ca = tolower((unsigned char)a[i - 1]);
+            int cb = tolower((unsigned char)b[j - 1]);
+            int cost = (ca == cb) ? 0 : 1;
+            dp[j] = min3(dp[j] + 1, dp[j - 1] + 1, prev + cost);
+            prev = old;
+        }
+    }
+
+    int dist = dp[lb];
+    free(dp);
+    return dist;
+}
+
+static int is_identifier_text(const char *s) {
+    if (!s || !*s) return 0;
+    if (!(isalpha((unsigned char)s[0]) || s[0] == '_')) return 0;
+    for (int i = 1; s[i]; ++i) {
+        if (!(isalnum((unsigned char)s[i]) || s[i] == '_')) return 0;
+    }
+    return 1;
+}
+
+static const char *closest_keyword(const char *tok, int *out_dist) {
+    static const char *kws[] = {
+        "int", "char", "void", "const", "typedef", "struct", "class", "virtual",
+        "public", "private", "if", "else", "while", "for", "return", "switch",
+        "case", "default", "break", "continue", "printf", "scanf", "new", "delete",
+        "try", "catch", "throw", NULL
+    };
+
+    const char *best = NULL;
+    int best_dist = 999;
+    for (int i = 0; kws[i]; ++i) {
+        int d = edit_distance_ci(tok, kws[i]);
+        if (d < best_dist) {
+            best_dist = d;
+            best = kws[i];
+        }
+    }
+    if (out_dist) *out_dist = best_dist;
+    return best;
+}
+
+static int token_can_start_statement(const char *tok) {
+    if (!tok || !*tok) return 0;
+    static const char *starters[] = {
+        "int", "char", "void", "const", "typedef", "if", "while", "for", "return",
+        "switch", "break", "continue", "printf", "scanf", "try", "throw", "}",
+        "else", "case", "default", NULL
+    };
+    for (int i = 0; starters[i]; ++i) {
+        if (strcmp(tok, starters[i]) == 0) return 1;
+    }
+    return 0;
+}
+
+#line 208 "build/y.tab.c"
+
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
+# ifndef YY_NULLPTR
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
+#  else
+#   define YY_NULLPTR ((void*)0)
+#  endif
+# endif
+
+#include "y.tab.h"
+/* Symbol kind.  */
+enum yysymbol_kind_t
+{
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_T_INT = 3,                      /* T_INT  */
+  YYSYMBOL_T_VOID = 4,                     /* T_VOID  */
+  YYSYMBOL_T_CHAR = 5,                     /* T_CHAR  */
+  YYSYMBOL_T_STRUCT = 6,                   /* T_STRUCT  */
+  YYSYMBOL_T_VIRTUAL = 7,                  /* T_VIRTUAL  */
+  YYSYMBOL_T_CLASS = 8,                    /* T_CLASS  */
+  YYSYMBOL_T_PUBLIC = 9,                   /* T_PUBLIC  */
+  YYSYMBOL_T_PRIVATE = 10,                 /* T_PRIVATE  */
+  YYSYMBOL_T_COLON = 11,                   /* T_COLON  */
+  YYSYMBOL_T_IF = 12,                      /* T_IF  */
+  YYSYMBOL_T_ELSE = 13,                    /* T_ELSE  */
+  YYSYMBOL_T_WHILE = 14,                   /* T_WHILE  */
+  YYSYMBOL_T_FOR = 15,                     /* T_FOR  */
+  YYSYMBOL_T_RETURN = 16,                  /* T_RETURN  */
+  YYSYMBOL_T_SWITCH = 17,                  /* T_SWITCH  */
+  YYSYMBOL_T_CASE = 18,                    /* T_CASE  */
+  YYSYMBOL_T_DEFAULT = 19,                 /* T_DEFAULT  */
+  YYSYMBOL_T_BREAK = 20,                   /* T_BREAK  */
+  YYSYMBOL_T_CONTINUE = 21,                /* T_CONTINUE  */
+  YYSYMBOL_T_PRINTF = 22,                  /* T_PRINTF  */
+  YYSYMBOL_T_SCANF = 23,                   /* T_SCANF  */
+  YYSYMBOL_T_CONST = 24,                   /* T_CONST  */
+  YYSYMBOL_T_TRY = 25,                     /* T_TRY  */
+  YYSYMBOL_T_CATCH = 26,                   /* T_CATCH  */
+  YYSYMBOL_T_THROW = 27,                   /* T_THROW  */
+  YYSYMBOL_T_NEW = 28,                     /* T_NEW  */
+  YYSYMBOL_T_DELETE = 29,                  /* T_DELETE  */
+  YYSYMBOL_T_TYPEDEF = 30,                 /* T_TYPEDEF  */
+  YYSYMBOL_T_IDENT = 31,                   /* T_IDENT  */
+  YYSYMBOL_T_TYPE_NAME = 32,               /* T_TYPE_NAME  */
+  YYSYMBOL_T_STRING_LIT = 33,              /* T_STRING_LIT  */
+  YYSYMBOL_T_NUMBER = 34,                  /* T_NUMBER  */
+  YYSYMBOL_T_CHAR_LIT = 35,                /* T_CHAR_LIT  */
+  YYSYMBOL_T_ARROW = 36,                   /* T_ARROW  */
+  YYSYMBOL_T_TILDE = 37,                   /* T_TILDE  */
+  YYSYMBOL_T_EQ = 38,                      /* T_EQ  */
+  YYSYMBOL_T_NEQ = 39,                     /* T_NEQ  */
+  YYSYMBOL_T_LE = 40,                      /* T_LE  */
+  YYSYMBOL_T_GE = 41,                      /* T_GE  */
+  YYSYMBOL_T_AND = 42,                     /* T_AND  */
+  YYSYMBOL_T_OR = 43,                      /* T_OR  */
+  YYSYMBOL_T_INC = 44,                     /* T_INC  */
+  YYSYMBOL_T_DEC = 45,                     /* T_DEC  */
+  YYSYMBOL_T_SHL = 46,                     /* T_SHL  */
+  YYSYMBOL_T_SHR = 47,                     /* T_SHR  */
+  YYSYMBOL_48_ = 48,                       /* '='  */
+  YYSYMBOL_49_ = 49,                       /* '|'  */
+  YYSYMBOL_50_ = 50,                       /* '^'  */
+  YYSYMBOL_51_ = 51,                       /* '&'  */
+  YYSYMBOL_52_ = 52,                       /* '<'  */
+  YYSYMBOL_53_ = 53,                       /* '>'  */
+  YYSYMBOL_54_ = 54,                       /* '+'  */
+  YYSYMBOL_55_ = 55,                       /* '-'  */
+  YYSYMBOL_56_ = 56,                       /* '*'  */
+  YYSYMBOL_57_ = 57,                       /* '/'  */
+  YYSYMBOL_58_ = 58,                       /* '%'  */
+  YYSYMBOL_59_ = 59,                       /* '!'  */
+  YYSYMBOL_LOWER_THAN_ELSE = 60,           /* LOWER_THAN_ELSE  */
+  YYSYMBOL_61_ = 61,                       /* ';'  */
+  YYSYMBOL_62_ = 62,                       /* '('  */
+  YYSYMBOL_63_ = 63,                       /* ')'  */
+  YYSYMBOL_64_ = 64,                       /* ','  */
+  YYSYMBOL_65_ = 65,                       /* '['  */
+  YYSYMBOL_66_ = 66,                       /* ']'  */
+  YYSYMBOL_67_ = 67,                       /* '{'  */
+  YYSYMBOL_68_ = 68,                       /* '}'  */
+  YYSYMBOL_69_ = 69,                       /* '.'  */
+  YYSYMBOL_YYACCEPT = 70,                  /* $accept  */
+  YYSYMBOL_program = 71,                   /* program  */
+  YYSYMBOL_external_declaration_list = 72, /* external_declaration_list  */
+  YYSYMBOL_external_declaration = 73,      /* external_declaration  */
+  YYSYMBOL_function_definition = 74,       /* function_definition  */
+  YYSYMBOL_parameter_list = 75,            /* parameter_list  */
+  YYSYMBOL_parameter_declaration = 76,     /* parameter_declaration  */
+  YYSYMBOL_declaration = 77,               /* declaration  */
+  YYSYMBOL_declarator_list = 78,           /* declarator_list  */
+  YYSYMBOL_init_declarator = 79,           /* init_declarator  */
+  YYSYMBOL_declarator = 80,                /* declarator  */
+  YYSYMBOL_pointer = 81,                   /* pointer  */
+  YYSYMBOL_direct_declarator = 82,         /* direct_declarator  */
+  YYSYMBOL_type_specifier = 83,            /* type_specifier  */
+  YYSYMBOL_struct_specifier = 84,          /* struct_specifier  */
+  YYSYMBOL_85_1 = 85,                      /* $@1  */
+  YYSYMBOL_class_head = 86,                /* class_head  */
+  YYSYMBOL_class_specifier = 87,           /* class_specifier  */
+  YYSYMBOL_struct_declaration_list = 88,   /* struct_declaration_list  */
+  YYSYMBOL_struct_member = 89,             /* struct_member  */
+  YYSYMBOL_statement = 90,                 /* statement  */
+  YYSYMBOL_compound_statement = 91,        /* compound_statement  */
+  YYSYMBOL_block_item_list = 92,           /* block_item_list  */
+  YYSYMBOL_block_item = 93,                /* block_item  */
+  YYSYMBOL_expression_statement = 94,      /* expression_statement  */
+  YYSYMBOL_selection_statement = 95,       /* selection_statement  */
+  YYSYMBOL_iteration_statement = 96,       /* iteration_statement  */
+  YYSYMBOL_jump_statement = 97,            /* jump_statement  */
+  YYSYMBOL_throw_statement = 98,           /* throw_statement  */
+  YYSYMBOL_try_statement = 99,             /* try_statement  */
+  YYSYMBOL_catch_clause_list = 100,        /* catch_clause_list  */
+  YYSYMBOL_catch_clause = 101,             /* catch_clause  */
+  YYSYMBOL_switch_statement = 102,         /* switch_statement  */
+  YYSYMBOL_switch_clause_list = 103,       /* switch_clause_list  */
+  YYSYMBOL_switch_clause = 104,            /* switch_clause  */
+  YYSYMBOL_statement_list_opt = 105,       /* statement_list_opt  */
+  YYSYMBOL_statement_list = 106,           /* statement_list  */
+  YYSYMBOL_expression = 107,               /* expression  */
+  YYSYMBOL_assignment_expression = 108,    /* assignment_expression  */
+  YYSYMBOL_logical_or_expression = 109,    /* logical_or_expression  */
+  YYSYMBOL_logical_and_expression = 110,   /* logical_and_expression  */
+  YYSYMBOL_inclusive_or_expression = 111,  /* inclusive_or_expression  */
+  YYSYMBOL_exclusive_or_expression = 112,  /* exclusive_or_expression  */
+  YYSYMBOL_and_expression = 113,           /* and_expression  */
+  YYSYMBOL_equality_expression = 114,      /* equality_expression  */
+  YYSYMBOL_relational_expression = 115,    /* relational_expression  */
+  YYSYMBOL_shift_expression = 116,         /* shift_expression  */
+  YYSYMBOL_additive_expression = 117,      /* additive_expression  */
+  YYSYMBOL_multiplicative_expression = 118, /* multiplicative_expression  */
+  YYSYMBOL_postfix_expression = 119,       /* postfix_expression  */
+  YYSYMBOL_unary_expression = 120,         /* unary_expression  */
+  YYSYMBOL_primary_expression = 121,       /* primary_expression  */
+  YYSYMBOL_argument_expression_list = 122  /* argument_expression_list  */
+};
+typedef enum yysymbol_kind_t yysymbol_kind_t;
+
+
+
+
+#ifdef short
+# undef short
+#endif
+
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
+
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
+#endif
+
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
+
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
+#else
+typedef signed char yytype_int8;
+#endif
+
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
+#else
+typedef short yytype_int16;
+#endif
+
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
+
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
+#else
+typedef short yytype_uint8;
+#endif
+
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
+#else
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
+#endif
+
+#ifndef YYSIZE_T
+# ifdef __SIZE_TYPE__
+#  define YYSIZE_T __SIZE_TYPE__
+# elif defined size_t
+#  define YYSIZE_T size_t
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYSIZE_T size_t
+# else
+#  define YYSIZE_T unsigned
+# endif
+#endif
+
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_int16 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
+
+#ifndef YY_
+# if defined YYENABLE_NLS && YYENABLE_NLS
+#  if ENABLE_NLS
+#   include <libintl.h> /* INFRINGES ON USER NAME SPACE */
+#   define YY_(Msgid) dgettext ("bison-runtime", Msgid)
+#  endif
+# endif
+# ifndef YY_
+#  define YY_(Msgid) Msgid
+# endif
+#endif
+
+
+#ifndef YY_ATTRIBUTE_PURE
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
+#endif
+
+#ifndef YY_ATTRIBUTE_UNUSED
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
+# else
+#  define YY_ATTRIBUTE_UNUSED
+# endif
+#endif
+
+/* Suppress unused-variable warnings by "using" E.  */
+#if ! defined lint || defined __GNUC__
+# define YY_USE(E) ((void) (E))
+#else
+# define YY_USE(E) /* empty */
+#endif
+
+/* Suppress an incorrect diagnostic about yylval being uninitialized.  */
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
+    _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
+    _Pragma ("GCC diagnostic pop")
+#else
+# define YY_INITIAL_VALUE(Value) Value
+#endif
+#ifndef YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END
+#endif
+#ifndef YY_INITIAL_VALUE
+# define YY_INITIAL_VALUE(Value) /* Nothing. */
+#endif
+
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
+#endif
+
+
+#define YY_ASSERT(E) ((void) (0 && (E)))
+
+#if !defined yyoverflow
+
+/* The parser invokes alloca or malloc; define the necessary symbols.  */
+
+# ifdef YYSTACK_USE_ALLOCA
+#  if YYSTACK_USE_ALLOCA
+#   ifdef __GNUC__
+#    define YYSTACK_ALLOC __builtin_alloca
+#   elif defined __BUILTIN_VA_ARG_INCR
+#    include <alloca.h> /* INFRINGES ON USER NAME SPACE */
+#   elif defined _AIX
+#    define YYSTACK_ALLOC __alloca
+#   elif defined _MSC_VER
+#    include <malloc.h> /* INFRINGES ON USER NAME SPACE */
+#    define alloca _alloca
+#   else
+#    define YYSTACK_ALLOC alloca
+#    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS
+#     include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+      /* Use EXIT_SUCCESS as a witness for stdlib.h.  */
+#     ifndef EXIT_SUCCESS
+#      define EXIT_SUCCESS 0
+#     endif
+#    endif
+#   endif
+#  endif
+# endif
+
+# ifdef YYSTACK_ALLOC
+   /* Pacify GCC's 'empty if-body' warning.  */
+#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (0)
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+    /* The OS might guarantee only one guard page at the bottom of the stack,
+       and a page size can be as small as 4096 bytes.  So we cannot safely
+       invoke alloca (N) if N exceeds 4096.  Use a slightly smaller number
+       to allow for a few compiler-allocated temporary stack slots.  */
+#   define YYSTACK_ALLOC_MAXIMUM 4032 /* reasonable circa 2006 */
+#  endif
+# else
+#  define YYSTACK_ALLOC YYMALLOC
+#  define YYSTACK_FREE YYFREE
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+#   define YYSTACK_ALLOC_MAXIMUM YYSIZE_MAXIMUM
+#  endif
+#  if (defined __cplusplus && ! defined EXIT_SUCCESS \
+       && ! ((defined YYMALLOC || defined malloc) \
+             && (defined YYFREE || defined free)))
+#   include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+#   ifndef EXIT_SUCCESS
+#    define EXIT_SUCCESS 0
+#   endif
+#  endif
+#  ifndef YYMALLOC
+#   define YYMALLOC malloc
+#   if ! defined malloc && ! defined EXIT_SUCCESS
+void *malloc (YYSIZE_T); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+#  ifndef YYFREE
+#   define YYFREE free
+#   if ! defined free && ! defined EXIT_SUCCESS
+void free (void *); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+# endif
+#endif /* !defined yyoverflow */
+
+#if (! defined yyoverflow \
+     && (! defined __cplusplus \
+         || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
+
+/* A type that is properly aligned for any stack member.  */
+union yyalloc
+{
+  yy_state_t yyss_alloc;
+  YYSTYPE yyvs_alloc;
+};
+
+/* The size of the maximum gap between one aligned stack and the next.  */
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
+
+/* The size of an array large to enough to hold all stacks, each with
+   N elements.  */
+# define YYSTACK_BYTES(N) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE)) \
+      + YYSTACK_GAP_MAXIMUM)
+
+# define YYCOPY_NEEDED 1
+
+/* Relocate STACK from its old location to the new one.  The
+   local variables YYSIZE and YYSTACKSIZE give the old and new number of
+   elements in the stack, and YYPTR gives the new location of the
+   stack.  Advance YYPTR to a properly aligned location for the next
+   stack.  */
+# define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
+    do                                                                  \
+      {                                                                 \
+        YYPTRDIFF_T yynewbytes;                                         \
+        YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
+        Stack = &yyptr->Stack_alloc;                                    \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
+      }                                                                 \
+    while (0)
+
+#endif
+
+#if defined YYCOPY_NEEDED && YYCOPY_NEEDED
+/* Copy COUNT objects from SRC to DST.  The source and destination do
+   not overlap.  */
+# ifndef YYCOPY
+#  if defined __GNUC__ && 1 < __GNUC__
+#   define YYCOPY(Dst, Src, Count) \
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
+#  else
+#   define YYCOPY(Dst, Src, Count)              \
+      do                                        \
+        {                                       \
+          YYPTRDIFF_T yyi;                      \
+          for (yyi = 0; yyi < (Count); yyi++)   \
+            (Dst)[yyi] = (Src)[yyi];            \
+        }                                       \
+      while (0)
+#  endif
+# endif
+#endif /* !YYCOPY_NEEDED */
+
+/* YYFINAL -- State number of the termination state.  */
+#define YYFINAL  28
+/* YYLAST -- Last index in YYTABLE.  */
+#define YYLAST   1098
+
+/* YYNTOKENS -- Number of terminals.  */
+#define YYNTOKENS  70
+/* YYNNTS -- Number of nonterminals.  */
+#define YYNNTS  53
+/* YYNRULES -- Number of rules.  */
+#define YYNRULES  169
+/* YYNSTATES -- Number of states.  */
+#define YYNSTATES  349
+
+/* YYMAXUTOK -- Last valid token kind.  */
+#define YYMAXUTOK   303
+
+
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
+
+/* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex.  */
+static const yytype_int8 yytranslate[] =
+{
+       0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,    59,     2,     2,     2,    58,    51,     2,
+      62,    63,    56,    54,    64,    55,    69,    57,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,    61,
+      52,    48,    53,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,    65,     2,    66,    50,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,    67,    49,    68,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     1,     2,     3,     4,
+       5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
+      15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
+      25,    26,    27,    28,    29,    30,    31,    32,    33,    34,
+      35,    36,    37,    38,    39,    40,    41,    42,    43,    44,
+      45,    46,    47,    60
+};
+
+#if YYDEBUG
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+static const yytype_int16 yyrline[] =
+{
+       0,   192,   192,   196,   197,   203,   204,   205,   213,   217,
+     221,   226,   234,   235,   241,   256,   295,   325,   356,   388,
+     392,   396,   403,   404,   413,   414,   421,   425,   432,   436,
+     443,   451,   457,   465,   466,   467,   468,   469,   470,   479,
+     479,   489,   498,   507,   515,   523,   533,   543,   553,   561,
+     562,   566,   567,   572,   573,   579,   585,   591,   597,   603,
+     609,   615,   625,   626,   627,   628,   629,   630,   631,   632,
+     633,   639,   645,   651,   659,   663,   668,   676,   677,   683,
+     684,   688,   689,   690,   698,   702,   709,   713,   717,   721,
+     728,   732,   737,   741,   748,   752,   759,   766,   767,   773,
+     777,   784,   791,   792,   798,   802,   809,   810,   814,   815,
+     822,   826,   830,   840,   841,   848,   849,   856,   857,   864,
+     865,   872,   873,   880,   881,   885,   892,   893,   897,   901,
+     905,   912,   913,   917,   924,   925,   929,   936,   937,   941,
+     945,   952,   953,   957,   965,   973,   983,   993,   998,  1006,
+    1007,  1011,  1015,  1019,  1023,  1027,  1032,  1037,  1043,  1049,
+    1055,  1061,  1068,  1078,  1082,  1086,  1090,  1094,  1100,  1101
+};
+#endif
+
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if YYDEBUG || 0
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
+/* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
+   First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
+static const char *const yytname[] =
+{
+  "\"end of file\"", "error", "\"invalid token\"", "T_INT", "T_VOID",
+  "T_CHAR", "T_STRUCT", "T_VIRTUAL", "T_CLASS", "T_PUBLIC", "T_PRIVATE",
+  "T_COLON", "T_IF", "T_ELSE", "T_WHILE", "T_FOR", "T_RETURN", "T_SWITCH",
+  "T_CASE", "T_DEFAULT", "T_BREAK", "T_CONTINUE", "T_PRINTF", "T_SCANF",
+  "T_CONST", "T_TRY", "T_CATCH", "T_THROW", "T_NEW", "T_DELETE",
+  "T_TYPEDEF", "T_IDENT", "T_TYPE_NAME", "T_STRING_LIT", "T_NUMBER",
+  "T_CHAR_LIT", "T_ARROW", "T_TILDE", "T_EQ", "T_NEQ", "T_LE", "T_GE",
+  "T_AND", "T_OR", "T_INC", "T_DEC", "T_SHL", "T_SHR", "'='", "'|'", "'^'",
+  "'&'", "'<'", "'>'", "'+'", "'-'", "'*'", "'/'", "'%'", "'!'",
+  "LOWER_THAN_ELSE", "';'", "'('", "')'", "','", "'['", "']'", "'{'",
+  "'}'", "'.'", "$accept", "program", "external_declaration_list",
+  "external_declaration", "function_definition", "parameter_list",
+  "parameter_declaration", "declaration", "declarator_list",
+  "init_declarator", "declarator", "pointer", "direct_declarator",
+  "type_specifier", "struct_specifier", "$@1", "class_head",
+  "class_specifier", "struct_declaration_list", "struct_member",
+  "statement", "compound_statement", "block_item_list", "block_item",
+  "expression_statement", "selection_statement", "iteration_statement",
+  "jump_statement", "throw_statement", "try_statement",
+  "catch_clause_list", "catch_clause", "switch_statement",
+  "switch_clause_list", "switch_clause", "statement_list_opt",
+  "statement_list", "expression", "assignment_expression",
+  "logical_or_expression", "logical_and_expression",
+  "inclusive_or_expression", "exclusive_or_expression", "and_expression",
+  "equality_expression", "relational_expression", "shift_expression",
+  "additive_expression", "multiplicative_expression", "postfix_expression",
+  "unary_expression", "primary_expression", "argument_expression_list", YY_NULLPTR
+};
+
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
+{
+  return yytname[yysymbol];
+}
+#endif
+
+#define YYPACT_NINF (-237)
+
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
+
+#define YYTABLE_NINF (-108)
+
+#define yytable_value_is_error(Yyn) \
+  0
+
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
+static const yytype_int16 yypact[] =
+{
+    1066,   -45,  -237,  -237,  -237,   129,    25,   227,   651,  -237,
+      28,  1057,  -237,  -237,  -237,    -9,     9,     6,    32,  -237,
+       0,  -237,  -237,    -8,  -237,  -237,   227,    -8,  -237,  -237,
+       1,    42,     7,  -237,    53,    72,    48,  -237,    22,  1014,
+    -237,    51,  -237,   -24,   105,    -8,   -18,    91,  -237,  -237,
+    -237,    -8,   997,    80,    48,   727,   118,   122,    89,   227,
+     151,   186,   106,   137,   133,  -237,  -237,   185,  -237,  1014,
+    -237,    -6,  -237,   141,   115,  -237,    -8,  -237,   149,  -237,
+    -237,  -237,  -237,   997,   997,   997,   997,   997,   997,   997,
+     997,  -237,  -237,   -14,   170,   179,   184,   191,   146,    34,
+     140,   152,    90,    -3,  -237,  -237,   166,  -237,   180,   190,
+     195,  1014,  -237,    -4,  -237,  -237,   235,   486,   209,   224,
+    -237,  -237,   564,  -237,   260,  -237,   141,   227,  -237,   234,
+     237,  -237,  -237,  -237,  -237,  -237,  -237,  -237,   240,   997,
+     997,   997,   997,   997,   997,   997,   997,   997,   997,   997,
+     997,   997,   997,   997,   997,   997,   997,   997,   269,  -237,
+    -237,   757,   997,   275,   141,   147,  -237,  1014,  1014,   573,
+       1,   276,   141,   150,   141,   155,   245,   246,  -237,     8,
+     248,   250,   251,   922,   252,   256,   257,   258,   261,   141,
+     954,   997,  -237,  -237,  -237,    -8,  -237,  -237,   328,  -237,
+    -237,  -237,  -237,  -237,  -237,  -237,  -237,   263,  -237,  -237,
+     790,   823,  -237,   170,  -237,   179,   184,   191,   146,    34,
+      34,   140,   140,   140,   140,   152,   152,    90,    90,  -237,
+    -237,  -237,  -237,  -237,  -237,   157,   259,  -237,  -237,   141,
+     612,   621,  -237,    80,  -237,   141,  -237,   141,   141,   141,
+    -237,  -237,   997,   997,   660,  -237,   265,   997,  -237,  -237,
+     297,   302,   311,  -237,   277,   278,   280,  -237,  -237,  -237,
+    -237,   161,  -237,   163,  -237,   997,  -237,  -237,  -237,  -237,
+    -237,  -237,  -237,  -237,   283,   284,   695,   695,  -237,   291,
+     173,   300,   304,   311,  -237,  -237,  -237,  -237,  -237,  -237,
+     499,   499,   856,   997,   301,   306,   997,   997,   889,  -237,
+     356,  -237,   499,   307,   308,   226,  -237,   206,   215,   141,
+     312,   499,  -237,   499,   499,   997,   363,    17,  -237,   315,
+     316,  -237,   141,  -237,  -237,  -237,   367,   385,  -237,  -237,
+    -237,  -237,  -237,   385,  -237,  -237,   442,  -237,  -237
+};
+
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
+static const yytype_uint8 yydefact[] =
+{
+       0,     0,    33,    35,    34,     0,     0,     0,     0,    38,
+       0,     0,     3,     5,     6,     0,    36,    48,    37,     7,
+      41,    42,    43,     0,    36,    37,     0,     0,     1,     4,
+      30,    28,     0,    22,    24,     0,    27,    20,     0,     0,
+      21,     0,    30,     0,     0,     0,     0,     0,    29,    19,
+      15,     0,     0,    30,    26,     0,     0,     0,     0,     0,
+       0,     0,     0,    38,     0,    53,    51,     0,    49,     0,
+      16,     0,    17,     0,     0,    12,     0,    23,     0,   163,
+     166,   164,   165,     0,     0,     0,     0,     0,     0,     0,
+       0,    25,   110,   111,   113,   115,   117,   119,   121,   123,
+     126,   131,   134,   149,   137,   141,     0,    32,     0,     0,
+       0,     0,    52,     0,    60,    61,     0,     0,     0,     0,
+      44,    50,     0,    18,     0,     9,     0,     0,    14,   161,
+     162,   152,   155,   156,   153,   150,   154,   151,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,   147,
+     148,     0,     0,     0,     0,     0,    31,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,    40,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,    81,    74,    79,     0,    80,    62,     0,    77,
+      63,    64,    65,    66,    69,    68,    67,     0,     8,    13,
+       0,     0,   167,   114,   112,   116,   118,   120,   122,   124,
+     125,   129,   130,   127,   128,   132,   133,   135,   136,   138,
+     139,   140,   144,   146,   168,     0,     0,   143,    11,     0,
+       0,     0,    47,     0,    56,     0,    57,     0,     0,     0,
+      83,    76,     0,     0,     0,    90,     0,     0,    92,    93,
+       0,     0,     0,    95,     0,     0,     0,    75,    78,    82,
+     159,     0,   160,     0,   145,     0,   142,    10,    45,    46,
+      54,    55,    58,    59,     0,     0,     0,     0,    91,     0,
+       0,     0,     0,    96,    97,    94,    73,   157,   158,   169,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,    98,
+      84,    86,     0,     0,     0,     0,    70,     0,     0,     0,
+       0,     0,    88,     0,     0,     0,     0,     0,   102,     0,
+       0,   100,     0,    85,    89,    87,     0,     0,   101,   103,
+      71,    72,    99,     0,   108,   105,     0,   104,   109
+};
+
+/* YYPGOTO[NTERM-NUM].  */
+static const yytype_int16 yypgoto[] =
+{
+    -237,  -237,  -237,   369,     2,    10,   254,     4,   110,   331,
+     309,    -1,   -25,    -2,    13,  -237,  -237,    18,   -62,   -58,
+    -180,   -72,  -237,   193,  -236,  -237,  -237,  -237,  -237,  -237,
+    -237,    95,  -237,  -237,    65,    50,  -237,   -52,   271,  -237,
+     255,   268,   273,   274,   279,    58,   -59,    97,   148,  -237,
+      -5,  -237,  -199
+};
+
+/* YYDEFGOTO[NTERM-NUM].  */
+static const yytype_int16 yydefgoto[] =
+{
+       0,    10,    11,    12,    65,    74,    75,    66,    32,    33,
+      34,    44,    36,    15,    16,    41,    17,    18,    67,    68,
+     196,   197,   198,   199,   200,   201,   202,   203,   204,   205,
+     293,   294,   206,   327,   328,   345,   346,   207,    92,    93,
+      94,    95,    96,    97,    98,    99,   100,   101,   102,   103,
+     104,   105,   235
+};
+
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
+static const yytype_int16 yytable[] =
+{
+      91,   125,    13,   108,    14,    23,    27,   122,    49,   121,
+      54,   271,   273,    13,    35,    14,    19,    38,   287,    54,
+      24,    24,    30,    42,    45,    25,    25,   170,    28,   139,
+      48,    56,    57,   158,   140,   325,   326,    70,   138,    24,
+      51,   159,   160,    72,    25,    76,    51,    31,    31,   169,
+     302,   303,    31,    58,   208,   123,    22,   113,    51,   161,
+      24,   112,   162,    47,   121,    25,   163,   -39,    50,   250,
+      37,    51,    24,    39,   147,   148,   251,    25,   131,   132,
+     133,   134,   135,   136,   137,   338,   149,   150,   221,   222,
+     223,   224,   238,    40,     2,     3,     4,     5,    31,     6,
+     244,    52,   246,    53,    76,   240,   241,   317,   318,   234,
+     236,   121,   171,    55,    76,    76,   165,   262,    69,    24,
+     310,   311,   195,     9,    25,    76,   173,   175,   194,    24,
+      24,   256,   322,    43,    25,    25,    42,    46,   264,   265,
+      24,   333,   106,   334,   335,    25,   155,   156,   157,   109,
+     229,   230,   231,   110,    73,    71,   111,   344,   234,   234,
+      20,    21,   114,   344,   118,   119,   348,   277,   116,     2,
+       3,     4,     5,   280,     6,   281,   282,   283,   126,   127,
+     129,   130,   121,   121,   145,   146,   151,   152,     2,     3,
+       4,     5,    59,     6,    60,    61,   195,   115,     9,   117,
+     284,   285,   194,   219,   220,   289,   153,   154,   124,     7,
+     239,   127,   141,   245,   127,     8,    62,    63,   247,   127,
+     274,   275,    64,   299,   297,   275,   298,   275,   142,   164,
+       2,     3,     4,     5,   143,     6,   305,   306,     2,     3,
+       4,     5,   144,     6,   325,   326,   166,   331,   225,   226,
+     313,   314,   195,   120,   234,   234,   320,   167,   286,     9,
+     342,   179,   168,     2,     3,     4,     5,     9,     6,   329,
+     275,   176,   180,   336,   181,   182,   183,   184,   330,   275,
+     185,   186,   187,   188,     7,   189,   177,   190,    78,   191,
+       8,    79,     9,    80,    81,    82,   210,    83,   172,   211,
+     232,   227,   228,   212,    84,    85,   237,   243,   248,   249,
+     252,    86,   253,   254,   257,    87,    88,   258,   259,    89,
+     260,   192,    90,   261,   269,   276,   288,   124,   193,   266,
+     290,     2,     3,     4,     5,   291,     6,   292,   295,   296,
+     180,   250,   181,   182,   183,   184,   300,   301,   185,   186,
+     187,   188,     7,   189,   304,   190,    78,   191,     8,    79,
+       9,    80,    81,    82,   307,    83,   308,   316,   315,   321,
+     323,   324,    84,    85,   337,   332,   340,   341,   343,    86,
+      29,   209,    77,    87,    88,   128,   266,    89,   309,   192,
+      90,   268,   339,   347,   213,   124,   267,   180,     0,   181,
+     182,   183,   184,  -106,  -106,   185,   186,   187,   188,   215,
+     189,   214,   190,    78,   191,   216,    79,   217,    80,    81,
+      82,     0,    83,   218,     0,     0,     0,     0,     0,    84,
+      85,     0,     0,     0,     0,     0,    86,     0,     0,     0,
+      87,    88,     0,   266,    89,     0,   192,    90,     0,     0,
+       0,     0,   124,  -106,   180,     0,   181,   182,   183,   184,
+    -107,  -107,   185,   186,   187,   188,     0,   189,     0,   190,
+      78,   191,     0,    79,     0,    80,    81,    82,     0,    83,
+       0,     0,     0,     0,     0,     0,    84,    85,     0,     2,
+       3,     4,     5,    86,     6,     0,     0,    87,    88,     0,
+     266,    89,     0,   192,    90,     0,     0,     0,     0,   124,
+    -107,   180,     0,   181,   182,   183,   184,     0,     9,   185,
+     186,   187,   188,     0,   189,     0,   190,    78,   191,     0,
+      79,     0,    80,    81,    82,     0,    83,     0,     0,     0,
+       0,     0,     0,    84,    85,     0,     0,     0,     0,   174,
+      86,     0,     0,     0,    87,    88,     0,     0,    89,     0,
+     192,    90,     0,     0,     0,     0,   124,     2,     3,     4,
+       5,    59,     6,    60,    61,     0,     2,     3,     4,     5,
+      59,     6,    60,    61,     0,     0,     0,     0,     7,     0,
+       0,     0,     0,     0,     8,    62,    63,     7,     0,     0,
+       0,    64,     0,     8,    62,    63,     0,     0,     0,     0,
+      64,     0,     0,     0,     0,     2,     3,     4,     5,    59,
+       6,    60,    61,     0,     2,     3,     4,     5,    59,     6,
+      60,    61,   178,     0,     0,     0,     7,     0,     0,     0,
+       0,   242,     8,    62,    63,     7,     0,     0,     0,    64,
+       0,     8,    62,    63,     2,     3,     4,     5,    64,     6,
+       0,   266,     0,     2,     3,     4,     5,     0,     6,     0,
+       0,     0,     0,     0,     0,    26,     0,     0,     0,     0,
+     278,     0,     0,     9,     7,     0,     0,     0,    78,   279,
+       8,    79,     9,    80,    81,    82,   266,    83,     0,     0,
+       0,     0,     0,     0,    84,    85,     0,     0,     0,     0,
+       0,    86,     0,     0,     0,    87,    88,     0,     0,    89,
+       0,   192,    90,    78,     0,     0,    79,     0,    80,    81,
+      82,     0,    83,     0,     0,     0,     0,     0,     0,    84,
+      85,     0,     0,     0,     0,     0,    86,     0,     0,     0,
+      87,    88,     0,     0,    89,    78,   192,    90,    79,     0,
+      80,    81,    82,     0,    83,     0,     0,     0,     0,     0,
+       0,    84,    85,     0,     0,     0,     0,     0,    86,     0,
+       0,     0,    87,    88,     0,    78,    89,     0,    79,    90,
+      80,    81,    82,   107,    83,     0,     0,     0,     0,     0,
+       0,    84,    85,     0,     0,     0,     0,     0,    86,     0,
+       0,     0,    87,    88,     0,     0,    89,     0,    78,    90,
+     233,    79,     0,    80,    81,    82,     0,    83,     0,     0,
+       0,     0,     0,     0,    84,    85,     0,     0,     0,     0,
+       0,    86,     0,     0,     0,    87,    88,     0,     0,    89,
+       0,    78,    90,   270,    79,     0,    80,    81,    82,     0,
+      83,     0,     0,     0,     0,     0,     0,    84,    85,     0,
+       0,     0,     0,     0,    86,     0,     0,     0,    87,    88,
+       0,     0,    89,     0,    78,    90,   272,    79,     0,    80,
+      81,    82,     0,    83,     0,     0,     0,     0,     0,     0,
+      84,    85,     0,     0,     0,     0,     0,    86,     0,     0,
+       0,    87,    88,     0,     0,    89,     0,    78,    90,   312,
+      79,     0,    80,    81,    82,     0,    83,     0,     0,     0,
+       0,     0,     0,    84,    85,     0,     0,     0,     0,     0,
+      86,     0,     0,     0,    87,    88,     0,     0,    89,     0,
+      78,    90,   319,    79,     0,    80,    81,    82,     0,    83,
+       0,     0,     0,     0,     0,     0,    84,    85,     0,     0,
+       0,     0,     0,    86,     0,     0,     0,    87,    88,     0,
+       0,    89,    78,   255,    90,    79,     0,    80,    81,    82,
+       0,    83,     0,     0,     0,     0,     0,     0,    84,    85,
+       0,     0,     0,     0,     0,    86,     0,     0,     0,    87,
+      88,     0,     0,    89,     0,   263,    90,     2,     3,     4,
+       5,    59,     6,    60,    61,    78,     0,     0,    79,     0,
+      80,    81,    82,     0,    83,     0,     0,     0,     7,     0,
+       0,    84,    85,     0,     8,    62,    63,     0,    86,     0,
+       0,    64,    87,    88,     0,     0,    89,    -2,     1,    90,
+       2,     3,     4,     5,     0,     6,     0,     1,     0,     2,
+       3,     4,     5,     0,     6,     0,     0,     0,     0,     0,
+       0,     7,     0,     0,     0,     0,     0,     8,     0,     9,
+       7,     0,     0,     0,     0,     0,     8,     0,     9
+};
+
+static const yytype_int16 yycheck[] =
+{
+      52,    73,     0,    55,     0,     7,     8,    69,     1,    67,
+      35,   210,   211,    11,    15,    11,    61,    11,   254,    44,
+       7,     8,    31,    31,    26,     7,     8,    31,     0,    43,
+      31,     9,    10,    36,    48,    18,    19,    61,    90,    26,
+      64,    44,    45,    61,    26,    47,    64,    56,    56,   111,
+     286,   287,    56,    31,   126,    61,    31,    59,    64,    62,
+      47,    59,    65,    62,   122,    47,    69,    67,    61,    61,
+      61,    64,    59,    67,    40,    41,    68,    59,    83,    84,
+      85,    86,    87,    88,    89,    68,    52,    53,   147,   148,
+     149,   150,   164,    61,     3,     4,     5,     6,    56,     8,
+     172,    48,   174,    31,   106,   167,   168,   306,   307,   161,
+     162,   169,   113,    65,   116,   117,   106,   189,    67,   106,
+     300,   301,   124,    32,   106,   127,   116,   117,   124,   116,
+     117,   183,   312,    23,   116,   117,    31,    27,   190,   191,
+     127,   321,    62,   323,   324,   127,    56,    57,    58,    31,
+     155,   156,   157,    31,    63,    45,    67,   337,   210,   211,
+      31,    32,    11,   343,    31,    32,   346,   239,    62,     3,
+       4,     5,     6,   245,     8,   247,   248,   249,    63,    64,
+      31,    32,   240,   241,    38,    39,    46,    47,     3,     4,
+       5,     6,     7,     8,     9,    10,   198,    11,    32,    62,
+     252,   253,   198,   145,   146,   257,    54,    55,    67,    24,
+      63,    64,    42,    63,    64,    30,    31,    32,    63,    64,
+      63,    64,    37,   275,    63,    64,    63,    64,    49,    63,
+       3,     4,     5,     6,    50,     8,    63,    64,     3,     4,
+       5,     6,    51,     8,    18,    19,    66,   319,   151,   152,
+     302,   303,   254,    68,   306,   307,   308,    67,   254,    32,
+     332,     1,    67,     3,     4,     5,     6,    32,     8,    63,
+      64,    62,    12,   325,    14,    15,    16,    17,    63,    64,
+      20,    21,    22,    23,    24,    25,    62,    27,    28,    29,
+      30,    31,    32,    33,    34,    35,    62,    37,    63,    62,
+      31,   153,   154,    63,    44,    45,    31,    31,    63,    63,
+      62,    51,    62,    62,    62,    55,    56,    61,    61,    59,
+      62,    61,    62,    62,    61,    66,    61,    67,    68,     1,
+      33,     3,     4,     5,     6,    33,     8,    26,    61,    61,
+      12,    61,    14,    15,    16,    17,    63,    63,    20,    21,
+      22,    23,    24,    25,    63,    27,    28,    29,    30,    31,
+      32,    33,    34,    35,    64,    37,    62,    61,    67,    13,
+      63,    63,    44,    45,    11,    63,    61,    61,    11,    51,
+      11,   127,    51,    55,    56,    76,     1,    59,   293,    61,
+      62,   198,   327,   343,   139,    67,    68,    12,    -1,    14,
+      15,    16,    17,    18,    19,    20,    21,    22,    23,   141,
+      25,   140,    27,    28,    29,   142,    31,   143,    33,    34,
+      35,    -1,    37,   144,    -1,    -1,    -1,    -1,    -1,    44,
+      45,    -1,    -1,    -1,    -1,    -1,    51,    -1,    -1,    -1,
+      55,    56,    -1,     1,    59,    -1,    61,    62,    -1,    -1,
+      -1,    -1,    67,    68,    12,    -1,    14,    15,    16,    17,
+      18,    19,    20,    21,    22,    23,    -1,    25,    -1,    27,
+      28,    29,    -1,    31,    -1,    33,    34,    35,    -1,    37,
+      -1,    -1,    -1,    -1,    -1,    -1,    44,    45,    -1,     3,
+       4,     5,     6,    51,     8,    -1,    -1,    55,    56,    -1,
+       1,    59,    -1,    61,    62,    -1,    -1,    -1,    -1,    67,
+      68,    12,    -1,    14,    15,    16,    17,    -1,    32,    20,
+      21,    22,    23,    -1,    25,    -1,    27,    28,    29,    -1,
+      31,    -1,    33,    34,    35,    -1,    37,    -1,    -1,    -1,
+      -1,    -1,    -1,    44,    45,    -1,    -1,    -1,    -1,    63,
+      51,    -1,    -1,    -1,    55,    56,    -1,    -1,    59,    -1,
+      61,    62,    -1,    -1,    -1,    -1,    67,     3,     4,     5,
+       6,     7,     8,     9,    10,    -1,     3,     4,     5,     6,
+       7,     8,     9,    10,    -1,    -1,    -1,    -1,    24,    -1,
+      -1,    -1,    -1,    -1,    30,    31,    32,    24,    -1,    -1,
+      -1,    37,    -1,    30,    31,    32,    -1,    -1,    -1,    -1,
+      37,    -1,    -1,    -1,    -1,     3,     4,     5,     6,     7,
+       8,     9,    10,    -1,     3,     4,     5,     6,     7,     8,
+       9,    10,    68,    -1,    -1,    -1,    24,    -1,    -1,    -1,
+      -1,    68,    30,    31,    32,    24,    -1,    -1,    -1,    37,
+      -1,    30,    31,    32,     3,     4,     5,     6,    37,     8,
+      -1,     1,    -1,     3,     4,     5,     6,    -1,     8,    -1,
+      -1,    -1,    -1,    -1,    -1,    24,    -1,    -1,    -1,    -1,
+      68,    -1,    -1,    32,    24,    -1,    -1,    -1,    28,    68,
+      30,    31,    32,    33,    34,    35,     1,    37,    -1,    -1,
+      -1,    -1,    -1,    -1,    44,    45,    -1,    -1,    -1,    -1,
+      -1,    51,    -1,    -1,    -1,    55,    56,    -1,    -1,    59,
+      -1,    61,    62,    28,    -1,    -1,    31,    -1,    33,    34,
+      35,    -1,    37,    -1,    -1,    -1,    -1,    -1,    -1,    44,
+      45,    -1,    -1,    -1,    -1,    -1,    51,    -1,    -1,    -1,
+      55,    56,    -1,    -1,    59,    28,    61,    62,    31,    -1,
+      33,    34,    35,    -1,    37,    -1,    -1,    -1,    -1,    -1,
+      -1,    44,    45,    -1,    -1,    -1,    -1,    -1,    51,    -1,
+      -1,    -1,    55,    56,    -1,    28,    59,    -1,    31,    62,
+      33,    34,    35,    66,    37,    -1,    -1,    -1,    -1,    -1,
+      -1,    44,    45,    -1,    -1,    -1,    -1,    -1,    51,    -1,
+      -1,    -1,    55,    56,    -1,    -1,    59,    -1,    28,    62,
+      63,    31,    -1,    33,    34,    35,    -1,    37,    -1,    -1,
+      -1,    -1,    -1,    -1,    44,    45,    -1,    -1,    -1,    -1,
+      -1,    51,    -1,    -1,    -1,    55,    56,    -1,    -1,    59,
+      -1,    28,    62,    63,    31,    -1,    33,    34,    35,    -1,
+      37,    -1,    -1,    -1,    -1,    -1,    -1,    44,    45,    -1,
+      -1,    -1,    -1,    -1,    51,    -1,    -1,    -1,    55,    56,
+      -1,    -1,    59,    -1,    28,    62,    63,    31,    -1,    33,
+      34,    35,    -1,    37,    -1,    -1,    -1,    -1,    -1,    -1,
+      44,    45,    -1,    -1,    -1,    -1,    -1,    51,    -1,    -1,
+      -1,    55,    56,    -1,    -1,    59,    -1,    28,    62,    63,
+      31,    -1,    33,    34,    35,    -1,    37,    -1,    -1,    -1,
+      -1,    -1,    -1,    44,    45,    -1,    -1,    -1,    -1,    -1,
+      51,    -1,    -1,    -1,    55,    56,    -1,    -1,    59,    -1,
+      28,    62,    63,    31,    -1,    33,    34,    35,    -1,    37,
+      -1,    -1,    -1,    -1,    -1,    -1,    44,    45,    -1,    -1,
+      -1,    -1,    -1,    51,    -1,    -1,    -1,    55,    56,    -1,
+      -1,    59,    28,    61,    62,    31,    -1,    33,    34,    35,
+      -1,    37,    -1,    -1,    -1,    -1,    -1,    -1,    44,    45,
+      -1,    -1,    -1,    -1,    -1,    51,    -1,    -1,    -1,    55,
+      56,    -1,    -1,    59,    -1,    61,    62,     3,     4,     5,
+       6,     7,     8,     9,    10,    28,    -1,    -1,    31,    -1,
+      33,    34,    35,    -1,    37,    -1,    -1,    -1,    24,    -1,
+      -1,    44,    45,    -1,    30,    31,    32,    -1,    51,    -1,
+      -1,    37,    55,    56,    -1,    -1,    59,     0,     1,    62,
+       3,     4,     5,     6,    -1,     8,    -1,     1,    -1,     3,
+       4,     5,     6,    -1,     8,    -1,    -1,    -1,    -1,    -1,
+      -1,    24,    -1,    -1,    -1,    -1,    -1,    30,    -1,    32,
+      24,    -1,    -1,    -1,    -1,    -1,    30,    -1,    32
+};
+
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_int8 yystos[] =
+{
+       0,     1,     3,     4,     5,     6,     8,    24,    30,    32,
+      71,    72,    73,    74,    77,    83,    84,    86,    87,    61,
+      31,    32,    31,    83,    84,    87,    24,    83,     0,    73,
+      31,    56,    78,    79,    80,    81,    82,    61,    11,    67,
+      61,    85,    31,    78,    81,    83,    78,    62,    81,     1,
+      61,    64,    48,    31,    82,    65,     9,    10,    31,     7,
+       9,    10,    31,    32,    37,    74,    77,    88,    89,    67,
+      61,    78,    61,    63,    75,    76,    83,    79,    28,    31,
+      33,    34,    35,    37,    44,    45,    51,    55,    56,    59,
+      62,   107,   108,   109,   110,   111,   112,   113,   114,   115,
+     116,   117,   118,   119,   120,   121,    62,    66,   107,    31,
+      31,    67,    74,    83,    11,    11,    62,    62,    31,    32,
+      68,    89,    88,    61,    67,    91,    63,    64,    80,    31,
+      32,   120,   120,   120,   120,   120,   120,   120,   107,    43,
+      48,    42,    49,    50,    51,    38,    39,    40,    41,    52,
+      53,    46,    47,    54,    55,    56,    57,    58,    36,    44,
+      45,    62,    65,    69,    63,    75,    66,    67,    67,    88,
+      31,    81,    63,    75,    63,    75,    62,    62,    68,     1,
+      12,    14,    15,    16,    17,    20,    21,    22,    23,    25,
+      27,    29,    61,    68,    77,    83,    90,    91,    92,    93,
+      94,    95,    96,    97,    98,    99,   102,   107,    91,    76,
+      62,    62,    63,   110,   108,   111,   112,   113,   114,   115,
+     115,   116,   116,   116,   116,   117,   117,   118,   118,   120,
+     120,   120,    31,    63,   107,   122,   107,    31,    91,    63,
+      88,    88,    68,    31,    91,    63,    91,    63,    63,    63,
+      61,    68,    62,    62,    62,    61,   107,    62,    61,    61,
+      62,    62,    91,    61,   107,   107,     1,    68,    93,    61,
+      63,   122,    63,   122,    63,    64,    66,    91,    68,    68,
+      91,    91,    91,    91,   107,   107,    77,    94,    61,   107,
+      33,    33,    26,   100,   101,    61,    61,    63,    63,   107,
+      63,    63,    94,    94,    63,    63,    64,    64,    62,   101,
+      90,    90,    63,   107,   107,    67,    61,   122,   122,    63,
+     107,    13,    90,    63,    63,    18,    19,   103,   104,    63,
+      63,    91,    63,    90,    90,    90,   107,    11,    68,   104,
+      61,    61,    91,    11,    90,   105,   106,   105,    90
+};
+
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr1[] =
+{
+       0,    70,    71,    72,    72,    73,    73,    73,    74,    74,
+      74,    74,    75,    75,    76,    77,    77,    77,    77,    77,
+      77,    77,    78,    78,    79,    79,    80,    80,    81,    81,
+      82,    82,    82,    83,    83,    83,    83,    83,    83,    85,
+      84,    84,    84,    86,    87,    87,    87,    87,    87,    88,
+      88,    89,    89,    89,    89,    89,    89,    89,    89,    89,
+      89,    89,    90,    90,    90,    90,    90,    90,    90,    90,
+      90,    90,    90,    90,    91,    91,    91,    92,    92,    93,
+      93,    94,    94,    94,    95,    95,    96,    96,    96,    96,
+      97,    97,    97,    97,    98,    98,    99,   100,   100,   101,
+     101,   102,   103,   103,   104,   104,   105,   105,   106,   106,
+     107,   108,   108,   109,   109,   110,   110,   111,   111,   112,
+     112,   113,   113,   114,   114,   114,   115,   115,   115,   115,
+     115,   116,   116,   116,   117,   117,   117,   118,   118,   118,
+     118,   119,   119,   119,   119,   119,   119,   119,   119,   120,
+     120,   120,   120,   120,   120,   120,   120,   120,   120,   120,
+     120,   120,   120,   121,   121,   121,   121,   121,   122,   122
+};
+
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
+{
+       0,     2,     1,     1,     2,     1,     1,     2,     6,     5,
+       7,     6,     1,     3,     2,     3,     4,     4,     5,     3,
+       2,     2,     1,     3,     1,     3,     2,     1,     1,     2,
+       1,     4,     3,     1,     1,     1,     1,     1,     1,     0,
+       6,     2,     2,     2,     4,     7,     7,     6,     1,     1,
+       2,     1,     2,     1,     5,     5,     4,     4,     5,     5,
+       2,     2,     1,     1,     1,     1,     1,     1,     1,     1,
+       5,     7,     7,     3,     2,     3,     3,     1,     2,     1,
+       1,     1,     2,     2,     5,     7,     5,     7,     6,     7,
+       2,     3,     2,     2,     3,     2,     3,     1,     2,     5,
+       4,     7,     1,     2,     4,     3,     0,     1,     1,     2,
+       1,     1,     3,     1,     3,     1,     3,     1,     3,     1,
+       3,     1,     3,     1,     3,     3,     1,     3,     3,     3,
+       3,     1,     3,     3,     1,     3,     3,     1,     3,     3,
+       3,     1,     4,     3,     3,     4,     3,     2,     2,     1,
+       2,     2,     2,     2,     2,     2,     2,     5,     5,     4,
+       4,     2,     2,     1,     1,     1,     1,     3,     1,     3
+};
+
+
+enum { YYENOMEM = -2 };
+
+#define yyerrok         (yyerrstatus = 0)
+#define yyclearin       (yychar = YYEMPTY)
+
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
+
+
+#define YYRECOVERING()  (!!yyerrstatus)
+
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
+
+
+/* Enable debugging if requested.  */
+#if YYDEBUG
+
+# ifndef YYFPRINTF
+#  include <stdio.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYFPRINTF fprintf
+# endif
+
+# define YYDPRINTF(Args)                        \
+do {                                            \
+  if (yydebug)                                  \
+    YYFPRINTF Args;                             \
+} while (0)
+
+
+
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
+do {                                                                      \
+  if (yydebug)                                                            \
+    {                                                                     \
+      YYFPRINTF (stderr, "%s ", Title);                                   \
+      yy_symbol_print (stderr,                                            \
+                  Kind, Value); \
+      YYFPRINTF (stderr, "\n");                                           \
+    }                                                                     \
+} while (0)
+
+
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
+
+static void
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
+{
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
+  if (!yyvaluep)
+    return;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
+
+static void
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
+{
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
+
+  yy_symbol_value_print (yyo, yykind, yyvaluep);
+  YYFPRINTF (yyo, ")");
+}
+
+/*------------------------------------------------------------------.
+| yy_stack_print -- Print the state stack from its BOTTOM up to its |
+| TOP (included).                                                   |
+`------------------------------------------------------------------*/
+
+static void
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
+{
+  YYFPRINTF (stderr, "Stack now");
+  for (; yybottom <= yytop; yybottom++)
+    {
+      int yybot = *yybottom;
+      YYFPRINTF (stderr, " %d", yybot);
+    }
+  YYFPRINTF (stderr, "\n");
+}
+
+# define YY_STACK_PRINT(Bottom, Top)                            \
+do {                                                            \
+  if (yydebug)                                                  \
+    yy_stack_print ((Bottom), (Top));                           \
+} while (0)
+
+
+/*------------------------------------------------.
+| Report that the YYRULE is going to be reduced.  |
+`------------------------------------------------*/
+
+static void
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
+                 int yyrule)
+{
+  int yylno = yyrline[yyrule];
+  int yynrhs = yyr2[yyrule];
+  int yyi;
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
+             yyrule - 1, yylno);
+  /* The symbols being reduced.  */
+  for (yyi = 0; yyi < yynrhs; yyi++)
+    {
+      YYFPRINTF (stderr, "   $%d = ", yyi + 1);
+      yy_symbol_print (stderr,
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)]);
+      YYFPRINTF (stderr, "\n");
+    }
+}
+
+# define YY_REDUCE_PRINT(Rule)          \
+do {                                    \
+  if (yydebug)                          \
+    yy_reduce_print (yyssp, yyvsp, Rule); \
+} while (0)
+
+/* Nonzero means print parse trace.  It is left uninitialized so that
+   multiple parsers can coexist.  */
+int yydebug;
+#else /* !YYDEBUG */
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
+# define YY_STACK_PRINT(Bottom, Top)
+# define YY_REDUCE_PRINT(Rule)
+#endif /* !YYDEBUG */
+
+
+/* YYINITDEPTH -- initial size of the parser's stacks.  */
+#ifndef YYINITDEPTH
+# define YYINITDEPTH 200
+#endif
+
+/* YYMAXDEPTH -- maximum size the stacks can grow to (effective only
+   if the built-in stack extension method is used).
+
+   Do not make this value too large; the results are undefined if
+   YYSTACK_ALLOC_MAXIMUM < YYSTACK_BYTES (YYMAXDEPTH)
+   evaluated with infinite-precision integer arithmetic.  */
+
+#ifndef YYMAXDEPTH
+# define YYMAXDEPTH 10000
+#endif
+
+
+
+
+
+
+/*-----------------------------------------------.
+| Release the memory associated to this symbol.  |
+`-----------------------------------------------*/
+
+static void
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep)
+{
+  YY_USE (yyvaluep);
+  if (!yymsg)
+    yymsg = "Deleting";
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+/* Lookahead token kind.  */
+int yychar;
+
+/* The semantic value of the lookahead symbol.  */
+YYSTYPE yylval;
+/* Number of syntax errors so far.  */
+int yynerrs;
+
+
+
+
+/*----------.
+| yyparse.  |
+`----------*/
+
+int
+yyparse (void)
+{
+    yy_state_fast_t yystate = 0;
+    /* Number of tokens to shift before error messages enabled.  */
+    int yyerrstatus = 0;
+
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
+       to reallocate them elsewhere.  */
+
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
+
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
+
+    /* The semantic value stack: array, bottom, top.  */
+    YYSTYPE yyvsa[YYINITDEPTH];
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
+
+  int yyn;
+  /* The return value of yyparse.  */
+  int yyresult;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
+  /* The variables used to return semantic value and location from the
+     action routines.  */
+  YYSTYPE yyval;
+
+
+
+#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
+
+  /* The number of symbols on the RHS of the reduced rule.
+     Keep to zero when no symbol should be popped.  */
+  int yylen = 0;
+
+  YYDPRINTF ((stderr, "Starting parse\n"));
+
+  yychar = YYEMPTY; /* Cause a token to be read.  */
+
+  goto yysetstate;
+
+
+/*------------------------------------------------------------.
+| yynewstate -- push a new state, which is found in yystate.  |
+`------------------------------------------------------------*/
+yynewstate:
+  /* In all cases, when you get here, the value and location stacks
+     have just been pushed.  So pushing a state here evens the stacks.  */
+  yyssp++;
+
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
+
+  if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
+    {
+      /* Get the current used size of the three stacks, in elements.  */
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
+
+# if defined yyoverflow
+      {
+        /* Give user a chance to reallocate the stack.  Use copies of
+           these so that the &'s don't force the real ones into
+           memory.  */
+        yy_state_t *yyss1 = yyss;
+        YYSTYPE *yyvs1 = yyvs;
+
+        /* Each stack pointer address is followed by the size of the
+           data in use in that stack, in bytes.  This used to be a
+           conditional around just the two extra args, but that might
+           be undefined if yyoverflow is a macro.  */
+        yyoverflow (YY_("memory exhausted"),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
+                    &yystacksize);
+        yyss = yyss1;
+        yyvs = yyvs1;
+      }
+# else /* defined YYSTACK_RELOCATE */
+      /* Extend the stack our own way.  */
+      if (YYMAXDEPTH <= yystacksize)
+        YYNOMEM;
+      yystacksize *= 2;
+      if (YYMAXDEPTH < yystacksize)
+        yystacksize = YYMAXDEPTH;
+
+      {
+        yy_state_t *yyss1 = yyss;
+        union yyalloc *yyptr =
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
+        if (! yyptr)
+          YYNOMEM;
+        YYSTACK_RELOCATE (yyss_alloc, yyss);
+        YYSTACK_RELOCATE (yyvs_alloc, yyvs);
+#  undef YYSTACK_RELOCATE
+        if (yyss1 != yyssa)
+          YYSTACK_FREE (yyss1);
+      }
+# endif
+
+      yyssp = yyss + yysize - 1;
+      yyvsp = yyvs + yysize - 1;
+
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
+
+      if (yyss + yystacksize - 1 <= yyssp)
+        YYABORT;
+    }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
+
+
+  if (yystate == YYFINAL)
+    YYACCEPT;
+
+  goto yybackup;
+
+
+/*-----------.
+| yybackup.  |
+`-----------*/
+yybackup:
+  /* Do appropriate processing given the current state.  Read a
+     lookahead token if we need one and don't already have one.  */
+
+  /* First try to decide what to do without reference to lookahead token.  */
+  yyn = yypact[yystate];
+  if (yypact_value_is_default (yyn))
+    goto yydefault;
+
+  /* Not known => get a lookahead token if don't already have one.  */
+
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
+  if (yychar == YYEMPTY)
+    {
+      YYDPRINTF ((stderr, "Reading a token\n"));
+      yychar = yylex ();
+    }
+
+  if (yychar <= YYEOF)
+    {
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
+      YYDPRINTF ((stderr, "Now at end of input.\n"));
+    }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      goto yyerrlab1;
+    }
+  else
+    {
+      yytoken = YYTRANSLATE (yychar);
+      YY_SYMBOL_PRINT ("Next token is", yytoken, &yylval, &yylloc);
+    }
+
+  /* If the proper action on seeing token YYTOKEN is to reduce or to
+     detect an error, take that action.  */
+  yyn += yytoken;
+  if (yyn < 0 || YYLAST < yyn || yycheck[yyn] != yytoken)
+    goto yydefault;
+  yyn = yytable[yyn];
+  if (yyn <= 0)
+    {
+      if (yytable_value_is_error (yyn))
+        goto yyerrlab;
+      yyn = -yyn;
+      goto yyreduce;
+    }
+
+  /* Count tokens shifted since error; after three, turn off error
+     status.  */
+  if (yyerrstatus)
+    yyerrstatus--;
+
+  /* Shift the lookahead token.  */
+  YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
+  yystate = yyn;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
+  goto yynewstate;
+
+
+/*-----------------------------------------------------------.
+| yydefault -- do the default action for the current state.  |
+`-----------------------------------------------------------*/
+yydefault:
+  yyn = yydefact[yystate];
+  if (yyn == 0)
+    goto yyerrlab;
+  goto yyreduce;
+
+
+/*-----------------------------.
+| yyreduce -- do a reduction.  |
+`-----------------------------*/
+yyreduce:
+  /* yyn is the number of a rule to reduce with.  */
+  yylen = yyr2[yyn];
+
+  /* If YYLEN is nonzero, implement the default value of the action:
+     '$$ = $1'.
+
+     Otherwise, the following line sets YYVAL to garbage.
+     This behavior is undocumented and Bison
+     users should not rely upon it.  Assigning to YYVAL
+     unconditionally makes the parser a bit smaller, and it avoids a
+     GCC warning that YYVAL may be used uninitialized.  */
+  yyval = yyvsp[1-yylen];
+
+
+  YY_REDUCE_PRINT (yyn);
+  switch (yyn)
+    {
+  case 2: /* program: external_declaration_list  */
+#line 192 "src/parser.y"
+                                { root = (yyvsp[0].node); }
+#line 1711 "build/y.tab.c"
+    break;
+
+  case 3: /* external_declaration_list: external_declaration  */
+#line 196 "src/parser.y"
+                           { (yyval.node) = (yyvsp[0].node); }
+#line 1717 "build/y.tab.c"
+    break;
+
+  case 4: /* external_declaration_list: external_declaration_list external_declaration  */
+#line 197 "src/parser.y"
+                                                     {
+        (yyval.node) = append_node((yyvsp[-1].node), (yyvsp[0].node));
+    }
+#line 1725 "build/y.tab.c"
+    break;
+
+  case 5: /* external_declaration: function_definition  */
+#line 203 "src/parser.y"
+                          { (yyval.node) = (yyvsp[0].node); }
+#line 1731 "build/y.tab.c"
+    break;
+
+  case 6: /* external_declaration: declaration  */
+#line 204 "src/parser.y"
+                  { (yyval.node) = (yyvsp[0].node); }
+#line 1737 "build/y.tab.c"
+    break;
+
+  case 7: /* external_declaration: error ';'  */
+#line 205 "src/parser.y"
+                {
+          yyerrok;
+          (yyval.node) = NULL;
+      }
+#line 1746 "build/y.tab.c"
+    break;
+
+  case 8: /* function_definition: type_specifier T_IDENT '(' parameter_list ')' compound_statement  */
+#line 213 "src/parser.y"
+                                                                       {
+        (yyval.node) = create_func_def((yyvsp[-5].node), (yyvsp[-4].str), (yyvsp[-2].node), (yyvsp[0].node));
+        SET_LINE((yyval.node));
+    }
+#line 1755 "build/y.tab.c"
+    break;
+
+  case 9: /* function_definition: type_specifier T_IDENT '(' ')' compound_statement  */
+#line 217 "src/parser.y"
+                                                        {
+        (yyval.node) = create_func_def((yyvsp[-4].node), (yyvsp[-3].str), NULL, (yyvsp[0].node));
+        SET_LINE((yyval.node));
+    }
+#line 1764 "build/y.tab.c"
+    break;
+
+  case 10: /* function_definition: type_specifier pointer T_IDENT '(' parameter_list ')' compound_statement  */
+#line 221 "src/parser.y"
+                                                                               {
+        (yyvsp[-6].node)->pointer_level = (yyvsp[-5].node)->int_val;
+        (yyval.node) = create_func_def((yyvsp[-6].node), (yyvsp[-4].str), (yyvsp[-2].node), (yyvsp[0].node));
+        SET_LINE((yyval.node));
+    }
+#line 1774 "build/y.tab.c"
+    break;
+
+  case 11: /* function_definition: type_specifier pointer T_IDENT '(' ')' compound_statement  */
+#line 226 "src/parser.y"
+                                                                {
+        (yyvsp[-5].node)->pointer_level = (yyvsp[-4].node)->int_val;
+        (yyval.node) = create_func_def((yyvsp[-5].node), (yyvsp[-3].str), NULL, (yyvsp[0].node));
+        SET_LINE((yyval.node));
+    }
+#line 1784 "build/y.tab.c"
+    break;
+
+  case 12: /* parameter_list: parameter_declaration  */
+#line 234 "src/parser.y"
+                            { (yyval.node) = (yyvsp[0].node); }
+#line 1790 "build/y.tab.c"
+    break;
+
+  case 13: /* parameter_list: parameter_list ',' parameter_declaration  */
+#line 235 "src/parser.y"
+                                               {
+        (yyval.node) = append_node((yyvsp[-2].node), (yyvsp[0].node));
+    }
+#line 1798 "build/y.tab.c"
+    break;
+
+  case 14: /* parameter_declaration: type_specifier declarator  */
+#line 241 "src/parser.y"
+                                {
+        ASTNode *param = create_node(NODE_PARAM);
+        SET_LINE(param);
+        param->left = (yyvsp[-1].node);
+        param->str_val = (yyvsp[0].node)->str_val;
+        param->pointer_level = (yyvsp[0].node)->pointer_level;
+        param->array_dim_count = (yyvsp[0].node)->array_dim_count;
+        param->array_dim_exprs = (yyvsp[0].node)->array_dim_exprs;
+        // Note: $2 is freed implicitly or we can free it
+        (yyval.node) = param;
+    }
+#line 1814 "build/y.tab.c"
+    break;
+
+  case 15: /* declaration: type_specifier declarator_list ';'  */
+#line 256 "src/parser.y"
+                                         {
+        /* If this is a struct definition with declarators (e.g. "struct S { ... } a;")
+         * we need to keep the struct definition node in the AST so semantic
+         * analysis can register the struct type before processing the variables.
+         */
+        ASTNode *result = NULL;
+        ASTNode *type_node = NULL;
+
+        if ((yyvsp[-2].node)->type == NODE_STRUCT_DEF) {
+            /* Keep the struct definition in the list */
+            result = (yyvsp[-2].node);
+            /* Build a type node to attach to each declarator */
+            type_node = create_type_node(T_STRUCT);
+            type_node->str_val = strdup((yyvsp[-2].node)->str_val);
+            type_node->left = (yyvsp[-2].node); /* keep definition for semantic use */
+        } else {
+            /* Normal type specifier (int/char/void/struct ref) */
+            type_node = (yyvsp[-2].node);
+        }
+
+        /* Distribute type to all declarators */
+        ASTNode *temp = (yyvsp[-1].node);
+        while(temp) {
+            temp->left = type_node;
+            if (type_node->type == NODE_TYPE && type_node->int_val == T_STRUCT) {
+                /* Preserve struct tag name if set */
+                if (!temp->left->str_val && type_node->str_val)
+                    temp->left->str_val = strdup(type_node->str_val);
+            }
+            temp = temp->next;
+        }
+
+        if (result) {
+            /* append declarators after struct definition */
+            (yyval.node) = append_node(result, (yyvsp[-1].node));
+        } else {
+            (yyval.node) = (yyvsp[-1].node);
+        }
+    }
+#line 1858 "build/y.tab.c"
+    break;
+
+  case 16: /* declaration: T_CONST type_specifier declarator_list ';'  */
+#line 295 "src/parser.y"
+                                                 {
+        ASTNode *result = NULL;
+        ASTNode *type_node = NULL;
+
+        if ((yyvsp[-2].node)->type == NODE_STRUCT_DEF) {
+            result = (yyvsp[-2].node);
+            type_node = create_type_node(T_STRUCT);
+            type_node->str_val = strdup((yyvsp[-2].node)->str_val);
+            type_node->left = (yyvsp[-2].node);
+        } else {
+            type_node = (yyvsp[-2].node);
+        }
+
+        ASTNode *temp = (yyvsp[-1].node);
+        while(temp) {
+            temp->left = type_node;
+            temp->is_const = 1; /* Mark as const */
+            if (type_node->type == NODE_TYPE && type_node->int_val == T_STRUCT) {
+                if (!temp->left->str_val && type_node->str_val)
+                    temp->left->str_val = strdup(type_node->str_val);
+            }
+            temp = temp->next;
+        }
+
+        if (result) {
+            (yyval.node) = append_node(result, (yyvsp[-1].node));
+        } else {
+            (yyval.node) = (yyvsp[-1].node);
+        }
+    }
+#line 1893 "build/y.tab.c"
+    break;
+
+  case 17: /* declaration: T_TYPEDEF type_specifier declarator_list ';'  */
+#line 325 "src/parser.y"
+                                                   {
+        ASTNode *result = NULL;
+        ASTNode *type_node = NULL;
+
+        if ((yyvsp[-2].node)->type == NODE_STRUCT_DEF) {
+            result = (yyvsp[-2].node);
+            type_node = create_type_node(T_STRUCT);
+            type_node->str_val = strdup((yyvsp[-2].node)->str_val);
+            type_node->left = (yyvsp[-2].node);
+        } else {
+            type_node = (yyvsp[-2].node);
+        }
+
+        ASTNode *temp = (yyvsp[-1].node);
+        while(temp) {
+            temp->left = type_node;
+            temp->is_typedef = 1;
+            if (type_node->type == NODE_TYPE && type_node->int_val == T_STRUCT) {
+                if (!temp->left->str_val && type_node->str_val)
+                    temp->left->str_val = strdup(type_node->str_val);
+            }
+            temp = temp->next;
+        }
+
+        if (result) {
+            (yyval.node) = append_node(result, (yyvsp[-1].node));
+        } else {
+            (yyval.node) = (yyvsp[-1].node);
+        }
+        register_typedef_declarator_list((yyvsp[-1].node));
+    }
+#line 1929 "build/y.tab.c"
+    break;
+
+  case 18: /* declaration: T_TYPEDEF T_CONST type_specifier declarator_list ';'  */
+#line 356 "src/parser.y"
+                                                           {
+        ASTNode *result = NULL;
+        ASTNode *type_node = NULL;
+
+        if ((yyvsp[-2].node)->type == NODE_STRUCT_DEF) {
+            result = (yyvsp[-2].node);
+            type_node = create_type_node(T_STRUCT);
+            type_node->str_val = strdup((yyvsp[-2].node)->str_val);
+            type_node->left = (yyvsp[-2].node);
+        } else {
+            type_node = (yyvsp[-2].node);
+        }
+
+        ASTNode *temp = (yyvsp[-1].node);
+        while(temp) {
+            temp->left = type_node;
+            temp->is_typedef = 1;
+            temp->is_const = 1;
+            if (type_node->type == NODE_TYPE && type_node->int_val == T_STRUCT) {
+                if (!temp->left->str_val && type_node->str_val)
+                    temp->left->str_val = strdup(type_node->str_val);
+            }
+            temp = temp->next;
+        }
+
+        if (result) {
+            (yyval.node) = append_node(result, (yyvsp[-1].node));
+        } else {
+            (yyval.node) = (yyvsp[-1].node);
+        }
+        register_typedef_declarator_list((yyvsp[-1].node));
+    }
+#line 1966 "build/y.tab.c"
+    break;
+
+  case 19: /* declaration: type_specifier declarator_list error  */
+#line 388 "src/parser.y"
+                                           {
+        yyerrok;
+        (yyval.node) = (yyvsp[-1].node);
+      }
+#line 1975 "build/y.tab.c"
+    break;
+
+  case 20: /* declaration: struct_specifier ';'  */
+#line 392 "src/parser.y"
+                           {
+        /* Standalone struct definition (no variable declared) */
+        (yyval.node) = (yyvsp[-1].node);
+    }
+#line 1984 "build/y.tab.c"
+    break;
+
+  case 21: /* declaration: class_specifier ';'  */
+#line 396 "src/parser.y"
+                          {
+        /* Standalone class definition (no variable declared) */
+        (yyval.node) = (yyvsp[-1].node);
+    }
+#line 1993 "build/y.tab.c"
+    break;
+
+  case 22: /* declarator_list: init_declarator  */
+#line 403 "src/parser.y"
+                      { (yyval.node) = (yyvsp[0].node); }
+#line 1999 "build/y.tab.c"
+    break;
+
+  case 23: /* declarator_list: declarator_list ',' init_declarator  */
+#line 404 "src/parser.y"
+                                          {
+        if ((yyvsp[0].node))
+          (yyval.node) = append_node((yyvsp[-2].node), (yyvsp[0].node));
+        else
+          (yyval.node) = (yyvsp[-2].node);
+    }
+#line 2010 "build/y.tab.c"
+    break;
+
+  case 24: /* init_declarator: declarator  */
+#line 413 "src/parser.y"
+                 { (yyval.node) = (yyvsp[0].node); }
+#line 2016 "build/y.tab.c"
+    break;
+
+  case 25: /* init_declarator: declarator '=' expression  */
+#line 414 "src/parser.y"
+                                {
+        (yyvsp[-2].node)->right = (yyvsp[0].node);   /* attach initializer */
+        (yyval.node) = (yyvsp[-2].node);
+    }
+#line 2025 "build/y.tab.c"
+    break;
+
+  case 26: /* declarator: pointer direct_declarator  */
+#line 421 "src/parser.y"
+                                {
+        (yyval.node) = (yyvsp[0].node);
+        (yyval.node)->pointer_level = (yyvsp[-1].node)->int_val;
+    }
+#line 2034 "build/y.tab.c"
+    break;
+
+  case 27: /* declarator: direct_declarator  */
+#line 425 "src/parser.y"
+                        {
+        (yyval.node) = (yyvsp[0].node);
+        (yyval.node)->pointer_level = 0;
+    }
+#line 2043 "build/y.tab.c"
+    break;
+
+  case 28: /* pointer: '*'  */
+#line 432 "src/parser.y"
+          {
+        (yyval.node) = create_node(NODE_TYPE);
+        (yyval.node)->int_val = 1;
+    }
+#line 2052 "build/y.tab.c"
+    break;
+
+  case 29: /* pointer: '*' pointer  */
+#line 436 "src/parser.y"
+                  {
+        (yyval.node) = (yyvsp[0].node);
+        (yyval.node)->int_val++;
+    }
+#line 2061 "build/y.tab.c"
+    break;
+
+  case 30: /* direct_declarator: T_IDENT  */
+#line 443 "src/parser.y"
+              {
+        (yyval.node) = create_node(NODE_VAR_DECL);
+        SET_LINE((yyval.node));
+        (yyval.node)->str_val = strdup((yyvsp[0].str));
+        (yyval.node)->array_dim_count = 0;
+        (yyval.node)->array_dim_exprs = NULL;
+        (yyval.node)->next = NULL;
+    }
+#line 2074 "build/y.tab.c"
+    break;
+
+  case 31: /* direct_declarator: direct_declarator '[' expression ']'  */
+#line 451 "src/parser.y"
+                                           {
+        (yyval.node) = (yyvsp[-3].node);
+        (yyval.node)->array_dim_exprs = realloc((yyval.node)->array_dim_exprs, sizeof(ASTNode*) * ((yyval.node)->array_dim_count + 1));
+        (yyval.node)->array_dim_exprs[(yyval.node)->array_dim_count] = (yyvsp[-1].node);
+        (yyval.node)->array_dim_count++;
+    }
+#line 2085 "build/y.tab.c"
+    break;
+
+  case 32: /* direct_declarator: direct_declarator '[' ']'  */
+#line 457 "src/parser.y"
+                                {
+        (yyval.node) = (yyvsp[-2].node);
+        (yyval.node)->array_dim_exprs = realloc((yyval.node)->array_dim_exprs, sizeof(ASTNode*) * ((yyval.node)->array_dim_count + 1));
+        (yyval.node)->array_dim_exprs[(yyval.node)->array_dim_count] = NULL; // VLA
+        (yyval.node)->array_dim_count++;
+    }
+#line 2096 "build/y.tab.c"
+    break;
+
+  case 33: /* type_specifier: T_INT  */
+#line 465 "src/parser.y"
+                      { (yyval.node) = create_type_node(T_INT); }
+#line 2102 "build/y.tab.c"
+    break;
+
+  case 34: /* type_specifier: T_CHAR  */
+#line 466 "src/parser.y"
+                        { (yyval.node) = create_type_node(T_CHAR); }
+#line 2108 "build/y.tab.c"
+    break;
+
+  case 35: /* type_specifier: T_VOID  */
+#line 467 "src/parser.y"
+                        { (yyval.node) = create_type_node(T_VOID); }
+#line 2114 "build/y.tab.c"
+    break;
+
+  case 36: /* type_specifier: struct_specifier  */
+#line 468 "src/parser.y"
+                                  { (yyval.node) = (yyvsp[0].node); }
+#line 2120 "build/y.tab.c"
+    break;
+
+  case 37: /* type_specifier: class_specifier  */
+#line 469 "src/parser.y"
+                                 { (yyval.node) = (yyvsp[0].node); }
+#line 2126 "build/y.tab.c"
+    break;
+
+  case 38: /* type_specifier: T_TYPE_NAME  */
+#line 470 "src/parser.y"
+                             {
+                   (yyval.node) = create_node(NODE_TYPE); 
+                   (yyval.node)->str_val = strdup((yyvsp[0].str));
+                   (yyval.node)->data_type = TYPE_STRUCT;
+                   SET_LINE((yyval.node));
+               }
+#line 2137 "build/y.tab.c"
+    break;
+
+  case 39: /* $@1: %empty  */
+#line 479 "src/parser.y"
+                       {
+        /* Make struct tag visible as a type while parsing its body. */
+        parser_register_typedef_name((yyvsp[0].str));
+    }
+#line 2146 "build/y.tab.c"
+    break;
+
+  case 40: /* struct_specifier: T_STRUCT T_IDENT $@1 '{' struct_declaration_list '}'  */
+#line 482 "src/parser.y"
+                                      {
+        ASTNode *node = create_node(NODE_STRUCT_DEF);
+        SET_LINE(node);
+        node->str_val = strdup((yyvsp[-4].str));             /* struct tag */
+        node->body = (yyvsp[-1].node);                        /* member declarations */
+        (yyval.node) = node;
+    }
+#line 2158 "build/y.tab.c"
+    break;
+
+  case 41: /* struct_specifier: T_STRUCT T_IDENT  */
+#line 489 "src/parser.y"
+                       {
+        /* Struct type reference (no definition)
+         * We create a NODE_TYPE with int_val = T_STRUCT and str_val = tag.
+         */
+        parser_register_typedef_name((yyvsp[0].str));
+        ASTNode *node = create_type_node(T_STRUCT);
+        node->str_val = strdup((yyvsp[0].str));
+        (yyval.node) = node;
+    }
+#line 2172 "build/y.tab.c"
+    break;
+
+  case 42: /* struct_specifier: T_STRUCT T_TYPE_NAME  */
+#line 498 "src/parser.y"
+                           {
+        /* `struct S` once S is defined: the lexer now returns the tag as a type name. */
+        ASTNode *node = create_type_node(T_STRUCT);
+        node->str_val = strdup((yyvsp[0].str));
+        (yyval.node) = node;
+    }
+#line 2183 "build/y.tab.c"
+    break;
+
+  case 43: /* class_head: T_CLASS T_IDENT  */
+#line 507 "src/parser.y"
+                      {
+        /* Make class tag visible as a type while parsing its body. */
+        parser_register_typedef_name((yyvsp[0].str));
+        (yyval.str) = (yyvsp[0].str);
+    }
+#line 2193 "build/y.tab.c"
+    break;
+
+  case 44: /* class_specifier: class_head '{' struct_declaration_list '}'  */
+#line 515 "src/parser.y"
+                                                 {
+        ASTNode *node = create_node(NODE_STRUCT_DEF);
+        SET_LINE(node);
+        node->str_val = strdup((yyvsp[-3].str));
+        node->body = (yyvsp[-1].node);
+        node->is_class = 1;
+        (yyval.node) = node;
+    }
+#line 2206 "build/y.tab.c"
+    break;
+
+  case 45: /* class_specifier: class_head T_COLON T_PUBLIC T_IDENT '{' struct_declaration_list '}'  */
+#line 523 "src/parser.y"
+                                                                          {
+        ASTNode *node = create_node(NODE_STRUCT_DEF);
+        SET_LINE(node);
+        node->str_val = strdup((yyvsp[-6].str));
+        node->base_class_name = strdup((yyvsp[-3].str));
+        node->body = (yyvsp[-1].node);
+        node->is_class = 1;
+        node->inheritance_modifier = 0; /* public */
+        (yyval.node) = node;
+    }
+#line 2221 "build/y.tab.c"
+    break;
+
+  case 46: /* class_specifier: class_head T_COLON T_PRIVATE T_IDENT '{' struct_declaration_list '}'  */
+#line 533 "src/parser.y"
+                                                                           {
+        ASTNode *node = create_node(NODE_STRUCT_DEF);
+        SET_LINE(node);
+        node->str_val = strdup((yyvsp[-6].str));
+        node->base_class_name = strdup((yyvsp[-3].str));
+        node->body = (yyvsp[-1].node);
+        node->is_class = 1;
+        node->inheritance_modifier = 1; /* private */
+        (yyval.node) = node;
+    }
+#line 2236 "build/y.tab.c"
+    break;
+
+  case 47: /* class_specifier: class_head T_COLON T_IDENT '{' struct_declaration_list '}'  */
+#line 543 "src/parser.y"
+                                                                 {
+        ASTNode *node = create_node(NODE_STRUCT_DEF);
+        SET_LINE(node);
+        node->str_val = strdup((yyvsp[-5].str));
+        node->base_class_name = strdup((yyvsp[-3].str));
+        node->body = (yyvsp[-1].node);
+        node->is_class = 1;
+        node->inheritance_modifier = 1; /* DEFAULT private for class */
+        (yyval.node) = node;
+    }
+#line 2251 "build/y.tab.c"
+    break;
+
+  case 48: /* class_specifier: class_head  */
+#line 553 "src/parser.y"
+                 {
+        ASTNode *node = create_type_node(T_CLASS);
+        node->str_val = strdup((yyvsp[0].str));
+        (yyval.node) = node;
+    }
+#line 2261 "build/y.tab.c"
+    break;
+
+  case 49: /* struct_declaration_list: struct_member  */
+#line 561 "src/parser.y"
+                    { (yyval.node) = (yyvsp[0].node); }
+#line 2267 "build/y.tab.c"
+    break;
+
+  case 50: /* struct_declaration_list: struct_declaration_list struct_member  */
+#line 562 "src/parser.y"
+                                            { (yyval.node) = append_node((yyvsp[-1].node), (yyvsp[0].node)); }
+#line 2273 "build/y.tab.c"
+    break;
+
+  case 51: /* struct_member: declaration  */
+#line 566 "src/parser.y"
+                  { (yyval.node) = (yyvsp[0].node); }
+#line 2279 "build/y.tab.c"
+    break;
+
+  case 52: /* struct_member: T_VIRTUAL function_definition  */
+#line 567 "src/parser.y"
+                                    {
+        /* Mark the function as virtual */
+        (yyvsp[0].node)->is_virtual = 1;
+        (yyval.node) = (yyvsp[0].node);
+    }
+#line 2289 "build/y.tab.c"
+    break;
+
+  case 53: /* struct_member: function_definition  */
+#line 572 "src/parser.y"
+                          { (yyval.node) = (yyvsp[0].node); }
+#line 2295 "build/y.tab.c"
+    break;
+
+  case 54: /* struct_member: T_IDENT '(' parameter_list ')' compound_statement  */
+#line 573 "src/parser.y"
+                                                        {
+        /* Constructor with params */
+        (yyval.node) = create_func_def(create_type_node(T_VOID), (yyvsp[-4].str), (yyvsp[-2].node), (yyvsp[0].node));
+        (yyval.node)->is_constructor = 1;
+        SET_LINE((yyval.node));
+    }
+#line 2306 "build/y.tab.c"
+    break;
+
+  case 55: /* struct_member: T_TYPE_NAME '(' parameter_list ')' compound_statement  */
+#line 579 "src/parser.y"
+                                                            {
+        /* Constructor with params where class name lexes as type name */
+        (yyval.node) = create_func_def(create_type_node(T_VOID), (yyvsp[-4].str), (yyvsp[-2].node), (yyvsp[0].node));
+        (yyval.node)->is_constructor = 1;
+        SET_LINE((yyval.node));
+    }
+#line 2317 "build/y.tab.c"
+    break;
+
+  case 56: /* struct_member: T_IDENT '(' ')' compound_statement  */
+#line 585 "src/parser.y"
+                                         {
+        /* Constructor without params */
+        (yyval.node) = create_func_def(create_type_node(T_VOID), (yyvsp[-3].str), NULL, (yyvsp[0].node));
+        (yyval.node)->is_constructor = 1;
+        SET_LINE((yyval.node));
+    }
+#line 2328 "build/y.tab.c"
+    break;
+
+  case 57: /* struct_member: T_TYPE_NAME '(' ')' compound_statement  */
+#line 591 "src/parser.y"
+                                             {
+        /* Constructor without params where class name lexes as type name */
+        (yyval.node) = create_func_def(create_type_node(T_VOID), (yyvsp[-3].str), NULL, (yyvsp[0].node));
+        (yyval.node)->is_constructor = 1;
+        SET_LINE((yyval.node));
+    }
+#line 2339 "build/y.tab.c"
+    break;
+
+  case 58: /* struct_member: T_TILDE T_IDENT '(' ')' compound_statement  */
+#line 597 "src/parser.y"
+                                                 {
+        /* Destructor */
+        (yyval.node) = create_func_def(create_type_node(T_VOID), (yyvsp[-3].str), NULL, (yyvsp[0].node));
+        (yyval.node)->is_destructor = 1;
+        SET_LINE((yyval.node));
+    }
+#line 2350 "build/y.tab.c"
+    break;
+
+  case 59: /* struct_member: T_TILDE T_TYPE_NAME '(' ')' compound_statement  */
+#line 603 "src/parser.y"
+                                                     {
+        /* Destructor where class name lexes as type name */
+        (yyval.node) = create_func_def(create_type_node(T_VOID), (yyvsp[-3].str), NULL, (yyvsp[0].node));
+        (yyval.node)->is_destructor = 1;
+        SET_LINE((yyval.node));
+    }
+#line 2361 "build/y.tab.c"
+    break;
+
+  case 60: /* struct_member: T_PUBLIC T_COLON  */
+#line 609 "src/parser.y"
+                       {
+        ASTNode *node = create_node(NODE_ACCESS_SPEC);
+        SET_LINE(node);
+        node->access_modifier = 0; /* public */
+        (yyval.node) = node;
+    }
+#line 2372 "build/y.tab.c"
+    break;
+
+  case 61: /* struct_member: T_PRIVATE T_COLON  */
+#line 615 "src/parser.y"
+                        {
+        ASTNode *node = create_node(NODE_ACCESS_SPEC);
+        SET_LINE(node);
+        node->access_modifier = 1; /* private */
+        (yyval.node) = node;
+    }
+#line 2383 "build/y.tab.c"
+    break;
+
+  case 62: /* statement: compound_statement  */
+#line 625 "src/parser.y"
+                         { (yyval.node) = (yyvsp[0].node); }
+#line 2389 "build/y.tab.c"
+    break;
+
+  case 63: /* statement: expression_statement  */
+#line 626 "src/parser.y"
+                           { (yyval.node) = (yyvsp[0].node); }
+#line 2395 "build/y.tab.c"
+    break;
+
+  case 64: /* statement: selection_statement  */
+#line 627 "src/parser.y"
+                          { (yyval.node) = (yyvsp[0].node); }
+#line 2401 "build/y.tab.c"
+    break;
+
+  case 65: /* statement: iteration_statement  */
+#line 628 "src/parser.y"
+                          { (yyval.node) = (yyvsp[0].node); }
+#line 2407 "build/y.tab.c"
+    break;
+
+  case 66: /* statement: jump_statement  */
+#line 629 "src/parser.y"
+                     { (yyval.node) = (yyvsp[0].node); }
+#line 2413 "build/y.tab.c"
+    break;
+
+  case 67: /* statement: switch_statement  */
+#line 630 "src/parser.y"
+                       { (yyval.node) = (yyvsp[0].node); }
+#line 2419 "build/y.tab.c"
+    break;
+
+  case 68: /* statement: try_statement  */
+#line 631 "src/parser.y"
+                    { (yyval.node) = (yyvsp[0].node); }
+#line 2425 "build/y.tab.c"
+    break;
+
+  case 69: /* statement: throw_statement  */
+#line 632 "src/parser.y"
+                      { (yyval.node) = (yyvsp[0].node); }
+#line 2431 "build/y.tab.c"
+    break;
+
+  case 70: /* statement: T_PRINTF '(' T_STRING_LIT ')' ';'  */
+#line 633 "src/parser.y"
+                                        {
+        ASTNode *fmt = create_str_node((yyvsp[-2].str));
+        SET_LINE(fmt);
+        (yyval.node) = create_printf_node(fmt, NULL);
+        SET_LINE((yyval.node));
+    }
+#line 2442 "build/y.tab.c"
+    break;
+
+  case 71: /* statement: T_PRINTF '(' T_STRING_LIT ',' argument_expression_list ')' ';'  */
+#line 639 "src/parser.y"
+                                                                     {
+        ASTNode *fmt = create_str_node((yyvsp[-4].str));
+        SET_LINE(fmt);
+        (yyval.node) = create_printf_node(fmt, (yyvsp[-2].node));
+        SET_LINE((yyval.node));
+    }
+#line 2453 "build/y.tab.c"
+    break;
+
+  case 72: /* statement: T_SCANF '(' T_STRING_LIT ',' argument_expression_list ')' ';'  */
+#line 645 "src/parser.y"
+                                                                    {
+        ASTNode *fmt = create_str_node((yyvsp[-4].str));
+        SET_LINE(fmt);
+        (yyval.node) = create_scanf_node(fmt, (yyvsp[-2].node));
+        SET_LINE((yyval.node));
+    }
+#line 2464 "build/y.tab.c"
+    break;
+
+  case 73: /* statement: T_DELETE expression ';'  */
+#line 651 "src/parser.y"
+                              {
+        (yyval.node) = create_node(NODE_DELETE);
+        SET_LINE((yyval.node));
+        (yyval.node)->left = (yyvsp[-1].node);
+    }
+#line 2474 "build/y.tab.c"
+    break;
+
+  case 74: /* compound_statement: '{' '}'  */
+#line 659 "src/parser.y"
+              {
+        (yyval.node) = create_node(NODE_BLOCK);
+        SET_LINE((yyval.node));
+    }
+#line 2483 "build/y.tab.c"
+    break;
+
+  case 75: /* compound_statement: '{' block_item_list '}'  */
+#line 663 "src/parser.y"
+                              {
+        (yyval.node) = create_node(NODE_BLOCK);
+        SET_LINE((yyval.node));
+        (yyval.node)->left = (yyvsp[-1].node);
+    }
+#line 2493 "build/y.tab.c"
+    break;
+
+  case 76: /* compound_statement: '{' error '}'  */
+#line 668 "src/parser.y"
+                    {
+        yyerrok;
+        (yyval.node) = create_node(NODE_BLOCK);
+        SET_LINE((yyval.node));
+      }
+#line 2503 "build/y.tab.c"
+    break;
+
+  case 77: /* block_item_list: block_item  */
+#line 676 "src/parser.y"
+                 { (yyval.node) = (yyvsp[0].node); }
+#line 2509 "build/y.tab.c"
+    break;
+
+  case 78: /* block_item_list: block_item_list block_item  */
+#line 677 "src/parser.y"
+                                 {
+        (yyval.node) = append_node((yyvsp[-1].node), (yyvsp[0].node));
+    }
+#line 2517 "build/y.tab.c"
+    break;
+
+  case 79: /* block_item: declaration  */
+#line 683 "src/parser.y"
+                  { (yyval.node) = (yyvsp[0].node); }
+#line 2523 "build/y.tab.c"
+    break;
+
+  case 80: /* block_item: statement  */
+#line 684 "src/parser.y"
+                { (yyval.node) = (yyvsp[0].node); }
+#line 2529 "build/y.tab.c"
+    break;
+
+  case 81: /* expression_statement: ';'  */
+#line 688 "src/parser.y"
+          { (yyval.node) = create_node(NODE_EMPTY);  SET_LINE((yyval.node)); }
+#line 2535 "build/y.tab.c"
+    break;
+
+  case 82: /* expression_statement: expression ';'  */
+#line 689 "src/parser.y"
+                     { (yyval.node) = (yyvsp[-1].node); }
+#line 2541 "build/y.tab.c"
+    break;
+
+  case 83: /* expression_statement: error ';'  */
+#line 690 "src/parser.y"
+                {
+          yyerrok;
+          (yyval.node) = create_node(NODE_EMPTY);
+          SET_LINE((yyval.node));
+      }
+#line 2551 "build/y.tab.c"
+    break;
+
+  case 84: /* selection_statement: T_IF '(' expression ')' statement  */
+#line 698 "src/parser.y"
+                                                              {
+        (yyval.node) = create_if_node((yyvsp[-2].node), (yyvsp[0].node), NULL);
+        SET_LINE((yyval.node));
+    }
+#line 2560 "build/y.tab.c"
+    break;
+
+  case 85: /* selection_statement: T_IF '(' expression ')' statement T_ELSE statement  */
+#line 702 "src/parser.y"
+                                                         {
+        (yyval.node) = create_if_node((yyvsp[-4].node), (yyvsp[-2].node), (yyvsp[0].node));
+        SET_LINE((yyval.node));
+    }
+#line 2569 "build/y.tab.c"
+    break;
+
+  case 86: /* iteration_statement: T_WHILE '(' expression ')' statement  */
+#line 709 "src/parser.y"
+                                           {
+        (yyval.node) = create_while_node((yyvsp[-2].node), (yyvsp[0].node));
+        SET_LINE((yyval.node));
+    }
+#line 2578 "build/y.tab.c"
+    break;
+
+  case 87: /* iteration_statement: T_FOR '(' expression_statement expression_statement expression ')' statement  */
+#line 713 "src/parser.y"
+                                                                                   {
+        (yyval.node) = create_for_node((yyvsp[-4].node), (yyvsp[-3].node), (yyvsp[-2].node), (yyvsp[0].node));
+        SET_LINE((yyval.node));
+    }
+#line 2587 "build/y.tab.c"
+    break;
+
+  case 88: /* iteration_statement: T_FOR '(' declaration expression_statement ')' statement  */
+#line 717 "src/parser.y"
+                                                               {
+        (yyval.node) = create_for_node((yyvsp[-3].node), (yyvsp[-2].node), NULL, (yyvsp[0].node));
+        SET_LINE((yyval.node));
+    }
+#line 2596 "build/y.tab.c"
+    break;
+
+  case 89: /* iteration_statement: T_FOR '(' declaration expression_statement expression ')' statement  */
+#line 721 "src/parser.y"
+                                                                          {
+        (yyval.node) = create_for_node((yyvsp[-4].node), (yyvsp[-3].node), (yyvsp[-2].node), (yyvsp[0].node));
+        SET_LINE((yyval.node));
+    }
+#line 2605 "build/y.tab.c"
+    break;
+
+  case 90: /* jump_statement: T_RETURN ';'  */
+#line 728 "src/parser.y"
+                   {
+        (yyval.node) = create_node(NODE_RETURN);
+        SET_LINE((yyval.node));
+    }
+#line 2614 "build/y.tab.c"
+    break;
+
+  case 91: /* jump_statement: T_RETURN expression ';'  */
+#line 732 "src/parser.y"
+                              {
+        (yyval.node) = create_node(NODE_RETURN);
+        SET_LINE((yyval.node));
+        (yyval.node)->left = (yyvsp[-1].node);
+    }
+#line 2624 "build/y.tab.c"
+    break;
+
+  case 92: /* jump_statement: T_BREAK ';'  */
+#line 737 "src/parser.y"
+                  {
+        (yyval.node) = create_break_node();
+        SET_LINE((yyval.node));
+    }
+#line 2633 "build/y.tab.c"
+    break;
+
+  case 93: /* jump_statement: T_CONTINUE ';'  */
+#line 741 "src/parser.y"
+                     {
+        (yyval.node) = create_continue_node();
+        SET_LINE((yyval.node));
+    }
+#line 2642 "build/y.tab.c"
+    break;
+
+  case 94: /* throw_statement: T_THROW expression ';'  */
+#line 748 "src/parser.y"
+                             {
+        (yyval.node) = create_throw_node((yyvsp[-1].node));
+        SET_LINE((yyval.node));
+    }
+#line 2651 "build/y.tab.c"
+    break;
+
+  case 95: /* throw_statement: T_THROW ';'  */
+#line 752 "src/parser.y"
+                  {
+        (yyval.node) = create_throw_node(NULL);
+        SET_LINE((yyval.node));
+    }
+#line 2660 "build/y.tab.c"
+    break;
+
+  case 96: /* try_statement: T_TRY compound_statement catch_clause_list  */
+#line 759 "src/parser.y"
+                                                 {
+        (yyval.node) = create_try_node((yyvsp[-1].node), (yyvsp[0].node));
+        SET_LINE((yyval.node));
+    }
+#line 2669 "build/y.tab.c"
+    break;
+
+  case 97: /* catch_clause_list: catch_clause  */
+#line 766 "src/parser.y"
+                   { (yyval.node) = (yyvsp[0].node); }
+#line 2675 "build/y.tab.c"
+    break;
+
+  case 98: /* catch_clause_list: catch_clause_list catch_clause  */
+#line 767 "src/parser.y"
+                                     {
+        (yyval.node) = append_node((yyvsp[-1].node), (yyvsp[0].node));
+    }
+#line 2683 "build/y.tab.c"
+    break;
+
+  case 99: /* catch_clause: T_CATCH '(' expression ')' compound_statement  */
+#line 773 "src/parser.y"
+                                                    {
+        (yyval.node) = create_catch_node((yyvsp[-2].node), (yyvsp[0].node));
+        SET_LINE((yyval.node));
+    }
+#line 2692 "build/y.tab.c"
+    break;
+
+  case 100: /* catch_clause: T_CATCH '(' ')' compound_statement  */
+#line 777 "src/parser.y"
+                                         {
+        (yyval.node) = create_catch_node(NULL, (yyvsp[0].node));
+        SET_LINE((yyval.node));
+    }
+#line 2701 "build/y.tab.c"
+    break;
+
+  case 101: /* switch_statement: T_SWITCH '(' expression ')' '{' switch_clause_list '}'  */
+#line 784 "src/parser.y"
+                                                             {
+        (yyval.node) = create_switch_node((yyvsp[-4].node), (yyvsp[-1].node));
+        SET_LINE((yyval.node));
+    }
+#line 2710 "build/y.tab.c"
+    break;
+
+  case 102: /* switch_clause_list: switch_clause  */
+#line 791 "src/parser.y"
+                    { (yyval.node) = (yyvsp[0].node); }
+#line 2716 "build/y.tab.c"
+    break;
+
+  case 103: /* switch_clause_list: switch_clause_list switch_clause  */
+#line 792 "src/parser.y"
+                                       {
+        (yyval.node) = append_node((yyvsp[-1].node), (yyvsp[0].node));
+    }
+#line 2724 "build/y.tab.c"
+    break;
+
+  case 104: /* switch_clause: T_CASE expression T_COLON statement_list_opt  */
+#line 798 "src/parser.y"
+                                                   {
+        (yyval.node) = create_case_node((yyvsp[-2].node), (yyvsp[0].node));
+        SET_LINE((yyval.node));
+    }
+#line 2733 "build/y.tab.c"
+    break;
+
+  case 105: /* switch_clause: T_DEFAULT T_COLON statement_list_opt  */
+#line 802 "src/parser.y"
+                                           {
+        (yyval.node) = create_case_node(NULL, (yyvsp[0].node));
+        SET_LINE((yyval.node));
+    }
+#line 2742 "build/y.tab.c"
+    break;
+
+  case 106: /* statement_list_opt: %empty  */
+#line 809 "src/parser.y"
+                  { (yyval.node) = NULL; }
+#line 2748 "build/y.tab.c"
+    break;
+
+  case 107: /* statement_list_opt: statement_list  */
+#line 810 "src/parser.y"
+                     { (yyval.node) = (yyvsp[0].node); }
+#line 2754 "build/y.tab.c"
+    break;
+
+  case 108: /* statement_list: statement  */
+#line 814 "src/parser.y"
+                { (yyval.node) = (yyvsp[0].node); }
+#line 2760 "build/y.tab.c"
+    break;
+
+  case 109: /* statement_list: statement_list statement  */
+#line 815 "src/parser.y"
+                               {
+        (yyval.node) = append_node((yyvsp[-1].node), (yyvsp[0].node));
+    }
+#line 2768 "build/y.tab.c"
+    break;
+
+  case 110: /* expression: assignment_expression  */
+#line 822 "src/parser.y"
+                            { (yyval.node) = (yyvsp[0].node); }
+#line 2774 "build/y.tab.c"
+    break;
+
+  case 111: /* assignment_expression: logical_or_expression  */
+#line 826 "src/parser.y"
+                            { /* no assignment, just propagate the expression */
+        (yyval.node) = (yyvsp[0].node);
+    }
+#line 2782 "build/y.tab.c"
+    break;
+
+  case 112: /* assignment_expression: logical_or_expression '=' assignment_expression  */
+#line 830 "src/parser.y"
+                                                      {
+        /* left side is already an ASTNode representing a variable or indexed value */
+        (yyval.node) = create_node(NODE_ASSIGN);
+        SET_LINE((yyval.node));
+        (yyval.node)->left = (yyvsp[-2].node);
+        (yyval.node)->right = (yyvsp[0].node);
+    }
+#line 2794 "build/y.tab.c"
+    break;
+
+  case 113: /* logical_or_expression: logical_and_expression  */
+#line 840 "src/parser.y"
+                             { (yyval.node) = (yyvsp[0].node); }
+#line 2800 "build/y.tab.c"
+    break;
+
+  case 114: /* logical_or_expression: logical_or_expression T_OR logical_and_expression  */
+#line 841 "src/parser.y"
+                                                        {
+        (yyval.node) = create_binary_node(T_OR, (yyvsp[-2].node), (yyvsp[0].node));
+        SET_LINE((yyval.node));
+    }
+#line 2809 "build/y.tab.c"
+    break;
+
+  case 115: /* logical_and_expression: inclusive_or_expression  */
+#line 848 "src/parser.y"
+                              { (yyval.node) = (yyvsp[0].node); }
+#line 2815 "build/y.tab.c"
+    break;
+
+  case 116: /* logical_and_expression: logical_and_expression T_AND inclusive_or_expression  */
+#line 849 "src/parser.y"
+                                                           {
+        (yyval.node) = create_binary_node(T_AND, (yyvsp[-2].node), (yyvsp[0].node));
+        SET_LINE((yyval.node));
+    }
+#line 2824 "build/y.tab.c"
+    break;
+
+  case 117: /* inclusive_or_expression: exclusive_or_expression  */
+#line 856 "src/parser.y"
+                              { (yyval.node) = (yyvsp[0].node); }
+#line 2830 "build/y.tab.c"
+    break;
+
+  case 118: /* inclusive_or_expression: inclusive_or_expression '|' exclusive_or_expression  */
+#line 857 "src/parser.y"
+                                                          {
+        (yyval.node) = create_binary_node('|', (yyvsp[-2].node), (yyvsp[0].node));
+        SET_LINE((yyval.node));
+    }
+#line 2839 "build/y.tab.c"
+    break;
+
+  case 119: /* exclusive_or_expression: and_expression  */
+#line 864 "src/parser.y"
+                     { (yyval.node) = (yyvsp[0].node); }
+#line 2845 "build/y.tab.c"
+    break;
+
+  case 120: /* exclusive_or_expression: exclusive_or_expression '^' and_expression  */
+#line 865 "src/parser.y"
+                                                 {
+        (yyval.node) = create_binary_node('^', (yyvsp[-2].node), (yyvsp[0].node));
+        SET_LINE((yyval.node));
+    }
+#line 2854 "build/y.tab.c"
+    break;
+
+  case 121: /* and_expression: equality_expression  */
+#line 872 "src/parser.y"
+                          { (yyval.node) = (yyvsp[0].node); }
+#line 2860 "build/y.tab.c"
+    break;
+
+  case 122: /* and_expression: and_expression '&' equality_expression  */
+#line 873 "src/parser.y"
+                                             {
+        (yyval.node) = create_binary_node('&', (yyvsp[-2].node), (yyvsp[0].node));
+        SET_LINE((yyval.node));
+    }
+#line 2869 "build/y.tab.c"
+    break;
+
+  case 123: /* equality_expression: relational_expression  */
+#line 880 "src/parser.y"
+                            { (yyval.node) = (yyvsp[0].node); }
+#line 2875 "build/y.tab.c"
+    break;
+
+  case 124: /* equality_expression: equality_expression T_EQ relational_expression  */
+#line 881 "src/parser.y"
+                                                     {
+        (yyval.node) = create_binary_node(T_EQ, (yyvsp[-2].node), (yyvsp[0].node));
+        SET_LINE((yyval.node));
+    }
+#line 2884 "build/y.tab.c"
+    break;
+
+  case 125: /* equality_expression: equality_expression T_NEQ relational_expression  */
+#line 885 "src/parser.y"
+                                                      {
+        (yyval.node) = create_binary_node(T_NEQ, (yyvsp[-2].node), (yyvsp[0].node));
+        SET_LINE((yyval.node));
+    }
+#line 2893 "build/y.tab.c"
+    break;
+
+  case 126: /* relational_expression: shift_expression  */
+#line 892 "src/parser.y"
+                       { (yyval.node) = (yyvsp[0].node); }
+#line 2899 "build/y.tab.c"
+    break;
+
+  case 127: /* relational_expression: relational_expression '<' shift_expression  */
+#line 893 "src/parser.y"
+                                                 {
+        (yyval.node) = create_binary_node('<', (yyvsp[-2].node), (yyvsp[0].node));
+        SET_LINE((yyval.node));
+    }
+#line 2908 "build/y.tab.c"
+    break;
+
+  case 128: /* relational_expression: relational_expression '>' shift_expression  */
+#line 897 "src/parser.y"
+                                                 {
+        (yyval.node) = create_binary_node('>', (yyvsp[-2].node), (yyvsp[0].node));
+        SET_LINE((yyval.node));
+    }
+#line 2917 "build/y.tab.c"
+    break;
+
+  case 129: /* relational_expression: relational_expression T_LE shift_expression  */
+#line 901 "src/parser.y"
+                                                  {
+        (yyval.node) = create_binary_node(T_LE, (yyvsp[-2].node), (yyvsp[0].node));
+        SET_LINE((yyval.node));
+    }
+#line 2926 "build/y.tab.c"
+    break;
+
+  case 130: /* relational_expression: relational_expression T_GE shift_expression  */
+#line 905 "src/parser.y"
+                                                  {
+        (yyval.node) = create_binary_node(T_GE, (yyvsp[-2].node), (yyvsp[0].node));
+        SET_LINE((yyval.node));
+    }
+#line 2935 "build/y.tab.c"
+    break;
+
+  case 131: /* shift_expression: additive_expression  */
+#line 912 "src/parser.y"
+                          { (yyval.node) = (yyvsp[0].node); }
+#line 2941 "build/y.tab.c"
+    break;
+
+  case 132: /* shift_expression: shift_expression T_SHL additive_expression  */
+#line 913 "src/parser.y"
+                                                 {
+        (yyval.node) = create_binary_node(T_SHL, (yyvsp[-2].node), (yyvsp[0].node));
+        SET_LINE((yyval.node));
+    }
+#line 2950 "build/y.tab.c"
+    break;
+
+  case 133: /* shift_expression: shift_expression T_SHR additive_expression  */
+#line 917 "src/parser.y"
+                                                 {
+        (yyval.node) = create_binary_node(T_SHR, (yyvsp[-2].node), (yyvsp[0].node));
+        SET_LINE((yyval.node));
+    }
+#line 2959 "build/y.tab.c"
+    break;
+
+  case 134: /* additive_expression: multiplicative_expression  */
+#line 924 "src/parser.y"
+                                { (yyval.node) = (yyvsp[0].node); }
+#line 2965 "build/y.tab.c"
+    break;
+
+  case 135: /* additive_expression: additive_expression '+' multiplicative_expression  */
+#line 925 "src/parser.y"
+                                                        {
+        (yyval.node) = create_binary_node('+', (yyvsp[-2].node), (yyvsp[0].node));
+        SET_LINE((yyval.node));
+    }
+#line 2974 "build/y.tab.c"
+    break;
+
+  case 136: /* additive_expression: additive_expression '-' multiplicative_expression  */
+#line 929 "src/parser.y"
+                                                        {
+        (yyval.node) = create_binary_node('-', (yyvsp[-2].node), (yyvsp[0].node));
+        SET_LINE((yyval.node));
+    }
+#line 2983 "build/y.tab.c"
+    break;
+
+  case 137: /* multiplicative_expression: unary_expression  */
+#line 936 "src/parser.y"
+                       { (yyval.node) = (yyvsp[0].node); }
+#line 2989 "build/y.tab.c"
+    break;
+
+  case 138: /* multiplicative_expression: multiplicative_expression '*' unary_expression  */
+#line 937 "src/parser.y"
+                                                     {
+        (yyval.node) = create_binary_node('*', (yyvsp[-2].node), (yyvsp[0].node));
+        SET_LINE((yyval.node));
+    }
+#line 2998 "build/y.tab.c"
+    break;
+
+  case 139: /* multiplicative_expression: multiplicative_expression '/' unary_expression  */
+#line 941 "src/parser.y"
+                                                     {
+        (yyval.node) = create_binary_node('/', (yyvsp[-2].node), (yyvsp[0].node));
+        SET_LINE((yyval.node));
+    }
+#line 3007 "build/y.tab.c"
+    break;
+
+  case 140: /* multiplicative_expression: multiplicative_expression '%' unary_expression  */
+#line 945 "src/parser.y"
+                                                     {
+        (yyval.node) = create_binary_node('%', (yyvsp[-2].node), (yyvsp[0].node));
+        SET_LINE((yyval.node));
+    }
+#line 3016 "build/y.tab.c"
+    break;
+
+  case 141: /* postfix_expression: primary_expression  */
+#line 952 "src/parser.y"
+                         { (yyval.node) = (yyvsp[0].node); }
+#line 3022 "build/y.tab.c"
+    break;
+
+  case 142: /* postfix_expression: postfix_expression '[' expression ']'  */
+#line 953 "src/parser.y"
+                                            {
+        (yyval.node) = create_index_node((yyvsp[-3].node), (yyvsp[-1].node));
+        SET_LINE((yyval.node));
+    }
+#line 3031 "build/y.tab.c"
+    break;
+
+  case 143: /* postfix_expression: postfix_expression '.' T_IDENT  */
+#line 957 "src/parser.y"
+                                     {
+        ASTNode *node = create_node(NODE_MEMBER_ACCESS);
+        SET_LINE(node);
+        node->left = (yyvsp[-2].node);
+        node->str_val = strdup((yyvsp[0].str));
+        node->int_val = 0; /* dot */
+        (yyval.node) = node;
+    }
+#line 3044 "build/y.tab.c"
+    break;
+
+  case 144: /* postfix_expression: postfix_expression T_ARROW T_IDENT  */
+#line 965 "src/parser.y"
+                                         {
+        ASTNode *node = create_node(NODE_MEMBER_ACCESS);
+        SET_LINE(node);
+        node->left = (yyvsp[-2].node);
+        node->str_val = strdup((yyvsp[0].str));
+        node->int_val = 1; /* arrow */
+        (yyval.node) = node;
+    }
+#line 3057 "build/y.tab.c"
+    break;
+
+  case 145: /* postfix_expression: postfix_expression '(' argument_expression_list ')'  */
+#line 973 "src/parser.y"
+                                                          {
+        ASTNode *func = create_node(NODE_FUNC_CALL);
+        SET_LINE(func);
+        func->left = (yyvsp[-3].node); /* Callee */
+        func->right = (yyvsp[-1].node); /* Arguments */
+        if ((yyvsp[-3].node) && (yyvsp[-3].node)->type == NODE_VAR) {
+            func->str_val = strdup((yyvsp[-3].node)->str_val);
+        }
+        (yyval.node) = func;
+    }
+#line 3072 "build/y.tab.c"
+    break;
+
+  case 146: /* postfix_expression: postfix_expression '(' ')'  */
+#line 983 "src/parser.y"
+                                 {
+        ASTNode *func = create_node(NODE_FUNC_CALL);
+        SET_LINE(func);
+        func->left = (yyvsp[-2].node); /* Callee */
+        func->right = NULL;
+        if ((yyvsp[-2].node) && (yyvsp[-2].node)->type == NODE_VAR) {
+            func->str_val = strdup((yyvsp[-2].node)->str_val);
+        }
+        (yyval.node) = func;
+    }
+#line 3087 "build/y.tab.c"
+    break;
+
+  case 147: /* postfix_expression: postfix_expression T_INC  */
+#line 993 "src/parser.y"
+                               {
+        (yyval.node) = create_unary_node(T_INC, (yyvsp[-1].node));
+        (yyval.node)->type = NODE_POST_INC;
+        SET_LINE((yyval.node));
+    }
+#line 3097 "build/y.tab.c"
+    break;
+
+  case 148: /* postfix_expression: postfix_expression T_DEC  */
+#line 998 "src/parser.y"
+                               {
+        (yyval.node) = create_unary_node(T_DEC, (yyvsp[-1].node));
+        (yyval.node)->type = NODE_POST_DEC;
+        SET_LINE((yyval.node));
+    }
+#line 3107 "build/y.tab.c"
+    break;
+
+  case 149: /* unary_expression: postfix_expression  */
+#line 1006 "src/parser.y"
+                         { (yyval.node) = (yyvsp[0].node); }
+#line 3113 "build/y.tab.c"
+    break;
+
+  case 150: /* unary_expression: '-' unary_expression  */
+#line 1007 "src/parser.y"
+                           {
+        (yyval.node) = create_unary_node('-', (yyvsp[0].node));
+        SET_LINE((yyval.node));
+    }
+#line 3122 "build/y.tab.c"
+    break;
+
+  case 151: /* unary_expression: '!' unary_expression  */
+#line 1011 "src/parser.y"
+                           {
+        (yyval.node) = create_unary_node('!', (yyvsp[0].node));
+        SET_LINE((yyval.node));
+    }
+#line 3131 "build/y.tab.c"
+    break;
+
+  case 152: /* unary_expression: T_TILDE unary_expression  */
+#line 1015 "src/parser.y"
+                               {
+        (yyval.node) = create_unary_node('~', (yyvsp[0].node));
+        SET_LINE((yyval.node));
+    }
+#line 3140 "build/y.tab.c"
+    break;
+
+  case 153: /* unary_expression: '&' unary_expression  */
+#line 1019 "src/parser.y"
+                           {
+        (yyval.node) = create_unary_node('&', (yyvsp[0].node));
+        SET_LINE((yyval.node));
+    }
+#line 3149 "build/y.tab.c"
+    break;
+
+  case 154: /* unary_expression: '*' unary_expression  */
+#line 1023 "src/parser.y"
+                           {
+        (yyval.node) = create_unary_node('*', (yyvsp[0].node));
+        SET_LINE((yyval.node));
+    }
+#line 3158 "build/y.tab.c"
+    break;
+
+  case 155: /* unary_expression: T_INC unary_expression  */
+#line 1027 "src/parser.y"
+                             {
+        (yyval.node) = create_unary_node(T_INC, (yyvsp[0].node));
+        (yyval.node)->type = NODE_PRE_INC;
+        SET_LINE((yyval.node));
+    }
+#line 3168 "build/y.tab.c"
+    break;
+
+  case 156: /* unary_expression: T_DEC unary_expression  */
+#line 1032 "src/parser.y"
+                             {
+        (yyval.node) = create_unary_node(T_DEC, (yyvsp[0].node));
+        (yyval.node)->type = NODE_PRE_DEC;
+        SET_LINE((yyval.node));
+    }
+#line 3178 "build/y.tab.c"
+    break;
+
+  case 157: /* unary_expression: T_NEW T_IDENT '(' argument_expression_list ')'  */
+#line 1037 "src/parser.y"
+                                                     {
+        (yyval.node) = create_node(NODE_NEW);
+        SET_LINE((yyval.node));
+        (yyval.node)->str_val = strdup((yyvsp[-3].str));
+        (yyval.node)->params = (yyvsp[-1].node);
+    }
+#line 3189 "build/y.tab.c"
+    break;
+
+  case 158: /* unary_expression: T_NEW T_TYPE_NAME '(' argument_expression_list ')'  */
+#line 1043 "src/parser.y"
+                                                         {
+        (yyval.node) = create_node(NODE_NEW);
+        SET_LINE((yyval.node));
+        (yyval.node)->str_val = strdup((yyvsp[-3].str));
+        (yyval.node)->params = (yyvsp[-1].node);
+    }
+#line 3200 "build/y.tab.c"
+    break;
+
+  case 159: /* unary_expression: T_NEW T_IDENT '(' ')'  */
+#line 1049 "src/parser.y"
+                            {
+        (yyval.node) = create_node(NODE_NEW);
+        SET_LINE((yyval.node));
+        (yyval.node)->str_val = strdup((yyvsp[-2].str));
+        (yyval.node)->params = NULL;
+    }
+#line 3211 "build/y.tab.c"
+    break;
+
+  case 160: /* unary_expression: T_NEW T_TYPE_NAME '(' ')'  */
+#line 1055 "src/parser.y"
+                                {
+        (yyval.node) = create_node(NODE_NEW);
+        SET_LINE((yyval.node));
+        (yyval.node)->str_val = strdup((yyvsp[-2].str));
+        (yyval.node)->params = NULL;
+    }
+#line 3222 "build/y.tab.c"
+    break;
+
+  case 161: /* unary_expression: T_NEW T_IDENT  */
+#line 1061 "src/parser.y"
+                    {
+        /* Support for 'new int' etc. without parens */
+        (yyval.node) = create_node(NODE_NEW);
+        SET_LINE((yyval.node));
+        (yyval.node)->str_val = strdup((yyvsp[0].str));
+        (yyval.node)->params = NULL;
+    }
+#line 3234 "build/y.tab.c"
+    break;
+
+  case 162: /* unary_expression: T_NEW T_TYPE_NAME  */
+#line 1068 "src/parser.y"
+                        {
+        /* Support for 'new Type' where Type lexes as type name */
+        (yyval.node) = create_node(NODE_NEW);
+        SET_LINE((yyval.node));
+        (yyval.node)->str_val = strdup((yyvsp[0].str));
+        (yyval.node)->params = NULL;
+    }
+#line 3246 "build/y.tab.c"
+    break;
+
+  case 163: /* primary_expression: T_IDENT  */
+#line 1078 "src/parser.y"
+              {
+        (yyval.node) = create_var_node((yyvsp[0].str));
+        SET_LINE((yyval.node));
+    }
+#line 3255 "build/y.tab.c"
+    break;
+
+  case 164: /* primary_expression: T_NUMBER  */
+#line 1082 "src/parser.y"
+               {
+        (yyval.node) = create_int_node((yyvsp[0].intval));
+        SET_LINE((yyval.node));
+    }
+#line 3264 "build/y.tab.c"
+    break;
+
+  case 165: /* primary_expression: T_CHAR_LIT  */
+#line 1086 "src/parser.y"
+                 {
+        (yyval.node) = create_char_node((yyvsp[0].intval));
+        SET_LINE((yyval.node));
+    }
+#line 3273 "build/y.tab.c"
+    break;
+
+  case 166: /* primary_expression: T_STRING_LIT  */
+#line 1090 "src/parser.y"
+                   {
+        (yyval.node) = create_str_node((yyvsp[0].str));
+        SET_LINE((yyval.node));
+    }
+#line 3282 "build/y.tab.c"
+    break;
+
+  case 167: /* primary_expression: '(' expression ')'  */
+#line 1094 "src/parser.y"
+                         {
+        (yyval.node) = (yyvsp[-1].node);
+    }
+#line 3290 "build/y.tab.c"
+    break;
+
+  case 168: /* argument_expression_list: expression  */
+#line 1100 "src/parser.y"
+                 { (yyval.node) = (yyvsp[0].node); }
+#line 3296 "build/y.tab.c"
+    break;
+
+  case 169: /* argument_expression_list: argument_expression_list ',' expression  */
+#line 1101 "src/parser.y"
+                                              {
+        (yyval.node) = append_node((yyvsp[-2].node), (yyvsp[0].node));
+    }
+#line 3304 "build/y.tab.c"
+    break;
+
+
+#line 3308 "build/y.tab.c"
+
+      default: break;
+    }
+  /* User semantic actions sometimes alter yychar, and that requires
+     that yytoken be updated with the new translation.  We take the
+     approach of translating immediately before every use of yytoken.
+     One alternative is translating here after every semantic action,
+     but that translation would be missed if the semantic action invokes
+     YYABORT, YYACCEPT, or YYERROR immediately after altering yychar or
+     if it invokes YYBACKUP.  In the case of YYABORT or YYACCEPT, an
+     incorrect destructor might then be invoked immediately.  In the
+     case of YYERROR or YYBACKUP, subsequent parser actions might lead
+     to an incorrect destructor call or verbose syntax error message
+     before the lookahead is translated.  */
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
+
+  YYPOPSTACK (yylen);
+  yylen = 0;
+
+  *++yyvsp = yyval;
+
+  /* Now 'shift' the result of the reduction.  Determine what state
+     that goes to, based on the state we popped back to and the rule
+     number reduced by.  */
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
+
+  goto yynewstate;
+
+
+/*--------------------------------------.
+| yyerrlab -- here on detecting error.  |
+`--------------------------------------*/
+yyerrlab:
+  /* Make sure we have latest lookahead translation.  See comments at
+     user semantic actions for why this is necessary.  */
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
+  /* If not already recovering from an error, report this error.  */
+  if (!yyerrstatus)
+    {
+      ++yynerrs;
+      yyerror (YY_("syntax error"));
+    }
+
+  if (yyerrstatus == 3)
+    {
+      /* If just tried and failed to reuse lookahead token after an
+         error, discard it.  */
+
+      if (yychar <= YYEOF)
+        {
+          /* Return failure if at end of input.  */
+          if (yychar == YYEOF)
+            YYABORT;
+        }
+      else
+        {
+          yydestruct ("Error: discarding",
+                      yytoken, &yylval);
+          yychar = YYEMPTY;
+        }
+    }
+
+  /* Else will try to reuse lookahead token after shifting the error
+     token.  */
+  goto yyerrlab1;
+
+
+/*---------------------------------------------------.
+| yyerrorlab -- error raised explicitly by YYERROR.  |
+`---------------------------------------------------*/
+yyerrorlab:
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
+
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYERROR.  */
+  YYPOPSTACK (yylen);
+  yylen = 0;
+  YY_STACK_PRINT (yyss, yyssp);
+  yystate = *yyssp;
+  goto yyerrlab1;
+
+
+/*-------------------------------------------------------------.
+| yyerrlab1 -- common code for both syntax error and YYERROR.  |
+`-------------------------------------------------------------*/
+yyerrlab1:
+  yyerrstatus = 3;      /* Each real token shifted decrements this.  */
+
+  /* Pop stack until we find a state that shifts the error token.  */
+  for (;;)
+    {
+      yyn = yypact[yystate];
+      if (!yypact_value_is_default (yyn))
+        {
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
+            {
+              yyn = yytable[yyn];
+              if (0 < yyn)
+                break;
+            }
+        }
+
+      /* Pop the current state because it cannot handle the error token.  */
+      if (yyssp == yyss)
+        YYABORT;
+
+
+      yydestruct ("Error: popping",
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp);
+      YYPOPSTACK (1);
+      yystate = *yyssp;
+      YY_STACK_PRINT (yyss, yyssp);
+    }
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+
+  /* Shift the error token.  */
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
+
+  yystate = yyn;
+  goto yynewstate;
+
+
+/*-------------------------------------.
+| yyacceptlab -- YYACCEPT comes here.  |
+`-------------------------------------*/
+yyacceptlab:
+  yyresult = 0;
+  goto yyreturnlab;
+
+
+/*-----------------------------------.
+| yyabortlab -- YYABORT comes here.  |
+`-----------------------------------*/
+yyabortlab:
+  yyresult = 1;
+  goto yyreturnlab;
+
+
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
+yyexhaustedlab:
+  yyerror (YY_("memory exhausted"));
+  yyresult = 2;
+  goto yyreturnlab;
+
+
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
+  if (yychar != YYEMPTY)
+    {
+      /* Make sure we have latest lookahead translation.  See comments at
+         user semantic actions for why this is necessary.  */
+      yytoken = YYTRANSLATE (yychar);
+      yydestruct ("Cleanup: discarding lookahead",
+                  yytoken, &yylval);
+    }
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYABORT or YYACCEPT.  */
+  YYPOPSTACK (yylen);
+  YY_STACK_PRINT (yyss, yyssp);
+  while (yyssp != yyss)
+    {
+      yydestruct ("Cleanup: popping",
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp);
+      YYPOPSTACK (1);
+    }
+#ifndef yyoverflow
+  if (yyss != yyssa)
+    YYSTACK_FREE (yyss);
+#endif
+
+  return yyresult;
+}
+
+#line 1106 "src/parser.y"
+
+
+int parse_errors = 0;
+
+static int is_likely_false_positive_hint(const char *tok, const char *keyword) {
+    if (!tok || !keyword) return 0;
+    
+    int tok_len = strlen(tok);
+    int kw_len = strlen(keyword);
+    
+    /* 1-3 character identifiers matching to keywords of different length
+     * are likely class/method names, not typos */
+    if (tok_len <= 3 && kw_len != tok_len) {
+        return 1;
+    }
+    
+    /* Identifiers up to 5 characters that are 1-2 chars different from keywords
+     * are likely legitimate names, not typos */
+    if (tok_len <= 5) {
+        int len_diff = (tok_len > kw_len) ? (tok_len - kw_len) : (kw_len - tok_len);
+        if (len_diff <= 2) {
+            /* This might be a false positive - a real typo would typically affect
+             * the middle characters, not just length difference */
+            return 1;
+        }
+    }
+    
+    /* Single character tokens are rarely typos */
+    if (tok_len == 1) {
+        return 1;
+    }
+    
+    return 0;
+}
+
+void yyerror(const char *s) {
+    fprintf(stderr, "Parser Error: %s at line %d, column %d (token: %s)\n", s, line_num, col_num, yytext);
+
+    /* First priority: check if missing semicolon */
+    if (token_can_start_statement(yytext)) {
+        fprintf(stderr, "Hint: it looks like you may have forgotten a semicolon before '%s'.\n", yytext);
+    }
+    /* Second priority: check for keyword similarity, but filter out false positives */
+    else if (is_identifier_text(yytext)) {
+        int dist = 999;
+        const char *kw = closest_keyword(yytext, &dist);
+        if (kw && dist > 0 && dist <= 2) {
+            /* Filter out false positives:
+             * - Short identifiers (1-3 chars) matching longer keywords
+             * - Single character identifiers (likely class/method names)
+             * - Identifiers that look like they might be in an OOP context
+             */
+            if (!is_likely_false_positive_hint(yytext, kw)) {
+                fprintf(stderr, "Hint: '%s' looks similar to keyword '%s'.\n", yytext, kw);
+            }
+        }
+    }
+
+    parse_errors++;
+}
+
+int main(int argc, char **argv) {
+    int arg_idx = 1;
+    int want_metrics = 0;
+    OptLevel opt_level = OPT_O2;
+    while (arg_idx < argc) {
+        if (strcmp(argv[arg_idx], "--debug") == 0) {
+            arg_idx++;
+            printf("Debug mode enabled\n");
+            continue;
+        }
+        if (strcmp(argv[arg_idx], "--metrics") == 0) {
+            arg_idx++;
+            want_metrics = 1;
+            continue;
+        }
+        if (strcmp(argv[arg_idx], "-mzicond") == 0) {
+            arg_idx++;
+            riscv_ext_zicond = 1;
+            continue;
+        }
+        if (strcmp(argv[arg_idx], "-mzba") == 0) {
+            arg_idx++;
+            riscv_ext_zba = 1;
+            continue;
+        }
+        if (strncmp(argv[arg_idx], "-march=", 7) == 0) {
+            if (!riscv_set_march(argv[arg_idx] + 7)) {
+                fprintf(stderr, "Unknown architecture: %s (use rv64gc or rv64gcv, optionally followed by _zba, _zicond)\n", argv[arg_idx] + 7);
+                return 1;
+            }
+            arg_idx++;
+            continue;
+        }
+        if (strcmp(argv[arg_idx], "-floop-unroll-and-jam") == 0 ||
+            strcmp(argv[arg_idx], "-fno-loop-unroll-and-jam") == 0) {
+            loop_unroll_and_jam = argv[arg_idx][2] != 'n';
+            arg_idx++;
+            continue;
+        }
+        if (strcmp(argv[arg_idx], "-fno-prefetch-loop-arrays") == 0) {
+            prefetch_loop_arrays = 0;
+            arg_idx++;
+            continue;
+        }
+        if (strncmp(argv[arg_idx], "-fprefetch-loop-arrays", 22) == 0) {
+            const char *rest = argv[arg_idx] + 22;
+            char *end = (char *)rest;
+            long dist = PREFETCH_DEFAULT_DISTANCE;
+            if (*rest == '=')
+                dist = strtol(rest + 1, &end, 10);
+            if (*end || end == rest + 1 || dist <= 0 || dist > 65536) {
+                fprintf(stderr, "Unknown option: %s (use -fprefetch-loop-arrays[=bytes], 1 to 65536)\n", argv[arg_idx]);
+                return 1;
+            }
+            prefetch_loop_arrays = (int)dist;
+            arg_idx++;
+            continue;
+        }
+        if (strncmp(argv[arg_idx], "-mtune=", 7) == 0) {
+            if (!riscv_set_tune(argv[arg_idx] + 7)) {
+                fprintf(stderr, "Unknown tuning target: %s (use generic, sifive-7-series or rocket)\n", argv[arg_idx] + 7);
+                return 1;
+            }
+            arg_idx++;
+            continue;
+        }
+        if (strncmp(argv[arg_idx], "-fprofile-generate", 18) == 0 ||
+            strncmp(argv[arg_idx], "-fprofile-use", 13) == 0) {
+            int gen = argv[arg_idx][10] == 'g';
+            const char *rest = argv[arg_idx] + (gen ? 18 : 13);
+            if (*rest == '=' && rest[1])
+                profile_file = rest + 1;
+            else if (*rest) {
+                fprintf(stderr, "Unknown option: %s (use -fprofile-generate[=file] or -fprofile-use[=file])\n", argv[arg_idx]);
+                return 1;
+            }
+            profile_mode = gen ? PROFILE_GENERATE : PROFILE_USE;
+            arg_idx++;
+            continue;
+        }
+        if (strncmp(argv[arg_idx], "-O", 2) == 0) {
+            const char *lvl = argv[arg_idx] + 2;
+            if (strcmp(lvl, "0") == 0)
+                opt_level = OPT_O0;
+            else if (strcmp(lvl, "1") == 0)
+                opt_level = OPT_O1;
+            else if (strcmp(lvl, "2") == 0)
+                opt_level = OPT_O2;
+            else {
+                fprintf(stderr, "Unknown optimization level: %s (use -O0, -O1, or -O2)\n", argv[arg_idx]);
+                return 1;
+            }
+            arg_idx++;
+            continue;
+        }
+        break;
+    }
+
+    if (arg_idx < argc) {
+        FILE *file = fopen(argv[arg_idx], "r");
+        if (!file) {
+            perror("Error opening file");
+            return 1;
+        }
+        yyin = file;
+    }
+
+    printf("Parsing...\n");
+    parser_clear_typedef_names();
+    int parse_result = yyparse();
+
+    if(parse_result == 0 && parse_errors == 0 && root != NULL){
+        init_symbol_table();
+        semantic_analyze(root);
+        if (semantic_errors == 0)
+        {
+          print_symbol_table();
+          printf("Semantic analysis successful.\n");
+
+          if (opt_level == OPT_O2)
+              restructure_loop_nests(root);
+
+          IRProgram *ir = ir_generate(root);
+          if (ir) {
+            profile_prepare_program(ir);
+            CompilerMetrics metrics = {0};
+            if (want_metrics)
+                compiler_metrics_init(&metrics);
+
+            ir_print_program(ir);
+            print_vtables();
+            ir_export_to_file(ir, "ir.txt");
+
+            if (want_metrics)
+                metrics.pre_opt_ir_instructions = compiler_metrics_count_ir_instructions(ir);
+
+            if (opt_level == OPT_O0)
+                printf("Skipping IR optimization (-O0).\n");
+            else
+                printf("Optimizing IR...\n");
+            optimize_program(ir, opt_level, want_metrics ? &metrics : NULL);
+            if (opt_level == OPT_O0)
+                printf("IR unchanged (optimization level O0). Optimized IR printed below:\n");
+            else
+                printf("Optimization complete. Optimized IR printed below:\n");
+            ir_print_program(ir);
+            ir_export_to_file(ir, "ir_opt.txt");
+
+            if (want_metrics) {
+                metrics.post_opt_ir_instructions = compiler_metrics_count_ir_instructions(ir);
+                metrics.post_opt_basic_blocks = compiler_metrics_count_basic_blocks(ir);
+            }
+
+            /* Instruction Scheduling */
+            printf("Running instruction scheduling...\n");
+            IRFunc *sf = ir->funcs;
+            while (sf) {
+                ir_schedule_function(sf);
+                char sched_json[128];
+                snprintf(sched_json, sizeof(sched_json), "%s_sched.json", sf->name);
+                ir_schedule_export_json(sf, sched_json);
+                sf = sf->next;
+            }
+            printf("Instruction scheduling complete.\n");
+
+            /* Register allocation (Chaitin's graph coloring) */
+            printf("Running register allocation...\n");
+            RegAllocResult **ra_results = reg_alloc_program(ir);
+            printf("Register allocation complete.\n");
+
+            if (want_metrics)
+                compiler_metrics_set_spill_total(&metrics, ra_results);
+
+            riscv_generate(ir, ra_results, "output.s");
+
+            if (want_metrics) {
+                compiler_metrics_read_assembly_lines(&metrics, "output.s");
+                compiler_metrics_print_and_save(&metrics, "compiler_metrics.txt");
+            }
+
+            reg_alloc_free_all(ra_results);
+            ir_free_program(ir);
+          }
+        }
+        else{
+         printf("Semantic analysis failed with %d errors.\n", semantic_errors);
+        }
+    }
+
+    if (parse_result == 0) {
+        printf("Parsing Done with %d errors\n", parse_errors);
+        printf("AST Structure:\n");
+        if (root) {
+            print_ast(root, 0);
+            export_ast_to_dot(root, "ast.dot");
+            export_ast_to_json(root, "ast.json");
+        }
+        parser_clear_typedef_names();
+        return 0;
+    } else {
+        printf("Parsing Failed\n");
+        parser_clear_typedef_names();
+        return 1;
+     }
+}
@@ -0,0 +1,132 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison interface for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+#ifndef YY_YY_BUILD_Y_TAB_H_INCLUDED
+# define YY_YY_BUILD_Y_TAB_H_INCLUDED
+/* Debug traces.  */
+#ifndef YYDEBUG
+# define YYDEBUG 1
+#endif
+#if YYDEBUG
+extern int yydebug;
+#endif
+
+/* Token kinds.  */
+#ifndef YYTOKENTYPE
+# define YYTOKENTYPE
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    T_INT = 258,                   /* T_INT  */
+    T_VOID = 259,                  /* T_VOID  */
+    T_CHAR = 260,                  /* T_CHAR  */
+    T_STRUCT = 261,                /* T_STRUCT  */
+    T_VIRTUAL = 262,               /* T_VIRTUAL  */
+    T_CLASS = 263,                 /* T_CLASS  */
+    T_PUBLIC = 264,                /* T_PUBLIC  */
+    T_PRIVATE = 265,               /* T_PRIVATE  */
+    T_COLON = 266,                 /* T_COLON  */
+    T_IF = 267,                    /* T_IF  */
+    T_ELSE = 268,                  /* T_ELSE  */
+    T_WHILE = 269,                 /* T_WHILE  */
+    T_FOR = 270,                   /* T_FOR  */
+    T_RETURN = 271,                /* T_RETURN  */
+    T_SWITCH = 272,                /* T_SWITCH  */
+    T_CASE = 273,                  /* T_CASE  */
+    T_DEFAULT = 274,               /* T_DEFAULT  */
+    T_BREAK = 275,                 /* T_BREAK  */
+    T_CONTINUE = 276,              /* T_CONTINUE  */
+    T_PRINTF = 277,                /* T_PRINTF  */
+    T_SCANF = 278,                 /* T_SCANF  */
+    T_CONST = 279,                 /* T_CONST  */
+    T_TRY = 280,                   /* T_TRY  */
+    T_CATCH = 281,                 /* T_CATCH  */
+    T_THROW = 282,                 /* T_THROW  */
+    T_NEW = 283,                   /* T_NEW  */
+    T_DELETE = 284,                /* T_DELETE  */
+    T_TYPEDEF = 285,               /* T_TYPEDEF  */
+    T_IDENT = 286,                 /* T_IDENT  */
+    T_TYPE_NAME = 287,             /* T_TYPE_NAME  */
+    T_STRING_LIT = 288,            /* T_STRING_LIT  */
+    T_NUMBER = 289,                /* T_NUMBER  */
+    T_CHAR_LIT = 290,              /* T_CHAR_LIT  */
+    T_ARROW = 291,                 /* T_ARROW  */
+    T_TILDE = 292,                 /* T_TILDE  */
+    T_EQ = 293,                    /* T_EQ  */
+    T_NEQ = 294,                   /* T_NEQ  */
+    T_LE = 295,                    /* T_LE  */
+    T_GE = 296,                    /* T_GE  */
+    T_AND = 297,                   /* T_AND  */
+    T_OR = 298,                    /* T_OR  */
+    T_INC = 299,                   /* T_INC  */
+    T_DEC = 300,                   /* T_DEC  */
+    T_SHL = 301,                   /* T_SHL  */
+    T_SHR = 302,                   /* T_SHR  */
+    LOWER_THAN_ELSE = 303          /* LOWER_THAN_ELSE  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
+#endif
+
+/* Value type.  */
+#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
+union YYSTYPE
+{
+#line 138 "src/parser.y"
+
+    int intval;
+    char *str;
+    struct ASTNode *node;
+
+#line 118 "build/y.tab.h"
+
+};
+typedef union YYSTYPE YYSTYPE;
+# define YYSTYPE_IS_TRIVIAL 1
+# define YYSTYPE_IS_DECLARED 1
+#endif
+
+
+extern YYSTYPE yylval;
+
+
+int yyparse (void);
+
+
+#endif /* !YY_YY_BUILD_Y_TAB_H_INCLUDED  */
@@ -26,7 +26,9 @@ fi
 
 if [ $# -lt 1 ]; then
     echo "Usage: $0 [options] <source.c> [input-string]" >&2
-    echo "Options: -O1, -O2, --metrics, --cleanup" >&2
+    echo "Options: -O1, -O2, -march=rv64gc[v][_zba][_zicond], -mzicond, -mzba, -mtune=<core>," >&2
+    echo "         -fprefetch-loop-arrays[=bytes], -fprofile-generate[=file]," >&2
+    echo "         -fprofile-use[=file], --metrics, --cleanup" >&2
     exit 1
 fi
 
@@ -42,6 +44,12 @@ fi
 #         were concatenated into COMPILER_FLAGS and passed to $PARSER and
 #         $RISCVC, causing "unrecognised option" errors.
 COMPILER_FLAGS=()
+PARSER_FLAGS=()
+ASM_FLAGS=()
+QEMU_FLAGS=()
+RUNTIME_SRCS=("src/exception_runtime.s" "src/mem_runtime.s")
+MARCH_BASE="rv64gc"
+MARCH_EXTS=""
 SHOW_METRICS=false
 CLEANUP=false
 
@@ -50,12 +58,57 @@ while [[ $# -gt 0 && "$1" == -* ]]; do
         SHOW_METRICS=true
     elif [[ "$1" == "--cleanup" ]]; then
         CLEANUP=true
+    elif [[ "$1" == "-mzicond" ]]; then
+        # ISA extensions: the parser emits their instructions, gcc and QEMU
+        # must accept them (see the -march assembled below).
+        PARSER_FLAGS+=("$1")
+        [[ "${MARCH_EXTS}_" == *_zicond_* ]] || MARCH_EXTS+="_zicond"
+    elif [[ "$1" == "-mzba" ]]; then
+        PARSER_FLAGS+=("$1")
+        [[ "${MARCH_EXTS}_" == *_zba_* ]] || MARCH_EXTS+="_zba"
+    elif [[ "$1" == -march=* ]]; then
+        PARSER_FLAGS+=("$1")
+        [[ "$1" == -march=rv64gcv* ]] && MARCH_BASE="rv64gcv"
+        for ext in _zba _zicond; do
+            if [[ "${1#-march=}_" == *"${ext}_"* && "${MARCH_EXTS}_" != *"${ext}_"* ]]; then
+                MARCH_EXTS+="$ext"
+            fi
+        done
+    elif [[ "$1" == -floop-unroll-and-jam || "$1" == -fno-loop-unroll-and-jam ]]; then
+        # Parser pass switch, not gcc's option of the same name.
+        PARSER_FLAGS+=("$1")
+    elif [[ "$1" == -fprefetch-loop-arrays* ]]; then
+        # The hints are Zicbop instructions: the assembler must know them,
+        # cores without the extension run them as nops.
+        PARSER_FLAGS+=("$1")
+        [[ "${MARCH_EXTS}_" == *_zicbop_* ]] || MARCH_EXTS+="_zicbop"
+    elif [[ "$1" == -fno-prefetch-loop-arrays ]]; then
+        PARSER_FLAGS+=("$1")
+    elif [[ "$1" == -mtune=* ]]; then
+        # Cost model only: the assembler has nothing to tune.
+        PARSER_FLAGS+=("$1")
+    elif [[ "$1" == -fprofile-generate* ]]; then
+        # Our own block counters, not gcc's gcov: link the runtime that
+        # writes them out at exit instead of passing the flag to gcc.
+        PARSER_FLAGS+=("$1")
+        RUNTIME_SRCS+=("src/profile_runtime.s")
+    elif [[ "$1" == -fprofile-use* ]]; then
+        PARSER_FLAGS+=("$1")
     else
         COMPILER_FLAGS+=("$1")
     fi
     shift
 done
 
+if [ "$MARCH_BASE" != "rv64gc" ] || [ -n "$MARCH_EXTS" ]; then
+    ASM_FLAGS+=("-march=${MARCH_BASE}${MARCH_EXTS}")
+    QEMU_FLAGS+=("-cpu" "max")
+fi
+# Fill and copy loops call the _rvv routines in vector builds.
+if [ "$MARCH_BASE" = "rv64gcv" ]; then
+    RUNTIME_SRCS+=("src/mem_runtime_rvv.s")
+fi
+
 SRC_FILE="${1:-}"
 INPUT="${2:-}"
 
@@ -68,7 +121,7 @@ fi
 echo "--> Running Parser with flags: ${COMPILER_FLAGS[*]:-<none>}"
 # FIX 2: Use array expansion "${COMPILER_FLAGS[@]}" so flags with spaces
 #        are passed as separate arguments, not a single glob-split string.
-"$PARSER" "${COMPILER_FLAGS[@]}" "$SRC_FILE"
+"$PARSER" "${COMPILER_FLAGS[@]}" "${PARSER_FLAGS[@]}" "$SRC_FILE"
 
 # FIX 3: Verify output.s was actually produced by the parser before linking.
 #        Without this check, a stale output.s from a prior run gets linked
@@ -88,16 +141,16 @@ cleanup_all() { rm -f "$TMP_EXE" "$TIME_OUTPUT"; }
 trap cleanup_all EXIT INT TERM
 
 # FIX 5: Pass only the real compiler flags (not --metrics) to the compiler.
-$RISCVC "${COMPILER_FLAGS[@]}" -static -o "$TMP_EXE" output.s src/exception_runtime.s
+$RISCVC "${COMPILER_FLAGS[@]}" "${ASM_FLAGS[@]}" -static -o "$TMP_EXE" output.s "${RUNTIME_SRCS[@]}"
 
 # --- EXECUTION WITH REAL BENCHMARK METRICS ---
 echo "--> Executing in QEMU..."
 
 QEMU_EXIT=0
 if [ -n "$INPUT" ]; then
-    printf '%s' "$INPUT" | /usr/bin/time -v -o "$TIME_OUTPUT" "$QEMU" "$TMP_EXE" || QEMU_EXIT=$?
+    printf '%s' "$INPUT" | /usr/bin/time -v -o "$TIME_OUTPUT" "$QEMU" "${QEMU_FLAGS[@]}" "$TMP_EXE" || QEMU_EXIT=$?
 else
-    /usr/bin/time -v -o "$TIME_OUTPUT" "$QEMU" "$TMP_EXE" || QEMU_EXIT=$?
+    /usr/bin/time -v -o "$TIME_OUTPUT" "$QEMU" "${QEMU_FLAGS[@]}" "$TMP_EXE" || QEMU_EXIT=$?
 fi
 
 # --- METRICS EXTRACTION ---
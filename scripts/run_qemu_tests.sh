@@ -129,19 +129,231 @@ run_ir_no_backedge_test() {
   fi
 }
 
+run_compile_time_test() {
+  local src="$1"
+  local name="$2"
+  local seconds="$3"
+  local max_lines="$4"
+
+  printf "Running %s... " "$name"
+
+  if ! timeout "$seconds" "$PARSER" -O2 "$src" >/dev/null 2>&1; then
+    echo "FAIL (parser error or over ${seconds}s)"
+    FAIL=$((FAIL + 1))
+    return
+  fi
+
+  local lines
+  lines=$(wc -l < output.s)
+  if [ "$lines" -gt "$max_lines" ]; then
+    echo "FAIL ($lines lines of assembly, limit $max_lines)"
+    FAIL=$((FAIL + 1))
+    return
+  fi
+  echo "PASS"
+  PASS=$((PASS + 1))
+}
+
+# Every extended regex after the flags must match some line of ir_opt.txt.
+run_ir_contains_test() {
+  local src="$1"
+  local name="$2"
+  local flags="$3"
+  shift 3
+
+  printf "Running %s... " "$name"
+
+  # shellcheck disable=SC2086
+  if ! "$PARSER" $flags "$src" >/dev/null 2>&1; then
+    echo "FAIL (parser error)"
+    FAIL=$((FAIL + 1))
+    return
+  fi
+
+  local pattern
+  for pattern in "$@"; do
+    if ! grep -Eq -- "$pattern" ir_opt.txt; then
+      echo "FAIL (no line matches '$pattern')"
+      FAIL=$((FAIL + 1))
+      return
+    fi
+  done
+  echo "PASS"
+  PASS=$((PASS + 1))
+}
+
+# -fprofile-use must find and accept the profile (a missing or stale one
+# only warns), and the counts must reach the layout: in function $func of
+# ir_opt.txt, the first line containing $first precedes the first line
+# containing $second (fixed strings).
+run_profile_use_test() {
+  local src="$1"
+  local profile="$2"
+  local name="$3"
+  local func="$4"
+  local first="$5"
+  local second="$6"
+
+  printf "Running %s... " "$name"
+
+  local warnings
+  if ! warnings=$("$PARSER" -O2 "-fprofile-use=$profile" "$src" 2>&1 >/dev/null); then
+    echo "FAIL (parser error)"
+    FAIL=$((FAIL + 1))
+    return
+  fi
+  if printf "%s" "$warnings" | grep -q "compiling without it"; then
+    echo "FAIL (profile not applied: $warnings)"
+    FAIL=$((FAIL + 1))
+    return
+  fi
+
+  if ! awk -v func_hdr="function $func:" -v first="$first" -v second="$second" '
+      $0 == func_hdr { inside = 1; next }
+      /^function / { inside = 0 }
+      inside && !a && index($0, first) { a = NR }
+      inside && !b && index($0, second) { b = NR }
+      END { exit !(a && b && a < b) }
+    ' ir_opt.txt; then
+    echo "FAIL (\"$first\" does not precede \"$second\" in $func)"
+    FAIL=$((FAIL + 1))
+    return
+  fi
+  echo "PASS"
+  PASS=$((PASS + 1))
+}
+
 # Regression test for tail-recursive factorial bug.
 # The program should compute 7! = 5040.
 run_test "test/complex/factorial_tail_recursive.c" "7\n" "Enter a positive integer: Tail-Recursive Factorial is 5040" "factorial_tail_recursive"
 
+# Accumulator introduction: non-tail linear recursion (n * fact(n - 1)) becomes a loop.
+run_test "test/complex/factorial_recursive.c" "7\n" "Enter a positive integer: Recursive Factorial is 5040" "factorial_recursive_accumulator" "-O2"
+
+# Deep recursion (100000 levels) only fits the stack once it runs in O(1) frames.
+run_test "test/optimizations/accumulator_recursion.c" "" "sum=705082704 pow=243 zz=17" "accumulator_recursion" "-O2"
+
 # Full-unroll regression: multi-block loop body with exact trip count.
 run_test "test/optimizations/loop_unroll_multiblock.c" "" "sum=24" "full_unroll_multiblock" "-O2"
 
 # Full-unroll regression: trip count above historical capped behavior.
 run_test "test/optimizations/loop_unroll_large.c" "" "total=160" "full_unroll_large_trip" "-O2"
 
+# Runtime trip-count unrolling: unrolled main loop plus remainder loop.
+run_test "test/optimizations/loop_unroll_runtime.c" "" "u=666 e=42 d=86 f=650 acc=893 m=1" "runtime_unroll" "-O2"
+
+# Loop rotation: short-circuit headers, continue/break and zero-trip loops.
+run_test "test/optimizations/loop_rotation.c" "" "z=5 e=0 s=150 b=1014 t=35 n=0" "loop_rotation" "-O2"
+
+# IV strength reduction + test replacement on loops with internal branches,
+# and a global bound the loop changes through a pointer.
+run_test "test/optimizations/iv_strength_reduction.c" "" "last=20 s=672 a=30,7,-5 sm=19 b=360,14 rc=14 fg=5,9" "iv_strength_reduction" "-O2"
+
+# Loop interchange, distribution and tiling of array nests; illegal and zero-trip nests untouched.
+run_test "test/optimizations/loop_interchange.c" "" "s=2016 c=56700 d=1209 t=396 ij=0,4" "loop_interchange" "-O2"
+
+# Larger matrix benchmark: i-j-k multiply over VLAs sized after scanf.
+run_test "test/complex/matrix_benchmark.c" "48\n" "n=48 trace=95 check=-4755" "matrix_benchmark" "-O2"
+
+# Loop unswitching on invariant flags and exits; a flag written through its address stays in the loop.
+run_test "test/optimizations/loop_unswitch.c" "" "255 -255 0 1900 150 100 50 33" "loop_unswitch" "-O2"
+
+# Jump threading: repeated tests, flags tested after a join, a small state machine.
+run_test "test/optimizations/jump_threading.c" "" "11 100 13 -5 600 2" "jump_threading" "-O2"
+
+# If-conversion: min/max/abs/clamp/swap become selects; division stays guarded.
+# Arms in stack slots past the 12-bit offset range, with and without Zicond.
+run_test "test/optimizations/if_conversion.c" "" "3 3 -4 12 0 10 7 308 206 3 0 8 117" "if_conversion" "-O2"
+run_test "test/optimizations/if_conversion_large_frame.c" "100" "7385" "if_conversion_large_frame" "-O2"
+run_test "test/optimizations/if_conversion_large_frame.c" "100" "7385" "if_conversion_large_frame_zicond" "-O2 -mzicond"
+
+# Switch lowering: jump table for dense cases, compare tree for sparse, both for mixed.
+run_test "test/optimizations/switch_lowering.c" "" "50039 209 0 7 0 843230003 -1 8 -1" "switch_lowering" "-O2"
+
+# Constant divisors: magic-number and shift lowering checked against the hardware divide.
+run_test "test/optimizations/const_division.c" "" "9152 0 -7020" "const_division" "-O2"
+
+# Constant multipliers: shift/add chains checked against mul, base ISA and Zba with a slow multiplier.
+run_test "test/optimizations/const_multiply.c" "" "0 3896 2020" "const_multiply" "-O2"
+run_test "test/optimizations/const_multiply.c" "" "0 3896 2020" "const_multiply_zba" "-O2 -mzba -mtune=rocket"
+
+# Bitwise and shift operators: precedence, hashing, a bitset sieve and Q16 fixed point.
+run_test "test/features/bitwise_ops.c" "" "24 0 7 1031 -6 -4 57 12345 0 6935186 6 8 168 1414 12528 -416375" "bitwise_ops_O0" "-O0"
+run_test "test/features/bitwise_ops.c" "" "24 0 7 1031 -6 -4 57 12345 0 6935186 6 8 168 1414 12528 -416375" "bitwise_ops" "-O2"
+
+# Reassociation: constants combined across chains, cancelling terms, canonical order for CSE, invariant sums hoisted.
+run_test "test/optimizations/reassociation.c" "" "204083 -37337 159403423 855 0 15320 749 144" "reassociation" "-O2"
+
+# Scalar replacement of local structs: iterator, pair and bounding-box structs in loops, char fields and escaping structs stay in memory; a whole-struct copy read through a pointer (also at -O0).
+run_test "test/optimizations/sroa.c" "" "1683 333441 181 63 15 30" "sroa_O0" "-O0"
+run_test "test/optimizations/sroa.c" "" "1683 333441 181 63 15 30" "sroa_O1" "-O1"
+run_test "test/optimizations/sroa.c" "" "1683 333441 181 63 15 30" "sroa" "-O2"
+
+# Address-taken scalars promoted to registers: scanf targets, out-parameters of helpers, a local pointer; an escaping address stays in memory.
+run_test "test/optimizations/address_promotion.c" "6 3 -7 12 0 25 4" "174 -7 25 300 5120" "address_promotion_O1" "-O1"
+run_test "test/optimizations/address_promotion.c" "6 3 -7 12 0 25 4" "174 -7 25 300 5120" "address_promotion" "-O2"
+
+# Profile-guided optimization: block counters written at exit, then read back (cold loops, short trip counts, spill weights).
+# The never-entered loop in rarely() must be laid out after the return.
+run_test "test/optimizations/pgo.c" "200" "36831 0 19900" "pgo_generate" "-O2 -fprofile-generate=build/pgo_test.profile"
+run_test "test/optimizations/pgo.c" "200" "36831 0 19900" "pgo_use" "-O2 -fprofile-use=build/pgo_test.profile"
+run_profile_use_test "test/optimizations/pgo.c" "build/pgo_test.profile" "pgo_use_applied" "rarely" "return" " * "
+
+# Block placement: rare branches, a throw site and a catch handler moved out of line; statically and with a profile.
+# With the profile, classify()'s common return falls through and the rare ones follow.
+run_test "test/optimizations/block_layout.c" "300" "4086 1 100 2" "block_layout" "-O2"
+run_test "test/optimizations/block_layout.c" "300" "4086 1 100 2" "block_layout_pgo_generate" "-O2 -fprofile-generate=build/block_layout.profile"
+run_test "test/optimizations/block_layout.c" "300" "4086 1 100 2" "block_layout_pgo_use" "-O2 -fprofile-use=build/block_layout.profile"
+run_profile_use_test "test/optimizations/block_layout.c" "build/block_layout.profile" "block_layout_pgo_use_applied" "classify" "return t" "return -1"
+
+# Loop vectorization: element-wise loops, offsets, sum and dot reductions, a 2D row; aliasing and carried dependences stay scalar.
+run_test "test/optimizations/vectorize.c" "61" "-6437 442182 151 1000 8 177" "vectorize_scalar" "-O2"
+run_test "test/optimizations/vectorize.c" "61" "-6437 442182 151 1000 8 177" "vectorize_rvv" "-O2 -march=rv64gcv"
+run_test "test/complex/vector_benchmark.c" "1000" "n=1000 check=-64435010 sum=-39271" "vector_benchmark_rvv" "-O2 -march=rv64gcv"
+
+# Loop idioms: fill and copy loops become runtime calls (8-byte stores, RVV); overlapping or possibly aliased copies stay loops.
+run_test "test/optimizations/loop_idioms.c" "37 5" "51233 37 5 18802" "loop_idioms" "-O2"
+run_test "test/optimizations/loop_idioms.c" "37 5" "51233 37 5 18802" "loop_idioms_rvv" "-O2 -march=rv64gcv"
+
+# Loop versioning: pointer-parameter loops run a checked no-alias copy (hoisted loads, memcpy, vector kernel) or the original when ranges overlap.
+run_test "test/optimizations/loop_versioning.c" "50" "662509120 1469233261 -590057533 -573593151 1405621795 1405621795 78 26" "loop_versioning" "-O2"
+run_test "test/optimizations/loop_versioning.c" "50" "662509120 1469233261 -590057533 -573593151 1405621795 1405621795 78 26" "loop_versioning_rvv" "-O2 -march=rv64gcv"
+
+# Scalar evolution: down-counting loops reversed into fills, copies and sums; updates through temps; derived indices.
+run_test "test/optimizations/scalar_evolution.c" "40 8" "2380 -1 -1630016035 48 11044 511 5 10" "scalar_evolution" "-O2"
+run_test "test/optimizations/scalar_evolution.c" "40 8" "2380 -1 -1630016035 48 11044 511 5 10" "scalar_evolution_rvv" "-O2 -march=rv64gcv"
+
+# Dependence analysis: nests interchanged and distributed past non-trivial directions; disjoint halves copied, vectorized, reversed; carried dependences kept.
+run_test "test/optimizations/dependence_analysis.c" "5" "1212354 24136 550512 1602700" "dependence_analysis" "-O2"
+run_test "test/optimizations/dependence_analysis.c" "5" "1212354 24136 550512 1602700" "dependence_analysis_rvv" "-O2 -march=rv64gcv"
+
+# Unroll and jam: outer rows of a multiply, a reduction and a stencil jammed into the inner loop; remainders, zero trips and a (<, >) nest.
+run_test "test/optimizations/unroll_and_jam.c" "3" "c=128 s=21706 d=2597 e=210584 z=3,13,3" "unroll_and_jam" "-O2"
+run_test "test/complex/matrix_multiply_bench.c" "64" "n=64 trace=910 check=-6561" "matrix_multiply_bench" "-O2"
+run_test "test/complex/matrix_multiply_bench.c" "64" "n=64 trace=910 check=-6561" "matrix_multiply_bench_nojam" "-O2 -fno-loop-unroll-and-jam"
+
+# Software prefetching: Zicbop hints ahead of pointer, global-array, downward, column and conditional streams; hints past the array ends.
+run_test "test/optimizations/prefetch.c" "300" "-105 1116069513 -213200 -6 138 1230" "prefetch" "-O2 -fprefetch-loop-arrays"
+run_test "test/optimizations/prefetch.c" "300" "-105 1116069513 -213200 -6 138 1230" "prefetch_short_distance" "-O2 -fprefetch-loop-arrays=100"
+# The hints themselves: read and write pointer streams, the global array both ways and the
+# downward walk over it (a negative prefetch offset), at 256 bytes and at the shorter distance.
+run_ir_contains_test "test/optimizations/prefetch.c" "prefetch_ir" "-O2 -fprefetch-loop-arrays" \
+  'prefetch\.r __ivp[0-9]+\[256\]' 'prefetch\.w __ivp[0-9]+\[256\]' \
+  'prefetch\.r g\$3\[' 'prefetch\.w g\$3\[' '^  __pf[0-9]+ := [^ ]+ \+ -64$'
+run_ir_contains_test "test/optimizations/prefetch.c" "prefetch_short_distance_ir" "-O2 -fprefetch-loop-arrays=100" \
+  'prefetch\.r __ivp[0-9]+\[112\]' 'prefetch\.w __ivp[0-9]+\[112\]' \
+  'prefetch\.r g\$3\[' 'prefetch\.w g\$3\[' '^  __pf[0-9]+ := [^ ]+ \+ -28$'
+
+# Scalar promotion: globals and struct-pointer fields kept in temps across loops, stored back on every exit (break, nested loops).
+run_test "test/optimizations/scalar_promotion.c" "100" "495 63 3 3 100 1688 1365 595 3 4 6" "scalar_promotion" "-O2"
+
 # IR-structure assertions: fully unrolled cases should have no backward branches.
 run_ir_no_backedge_test "test/optimizations/loop_unroll_multiblock.c" "ir_no_backedge_loop_unroll_multiblock"
 run_ir_no_backedge_test "test/optimizations/loop_unroll_large.c" "ir_no_backedge_loop_unroll_large"
 
+# Compile-time assertions: full unrolling of fixed-size nests stays bounded.
+run_test "test/optimizations/unroll_nest_compile_time.c" "" "150528 5735 529536" "unroll_nest" "-O2"
+run_compile_time_test "test/optimizations/unroll_nest_compile_time.c" "compile_time_unroll_nest" 10 6000
+
 printf "\nResults: Passed=%d  Failed=%d\n" "$PASS" "$FAIL"
 [ "$FAIL" -eq 0 ]
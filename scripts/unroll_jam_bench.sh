@@ -0,0 +1,58 @@
+#!/bin/bash
+# Unroll-and-jam on and off for a loop-nest benchmark: output and retired
+# instructions (QEMU's insn plugin), both at -O2.
+#
+# Usage: scripts/unroll_jam_bench.sh [source.c] [input]
+# QEMU_PLUGIN_DIR points at QEMU's contrib/plugins build (libinsn.so).
+set -euo pipefail
+
+ROOT_DIR=$(cd "$(dirname "$0")/.." && pwd)
+cd "$ROOT_DIR"
+
+SRC="${1:-test/complex/matrix_multiply_bench.c}"
+INPUT="${2:-200}"
+
+PARSER=./build/parser
+if [ ! -x "$PARSER" ]; then
+  make parser >/dev/null
+fi
+
+RISCVC=${RISCV64_GCC:-$(command -v riscv64-linux-gnu-gcc || command -v riscv64-unknown-elf-gcc || true)}
+QEMU=${QEMU_RISCV:-$(command -v qemu-riscv64 || command -v qemu-riscv64-static || true)}
+if [ -z "$RISCVC" ] || [ -z "$QEMU" ]; then
+  echo "Error: riscv64 cross-compiler and qemu-riscv64 are required." >&2
+  exit 1
+fi
+
+PLUGIN=""
+for dir in "${QEMU_PLUGIN_DIR:-}" /usr/lib/qemu/plugins /usr/local/lib/qemu/plugins /usr/libexec/qemu/plugins; do
+  if [ -n "$dir" ] && [ -f "$dir/libinsn.so" ]; then
+    PLUGIN="$dir/libinsn.so"
+    break
+  fi
+done
+if [ -z "$PLUGIN" ]; then
+  echo "Error: libinsn.so not found; set QEMU_PLUGIN_DIR." >&2
+  exit 1
+fi
+
+TMP_DIR=$(mktemp -d /tmp/unroll_jam_bench_XXXXXX)
+trap 'rm -rf "$TMP_DIR"' EXIT
+
+run_variant() {
+  local name="$1"
+  shift
+  "$PARSER" "$@" "$SRC" >/dev/null
+  $RISCVC -static -o "$TMP_DIR/$name.elf" output.s src/exception_runtime.s src/mem_runtime.s
+  local out insns
+  out=$(printf '%s' "$INPUT" | "$QEMU" -plugin "$PLUGIN" -d plugin -D "$TMP_DIR/$name.log" "$TMP_DIR/$name.elf")
+  insns=$(grep -o 'insns: [0-9]*' "$TMP_DIR/$name.log" | awk '{ s += $2 } END { print s }')
+  printf "%-8s %12s insns   %s\n" "$name" "$insns" "$out"
+  echo "$insns" > "$TMP_DIR/$name.count"
+}
+
+run_variant nojam -O2 -fno-loop-unroll-and-jam
+run_variant jam -O2
+
+awk -v s="$(cat "$TMP_DIR/nojam.count")" -v v="$(cat "$TMP_DIR/jam.count")" \
+  'BEGIN { if (v > 0) printf "speedup (instructions): %.2fx\n", s / v }'
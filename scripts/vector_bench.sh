@@ -0,0 +1,61 @@
+#!/bin/bash
+# Scalar vs. vector build of a benchmark: output and retired instructions
+# (QEMU's insn plugin) for -O2 and -O2 -march=rv64gcv.
+#
+# Usage: scripts/vector_bench.sh [source.c] [input]
+# QEMU_PLUGIN_DIR points at QEMU's contrib/plugins build (libinsn.so).
+set -euo pipefail
+
+ROOT_DIR=$(cd "$(dirname "$0")/.." && pwd)
+cd "$ROOT_DIR"
+
+SRC="${1:-test/complex/vector_benchmark.c}"
+INPUT="${2:-4096}"
+
+PARSER=./build/parser
+if [ ! -x "$PARSER" ]; then
+  make parser >/dev/null
+fi
+
+RISCVC=${RISCV64_GCC:-$(command -v riscv64-linux-gnu-gcc || command -v riscv64-unknown-elf-gcc || true)}
+QEMU=${QEMU_RISCV:-$(command -v qemu-riscv64 || command -v qemu-riscv64-static || true)}
+if [ -z "$RISCVC" ] || [ -z "$QEMU" ]; then
+  echo "Error: riscv64 cross-compiler and qemu-riscv64 are required." >&2
+  exit 1
+fi
+
+PLUGIN=""
+for dir in "${QEMU_PLUGIN_DIR:-}" /usr/lib/qemu/plugins /usr/local/lib/qemu/plugins /usr/libexec/qemu/plugins; do
+  if [ -n "$dir" ] && [ -f "$dir/libinsn.so" ]; then
+    PLUGIN="$dir/libinsn.so"
+    break
+  fi
+done
+if [ -z "$PLUGIN" ]; then
+  echo "Error: libinsn.so not found; set QEMU_PLUGIN_DIR." >&2
+  exit 1
+fi
+
+TMP_DIR=$(mktemp -d /tmp/vector_bench_XXXXXX)
+trap 'rm -rf "$TMP_DIR"' EXIT
+
+run_variant() {
+  local name="$1" march="$2"
+  shift 2
+  local runtime=(src/exception_runtime.s src/mem_runtime.s)
+  [ "$march" = rv64gcv ] && runtime+=(src/mem_runtime_rvv.s)
+  "$PARSER" "$@" "$SRC" >/dev/null
+  $RISCVC -march="$march" -static -o "$TMP_DIR/$name.elf" output.s "${runtime[@]}"
+  local out insns
+  out=$(printf '%s' "$INPUT" | "$QEMU" -cpu max -plugin "$PLUGIN" -d plugin -D "$TMP_DIR/$name.log" "$TMP_DIR/$name.elf")
+  insns=$(grep -o 'insns: [0-9]*' "$TMP_DIR/$name.log" | awk '{ s += $2 } END { print s }')
+  printf "%-8s %12s insns   %s\n" "$name" "$insns" "$out"
+  echo "$insns" > "$TMP_DIR/$name.count"
+}
+
+run_variant scalar rv64gc -O2
+run_variant vector rv64gcv -O2 -march=rv64gcv
+cat vectorize_report.txt
+
+awk -v s="$(cat "$TMP_DIR/scalar.count")" -v v="$(cat "$TMP_DIR/vector.count")" \
+  'BEGIN { if (v > 0) printf "speedup (instructions): %.2fx\n", s / v }'
@@ -63,6 +63,9 @@ const char* get_op_string(int op) {
         case '>': return ">";
         case '=': return "=";
         case '&' :return "&";
+        case '|': return "|";
+        case '^': return "^";
+        case '~': return "~";
         case '!': return "!";
 
         case T_EQ:  return "==";
@@ -71,6 +74,8 @@ const char* get_op_string(int op) {
         case T_GE:  return ">=";
         case T_AND: return "&&";
         case T_OR:  return "||";
+        case T_SHL: return "<<";
+        case T_SHR: return ">>";
         case T_INC: return "++";
         case T_DEC: return "--";
 
@@ -0,0 +1,158 @@
+/**
+ * dependence.c - Array dependence testing: per-dimension ZIV, strong SIV,
+ * GCD and Banerjee tests on affine subscripts, combined into direction
+ * and distance vectors (see dependence.h).
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "dependence.h"
+
+static long long gcd_ll(long long a, long long b) {
+    if (a < 0) a = -a;
+    if (b < 0) b = -b;
+    while (b) {
+        long long t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/* Range of a * i - b * i' over lo <= i, i' <= hi with the sign of i' - i
+ * in direction d (one of DEP_LT, DEP_EQ, DEP_GT, or DEP_ALL). The range of
+ * a linear function over that polygon is reached at its corners. Returns
+ * 0 when no (i, i') pair has that direction, -1 when the range is not
+ * bounded, 1 otherwise. */
+static int term_bounds(long long a, long long b, const DepLoop *l, int d,
+                       long long *min, long long *max) {
+    if (!l->known) {
+        if (a == 0 && b == 0) {
+            *min = *max = 0;
+            return 1;
+        }
+        if (d == DEP_EQ && a == b) {
+            *min = *max = 0;
+            return 1;
+        }
+        return -1;
+    }
+    long long lo = l->lo, hi = l->hi;
+    long long pts[4][2];
+    int n = 0;
+    if (hi < lo) return 0;
+    switch (d) {
+        case DEP_EQ:
+            pts[n][0] = lo; pts[n++][1] = lo;
+            pts[n][0] = hi; pts[n++][1] = hi;
+            break;
+        case DEP_LT:
+            if (hi == lo) return 0;
+            pts[n][0] = lo;     pts[n++][1] = lo + 1;
+            pts[n][0] = lo;     pts[n++][1] = hi;
+            pts[n][0] = hi - 1; pts[n++][1] = hi;
+            break;
+        case DEP_GT:
+            if (hi == lo) return 0;
+            pts[n][0] = lo + 1; pts[n++][1] = lo;
+            pts[n][0] = hi;     pts[n++][1] = lo;
+            pts[n][0] = hi;     pts[n++][1] = hi - 1;
+            break;
+        default:
+            pts[n][0] = lo; pts[n++][1] = lo;
+            pts[n][0] = lo; pts[n++][1] = hi;
+            pts[n][0] = hi; pts[n++][1] = lo;
+            pts[n][0] = hi; pts[n++][1] = hi;
+            break;
+    }
+    for (int k = 0; k < n; k++) {
+        long long v = a * pts[k][0] - b * pts[k][1];
+        if (k == 0 || v < *min) *min = v;
+        if (k == 0 || v > *max) *max = v;
+    }
+    return 1;
+}
+
+/* Could sum_k a_k i_k - b_k i'_k equal c with loop `only` restricted to
+ * direction d and every other loop to its current set? A set other than
+ * DEP_EQ is bounded as DEP_ALL. */
+static int banerjee_admits(const DepSubscript *x, const DepSubscript *y, long long c,
+                           const DepLoop *loops, int nloops, const int *dir, int only, int d) {
+    long long lo = 0, hi = 0;
+    for (int k = 0; k < nloops; k++) {
+        long long a = x->coef[k], b = y->coef[k], kmin, kmax;
+        int kd = (k == only) ? d : (dir[k] == DEP_EQ ? DEP_EQ : DEP_ALL);
+        int r = term_bounds(a, b, &loops[k], kd, &kmin, &kmax);
+        if (r == 0) return 0;
+        if (r < 0) return 1;
+        lo += kmin;
+        hi += kmax;
+    }
+    return c >= lo && c <= hi;
+}
+
+/* One dimension; narrows dir and dist. Returns 0 when the subscripts
+ * can never be equal. */
+static int test_dimension(const DepSubscript *x, const DepSubscript *y, const DepLoop *loops,
+                          int nloops, Dependence *dep) {
+    if (!x->affine || !y->affine || x->sym != y->sym) return 1;
+    long long c = y->off - x->off;
+    long long g = 0;
+    int used = 0, last = -1;
+    for (int k = 0; k < nloops; k++) {
+        if (x->coef[k] == 0 && y->coef[k] == 0) continue;
+        g = gcd_ll(g, gcd_ll(x->coef[k], y->coef[k]));
+        used++;
+        last = k;
+    }
+
+    /* ZIV: no counter in either subscript. */
+    if (used == 0) return c == 0;
+
+    /* GCD: a_k i_k - b_k i'_k only takes multiples of g. */
+    if (c % g != 0) return 0;
+
+    /* Strong SIV: a i - a i' = c, so i' - i = -c / a. */
+    if (used == 1 && x->coef[last] == y->coef[last]) {
+        long long d = -c / x->coef[last];
+        const DepLoop *l = &loops[last];
+        if (l->known && (d > l->hi - l->lo || -d > l->hi - l->lo)) return 0;
+        if (dep->has_dist[last] && dep->dist[last] != d) return 0;
+        dep->has_dist[last] = 1;
+        dep->dist[last] = d;
+        dep->dir[last] &= d > 0 ? DEP_LT : d < 0 ? DEP_GT : DEP_EQ;
+        return dep->dir[last] != 0;
+    }
+
+    /* Banerjee: drop each direction the bounds rule out. */
+    for (int k = 0; k < nloops; k++) {
+        if (x->coef[k] == 0 && y->coef[k] == 0) continue;
+        static const int dirs[3] = { DEP_LT, DEP_EQ, DEP_GT };
+        for (int q = 0; q < 3; q++)
+            if ((dep->dir[k] & dirs[q]) &&
+                !banerjee_admits(x, y, c, loops, nloops, dep->dir, k, dirs[q]))
+                dep->dir[k] &= ~dirs[q];
+        if (dep->dir[k] == 0) return 0;
+    }
+    return 1;
+}
+
+int dep_test(const DepSubscript *x, const DepSubscript *y, int dims,
+             const DepLoop *loops, int nloops, Dependence *dep) {
+    memset(dep, 0, sizeof(*dep));
+    for (int k = 0; k < nloops; k++) dep->dir[k] = DEP_ALL;
+    for (int d = 0; d < dims; d++)
+        if (!test_dimension(&x[d], &y[d], loops, nloops, dep)) {
+            dep->independent = 1;
+            return 0;
+        }
+    for (int k = 0; k < nloops; k++)
+        if (dep->dir[k] == DEP_EQ && !dep->has_dist[k]) dep->has_dist[k] = 1;
+    return 1;
+}
+
+int dep_crosses(const Dependence *dep, int a, int b) {
+    if (dep->independent) return 0;
+    return ((dep->dir[a] & DEP_LT) && (dep->dir[b] & DEP_GT)) ||
+           ((dep->dir[a] & DEP_GT) && (dep->dir[b] & DEP_LT));
+}
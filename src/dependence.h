@@ -0,0 +1,60 @@
+/**
+ * dependence.h - Array dependence testing
+ * Whether two references to an array can touch the same element in
+ * iterations I and I' of a loop nest, and if so in which directions and
+ * at which distances I' - I. Subscripts are affine in the loops' counters,
+ *
+ *     coef[0] * i0 + coef[1] * i1 + ... + sym + off
+ *
+ * with sym an opaque loop-invariant term the caller matches by identity
+ * (a Symbol in loop_nest.c, an IR name in ir_opt.c). Each dimension is
+ * tested on its own (ZIV, strong SIV, then GCD and Banerjee bounds per
+ * direction) and the results intersected, so loop_nest.c, which still
+ * sees the dimensions get_index_info() linearizes, gets exact answers for
+ * a[i][j] against a[i - 1][j + 1]; the IR passes test the linearized
+ * index as one dimension, its row term folded into sym.
+ */
+
+#ifndef DEPENDENCE_H
+#define DEPENDENCE_H
+
+#define DEP_MAX_LOOPS 4
+
+/* Direction sets: bit per sign of I' - I in one loop. */
+#define DEP_LT  1       /* I' > I: the second reference runs later */
+#define DEP_EQ  2
+#define DEP_GT  4       /* I' < I */
+#define DEP_ALL (DEP_LT | DEP_EQ | DEP_GT)
+
+typedef struct {
+    long long coef[DEP_MAX_LOOPS];
+    const void *sym;    /* NULL if none */
+    long long off;
+    int affine;         /* 0: nothing known about this subscript */
+} DepSubscript;
+
+/* Counter range of one loop, in iterations of step 1 (inclusive). */
+typedef struct {
+    long long lo, hi;
+    int known;
+} DepLoop;
+
+typedef struct {
+    int independent;
+    int dir[DEP_MAX_LOOPS];         /* direction set per loop */
+    int has_dist[DEP_MAX_LOOPS];
+    long long dist[DEP_MAX_LOOPS];  /* I' - I, when has_dist */
+} Dependence;
+
+/* Test reference x (iteration I) against y (iteration I'), both with
+ * `dims` subscripts over the `nloops` loops. Returns 1 when the two may
+ * touch the same element, filling dep; 0 when they never do. */
+int dep_test(const DepSubscript *x, const DepSubscript *y, int dims,
+             const DepLoop *loops, int nloops, Dependence *dep);
+
+/* Could some dependence of dep, taken in its source-to-sink order, run
+ * backwards in loop a and forwards in loop b? Such a pair forbids
+ * interchanging a and b, and tiling them. */
+int dep_crosses(const Dependence *dep, int a, int b);
+
+#endif /* DEPENDENCE_H */
@@ -100,6 +100,20 @@ IRInstr* ir_make_unop(char *dst, IROperand src, int op, int line) {
     return i;
 }
 
+IRInstr* ir_make_select(char *dst, IROperand cond_left, IROperand cond_right, IRRelop relop,
+                        IROperand if_true, IROperand if_false, int line) {
+    IRInstr *i = calloc(1, sizeof(IRInstr));
+    i->kind = IR_SELECT;
+    i->line = line;
+    i->result = dst ? strdup(dst) : NULL;
+    i->if_left = ir_op_copy(&cond_left);
+    i->if_right = ir_op_copy(&cond_right);
+    i->relop = relop;
+    i->left = ir_op_copy(&if_true);
+    i->right = ir_op_copy(&if_false);
+    return i;
+}
+
 IRInstr* ir_make_param(IROperand op, int line) {
     IRInstr *i = calloc(1, sizeof(IRInstr));
     i->kind = IR_PARAM;
@@ -182,6 +196,25 @@ IRInstr* ir_make_if(IROperand left, IROperand right, IRRelop relop, char *label,
     return i;
 }
 
+IRInstr* ir_make_switch(IROperand discr, int count, int *vals, char **labels,
+                        char *default_label, int line) {
+    IRInstr *i = calloc(1, sizeof(IRInstr));
+    i->kind = IR_SWITCH;
+    i->line = line;
+    i->src = ir_op_copy(&discr);
+    i->label = default_label ? strdup(default_label) : NULL;
+    i->case_count = count;
+    if (count > 0) {
+        i->case_vals = malloc(sizeof(int) * count);
+        i->case_labels = malloc(sizeof(char *) * count);
+        for (int k = 0; k < count; k++) {
+            i->case_vals[k] = vals[k];
+            i->case_labels[k] = strdup(labels[k]);
+        }
+    }
+    return i;
+}
+
 IRInstr* ir_make_load(char *dst, IROperand base, IROperand index, int scale, int line) {
     IRInstr *i = calloc(1, sizeof(IRInstr));
     i->kind = IR_LOAD;
@@ -204,6 +237,17 @@ IRInstr* ir_make_store(IROperand base, IROperand index, int scale, IROperand val
     return i;
 }
 
+IRInstr* ir_make_prefetch(IROperand base, IROperand index, int scale, int write, int line) {
+    IRInstr *i = calloc(1, sizeof(IRInstr));
+    i->kind = IR_PREFETCH;
+    i->line = line;
+    i->base = ir_op_copy(&base);
+    i->index = ir_op_copy(&index);
+    i->scale = scale;
+    i->prefetch_write = write;
+    return i;
+}
+
 IRInstr* ir_make_alloca(char *dst, IROperand size, int line) {
     IRInstr *i = calloc(1, sizeof(IRInstr));
     i->kind = IR_ALLOCA;
@@ -308,13 +352,18 @@ static void print_operand(IROperand *op) {
         printf("?");
 }
 
-static const char* binop_str(int op) {
+const char* ir_binop_str(int op) {
     switch (op) {
         case '+': return "+";
         case '-': return "-";
         case '*': return "*";
         case '/': return "/";
         case '%': return "%";
+        case '&': return "&";
+        case '|': return "|";
+        case '^': return "^";
+        case T_SHL: return "<<";
+        case T_SHR: return ">>";
         case '<': return "<";
         case '>': return ">";
         case T_EQ: return "==";
@@ -351,7 +400,7 @@ void ir_print_instr(IRInstr *instr) {
         case IR_BINOP:
             printf("  %s := ", instr->result);
             print_operand(&instr->left);
-            printf(" %s ", binop_str(instr->binop));
+            printf(" %s ", ir_binop_str(instr->binop));
             print_operand(&instr->right);
             printf("\n");
             break;
@@ -400,6 +449,14 @@ void ir_print_instr(IRInstr *instr) {
             print_operand(&instr->if_right);
             printf(" goto %s\n", instr->label);
             break;
+        case IR_SWITCH:
+            printf("  switch ");
+            print_operand(&instr->src);
+            printf(" [");
+            for (int k = 0; k < instr->case_count; k++)
+                printf("%s%d: %s", k ? ", " : "", instr->case_vals[k], instr->case_labels[k]);
+            printf("] default %s\n", instr->label);
+            break;
         case IR_LOAD:
             printf("  %s = ", instr->result ? instr->result : "?");
             if (instr->index.is_const && instr->index.const_val == 0) {
@@ -443,6 +500,17 @@ void ir_print_instr(IRInstr *instr) {
             print_operand(&instr->src);
             printf("\n");
             break;
+        case IR_SELECT:
+            printf("  %s := ", instr->result);
+            print_operand(&instr->if_left);
+            printf(" %s ", relop_str(instr->relop));
+            print_operand(&instr->if_right);
+            printf(" ? ");
+            print_operand(&instr->left);
+            printf(" : ");
+            print_operand(&instr->right);
+            printf("\n");
+            break;
         case IR_PHI: {
             printf("  %s := phi(", instr->result ? instr->result : "?");
             for (int i = 0; i < instr->phi_arity; i++) {
@@ -453,6 +521,16 @@ void ir_print_instr(IRInstr *instr) {
             printf(")\n");
             break;
         }
+        case IR_PROFILE_COUNTER:
+            printf("  profile_counter %d\n", instr->prof_block);
+            break;
+        case IR_PREFETCH:
+            printf("  prefetch.%c ", instr->prefetch_write ? 'w' : 'r');
+            print_operand(&instr->base);
+            printf("[");
+            print_operand(&instr->index);
+            printf("]\n");
+            break;
     }
 }
 
@@ -476,7 +554,7 @@ int ir_snprint_instr(char *buf, size_t size, IRInstr *instr) {
         case IR_BINOP:
             n += snprintf(buf + n, size - n, "  %s := ", instr->result);
             n += snprint_operand(buf + n, size - n, &instr->left);
-            n += snprintf(buf + n, size - n, " %s ", binop_str(instr->binop));
+            n += snprintf(buf + n, size - n, " %s ", ir_binop_str(instr->binop));
             n += snprint_operand(buf + n, size - n, &instr->right);
             break;
         case IR_UNOP:
@@ -521,6 +599,11 @@ int ir_snprint_instr(char *buf, size_t size, IRInstr *instr) {
             n += snprint_operand(buf + n, size - n, &instr->if_right);
             n += snprintf(buf + n, size - n, " goto %s", instr->label);
             break;
+        case IR_SWITCH:
+            n += snprintf(buf + n, size - n, "  switch ");
+            n += snprint_operand(buf + n, size - n, &instr->src);
+            n += snprintf(buf + n, size - n, " [%d cases] default %s", instr->case_count, instr->label);
+            break;
         case IR_LOAD:
             n += snprintf(buf + n, size - n, "  %s = ", instr->result ? instr->result : "?");
             if (instr->index.is_const && instr->index.const_val == 0) n += snprintf(buf + n, size - n, "*");
@@ -556,6 +639,16 @@ int ir_snprint_instr(char *buf, size_t size, IRInstr *instr) {
             n += snprintf(buf + n, size - n, "  throw ");
             n += snprint_operand(buf + n, size - n, &instr->src);
             break;
+        case IR_SELECT:
+            n += snprintf(buf + n, size - n, "  %s := ", instr->result);
+            n += snprint_operand(buf + n, size - n, &instr->if_left);
+            n += snprintf(buf + n, size - n, " %s ", relop_str(instr->relop));
+            n += snprint_operand(buf + n, size - n, &instr->if_right);
+            n += snprintf(buf + n, size - n, " ? ");
+            n += snprint_operand(buf + n, size - n, &instr->left);
+            n += snprintf(buf + n, size - n, " : ");
+            n += snprint_operand(buf + n, size - n, &instr->right);
+            break;
         case IR_PHI: {
             n += snprintf(buf + n, size - n, "  %s := phi(",
                           instr->result ? instr->result : "?");
@@ -569,6 +662,16 @@ int ir_snprint_instr(char *buf, size_t size, IRInstr *instr) {
             n += snprintf(buf + n, size - n, ")");
             break;
         }
+        case IR_PROFILE_COUNTER:
+            n += snprintf(buf + n, size - n, "  profile_counter %d", instr->prof_block);
+            break;
+        case IR_PREFETCH:
+            n += snprintf(buf + n, size - n, "  prefetch.%c ", instr->prefetch_write ? 'w' : 'r');
+            n += snprint_operand(buf + n, size - n, &instr->base);
+            n += snprintf(buf + n, size - n, "[");
+            n += snprint_operand(buf + n, size - n, &instr->index);
+            n += snprintf(buf + n, size - n, "]");
+            break;
     }
     return n;
 }
@@ -589,131 +692,180 @@ void ir_print_program(IRProgram *prog) {
     printf("===============================================\n");
 }
 
+static void export_instrs(FILE *f, IRInstr *list) {
+    for (IRInstr *i = list; i; i = i->next) {
+        switch (i->kind) {
+            case IR_ASSIGN:
+                fprintf(f, "  %s := ", i->result);
+                if (i->src.is_const) fprintf(f, "%d", i->src.const_val);
+                else fprintf(f, "%s", i->src.name);
+                fprintf(f, "\n");
+                break;
+            case IR_BINOP:
+                fprintf(f, "  %s := ", i->result);
+                if (i->left.is_const) fprintf(f, "%d", i->left.const_val);
+                else fprintf(f, "%s", i->left.name);
+                fprintf(f, " %s ", ir_binop_str(i->binop));
+                if (i->right.is_const) fprintf(f, "%d", i->right.const_val);
+                else fprintf(f, "%s", i->right.name);
+                fprintf(f, "\n");
+                break;
+            case IR_UNOP:
+                fprintf(f, "  %s := %c", i->result, i->unop);
+                if (i->unop_src.is_const) fprintf(f, "%d", i->unop_src.const_val);
+                else fprintf(f, "%s", i->unop_src.name);
+                fprintf(f, "\n");
+                break;
+            case IR_PARAM:
+                fprintf(f, "  param ");
+                if (i->src.is_const) fprintf(f, "%d", i->src.const_val);
+                else fprintf(f, "%s", i->src.name);
+                fprintf(f, "\n");
+                break;
+            case IR_CALL:
+                if (i->result)
+                    fprintf(f, "  %s := call %s, %d\n", i->result, i->call_fn, i->arg_count);
+                else
+                    fprintf(f, "  call %s, %d\n", i->call_fn, i->arg_count);
+                break;
+            case IR_CALL_INDIRECT:
+                if (i->result)
+                    fprintf(f, "  %s := call *", i->result);
+                else
+                    fprintf(f, "  call *");
+                if (i->base.is_const) fprintf(f, "%d", i->base.const_val);
+                else fprintf(f, "%s", i->base.name);
+                fprintf(f, ", %d\n", i->arg_count);
+                break;
+            case IR_RETURN:
+                if (i->src.name || i->src.is_const) {
+                    fprintf(f, "  return ");
+                    if (i->src.is_const) fprintf(f, "%d", i->src.const_val);
+                    else fprintf(f, "%s", i->src.name);
+                    fprintf(f, "\n");
+                } else
+                    fprintf(f, "  return\n");
+                break;
+            case IR_LABEL:
+                fprintf(f, "%s:\n", i->label);
+                break;
+            case IR_GOTO:
+                fprintf(f, "  goto %s\n", i->label);
+                break;
+            case IR_IF:
+                fprintf(f, "  if ");
+                if (i->if_left.is_const) fprintf(f, "%d", i->if_left.const_val);
+                else fprintf(f, "%s", i->if_left.name);
+                fprintf(f, " %s ", relop_str(i->relop));
+                if (i->if_right.is_const) fprintf(f, "%d", i->if_right.const_val);
+                else fprintf(f, "%s", i->if_right.name);
+                fprintf(f, " goto %s\n", i->label);
+                break;
+            case IR_SWITCH:
+                fprintf(f, "  switch ");
+                if (i->src.is_const) fprintf(f, "%d", i->src.const_val);
+                else fprintf(f, "%s", i->src.name);
+                fprintf(f, " [");
+                for (int k = 0; k < i->case_count; k++)
+                    fprintf(f, "%s%d: %s", k ? ", " : "", i->case_vals[k], i->case_labels[k]);
+                fprintf(f, "] default %s\n", i->label);
+                break;
+            case IR_LOAD:
+                fprintf(f, "  %s := load ", i->result ? i->result : "?");
+                if (i->base.is_const) fprintf(f, "%d", i->base.const_val);
+                else fprintf(f, "%s", i->base.name);
+                fprintf(f, "[");
+                if (i->index.is_const) fprintf(f, "%d", i->index.const_val);
+                else fprintf(f, "%s", i->index.name);
+                fprintf(f, "] (scale %d)\n", i->scale);
+                break;
+            case IR_STORE:
+                fprintf(f, "  store ");
+                if (i->base.is_const) fprintf(f, "%d", i->base.const_val);
+                else fprintf(f, "%s", i->base.name);
+                fprintf(f, "[");
+                if (i->index.is_const) fprintf(f, "%d", i->index.const_val);
+                else fprintf(f, "%s", i->index.name);
+                fprintf(f, "] (scale %d) := ", i->scale);
+                if (i->store_val.is_const) fprintf(f, "%d", i->store_val.const_val);
+                else fprintf(f, "%s", i->store_val.name);
+                fprintf(f, "\n");
+                break;
+            case IR_ALLOCA:
+                fprintf(f, "  %s := alloca ", i->result);
+                if (i->src.is_const) fprintf(f, "%d", i->src.const_val);
+                else fprintf(f, "%s", i->src.name);
+                fprintf(f, "\n");
+                break;
+            case IR_TRY_BEGIN:
+                fprintf(f, "  try_begin %s\n", i->label);
+                break;
+            case IR_TRY_END:
+                fprintf(f, "  try_end\n");
+                break;
+            case IR_THROW:
+                fprintf(f, "  throw ");
+                if (i->src.is_const) fprintf(f, "%d", i->src.const_val);
+                else fprintf(f, "%s", i->src.name);
+                fprintf(f, "\n");
+                break;
+            case IR_SELECT:
+                fprintf(f, "  %s := ", i->result);
+                if (i->if_left.is_const) fprintf(f, "%d", i->if_left.const_val);
+                else fprintf(f, "%s", i->if_left.name);
+                fprintf(f, " %s ", relop_str(i->relop));
+                if (i->if_right.is_const) fprintf(f, "%d", i->if_right.const_val);
+                else fprintf(f, "%s", i->if_right.name);
+                fprintf(f, " ? ");
+                if (i->left.is_const) fprintf(f, "%d", i->left.const_val);
+                else fprintf(f, "%s", i->left.name);
+                fprintf(f, " : ");
+                if (i->right.is_const) fprintf(f, "%d", i->right.const_val);
+                else fprintf(f, "%s", i->right.name);
+                fprintf(f, "\n");
+                break;
+            case IR_PHI:
+                fprintf(f, "  %s := phi(", i->result ? i->result : "?");
+                for (int k = 0; k < i->phi_arity; k++) {
+                    fprintf(f, "%s[bb%d]",
+                            i->phi_args[k] ? i->phi_args[k] : "?",
+                            i->phi_pred_bb[k]);
+                    if (k + 1 < i->phi_arity) fprintf(f, ", ");
+                }
+                fprintf(f, ")\n");
+                break;
+            case IR_PROFILE_COUNTER:
+                fprintf(f, "  profile_counter %d\n", i->prof_block);
+                break;
+            case IR_PREFETCH:
+                fprintf(f, "  prefetch.%c ", i->prefetch_write ? 'w' : 'r');
+                if (i->base.is_const) fprintf(f, "%d", i->base.const_val);
+                else fprintf(f, "%s", i->base.name);
+                fprintf(f, "[");
+                if (i->index.is_const) fprintf(f, "%d", i->index.const_val);
+                else fprintf(f, "%s", i->index.name);
+                fprintf(f, "] (scale %d)\n", i->scale);
+                break;
+        }
+    }
+}
+
 void ir_export_to_file(IRProgram *prog, const char *filename) {
     if (!prog || !filename) return;
     FILE *f = fopen(filename, "w");
     if (!f) return;
     for (IRFunc *fn = prog->funcs; fn; fn = fn->next) {
         fprintf(f, "function %s:\n", fn->name);
-        for (IRInstr *i = fn->instrs; i; i = i->next) {
-            switch (i->kind) {
-                case IR_ASSIGN:
-                    fprintf(f, "  %s := ", i->result);
-                    if (i->src.is_const) fprintf(f, "%d", i->src.const_val);
-                    else fprintf(f, "%s", i->src.name);
-                    fprintf(f, "\n");
-                    break;
-                case IR_BINOP:
-                    fprintf(f, "  %s := ", i->result);
-                    if (i->left.is_const) fprintf(f, "%d", i->left.const_val);
-                    else fprintf(f, "%s", i->left.name);
-                    fprintf(f, " %s ", binop_str(i->binop));
-                    if (i->right.is_const) fprintf(f, "%d", i->right.const_val);
-                    else fprintf(f, "%s", i->right.name);
-                    fprintf(f, "\n");
-                    break;
-                case IR_UNOP:
-                    fprintf(f, "  %s := %c", i->result, i->unop);
-                    if (i->unop_src.is_const) fprintf(f, "%d", i->unop_src.const_val);
-                    else fprintf(f, "%s", i->unop_src.name);
-                    fprintf(f, "\n");
-                    break;
-                case IR_PARAM:
-                    fprintf(f, "  param ");
-                    if (i->src.is_const) fprintf(f, "%d", i->src.const_val);
-                    else fprintf(f, "%s", i->src.name);
-                    fprintf(f, "\n");
-                    break;
-                case IR_CALL:
-                    if (i->result)
-                        fprintf(f, "  %s := call %s, %d\n", i->result, i->call_fn, i->arg_count);
-                    else
-                        fprintf(f, "  call %s, %d\n", i->call_fn, i->arg_count);
-                    break;
-                case IR_CALL_INDIRECT:
-                    if (i->result)
-                        fprintf(f, "  %s := call *", i->result);
-                    else
-                        fprintf(f, "  call *");
-                    if (i->base.is_const) fprintf(f, "%d", i->base.const_val);
-                    else fprintf(f, "%s", i->base.name);
-                    fprintf(f, ", %d\n", i->arg_count);
-                    break;
-                case IR_RETURN:
-                    if (i->src.name || i->src.is_const) {
-                        fprintf(f, "  return ");
-                        if (i->src.is_const) fprintf(f, "%d", i->src.const_val);
-                        else fprintf(f, "%s", i->src.name);
-                        fprintf(f, "\n");
-                    } else
-                        fprintf(f, "  return\n");
-                    break;
-                case IR_LABEL:
-                    fprintf(f, "%s:\n", i->label);
-                    break;
-                case IR_GOTO:
-                    fprintf(f, "  goto %s\n", i->label);
-                    break;
-                case IR_IF:
-                    fprintf(f, "  if ");
-                    if (i->if_left.is_const) fprintf(f, "%d", i->if_left.const_val);
-                    else fprintf(f, "%s", i->if_left.name);
-                    fprintf(f, " %s ", relop_str(i->relop));
-                    if (i->if_right.is_const) fprintf(f, "%d", i->if_right.const_val);
-                    else fprintf(f, "%s", i->if_right.name);
-                    fprintf(f, " goto %s\n", i->label);
-                    break;
-                case IR_LOAD:
-                    fprintf(f, "  %s := load ", i->result ? i->result : "?");
-                    if (i->base.is_const) fprintf(f, "%d", i->base.const_val);
-                    else fprintf(f, "%s", i->base.name);
-                    fprintf(f, "[");
-                    if (i->index.is_const) fprintf(f, "%d", i->index.const_val);
-                    else fprintf(f, "%s", i->index.name);
-                    fprintf(f, "] (scale %d)\n", i->scale);
-                    break;
-                case IR_STORE:
-                    fprintf(f, "  store ");
-                    if (i->base.is_const) fprintf(f, "%d", i->base.const_val);
-                    else fprintf(f, "%s", i->base.name);
-                    fprintf(f, "[");
-                    if (i->index.is_const) fprintf(f, "%d", i->index.const_val);
-                    else fprintf(f, "%s", i->index.name);
-                    fprintf(f, "] (scale %d) := ", i->scale);
-                    if (i->store_val.is_const) fprintf(f, "%d", i->store_val.const_val);
-                    else fprintf(f, "%s", i->store_val.name);
-                    fprintf(f, "\n");
-                    break;
-                case IR_ALLOCA:
-                    fprintf(f, "  %s := alloca ", i->result);
-                    if (i->src.is_const) fprintf(f, "%d", i->src.const_val);
-                    else fprintf(f, "%s", i->src.name);
-                    fprintf(f, "\n");
-                    break;
-                case IR_TRY_BEGIN:
-                    fprintf(f, "  try_begin %s\n", i->label);
-                    break;
-                case IR_TRY_END:
-                    fprintf(f, "  try_end\n");
-                    break;
-                case IR_THROW:
-                    fprintf(f, "  throw ");
-                    if (i->src.is_const) fprintf(f, "%d", i->src.const_val);
-                    else fprintf(f, "%s", i->src.name);
-                    fprintf(f, "\n");
-                    break;
-                case IR_PHI:
-                    fprintf(f, "  %s := phi(", i->result ? i->result : "?");
-                    for (int k = 0; k < i->phi_arity; k++) {
-                        fprintf(f, "%s[bb%d]",
-                                i->phi_args[k] ? i->phi_args[k] : "?",
-                                i->phi_pred_bb[k]);
-                        if (k + 1 < i->phi_arity) fprintf(f, ", ");
-                    }
-                    fprintf(f, ")\n");
-                    break;
-            }
-        }
+        export_instrs(f, fn->instrs);
+        fprintf(f, "\n");
+    }
+    for (VecKernel *k = prog->vec_kernels; k; k = k->next) {
+        fprintf(f, "vector kernel %s(", k->name);
+        for (int p = 0; p < k->param_count; p++) fprintf(f, "%s%s", p ? ", " : "", k->params[p]);
+        fprintf(f, "): for %s", k->ivar);
+        if (k->reduction) fprintf(f, ", sum %s", k->reduction);
+        fprintf(f, "\n");
+        export_instrs(f, k->body);
         fprintf(f, "\n");
     }
     fclose(f);
@@ -786,6 +938,20 @@ void ir_free_instr(IRInstr *instr) {
             case IR_THROW:
                 if (instr->src.name) free(instr->src.name);
                 break;
+            case IR_SWITCH:
+                if (instr->src.name) free(instr->src.name);
+                if (instr->label) free(instr->label);
+                for (int i = 0; i < instr->case_count; i++) free(instr->case_labels[i]);
+                if (instr->case_labels) free(instr->case_labels);
+                if (instr->case_vals) free(instr->case_vals);
+                break;
+            case IR_SELECT:
+                if (instr->result) free(instr->result);
+                if (instr->if_left.name) free(instr->if_left.name);
+                if (instr->if_right.name) free(instr->if_right.name);
+                if (instr->left.name) free(instr->left.name);
+                if (instr->right.name) free(instr->right.name);
+                break;
             case IR_PHI:
                 if (instr->result) free(instr->result);
                 for (int i = 0; i < instr->phi_arity; i++)
@@ -793,6 +959,12 @@ void ir_free_instr(IRInstr *instr) {
                 if (instr->phi_args)    free(instr->phi_args);
                 if (instr->phi_pred_bb) free(instr->phi_pred_bb);
                 break;
+            case IR_PROFILE_COUNTER:
+                break;
+            case IR_PREFETCH:
+                if (instr->base.name) free(instr->base.name);
+                if (instr->index.name) free(instr->index.name);
+                break;
         }
         free(instr);
         instr = next;
@@ -809,10 +981,25 @@ void ir_free_func(IRFunc *f) {
     }
 }
 
+void ir_free_vec_kernels(VecKernel *k) {
+    while (k) {
+        VecKernel *next = k->next;
+        free(k->name);
+        for (int i = 0; i < k->param_count; i++) free(k->params[i]);
+        free(k->params);
+        free(k->ivar);
+        free(k->reduction);
+        ir_free_instr(k->body);
+        free(k);
+        k = next;
+    }
+}
+
 void ir_free_program(IRProgram *prog) {
     if (!prog) return;
     ir_free_func(prog->funcs);
     ir_free_instr(prog->global_instrs);
+    ir_free_vec_kernels(prog->vec_kernels);
     
     StringLiteral *s = prog->strings;
     while (s) {
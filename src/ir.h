@@ -29,7 +29,11 @@ typedef enum {
     IR_TRY_BEGIN,   /* try_begin label_catch */
     IR_TRY_END,     /* try_end */
     IR_THROW,       /* throw x */
-    IR_PHI          /* SSA: x := phi(x_pred0, x_pred1, ...) — optimizer-internal only */
+    IR_SELECT,      /* x := a relop b ? y : z  (branch-free) */
+    IR_SWITCH,      /* switch x [v1: L1, v2: L2, ...] default Ld */
+    IR_PHI,         /* SSA: x := phi(x_pred0, x_pred1, ...) — optimizer-internal only */
+    IR_PROFILE_COUNTER, /* profile_counter N  (-fprofile-generate block counter) */
+    IR_PREFETCH     /* prefetch.r/w base, idx, scale  (cache hint, no result) */
 } IROpKind;
 
 /* Relational operators for IR_IF */
@@ -61,7 +65,9 @@ typedef struct IRInstr {
     /* For IR_ASSIGN: source */
     IROperand src;
 
-    /* For IR_BINOP: left, right, operator token */
+    /* For IR_BINOP: left, right, operator token.
+     * For IR_SELECT: left is the value when the condition holds, right
+     * the value otherwise; the condition uses if_left/if_right/relop. */
     IROperand left;
     IROperand right;
     int binop;      /* '+', '-', '*', '/', '%', T_AND, T_OR, etc. */
@@ -79,6 +85,12 @@ typedef struct IRInstr {
     IROperand base;
     IROperand index;
     int scale;
+    /* Accesses with different non-zero alias sets never overlap (set on
+     * the checked copy of a versioned loop); 0 means unknown. */
+    int alias_set;
+    /* For IR_PREFETCH (addressed like IR_LOAD): the line is about to be
+     * written rather than read. */
+    int prefetch_write;
 
     /* For IR_STORE: value to be stored */
     IROperand store_val;
@@ -87,10 +99,16 @@ typedef struct IRInstr {
     char *call_fn;
     int arg_count;
 
-    /* For IR_LABEL, IR_GOTO, IR_IF: label */
+    /* For IR_LABEL, IR_GOTO, IR_IF: label. For IR_SWITCH: default target */
     char *label;
 
-    /* For IR_IF: condition operands and relop */
+    /* For IR_SWITCH: discriminant in src; case_vals[i] jumps to
+     * case_labels[i] (owned strings), anything else to label. */
+    int    *case_vals;
+    char  **case_labels;
+    int     case_count;
+
+    /* For IR_IF, IR_SELECT: condition operands and relop */
     IROperand if_left;
     IROperand if_right;
     IRRelop relop;
@@ -105,6 +123,11 @@ typedef struct IRInstr {
     int    *phi_pred_bb;   /* predecessor block IDs */
     int     phi_arity;
 
+    /* Profile-guided optimization: number (1-based) of the block this
+     * instruction led when the IR was generated, 0 if none. For
+     * IR_PROFILE_COUNTER, the block whose counter it bumps. */
+    int prof_block;
+
     struct IRInstr *next;
 } IRInstr;
 
@@ -123,11 +146,32 @@ typedef struct StringLiteral {
     struct StringLiteral *next;
 } StringLiteral;
 
+/* Loop body outlined by the vectorizer (-march=rv64gcv). The backend
+ * emits it as a leaf function running
+ *
+ *     for (ivar = params[0]; ivar < params[1]; ivar++) body
+ *
+ * as strip-mined RVV code, with params bound to a0, a1, ... in order.
+ * body holds one element's work: loads and stores base[ivar + k]
+ * (scale 4, the index through `x := ivar + k`), arithmetic on those
+ * elements and invariant params, and, with a reduction, a single
+ * `reduction := reduction + v`. The sum, started at 0, is returned. */
+typedef struct VecKernel {
+    char *name;
+    char **params;
+    int param_count;
+    char *ivar;
+    char *reduction;         /* NULL if none */
+    IRInstr *body;
+    struct VecKernel *next;
+} VecKernel;
+
 /* Program IR: list of functions (incl. global decls as init code) */
 typedef struct {
     IRFunc *funcs;
     IRInstr *global_instrs;  /* global var initializers, if any */
     StringLiteral *strings;  /* static string pool */
+    VecKernel *vec_kernels;  /* outlined vector loops, if any */
 } IRProgram;
 
 /* --- Temp and label generation --- */
@@ -139,6 +183,8 @@ void ir_reset_temps(void);
 IRInstr* ir_make_assign(char *dst, IROperand src, int line);
 IRInstr* ir_make_binop(char *dst, IROperand left, IROperand right, int op, int line);
 IRInstr* ir_make_unop(char *dst, IROperand src, int op, int line);
+IRInstr* ir_make_select(char *dst, IROperand cond_left, IROperand cond_right, IRRelop relop,
+                        IROperand if_true, IROperand if_false, int line);
 IRInstr* ir_make_param(IROperand op, int line);
 IRInstr* ir_make_call(char *dst, char *fn, int nargs, int line);
 IRInstr* ir_make_call_void(char *fn, int nargs, int line);
@@ -148,10 +194,13 @@ IRInstr* ir_make_return(int line);
 IRInstr* ir_make_label(char *label, int line);
 IRInstr* ir_make_goto(char *label, int line);
 IRInstr* ir_make_if(IROperand left, IROperand right, IRRelop relop, char *label, int line);
+IRInstr* ir_make_switch(IROperand discr, int count, int *vals, char **labels,
+                        char *default_label, int line);
 
 /* Array element load/store */
 IRInstr* ir_make_load(char *dst, IROperand base, IROperand index, int scale, int line);
 IRInstr* ir_make_store(IROperand base, IROperand index, int scale, IROperand value, int line);
+IRInstr* ir_make_prefetch(IROperand base, IROperand index, int scale, int write, int line);
 IRInstr* ir_make_alloca(char *dst, IROperand size, int line);
 IRInstr* ir_make_try_begin(char *catch_label, int line);
 IRInstr* ir_make_try_end(int line);
@@ -176,6 +225,7 @@ IRFunc* ir_func_create(char *name, DataType ret_type);
 void ir_program_add_string(IRProgram *prog, char *label, char *val);
 
 /* --- Output --- */
+const char* ir_binop_str(int op);
 void ir_print_instr(IRInstr *instr);
 void ir_print_func(IRFunc *f);
 void ir_print_program(IRProgram *prog);
@@ -186,6 +236,7 @@ void ir_export_to_file(IRProgram *prog, const char *filename);
 void ir_free_operand(IROperand *op);
 void ir_free_instr(IRInstr *instr);
 void ir_free_func(IRFunc *f);
+void ir_free_vec_kernels(VecKernel *k);
 void ir_free_program(IRProgram *prog);
 
 #endif /* IR_H */
@@ -233,6 +233,90 @@ static IROperand gen_index_expr(ASTNode *node, IRInstr **list, int line) {
     return res;
 }
 
+/* --- Struct assignment --- */
+
+/* Is `node` a whole struct value (not a pointer to one)? */
+static int is_struct_value(ASTNode *node) {
+    return node && node->data_type == TYPE_STRUCT && node->pointer_level == 0 && node->struct_def;
+}
+
+/* Where a struct value lives: a struct variable, or a pointer holding its
+   address, plus a byte offset. 0 when the expression has no location. */
+static int struct_location(ASTNode *node, IROperand *base, int *offset, IRInstr **list) {
+    if (node->type == NODE_VAR) {
+        *base = ir_op_name(get_ir_name(node));
+        *offset = 0;
+        return 1;
+    }
+    if (node->type == NODE_UN_OP && node->int_val == '*') {
+        *base = gen_expr(node->left, list);
+        *offset = 0;
+        return 1;
+    }
+    if (node->type == NODE_MEMBER_ACCESS) {
+        ASTNode *obj = node->left;
+        if (obj->pointer_level > 0) {
+            *base = gen_expr(obj, list);
+            *offset = 0;
+        } else if (!struct_location(obj, base, offset, list)) {
+            return 0;
+        }
+        *offset += node->member_offset;
+        return 1;
+    }
+    return 0;
+}
+
+static void copy_struct_unit(IROperand *dst, int doff, IROperand *src, int soff, int scale,
+                             IRInstr **list, int line) {
+    char *t = ir_new_temp();
+    ir_append(list, ir_make_load(t, *src, ir_op_const(soff / scale), scale, line));
+    IROperand val = ir_op_name(t);
+    ir_append(list, ir_make_store(*dst, ir_op_const(doff / scale), scale, val, line));
+    ir_free_operand(&val);
+    free(t);
+}
+
+/* dst = src, one load/store pair per scalar member so that later passes
+   (SROA) see plain field accesses. Array and struct members are copied a
+   word at a time, or a byte at a time where the offsets are not aligned. */
+static void gen_struct_copy(IROperand dst, int doff, IROperand src, int soff, Symbol *def,
+                            IRInstr **list, int line) {
+    for (Symbol *m = def->members; m; m = m->next_member) {
+        if (m->kind == SYM_FUNCTION) continue;
+        int off = m->struct_offset;
+        int size = get_type_size(m->type, m->pointer_level, m->struct_def);
+        if (size <= 0) size = 1;
+        if (m->array_dim_count == 0 && !(m->struct_def && m->pointer_level == 0) &&
+            (doff + off) % size == 0 && (soff + off) % size == 0) {
+            copy_struct_unit(&dst, doff + off, &src, soff + off, size, list, line);
+            continue;
+        }
+        for (int i = 0; i < m->array_dim_count; i++)
+            if (m->array_sizes[i] > 0) size *= m->array_sizes[i];
+        int scale = ((doff + off) % 4 == 0 && (soff + off) % 4 == 0) ? 4 : 1;
+        for (int at = 0; at < size; at += scale) {
+            if (at + scale > size) scale = 1;
+            copy_struct_unit(&dst, doff + off + at, &src, soff + off + at, scale, list, line);
+        }
+    }
+}
+
+/* Whole-struct assignment dst = src; 0 when either side has no location. */
+static int gen_struct_assign(ASTNode *dst_node, ASTNode *src_node, IRInstr **list, int line) {
+    IROperand src, dst;
+    int soff, doff;
+    if (!struct_location(src_node, &src, &soff, list)) return 0;
+    if (!struct_location(dst_node, &dst, &doff, list)) {
+        ir_free_operand(&src);
+        return 0;
+    }
+    gen_struct_copy(dst, doff, src, soff, dst_node->struct_def, list, line);
+    ir_free_operand(&src);
+    ir_free_operand(&dst);
+    return 1;
+}
+
 /* --- Condition generation (for if/while/for) --- */
 static void gen_cond(ASTNode *node, IRInstr **list, char *true_label, char *false_label, int line) {
     if (!node) {
@@ -363,6 +447,14 @@ static IROperand gen_expr(ASTNode *node, IRInstr **list) {
 
             if (node->member_sym && node->member_sym->is_array && node->pointer_level == 0) {
                 // Decay array member to pointer: base + offset
+                if (is_struct_value(node->left) && base.name) {
+                    /* A struct object, not a pointer: start from its address. */
+                    char *addr = ir_new_temp();
+                    ir_append(list, ir_make_unop(addr, base, '&', line));
+                    free(base.name);
+                    base = ir_op_name(addr);
+                    free(addr);
+                }
                 char *t = ir_new_temp();
                 ir_append(list, ir_make_binop(t, base, ir_op_const(offset), '+', line));
                 if (base.name) free(base.name);
@@ -505,6 +597,9 @@ static IROperand gen_expr(ASTNode *node, IRInstr **list) {
         }
 
         case NODE_ASSIGN: {
+            if (is_struct_value(node->left) && is_struct_value(node->right) &&
+                gen_struct_assign(node->left, node->right, list, line))
+                return ir_op_const(0);
             IROperand val = gen_expr(node->right, list);
             if (node->left->type == NODE_VAR) {
                 char *target = get_ir_name(node->left);
@@ -845,23 +940,30 @@ static void gen_stmt(ASTNode *node, IRInstr **list) {
 
             char *L_end = ir_new_label();
 
-            /* Dispatch on discriminant */
+            /* Dispatch on discriminant: one multiway branch, lowered by the
+               backend to a jump table or a compare tree. */
             IROperand discr = gen_expr(node->cond, list);
+            int *case_vals = (int *)malloc(sizeof(int) * count);
+            char **case_labels = (char **)malloc(sizeof(char *) * count);
+            int case_count = 0;
             for (int i = 0; i < count; i++) {
                 ASTNode *c = cases[i];
                 if (c->type == NODE_CASE && c->left) {
-                    int v = c->left->int_val;
-                    IROperand cv = ir_op_const(v);
-                    ir_append(list, ir_make_if(discr, cv, IR_EQ, labels[i], line));
+                    case_vals[case_count] = c->left->int_val;
+                    case_labels[case_count] = labels[i];
+                    case_count++;
                 }
             }
 
-            if (default_index >= 0) {
-                ir_append(list, ir_make_goto(labels[default_index], line));
+            char *L_default = default_index >= 0 ? labels[default_index] : L_end;
+            if (case_count > 0) {
+                ir_append(list, ir_make_switch(discr, case_count, case_vals, case_labels, L_default, line));
             } else {
-                ir_append(list, ir_make_goto(L_end, line));
+                ir_append(list, ir_make_goto(L_default, line));
             }
 
+            free(case_vals);
+            free(case_labels);
             if (discr.name) free(discr.name);
 
             /* Emit case bodies with fallthrough */
@@ -977,6 +1079,18 @@ static void gen_stmt(ASTNode *node, IRInstr **list) {
                     free(t);
                 }
             }
+            if (node->right && sym && sym->pointer_level == 0 && !sym->is_array && is_struct_value(node->right) &&
+                node->right->struct_def == sym->struct_def) {
+                IROperand src;
+                int soff;
+                if (struct_location(node->right, &src, &soff, list)) {
+                    IROperand dst = ir_op_name(node->sym ? node->sym->ir_name : node->str_val);
+                    gen_struct_copy(dst, 0, src, soff, sym->struct_def, list, line);
+                    ir_free_operand(&src);
+                    ir_free_operand(&dst);
+                    break;
+                }
+            }
             if (node->right) {
                 IROperand init = gen_expr(node->right, list);
                 ir_append(list, ir_make_assign(node->sym ? node->sym->ir_name : node->str_val, init, line));
@@ -2,8 +2,14 @@
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <limits.h>
 #include "ir_opt.h"
 #include "compiler_metrics.h"
+#include "ast.h"
+#include "semantic.h"
+#include "profile.h"
+#include "dependence.h"
+#include "riscv_gen.h"
 #include "y.tab.h"
 
 /* --- CFG Construction --- */
@@ -36,6 +42,27 @@ static BasicBlock* find_bb_by_label(BasicBlock *list, const char *label) {
     return NULL;
 }
 
+/* Counts come from the block leaders tagged by profile_prepare_program().
+   The function entry may have gained code in front of its leader; blocks
+   the optimizer created take the count of the block laid out before them,
+   which is where their code came from or what falls into them. */
+static void assign_profile_counts(CFG *cfg) {
+    long long prev = -1;
+    for (BasicBlock *bb = cfg->blocks; bb; bb = bb->next) {
+        bb->count = -1;
+        if (!profile_available()) continue;
+        bb->count = profile_block_count(bb->instrs);
+        if (bb->count < 0 && bb == cfg->entry) {
+            for (IRInstr *cur = bb->instrs; cur && bb->count < 0; cur = cur->next) {
+                bb->count = profile_block_count(cur);
+                if (cur == bb->last) break;
+            }
+        }
+        if (bb->count < 0) bb->count = prev;
+        prev = bb->count;
+    }
+}
+
 CFG* build_cfg(IRFunc *f) {
     if (!f || !f->instrs) return NULL;
 
@@ -56,7 +83,7 @@ CFG* build_cfg(IRFunc *f) {
 
         while (curr) {
             new_bb->last = curr;
-            if (curr->kind == IR_GOTO || curr->kind == IR_IF || curr->kind == IR_RETURN || curr->kind == IR_TRY_BEGIN || curr->kind == IR_THROW) {
+            if (curr->kind == IR_GOTO || curr->kind == IR_IF || curr->kind == IR_SWITCH || curr->kind == IR_RETURN || curr->kind == IR_TRY_BEGIN || curr->kind == IR_THROW) {
                 curr = curr->next;
                 break;
             }
@@ -70,6 +97,7 @@ CFG* build_cfg(IRFunc *f) {
     cfg->blocks = head;
     cfg->entry = head;
     cfg->block_count = bb_count;
+    assign_profile_counts(cfg);
 
     BasicBlock *bb = head;
     while (bb) {
@@ -81,6 +109,13 @@ CFG* build_cfg(IRFunc *f) {
             BasicBlock *target = find_bb_by_label(head, last->label);
             if (target) add_succ(bb, target);
             if (bb->next) add_succ(bb, bb->next);
+        } else if (last->kind == IR_SWITCH) {
+            for (int i = 0; i < last->case_count; i++) {
+                BasicBlock *target = find_bb_by_label(head, last->case_labels[i]);
+                if (target) add_succ(bb, target);
+            }
+            BasicBlock *target = find_bb_by_label(head, last->label);
+            if (target) add_succ(bb, target);
         } else if (last->kind != IR_RETURN && last->kind != IR_THROW) {
             if (bb->next) add_succ(bb, bb->next);
         }
@@ -102,6 +137,8 @@ void export_cfg_to_json(CFG *cfg, const char *path) {
     while (bb) {
         fprintf(fp, "    {\n");
         fprintf(fp, "      \"id\": %d,\n", bb->id);
+        if (profile_available())
+            fprintf(fp, "      \"count\": %lld,\n", bb->count);
         fprintf(fp, "      \"instrs\": [\n");
         IRInstr *instr = bb->instrs;
         while (instr) {
@@ -194,6 +231,15 @@ static void free_instr_single(IRInstr *instr) {
     free(instr);
 }
 
+/* Fresh optimizer-owned temp. The "__" prefix keeps it disjoint from the
+   per-function t<N> temps handed out by ir_gen. */
+static char* new_opt_temp(const char *tag) {
+    static int opt_temp_counter = 0;
+    char *buf = malloc(32);
+    snprintf(buf, 32, "__%s%d", tag, opt_temp_counter++);
+    return buf;
+}
+
 static int eval_relop(int l, int r, IRRelop op) {
     switch (op) {
         case IR_LT: return l < r;
@@ -206,6 +252,51 @@ static int eval_relop(int l, int r, IRRelop op) {
     }
 }
 
+/* Turn a switch on a constant, or one whose targets all agree, into a goto. */
+static int fold_switch(IRInstr *sw) {
+    const char *target = sw->label;
+    for (int i = 0; i < sw->case_count; i++) {
+        if (sw->src.is_const) {
+            if (sw->case_vals[i] == sw->src.const_val) { target = sw->case_labels[i]; break; }
+        } else if (strcmp(sw->case_labels[i], sw->label) != 0) {
+            return 0;
+        }
+    }
+    char *lbl = strdup(target);
+    for (int i = 0; i < sw->case_count; i++) free(sw->case_labels[i]);
+    free(sw->case_labels);
+    free(sw->case_vals);
+    sw->case_labels = NULL;
+    sw->case_vals = NULL;
+    sw->case_count = 0;
+    free(sw->label);
+    memset(&sw->src, 0, sizeof(IROperand));
+    sw->kind = IR_GOTO;
+    sw->label = lbl;
+    return 1;
+}
+
+/* The label a jump to `label` can go to directly when it lands on a goto. */
+static const char* forwarded_label(IRInstr *head, const char *label) {
+    for (IRInstr *target = head; target; target = target->next) {
+        if (target->kind == IR_LABEL && strcmp(target->label, label) == 0) {
+            if (target->next && target->next->kind == IR_GOTO && strcmp(label, target->next->label) != 0)
+                return target->next->label;
+            return NULL;
+        }
+    }
+    return NULL;
+}
+
+/* Does the label run starting at `instr` contain `label`? */
+static int label_run_contains(IRInstr *instr, const char *label) {
+    while (instr && instr->kind == IR_LABEL) {
+        if (strcmp(instr->label, label) == 0) return 1;
+        instr = instr->next;
+    }
+    return 0;
+}
+
 static IRInstr* simplify_control_flow(IRInstr *head) {
     if (!head) return NULL;
     int changed = 1;
@@ -233,7 +324,10 @@ static IRInstr* simplify_control_flow(IRInstr *head) {
                 changed = 1;
             }
 
-            if (curr->kind == IR_GOTO || curr->kind == IR_RETURN || curr->kind == IR_THROW) {
+            if (curr->kind == IR_SWITCH && fold_switch(curr)) changed = 1;
+
+            if (curr->kind == IR_GOTO || curr->kind == IR_SWITCH || curr->kind == IR_RETURN ||
+                curr->kind == IR_THROW) {
                 while (curr->next && curr->next->kind != IR_LABEL) {
                     IRInstr *to_del = curr->next;
                     curr->next = to_del->next;
@@ -247,8 +341,9 @@ static IRInstr* simplify_control_flow(IRInstr *head) {
              * because it can silently change then/else behavior in non-trivial layouts.
              * Keep conditional control flow untouched unless proven safe by CFG analysis. */
 
-            if (curr->kind == IR_GOTO && curr->next && curr->next->kind == IR_LABEL &&
-                strcmp(curr->label, curr->next->label) == 0) {
+            /* A jump to the label run that follows goes nowhere, taken or not. */
+            if ((curr->kind == IR_GOTO || curr->kind == IR_IF) &&
+                label_run_contains(curr->next, curr->label)) {
 
                 *curr_ptr = curr->next;
                 curr->next = NULL;
@@ -273,6 +368,29 @@ static IRInstr* simplify_control_flow(IRInstr *head) {
                     target = target->next;
                 }
             }
+
+            if (curr->kind == IR_IF) {
+                const char *fwd = forwarded_label(head, curr->label);
+                if (fwd) {
+                    char *lbl = strdup(fwd);
+                    free(curr->label);
+                    curr->label = lbl;
+                    changed = 1;
+                }
+            }
+
+            if (curr->kind == IR_SWITCH) {
+                for (int i = 0; i <= curr->case_count; i++) {
+                    char **slot = i < curr->case_count ? &curr->case_labels[i] : &curr->label;
+                    const char *fwd = forwarded_label(head, *slot);
+                    if (fwd) {
+                        char *lbl = strdup(fwd);
+                        free(*slot);
+                        *slot = lbl;
+                        changed = 1;
+                    }
+                }
+            }
             curr_ptr = &((*curr_ptr)->next);
         }
     }
@@ -287,8 +405,11 @@ static void convert_to_assign(IRInstr *instr, IROperand new_src) {
     if (instr->kind == IR_BINOP) {
         ir_free_operand(&instr->left);
         ir_free_operand(&instr->right);
+        memset(&instr->left, 0, sizeof(IROperand));
+        memset(&instr->right, 0, sizeof(IROperand));
     } else if (instr->kind == IR_UNOP) {
         ir_free_operand(&instr->unop_src);
+        memset(&instr->unop_src, 0, sizeof(IROperand));
     }
     instr->kind = IR_ASSIGN;
     instr->src = src_owned;
@@ -302,6 +423,7 @@ static int fold_unop(IRInstr *instr) {
         switch (instr->unop) {
             case '-': val = -instr->unop_src.const_val; break;
             case '!': val = !instr->unop_src.const_val; break;
+            case '~': val = ~instr->unop_src.const_val; break;
             default: valid = 0; break;
         }
         if (valid) {
@@ -313,6 +435,30 @@ static int fold_unop(IRInstr *instr) {
     return 0;
 }
 
+/* A select with a constant condition, or with equal arms, is a copy. */
+static int fold_select(IRInstr *instr) {
+    if (instr->kind != IR_SELECT) return 0;
+    IROperand *pick = NULL;
+    if (instr->if_left.is_const && instr->if_right.is_const) {
+        pick = eval_relop(instr->if_left.const_val, instr->if_right.const_val, instr->relop) ? &instr->left : &instr->right;
+    } else if (instr->left.is_const ? (instr->right.is_const && instr->left.const_val == instr->right.const_val)
+                                    : (instr->left.name && instr->right.name && !instr->right.is_const &&
+                                       strcmp(instr->left.name, instr->right.name) == 0)) {
+        pick = &instr->left;
+    }
+    if (!pick) return 0;
+
+    IROperand src_owned = ir_op_copy(pick);
+    IROperand *ops[] = { &instr->if_left, &instr->if_right, &instr->left, &instr->right };
+    for (int k = 0; k < 4; k++) {
+        ir_free_operand(ops[k]);
+        memset(ops[k], 0, sizeof(IROperand));
+    }
+    instr->kind = IR_ASSIGN;
+    instr->src = src_owned;
+    return 1;
+}
+
 static int fold_constants(IRInstr *instr) {
     if (instr->kind != IR_BINOP) return 0;
     if (instr->left.is_const && instr->right.is_const) {
@@ -336,6 +482,23 @@ static int fold_constants(IRInstr *instr) {
                     valid = 0;
                 }
                 break;
+            case '&': val = instr->left.const_val & instr->right.const_val; break;
+            case '|': val = instr->left.const_val | instr->right.const_val; break;
+            case '^': val = instr->left.const_val ^ instr->right.const_val; break;
+            case T_SHL: {
+                /* Only shifts whose result is an int fold; the rest run as
+                   the target computes them. */
+                long long v = (long long)instr->left.const_val << (instr->right.const_val & 31);
+                if (instr->right.const_val >= 0 && instr->right.const_val < 32 &&
+                    v >= -2147483647LL - 1 && v <= 2147483647LL) val = (int)v;
+                else valid = 0;
+                break;
+            }
+            case T_SHR:
+                if (instr->right.const_val >= 0 && instr->right.const_val < 32)
+                    val = instr->left.const_val >> instr->right.const_val;
+                else valid = 0;
+                break;
             case '<': val = instr->left.const_val < instr->right.const_val; break;
             case '>': val = instr->left.const_val > instr->right.const_val; break;
             case T_LE: val = instr->left.const_val <= instr->right.const_val; break;
@@ -385,6 +548,40 @@ static int peephole_algebraic(IRInstr *instr) {
                 convert_to_assign(instr, const_op); return 1;
             }
         }
+        if (instr->binop == '%' && instr->right.is_const &&
+            (instr->right.const_val == 1 || instr->right.const_val == -1)) {
+            IROperand const_op; const_op.is_const = 1; const_op.const_val = 0; const_op.name = NULL;
+            convert_to_assign(instr, const_op); return 1;
+        }
+        if (instr->binop == '&' || instr->binop == '|' || instr->binop == '^') {
+            /* x OP 0 and the all-ones mask: identity or absorbing element. */
+            int absorb = instr->binop == '&' ? 0 : -1;
+            int ident = instr->binop == '&' ? -1 : 0;
+            IROperand *k = instr->right.is_const ? &instr->right : (instr->left.is_const ? &instr->left : NULL);
+            IROperand *x = k == &instr->right ? &instr->left : &instr->right;
+            if (k && k->const_val == ident) { convert_to_assign(instr, *x); return 1; }
+            if (k && instr->binop != '^' && k->const_val == absorb) {
+                IROperand const_op; const_op.is_const = 1; const_op.const_val = absorb; const_op.name = NULL;
+                convert_to_assign(instr, const_op); return 1;
+            }
+            if (!instr->left.is_const && !instr->right.is_const && instr->left.name && instr->right.name &&
+                strcmp(instr->left.name, instr->right.name) == 0) {
+                if (instr->binop == '^') {
+                    IROperand const_op; const_op.is_const = 1; const_op.const_val = 0; const_op.name = NULL;
+                    convert_to_assign(instr, const_op);
+                } else {
+                    convert_to_assign(instr, instr->left);
+                }
+                return 1;
+            }
+        }
+        if (instr->binop == T_SHL || instr->binop == T_SHR) {
+            if (instr->right.is_const && instr->right.const_val == 0) { convert_to_assign(instr, instr->left); return 1; }
+            if (instr->left.is_const && instr->left.const_val == 0) {
+                IROperand const_op; const_op.is_const = 1; const_op.const_val = 0; const_op.name = NULL;
+                convert_to_assign(instr, const_op); return 1;
+            }
+        }
     }
     return 0;
 }
@@ -400,6 +597,22 @@ static int strength_reduction(IRInstr *instr) {
             instr->left = ir_op_copy(&instr->right);
             return 1;
         }
+        /* x * 2^k => x << k (shifts are full-width, like mul, so this is exact). */
+        if (instr->left.is_const != instr->right.is_const) {
+            int c = instr->right.is_const ? instr->right.const_val : instr->left.const_val;
+            if (c > 2 && (c & (c - 1)) == 0) {
+                int k = 0;
+                while ((1 << k) != c) k++;
+                if (instr->left.is_const) {
+                    instr->left = instr->right;
+                    instr->right.is_const = 1;
+                    instr->right.name = NULL;
+                }
+                instr->right.const_val = k;
+                instr->binop = T_SHL;
+                return 1;
+            }
+        }
     }
     return 0;
 }
@@ -476,17 +689,22 @@ static void clear_local_structs(ConstVar *c_list, CopyVar *cp_list, ExprNode *e_
     }
 }
 
+static int is_memory_resident_name(const char *name);
+
 static int propagate_constants_and_copies(IRInstr *instr, ConstVar **consts, CopyVar **copies) {
     int changed = 0;
     IROperand *ops[5] = {NULL}; int num_ops = 0;
 
     if (instr->kind == IR_ASSIGN) { ops[0] = &instr->src; num_ops = 1; }
     else if (instr->kind == IR_BINOP) { ops[0] = &instr->left; ops[1] = &instr->right; num_ops = 2; }
-    else if (instr->kind == IR_UNOP) { ops[0] = &instr->unop_src; num_ops = 1; }
+    else if (instr->kind == IR_UNOP && instr->unop != '&') { ops[0] = &instr->unop_src; num_ops = 1; }
     else if (instr->kind == IR_IF) { ops[0] = &instr->if_left; ops[1] = &instr->if_right; num_ops = 2; }
-    else if (instr->kind == IR_RETURN || instr->kind == IR_THROW) { ops[0] = &instr->src; num_ops = 1; }
+    else if (instr->kind == IR_SELECT) {
+        ops[0] = &instr->if_left; ops[1] = &instr->if_right; ops[2] = &instr->left; ops[3] = &instr->right; num_ops = 4;
+    }
+    else if (instr->kind == IR_RETURN || instr->kind == IR_THROW || instr->kind == IR_SWITCH) { ops[0] = &instr->src; num_ops = 1; }
     else if (instr->kind == IR_PARAM) { ops[0] = &instr->src; num_ops = 1; }
-    else if (instr->kind == IR_LOAD) { ops[0] = &instr->base; ops[1] = &instr->index; num_ops = 2; }
+    else if (instr->kind == IR_LOAD || instr->kind == IR_PREFETCH) { ops[0] = &instr->base; ops[1] = &instr->index; num_ops = 2; }
     else if (instr->kind == IR_STORE) { ops[0] = &instr->base; ops[1] = &instr->index; ops[2] = &instr->store_val; num_ops = 3; }
     else if (instr->kind == IR_ALLOCA) { ops[0] = &instr->src; num_ops = 1; }
     else if (instr->kind == IR_CALL_INDIRECT) { ops[0] = &instr->base; num_ops = 1; }
@@ -515,13 +733,52 @@ static int propagate_constants_and_copies(IRInstr *instr, ConstVar **consts, Cop
         invalidate_copies_and_exprs(copies, NULL, instr->result);
 
         if (instr->kind == IR_ASSIGN) {
+            /* A copy out of memory is a load worth keeping: reading the
+               copy again is cheaper than reading the slot again. */
             if (instr->src.is_const) add_const(consts, instr->result, instr->src.const_val);
-            else if (instr->src.name) add_copy(copies, instr->result, instr->src.name);
+            else if (instr->src.name && !is_memory_resident_name(instr->src.name) &&
+                     strcmp(instr->src.name, instr->result) != 0)   /* x := x says nothing */
+                add_copy(copies, instr->result, instr->src.name);
         }
     }
     return changed;
 }
 
+/* Globals and address-taken locals can be written through a pointer or by a
+   callee, so nothing known about them survives a store or a call. */
+static int is_memory_resident_name(const char *name) {
+    if (!name) return 0;
+    Symbol *sym = lookup_all_scopes(name);
+    if (!sym || sym->kind == SYM_FUNCTION || sym->is_array) return 0;
+    return sym->is_address_taken || sym->scope_level == 0;
+}
+
+static void forget_memory_values(ConstVar **consts, CopyVar **copies, ExprNode **exprs) {
+    ConstVar **c = consts;
+    while (*c) {
+        if (is_memory_resident_name((*c)->name)) {
+            ConstVar *tmp = *c; *c = (*c)->next; free(tmp->name); free(tmp);
+        } else { c = &((*c)->next); }
+    }
+    CopyVar **cp = copies;
+    while (*cp) {
+        if (is_memory_resident_name((*cp)->dest) || is_memory_resident_name((*cp)->src)) {
+            CopyVar *tmp = *cp; *cp = (*cp)->next; free(tmp->dest); free(tmp->src); free(tmp);
+        } else { cp = &((*cp)->next); }
+    }
+    ExprNode **e = exprs;
+    while (*e) {
+        if (is_memory_resident_name((*e)->res) || is_memory_resident_name((*e)->l.name) ||
+            is_memory_resident_name((*e)->r.name)) {
+            ExprNode *tmp = *e; *e = (*e)->next;
+            free(tmp->res);
+            if (tmp->l.name) free(tmp->l.name);
+            if (tmp->r.name) free(tmp->r.name);
+            free(tmp);
+        } else { e = &((*e)->next); }
+    }
+}
+
 static int eliminate_cse(IRInstr *instr, ExprNode **exprs) {
     if (instr->kind != IR_BINOP) {
         if (instr->result) invalidate_copies_and_exprs(NULL, exprs, instr->result);
@@ -538,7 +795,8 @@ static int eliminate_cse(IRInstr *instr, ExprNode **exprs) {
 
             int match = left_match && right_match;
             if (!match) {
-                int commutative = (instr->binop == '+' || instr->binop == '*' || instr->binop == T_EQ || instr->binop == T_NEQ);
+                int commutative = (instr->binop == '+' || instr->binop == '*' || instr->binop == '&' || instr->binop == '|' ||
+                                   instr->binop == '^' || instr->binop == T_EQ || instr->binop == T_NEQ);
                 if (commutative) {
                     int left_swap = (e->l.is_const && instr->right.is_const && e->l.const_val == instr->right.const_val) ||
                                     (!e->l.is_const && !instr->right.is_const && e->l.name && instr->right.name && strcmp(e->l.name, instr->right.name) == 0);
@@ -551,6 +809,8 @@ static int eliminate_cse(IRInstr *instr, ExprNode **exprs) {
             if (match) {
                 IROperand src; src.is_const = 0; src.name = strdup(e->res); src.const_val = 0;
                 convert_to_assign(instr, src);
+                /* The result is redefined: drop expressions that read it. */
+                invalidate_copies_and_exprs(NULL, exprs, instr->result);
                 return 1;
             }
         }
@@ -558,7 +818,11 @@ static int eliminate_cse(IRInstr *instr, ExprNode **exprs) {
     }
     if (instr->result) {
         invalidate_copies_and_exprs(NULL, exprs, instr->result);
-        add_expr(exprs, instr->result, instr->left, instr->right, instr->binop);
+        /* `x := x + 1` must not be remembered: x no longer holds its operand. */
+        int self_ref = (instr->left.name && strcmp(instr->left.name, instr->result) == 0) ||
+                       (instr->right.name && strcmp(instr->right.name, instr->result) == 0);
+        if (!self_ref)
+            add_expr(exprs, instr->result, instr->left, instr->right, instr->binop);
     }
     return 0;
 }
@@ -568,6 +832,7 @@ typedef struct StoreRecord {
     char *index;
     int has_const_index;
     int const_index_val;
+    int scale;
     struct StoreRecord *next;
 } StoreRecord;
 
@@ -591,7 +856,9 @@ static void eliminate_dead_stores_local(BasicBlock *bb) {
             int is_dead = 0;
             StoreRecord *s = stores;
             while (s) {
-                if (s->base && instr->base.name && strcmp(s->base, instr->base.name) == 0) {
+                /* Same slot only at the same width: w[3] (scale 8) is not w[3] (scale 4). */
+                if (s->base && instr->base.name && strcmp(s->base, instr->base.name) == 0 &&
+                    s->scale == instr->scale) {
                     if (instr->index.is_const && s->has_const_index) {
                         if (instr->index.const_val == s->const_index_val) {
                             is_dead = 1; break;
@@ -613,6 +880,7 @@ static void eliminate_dead_stores_local(BasicBlock *bb) {
                 ns->base = instr->base.name ? strdup(instr->base.name) : NULL;
                 ns->has_const_index = instr->index.is_const;
                 ns->const_index_val = instr->index.is_const ? instr->index.const_val : 0;
+                ns->scale = instr->scale;
                 ns->index = (instr->index.is_const || !instr->index.name) ? NULL : strdup(instr->index.name);
                 ns->next = stores;
                 stores = ns;
@@ -639,6 +907,24 @@ static void eliminate_dead_stores_local(BasicBlock *bb) {
                 free(tmp);
             }
         }
+
+        /* A later store through a[i] says nothing about an earlier a[i] once
+           i (or the base) has been redefined in between. */
+        if (instr->result) {
+            StoreRecord **s = &stores;
+            while (*s) {
+                if (((*s)->index && strcmp((*s)->index, instr->result) == 0) ||
+                    ((*s)->base && strcmp((*s)->base, instr->result) == 0)) {
+                    StoreRecord *tmp = *s;
+                    *s = (*s)->next;
+                    if (tmp->base) free(tmp->base);
+                    if (tmp->index) free(tmp->index);
+                    free(tmp);
+                } else {
+                    s = &((*s)->next);
+                }
+            }
+        }
     }
 
     IRInstr *new_head = NULL, *new_tail = NULL;
@@ -676,8 +962,11 @@ static void optimize_bb(BasicBlock *bb) {
             changed |= eliminate_cse(curr, &exprs);
             changed |= fold_constants(curr);
             changed |= fold_unop(curr);
+            changed |= fold_select(curr);
             changed |= strength_reduction(curr);
             changed |= peephole_algebraic(curr);
+            if (curr->kind == IR_CALL || curr->kind == IR_CALL_INDIRECT || curr->kind == IR_STORE)
+                forget_memory_values(&consts, &copies, &exprs);
             if (curr == bb->last) break;
             curr = curr->next;
         }
@@ -729,8 +1018,11 @@ static void compute_use_def(BasicBlock *bb) {
         else if (curr->kind == IR_UNOP) { ops[0] = &curr->unop_src; num_ops = 1; }
         else if (curr->kind == IR_PARAM) { ops[0] = &curr->src; num_ops = 1; }
         else if (curr->kind == IR_IF) { ops[0] = &curr->if_left; ops[1] = &curr->if_right; num_ops = 2; }
-        else if (curr->kind == IR_RETURN || curr->kind == IR_THROW) { ops[0] = &curr->src; num_ops = 1; }
-        else if (curr->kind == IR_LOAD) { ops[0] = &curr->base; ops[1] = &curr->index; num_ops = 2; }
+        else if (curr->kind == IR_SELECT) {
+            ops[0] = &curr->if_left; ops[1] = &curr->if_right; ops[2] = &curr->left; ops[3] = &curr->right; num_ops = 4;
+        }
+        else if (curr->kind == IR_RETURN || curr->kind == IR_THROW || curr->kind == IR_SWITCH) { ops[0] = &curr->src; num_ops = 1; }
+        else if (curr->kind == IR_LOAD || curr->kind == IR_PREFETCH) { ops[0] = &curr->base; ops[1] = &curr->index; num_ops = 2; }
         else if (curr->kind == IR_STORE) { ops[0] = &curr->base; ops[1] = &curr->index; ops[2] = &curr->store_val; num_ops = 3; }
         else if (curr->kind == IR_ALLOCA) { ops[0] = &curr->src; num_ops = 1; }
         else if (curr->kind == IR_CALL_INDIRECT) { ops[0] = &curr->base; num_ops = 1; }
@@ -834,8 +1126,12 @@ void eliminate_dead_code(CFG *cfg, CompilerMetrics *metrics) {
                  else if (instr->kind == IR_UNOP) { ops[0] = &instr->unop_src; num_ops = 1; }
                  else if (instr->kind == IR_PARAM) { ops[0] = &instr->src; num_ops = 1; }
                  else if (instr->kind == IR_IF) { ops[0] = &instr->if_left; ops[1] = &instr->if_right; num_ops = 2; }
-                 else if (instr->kind == IR_RETURN) { ops[0] = &instr->src; num_ops = 1; }
-                 else if (instr->kind == IR_LOAD) { ops[0] = &instr->base; ops[1] = &instr->index; num_ops = 2; }
+                 else if (instr->kind == IR_SELECT) {
+                     ops[0] = &instr->if_left; ops[1] = &instr->if_right;
+                     ops[2] = &instr->left; ops[3] = &instr->right; num_ops = 4;
+                 }
+                 else if (instr->kind == IR_RETURN || instr->kind == IR_SWITCH) { ops[0] = &instr->src; num_ops = 1; }
+                 else if (instr->kind == IR_LOAD || instr->kind == IR_PREFETCH) { ops[0] = &instr->base; ops[1] = &instr->index; num_ops = 2; }
                  else if (instr->kind == IR_STORE) { ops[0] = &instr->base; ops[1] = &instr->index; ops[2] = &instr->store_val; num_ops = 3; }
                  else if (instr->kind == IR_ALLOCA) { ops[0] = &instr->src; num_ops = 1; }
                  else if (instr->kind == IR_CALL_INDIRECT) { ops[0] = &instr->base; num_ops = 1; }
@@ -879,21 +1175,28 @@ static void mark_reachable_and_cleanup(CFG *cfg) {
     int *reachable = calloc(cfg->block_count, sizeof(int));
     mark_reachable(cfg->entry, reachable);
 
+    /* Detach dead blocks from live successors first, while every block is
+       still allocated: a dead block may feed another dead block that sits
+       earlier in the list and would already be freed below. */
+    for (BasicBlock *dead = cfg->blocks; dead; dead = dead->next) {
+        if (reachable[dead->id]) continue;
+        for (int i = 0; i < dead->succ_count; i++) {
+            BasicBlock *succ = dead->succs[i];
+            if (!reachable[succ->id]) continue;
+            for (int j = 0; j < succ->pred_count; j++) {
+                if (succ->preds[j] == dead) {
+                    succ->preds[j] = succ->preds[--succ->pred_count];
+                    break;
+                }
+            }
+        }
+    }
+
     BasicBlock **curr = &cfg->blocks;
     while (*curr) {
         if (!reachable[(*curr)->id]) {
             BasicBlock *to_delete = *curr;
             *curr = to_delete->next;
-
-            for (int i = 0; i < to_delete->succ_count; i++) {
-                BasicBlock *succ = to_delete->succs[i];
-                for (int j = 0; j < succ->pred_count; j++) {
-                    if (succ->preds[j] == to_delete) {
-                        succ->preds[j] = succ->preds[--succ->pred_count];
-                        break;
-                    }
-                }
-            }
             
              IRInstr *ins = to_delete->instrs;
              while(ins) {
@@ -1369,10 +1672,18 @@ static void rename_block(BasicBlock *bb, CFG *cfg, RenameState *rs, VarEntry *va
                     rename_operand(&ins->if_left, rs, vars);
                     rename_operand(&ins->if_right, rs, vars);
                     break;
+                case IR_SELECT:
+                    rename_operand(&ins->if_left, rs, vars);
+                    rename_operand(&ins->if_right, rs, vars);
+                    rename_operand(&ins->left, rs, vars);
+                    rename_operand(&ins->right, rs, vars);
+                    break;
                 case IR_RETURN:
+                case IR_SWITCH:
                     rename_operand(&ins->src, rs, vars);
                     break;
                 case IR_LOAD:
+                case IR_PREFETCH:
                     rename_operand(&ins->base, rs, vars);
                     rename_operand(&ins->index, rs, vars);
                     break;
@@ -1594,7 +1905,7 @@ static void insert_copy_before_terminator(BasicBlock *pred_bb,
     }
 
     int is_term = (term->kind == IR_GOTO || term->kind == IR_IF ||
-                   term->kind == IR_RETURN);
+                   term->kind == IR_SWITCH || term->kind == IR_RETURN);
     if (!is_term) {
         /* Append after last */
         term->next    = copy;
@@ -1842,8 +2153,19 @@ void ssa_destruct(CFG *cfg) {
 
 /* --- Loop Invariant Code Motion (LICM) --- */
 
+static int accesses_may_alias(CFG *cfg, IRInstr *x, IRInstr *y);
+
+/* A store into a local array element cannot land on a scalar. */
+static int stores_to_local_array(IRInstr *store) {
+    if (store->base.is_const || !store->base.name) return 0;
+    Symbol *sym = lookup_all_scopes(store->base.name);
+    return sym && sym->is_array && !sym->is_vla && sym->kind != SYM_PARAMETER &&
+           sym->scope_level > 0;
+}
+
 static int is_loop_invariant(IRInstr *instr, int *loop_blocks, int n, CFG *cfg) {
-    if (instr->kind != IR_BINOP && instr->kind != IR_UNOP && instr->kind != IR_ASSIGN && instr->kind != IR_LOAD) return 0;
+    if (instr->kind != IR_BINOP && instr->kind != IR_UNOP && instr->kind != IR_ASSIGN && instr->kind != IR_LOAD &&
+        instr->kind != IR_SELECT) return 0;
 
     if (instr->result) {
         BasicBlock *bb = cfg->blocks;
@@ -1861,12 +2183,15 @@ static int is_loop_invariant(IRInstr *instr, int *loop_blocks, int n, CFG *cfg)
         }
     }
 
-    IROperand *ops[3] = {NULL};
+    IROperand *ops[4] = {NULL};
     int num = 0;
     if (instr->kind == IR_ASSIGN) { ops[0] = &instr->src; num = 1; }
     else if (instr->kind == IR_BINOP) { ops[0] = &instr->left; ops[1] = &instr->right; num = 2; }
     else if (instr->kind == IR_UNOP) { ops[0] = &instr->unop_src; num = 1; }
     else if (instr->kind == IR_LOAD) { ops[0] = &instr->base; ops[1] = &instr->index; num = 2; }
+    else if (instr->kind == IR_SELECT) {
+        ops[0] = &instr->if_left; ops[1] = &instr->if_right; ops[2] = &instr->left; ops[3] = &instr->right; num = 4;
+    }
 
     for (int i = 0; i < num; i++) {
         if (!ops[i]->is_const && ops[i]->name) {
@@ -1885,14 +2210,23 @@ static int is_loop_invariant(IRInstr *instr, int *loop_blocks, int n, CFG *cfg)
         }
     }
 
-    if (instr->kind == IR_LOAD) {
+    /* A name living in memory changes under calls and stores, whatever
+       the loop's own definitions say; taking its address reads nothing. */
+    int reads_memory = 0;
+    if (!(instr->kind == IR_UNOP && instr->unop == '&'))
+        for (int i = 0; i < num; i++)
+            if (!ops[i]->is_const && is_memory_resident_name(ops[i]->name)) reads_memory = 1;
+
+    if (instr->kind == IR_LOAD || reads_memory) {
         int has_store = 0;
         BasicBlock *bb = cfg->blocks;
         while (bb) {
             if (loop_blocks[bb->id]) {
                 IRInstr *check = bb->instrs;
                 while (check) {
-                    if (check->kind == IR_STORE) {
+                    if (check->kind == IR_STORE &&
+                        ((instr->kind == IR_LOAD && accesses_may_alias(cfg, check, instr)) ||
+                         (reads_memory && !stores_to_local_array(check)))) {
                         has_store = 1;
                     }
                     if (check->kind == IR_CALL || check->kind == IR_CALL_INDIRECT) {
@@ -1909,96 +2243,98 @@ static int is_loop_invariant(IRInstr *instr, int *loop_blocks, int n, CFG *cfg)
     return 1;
 }
 
+static int compute_natural_loop(BasicBlock *header, BasicBlock *latch, int *loop_blocks, CFG *cfg);
+static BasicBlock* find_preheader(BasicBlock *h, int *loop_blocks);
+
 void optimize_loops(CFG *cfg) {
     if (!cfg) return;
     compute_dominators(cfg);
+    compute_liveness(cfg);
 
-    BasicBlock *b = cfg->blocks;
-    while (b) {
-        for (int i = 0; i < b->succ_count; i++) {
-            BasicBlock *h = b->succs[i];
-            if (b->doms[h->id]) {
-                int *loop_blocks = calloc(cfg->block_count, sizeof(int));
-                loop_blocks[h->id] = 1;
-
-                BasicBlock **stack = malloc(cfg->block_count * sizeof(BasicBlock*));
-                int top = 0;
-
-                if (b != h) {
-                    loop_blocks[b->id] = 1;
-                    stack[top++] = b;
-                }
-
-                while (top > 0) {
-                    BasicBlock *m = stack[--top];
-                    for (int k = 0; k < m->pred_count; k++) {
-                        BasicBlock *p = m->preds[k];
-                        if (!loop_blocks[p->id]) {
-                            loop_blocks[p->id] = 1;
-                            stack[top++] = p;
-                        }
-                    }
-                }
-                free(stack);
+    int *one_latch = malloc(sizeof(int) * cfg->block_count);
+    for (BasicBlock *h = cfg->blocks; h; h = h->next) {
+        /* Every back edge into h belongs to the same loop: a body with
+           several latches (continue, switch arms) is one loop, not many. */
+        int *loop_blocks = calloc(cfg->block_count, sizeof(int));
+        int has_latch = 0;
+        for (int k = 0; k < h->pred_count; k++) {
+            BasicBlock *latch = h->preds[k];
+            if (!latch->doms || !latch->doms[h->id]) continue;
+            compute_natural_loop(h, latch, one_latch, cfg);
+            for (int m = 0; m < cfg->block_count; m++) loop_blocks[m] |= one_latch[m];
+            has_latch = 1;
+        }
 
-                BasicBlock *pre = NULL;
-                for (int p = 0; p < h->pred_count; p++) {
-                    if (!loop_blocks[h->preds[p]->id]) {
-                        pre = h->preds[p];
-                        break;
-                    }
-                }
+        BasicBlock *pre = has_latch ? find_preheader(h, loop_blocks) : NULL;
 
-                if (pre) {
-                    BasicBlock *lb = cfg->blocks;
-                    while (lb) {
-                        if (loop_blocks[lb->id]) {
-                            IRInstr *curr_ins = lb->instrs;
-                            IRInstr *prev_ins = NULL;
-                            while (curr_ins) {
-                                IRInstr *next_ins = curr_ins->next;
-                                if (curr_ins->kind != IR_GOTO && curr_ins->kind != IR_IF && is_loop_invariant(curr_ins, loop_blocks, cfg->block_count, cfg)) {
-                                    if (prev_ins) prev_ins->next = next_ins;
-                                    else lb->instrs = next_ins;
-
-                                    if (curr_ins == lb->last) lb->last = prev_ins;
-
-                                    IRInstr *pcur = pre->instrs, *pprev = NULL;
-                                    while (pcur && pcur != pre->last) { pprev = pcur; pcur = pcur->next; }
-                                    if (!pcur) {
-                                        pre->instrs = curr_ins;
-                                        curr_ins->next = NULL;
-                                        pre->last = curr_ins;
-                                    } else {
-                                        if (pcur->kind == IR_GOTO || pcur->kind == IR_IF || pcur->kind == IR_RETURN) {
-                                            if (pprev) { pprev->next = curr_ins; curr_ins->next = pcur; }
-                                            else { pre->instrs = curr_ins; curr_ins->next = pcur; }
-                                        } else {
-                                            pcur->next = curr_ins;
-                                            curr_ins->next = NULL;
-                                            pre->last = curr_ins;
-                                        }
-                                    }
+        if (pre) {
+            BasicBlock *lb = cfg->blocks;
+            while (lb) {
+                if (loop_blocks[lb->id]) {
+                    IRInstr *curr_ins = lb->instrs;
+                    IRInstr *prev_ins = NULL;
+                    while (curr_ins) {
+                        IRInstr *next_ins = curr_ins->next;
+                        /* A result live into the header carries a value across
+                           iterations (or from before the loop): hoisting its
+                           definition would clobber that value. */
+                        int carried = curr_ins->result &&
+                                      set_contains(h->live_in, h->live_in_count, curr_ins->result);
+                        if (curr_ins->kind != IR_GOTO && curr_ins->kind != IR_IF && !carried &&
+                            is_loop_invariant(curr_ins, loop_blocks, cfg->block_count, cfg)) {
+                            if (prev_ins) prev_ins->next = next_ins;
+                            else lb->instrs = next_ins;
+
+                            if (curr_ins == lb->last) lb->last = prev_ins;
+
+                            IRInstr *pcur = pre->instrs, *pprev = NULL;
+                            while (pcur && pcur != pre->last) { pprev = pcur; pcur = pcur->next; }
+                            if (!pcur) {
+                                pre->instrs = curr_ins;
+                                curr_ins->next = NULL;
+                                pre->last = curr_ins;
+                            } else {
+                                if (pcur->kind == IR_GOTO || pcur->kind == IR_IF || pcur->kind == IR_SWITCH ||
+                                    pcur->kind == IR_RETURN) {
+                                    if (pprev) { pprev->next = curr_ins; curr_ins->next = pcur; }
+                                    else { pre->instrs = curr_ins; curr_ins->next = pcur; }
                                 } else {
-                                    prev_ins = curr_ins;
+                                    pcur->next = curr_ins;
+                                    curr_ins->next = NULL;
+                                    pre->last = curr_ins;
                                 }
-                                if (curr_ins == lb->last) break;
-                                curr_ins = next_ins;
                             }
+                        } else {
+                            prev_ins = curr_ins;
                         }
-                        lb = lb->next;
+                        if (curr_ins == lb->last) break;
+                        curr_ins = next_ins;
                     }
                 }
-                free(loop_blocks);
+                lb = lb->next;
             }
         }
-        b = b->next;
+        free(loop_blocks);
     }
+    free(one_latch);
 }
 
 /* --- Loop Unrolling --- */
 
-#define MAX_FULL_UNROLL_INSTRUCTIONS 200000
+/* Full unrolling of constant-trip loops: innermost loops only (an outer
+   loop is never copied whole), at most MAX_FULL_UNROLL_INSTRUCTIONS in the
+   unrolled code, and at most MAX_FULL_UNROLL_GROWTH instructions added per
+   function. Labels and jumps, which merge away between the copies, are not
+   counted. The passes that run afterwards are not linear in block size. */
+#define MAX_FULL_UNROLL_INSTRUCTIONS 640
+#define MAX_FULL_UNROLL_GROWTH       1024
+
+/* Runtime-trip-count unrolling: bodies up to SMALL are unrolled x4, up to
+   MAX x2. Loops touching more than MAX_LIVE distinct names are left alone
+   (or capped at x2) so the copies do not push the allocator into spilling. */
+#define RUNTIME_UNROLL_SMALL_BODY 12
+#define RUNTIME_UNROLL_MAX_BODY   40
+#define RUNTIME_UNROLL_MAX_LIVE   12
 
 static IRInstr* clone_instr(IRInstr *src) {
     if (!src) return NULL;
@@ -2022,6 +2358,15 @@ static IRInstr* clone_instr(IRInstr *src) {
     if (src->if_left.name) dup->if_left.name = strdup(src->if_left.name);
     if (src->if_right.name) dup->if_right.name = strdup(src->if_right.name);
 
+    if (src->case_count > 0) {
+        dup->case_vals = malloc(sizeof(int) * src->case_count);
+        dup->case_labels = malloc(sizeof(char *) * src->case_count);
+        for (int i = 0; i < src->case_count; i++) {
+            dup->case_vals[i] = src->case_vals[i];
+            dup->case_labels[i] = strdup(src->case_labels[i]);
+        }
+    }
+
     return dup;
 }
 
@@ -2084,6 +2429,18 @@ static int is_name_defined_in_loop(const char *name, int *loop_blocks, CFG *cfg)
     return 0;
 }
 
+/* Can a store or call in the loop change a global or address-taken name? */
+static int loop_writes_memory(int *loop_blocks, CFG *cfg) {
+    for (BasicBlock *bb = cfg->blocks; bb; bb = bb->next) {
+        if (!loop_blocks[bb->id]) continue;
+        for (IRInstr *cur = bb->instrs; cur; cur = cur->next) {
+            if (cur->kind == IR_CALL || cur->kind == IR_CALL_INDIRECT || cur->kind == IR_STORE) return 1;
+            if (cur == bb->last) break;
+        }
+    }
+    return 0;
+}
+
 static IRRelop swap_relop(IRRelop relop) {
     switch (relop) {
         case IR_LT: return IR_GT;
@@ -2096,20 +2453,6 @@ static IRRelop swap_relop(IRRelop relop) {
     }
 }
 
-static int get_initial_value_from_block(BasicBlock *bb, const char *name, int *value) {
-    if (!bb || !name || !value) return 0;
-    IRInstr *last = NULL;
-    IRInstr *cur = bb->instrs;
-    while (cur) {
-        if (cur->result && strcmp(cur->result, name) == 0) last = cur;
-        if (cur == bb->last) break;
-        cur = cur->next;
-    }
-    if (!last || last->kind != IR_ASSIGN || !last->src.is_const) return 0;
-    *value = last->src.const_val;
-    return 1;
-}
-
 static BasicBlock* find_preheader(BasicBlock *h, int *loop_blocks) {
     if (!h || !loop_blocks) return NULL;
     BasicBlock *preheader = NULL;
@@ -2146,6 +2489,17 @@ static int find_loop_entry_exit(BasicBlock *h, int *loop_blocks, BasicBlock **bo
     return 1;
 }
 
+/* Label to jump to when leaving the loop through exit_block. ir_gen lowers
+   the loop test as `if cond goto body; goto end`, so the exit is usually an
+   unlabeled trampoline holding a single goto; jump straight to its target. */
+static const char* loop_exit_label(BasicBlock *exit_block) {
+    if (!exit_block || !exit_block->instrs) return NULL;
+    IRInstr *first = exit_block->instrs;
+    if (first->kind == IR_LABEL) return first->label;
+    if (first->kind == IR_GOTO && first == exit_block->last) return first->label;
+    return NULL;
+}
+
 static int has_side_exits(BasicBlock *header, int *loop_blocks, CFG *cfg, BasicBlock *exit_block) {
     if (!header || !loop_blocks || !cfg || !exit_block) return 1;
     BasicBlock *bb = cfg->blocks;
@@ -2165,113 +2519,6 @@ static int has_side_exits(BasicBlock *header, int *loop_blocks, CFG *cfg, BasicB
     return 0;
 }
 
-static int extract_delta_from_binop(IRInstr *ins, const char *ind_var, int *delta_out) {
-    if (!ins || ins->kind != IR_BINOP || !ind_var || !delta_out) return 0;
-    if (!ins->left.is_const && ins->left.name && strcmp(ins->left.name, ind_var) == 0 && ins->right.is_const && ins->binop == '+') {
-        *delta_out = ins->right.const_val;
-        return 1;
-    }
-    if (!ins->right.is_const && ins->right.name && strcmp(ins->right.name, ind_var) == 0 && ins->left.is_const && ins->binop == '+') {
-        *delta_out = ins->left.const_val;
-        return 1;
-    }
-    if (!ins->left.is_const && ins->left.name && strcmp(ins->left.name, ind_var) == 0 && ins->right.is_const && ins->binop == '-') {
-        *delta_out = -ins->right.const_val;
-        return 1;
-    }
-    return 0;
-}
-
-static int resolve_temp_based_delta(const char *temp_name, const char *ind_var, int *loop_blocks, CFG *cfg, int *delta_out) {
-    if (!temp_name || !ind_var || !loop_blocks || !cfg || !delta_out) return 0;
-    IRInstr *def = NULL;
-    BasicBlock *sb = cfg->blocks;
-    while (sb) {
-        if (loop_blocks[sb->id]) {
-            IRInstr *sc = sb->instrs;
-            while (sc) {
-                if (sc->result && strcmp(sc->result, temp_name) == 0) {
-                    int delta = 0;
-                    if (!extract_delta_from_binop(sc, ind_var, &delta)) return 0;
-                    if (def) return 0;
-                    def = sc;
-                    *delta_out = delta;
-                }
-                if (sc == sb->last) break;
-                sc = sc->next;
-            }
-        }
-        sb = sb->next;
-    }
-    return def != NULL;
-}
-
-static int compute_loop_step(int *loop_blocks, CFG *cfg, const char *ivar, int *step_out) {
-    if (!loop_blocks || !cfg || !ivar || !step_out) return 0;
-
-    IRInstr *update = NULL;
-
-    BasicBlock *bb = cfg->blocks;
-    while (bb) {
-        if (loop_blocks[bb->id]) {
-            IRInstr *cur = bb->instrs;
-            while (cur) {
-                if (cur->result && strcmp(cur->result, ivar) == 0) {
-                    int delta = 0;
-                    int matched = 0;
-                    if (cur->kind == IR_BINOP) {
-                        matched = extract_delta_from_binop(cur, ivar, &delta);
-                    } else if (cur->kind == IR_ASSIGN && !cur->src.is_const && cur->src.name) {
-                        matched = resolve_temp_based_delta(cur->src.name, ivar, loop_blocks, cfg, &delta);
-                    } else {
-                        return 0;
-                    }
-
-                    if (!matched || delta == 0) return 0;
-                    if (update) return 0;
-                    update = cur;
-                    *step_out = delta;
-                }
-                if (cur == bb->last) break;
-                cur = cur->next;
-            }
-        }
-        bb = bb->next;
-    }
-    return update != NULL;
-}
-
-static int resolve_operand_to_const(IROperand *op, BasicBlock *preheader, int *loop_blocks, CFG *cfg, int *value_out) {
-    if (!op || !preheader || !loop_blocks || !cfg || !value_out) return 0;
-    if (op->is_const) {
-        *value_out = op->const_val;
-        return 1;
-    }
-    if (!op->name) return 0;
-    if (is_name_defined_in_loop(op->name, loop_blocks, cfg)) return 0;
-    return get_initial_value_from_block(preheader, op->name, value_out);
-}
-
-static int extract_induction_condition(IRInstr *if_instr, BasicBlock *preheader, int *loop_blocks, CFG *cfg,
-                                      const char **ivar_out, int *bound_out, IRRelop *relop_out) {
-    if (!if_instr || if_instr->kind != IR_IF || !ivar_out || !bound_out || !relop_out) return 0;
-
-    int bound = 0;
-    if (if_instr->if_left.name && resolve_operand_to_const(&if_instr->if_right, preheader, loop_blocks, cfg, &bound)) {
-        *ivar_out = if_instr->if_left.name;
-        *bound_out = bound;
-        *relop_out = if_instr->relop;
-        return 1;
-    }
-    if (if_instr->if_right.name && resolve_operand_to_const(&if_instr->if_left, preheader, loop_blocks, cfg, &bound)) {
-        *ivar_out = if_instr->if_right.name;
-        *bound_out = bound;
-        *relop_out = swap_relop(if_instr->relop);
-        return 1;
-    }
-    return 0;
-}
-
 static int compute_trip_count(int init, int bound, int step, IRRelop relop, long *trip_out) {
     if (!trip_out || step == 0) return 0;
 
@@ -2535,6 +2782,17 @@ static int count_loop_body_instrs(BasicBlock **body_blocks, int body_count) {
     return total;
 }
 
+/* Instructions one unrolled copy of the body keeps once its blocks merge. */
+static int count_unrolled_copy_instrs(BasicBlock **body_blocks, int body_count) {
+    int total = 0;
+    for (int i = 0; i < body_count; i++) {
+        BasicBlock *bb = body_blocks[i];
+        for (IRInstr *cur = bb->instrs; cur; cur = (cur == bb->last) ? NULL : cur->next)
+            if (cur->kind != IR_LABEL && cur->kind != IR_GOTO) total++;
+    }
+    return total;
+}
+
 static int find_block_index(BasicBlock **blocks, int count, BasicBlock *target) {
     for (int i = 0; i < count; i++) {
         if (blocks[i] == target) return i;
@@ -2549,6 +2807,8 @@ static int build_body_block_list(CFG *cfg, int *loop_blocks, BasicBlock *header,
     while (bb) {
         if (loop_blocks[bb->id] && bb != header) {
             if (n >= max_count) return 0;
+            /* Copying a multiway dispatch (and its jump table) is never worth it. */
+            if (bb->last && bb->last->kind == IR_SWITCH) return 0;
             out_blocks[n++] = bb;
         }
         bb = bb->next;
@@ -2557,475 +2817,5125 @@ static int build_body_block_list(CFG *cfg, int *loop_blocks, BasicBlock *header,
 }
 
 
-/* --- Induction Variable Elimination (IVE) --- */
+/* --- Runtime Trip-Count Unrolling ---
+ *
+ * For a counted innermost loop whose bound is only known at run time,
+ *
+ *     L0: if i < n goto body        (body updates i by a constant step)
+ *
+ * emit an unrolled copy in front of the original loop:
+ *
+ *         lim := n - (N-1)*step
+ *     Lu: if i >= lim goto L0       (fewer than N iterations left)
+ *         body; body; ... (N copies, no tests in between)
+ *         goto Lu
+ *     L0: original loop             (runs the 0..N-1 remainder iterations)
+ *
+ * The preheader is redirected to the new code. Like the full unroller this
+ * only rewrites the header's instruction list; the CFG is rebuilt later.
+ */
 
-typedef struct {
-    char *name;
-    char *base_iv;
-    int multiplier;
-    int offset;
-    int is_basic;
-    int delta;
-} InductionVar;
-
-static int iv_name_match(const char *name1, const char *name2) {
-    if (!name1 || !name2) return 0;
-    const char *p1 = strchr(name1, '.');
-    const char *p2 = strchr(name2, '.');
-    int len1 = p1 ? (int)(p1 - name1) : (int)strlen(name1);
-    int len2 = p2 ? (int)(p2 - name2) : (int)strlen(name2);
-    if (len1 != len2) return 0;
-    return strncmp(name1, name2, len1) == 0;
-}
-
-static InductionVar* find_iv(InductionVar *ivs, int count, const char *name) {
-    if (!name) return NULL;
-    for (int i = 0; i < count; i++) {
-        if (iv_name_match(ivs[i].name, name)) return &ivs[i];
+static int loop_is_innermost(BasicBlock *h, int *loop_blocks, CFG *cfg) {
+    for (BasicBlock *bb = cfg->blocks; bb; bb = bb->next) {
+        if (!loop_blocks[bb->id] || bb == h) continue;
+        for (int i = 0; i < bb->pred_count; i++) {
+            BasicBlock *p = bb->preds[i];
+            if (p->doms && p->doms[bb->id]) return 0;
+        }
     }
-    return NULL;
+    return 1;
 }
 
+static IRInstr* find_unique_def_in_loop(const char *name, int *loop_blocks, CFG *cfg, BasicBlock **block_out) {
+    IRInstr *def = NULL;
+    for (BasicBlock *bb = cfg->blocks; bb; bb = bb->next) {
+        if (!loop_blocks[bb->id]) continue;
+        IRInstr *cur = bb->instrs;
+        while (cur) {
+            if (cur->result && strcmp(cur->result, name) == 0) {
+                if (def) return NULL;
+                def = cur;
+                if (block_out) *block_out = bb;
+            }
+            if (cur == bb->last) break;
+            cur = cur->next;
+        }
+    }
+    return def;
+}
 
-static void __attribute__((unused)) induction_variable_elimination(CFG *cfg) {
-    if (!cfg) return;
-    compute_dominators(cfg);
+static int count_loop_live_names(int *loop_blocks, CFG *cfg) {
+    char **names = NULL;
+    int count = 0;
+    for (BasicBlock *bb = cfg->blocks; bb; bb = bb->next) {
+        if (!loop_blocks[bb->id]) continue;
+        IRInstr *cur = bb->instrs;
+        while (cur) {
+            IROperand *ops[] = { &cur->src, &cur->left, &cur->right, &cur->unop_src, &cur->base,
+                                 &cur->index, &cur->store_val, &cur->if_left, &cur->if_right };
+            for (int k = 0; k < 9; k++) {
+                const char *n = ops[k]->name;
+                if (!n || ops[k]->is_const || strncmp(n, ".LC", 3) == 0) continue;
+                if (!set_contains(names, count, n)) set_add(&names, &count, n);
+            }
+            if (cur == bb->last) break;
+            cur = cur->next;
+        }
+    }
+    set_free(names, count);
+    return count;
+}
 
-    BasicBlock *b = cfg->blocks;
-    while (b) {
-        for (int j = 0; j < b->succ_count; j++) {
-            BasicBlock *h = b->succs[j];
-            if (!b->doms[h->id]) continue; /* only back-edges: h dominates b */
+/* Symbol behind an IR name. Locals of nested blocks sit below the function
+   scope, so fall back to the global list (IR names are unique). */
+static Symbol* lookup_ir_name(const char *name, Scope *scope) {
+    Symbol *sym = scope ? lookup_in_scope(scope, name) : NULL;
+    return sym ? sym : lookup_all_scopes(name);
+}
 
-            int *loop_blocks = calloc(cfg->block_count + 1, sizeof(int));
-            if (!loop_blocks) continue;
+static int is_register_candidate_name(const char *name, Scope *scope) {
+    if (!name) return 1;
+    Symbol *sym = lookup_ir_name(name, scope);
+    if (!sym) return 1;
+    return !sym->is_address_taken && sym->scope_level != 0;
+}
 
-            if (!compute_natural_loop(h, b, loop_blocks, cfg)) {
-                free(loop_blocks);
-                continue;
+/* --- Memory Disambiguation ---
+ *
+ * Whether two loads/stores can touch the same memory, judged by their
+ * base names. A local array nobody took the address of (int *p = &a) is
+ * a block only its own name reaches. Distinct global arrays are distinct
+ * blocks. Pointers and array parameters may point anywhere, except that
+ * two pointers each holding what one malloc call returned do not overlap.
+ * Beyond that, the copy of a versioned loop carries alias sets: its
+ * accesses were checked apart at run time (see Loop Versioning).
+ */
+
+/* Unique definition of name in the function, or NULL. */
+static IRInstr* unique_def(CFG *cfg, const char *name) {
+    IRInstr *def = NULL;
+    for (BasicBlock *b = cfg->blocks; b; b = b->next)
+        for (IRInstr *i = b->instrs; i; i = (i == b->last) ? NULL : i->next)
+            if (i->result && strcmp(i->result, name) == 0) {
+                if (def) return NULL;
+                def = i;
+            }
+    return def;
+}
+
+/* A pointer whose only value is what one malloc call returned. Two such
+   pointers with different names point into different blocks. */
+static int holds_fresh_alloc(CFG *cfg, const char *name, Scope *scope) {
+    if (!is_register_candidate_name(name, scope)) return 0;
+    IRInstr *def = unique_def(cfg, name);
+    if (def && def->kind == IR_ASSIGN && !def->src.is_const && def->src.name)
+        def = unique_def(cfg, def->src.name);
+    return def && def->kind == IR_CALL && def->call_fn && strcmp(def->call_fn, "malloc") == 0;
+}
+
+/* Storage of its own (a local or global array, a VLA), not a pointer. */
+static int is_array_object(Symbol *sym) {
+    return sym && sym->is_array && sym->kind != SYM_PARAMETER;
+}
+
+static int bases_may_alias(CFG *cfg, Scope *scope, const char *a, const char *b) {
+    if (strcmp(a, b) == 0) return 1;
+    Symbol *sa = lookup_ir_name(a, scope), *sb = lookup_ir_name(b, scope);
+    if (is_array_object(sa) && is_array_object(sb)) return 0;
+    if ((is_array_object(sa) && sa->scope_level > 0 && !sa->is_address_taken) ||
+        (is_array_object(sb) && sb->scope_level > 0 && !sb->is_address_taken))
+        return 0;
+    return !(holds_fresh_alloc(cfg, a, scope) && holds_fresh_alloc(cfg, b, scope));
+}
+
+static int accesses_may_alias(CFG *cfg, IRInstr *x, IRInstr *y) {
+    if (x->alias_set && y->alias_set && x->alias_set != y->alias_set) return 0;
+    if (x->base.is_const || !x->base.name || y->base.is_const || !y->base.name) return 1;
+    Symbol *fsym = lookup(cfg->func_name);
+    Scope *scope = (fsym && fsym->kind == SYM_FUNCTION) ? fsym->scope : NULL;
+    return bases_may_alias(cfg, scope, x->base.name, y->base.name);
+}
+
+/* --- Scalar Evolution ---
+ *
+ * How values change from one iteration of a loop to the next. A scan
+ * over the loop's code follows every name holding an affine value
+ *
+ *     coef * i + k + off      i the induction variable, as it was where
+ *                             the scan started; k a loop-invariant name
+ *
+ * through copies, temps, sums and differences, products and left shifts
+ * by constants, and negation. Over a whole loop, a name i is an
+ * add-recurrence {start, +, step} when the blocks every iteration runs
+ * once (those dominating each latch, outside inner loops) move it by a
+ * constant, however many updates and temps that takes, and no other block
+ * of the loop writes it. start is the constant i holds on entry
+ * when the straight-line code before the loop sets one; otherwise it is
+ * symbolic, i as read in the preheader.
+ *
+ * scev_counter() reads the loop test with this: which operand is the
+ * counter, its step, the invariant bound and the keep-iterating relation.
+ * The unrollers, match_counted_loop (vectorizer, idioms, versioning,
+ * reversal) and IV strength reduction all start from it, so decrementing
+ * counters, steps other than one and updates through temps come out the
+ * same as i = i + 1.
+ */
+
+#define SCEV_MAX_COEF  (1 << 20)
+#define SCEV_MAX_WALK  8    /* single-predecessor blocks searched for a start */
+
+typedef struct SCEVValue {
+    char *name;
+    int coef;
+    char *sym;          /* loop-invariant name, or NULL */
+    int off;
+    struct SCEVValue *next;
+} SCEVValue;
+
+/* Names known at the current point of a scan. */
+typedef struct {
+    SCEVValue *vals;
+    CFG *cfg;
+    int *loop_blocks;   /* names written here are not invariant */
+    Scope *scope;
+    char **unstable;    /* also written in blocks the scan skips */
+    int unstable_count;
+} SCEVScan;
+
+static SCEVValue* scev_find(SCEVScan *s, const char *name) {
+    for (SCEVValue *v = s->vals; v; v = v->next)
+        if (strcmp(v->name, name) == 0) return v;
+    return NULL;
+}
+
+static void scev_kill(SCEVScan *s, const char *name) {
+    for (SCEVValue **p = &s->vals; *p; p = &(*p)->next) {
+        if (strcmp((*p)->name, name) != 0) continue;
+        SCEVValue *v = *p;
+        *p = v->next;
+        free(v->name);
+        free(v->sym);
+        free(v);
+        return;
+    }
+}
+
+static void scev_set(SCEVScan *s, const char *name, int coef, const char *sym, int off) {
+    char *copy = sym ? strdup(sym) : NULL;      /* sym may be the old value's */
+    SCEVValue *v = scev_find(s, name);
+    if (!v) {
+        v = calloc(1, sizeof(SCEVValue));
+        v->name = strdup(name);
+        v->next = s->vals;
+        s->vals = v;
+    }
+    free(v->sym);
+    v->coef = coef;
+    v->sym = copy;
+    v->off = off;
+}
+
+/* Start a scan at a point where iv holds i itself. */
+static void scev_begin(SCEVScan *s, CFG *cfg, int *loop_blocks, const char *iv) {
+    memset(s, 0, sizeof(*s));
+    s->cfg = cfg;
+    s->loop_blocks = loop_blocks;
+    Symbol *fsym = lookup(cfg->func_name);
+    s->scope = (fsym && fsym->kind == SYM_FUNCTION) ? fsym->scope : NULL;
+    if (iv) scev_set(s, iv, 1, NULL, 0);
+}
+
+static void scev_end(SCEVScan *s) {
+    while (s->vals) scev_kill(s, s->vals->name);
+    set_free(s->unstable, s->unstable_count);
+    s->unstable = NULL;
+    s->unstable_count = 0;
+}
+
+static int scev_operand(SCEVScan *s, IROperand *op, SCEVValue *out) {
+    memset(out, 0, sizeof(*out));
+    if (op->is_const) {
+        out->off = op->const_val;
+        return 1;
+    }
+    if (!op->name) return 0;
+    SCEVValue *v = scev_find(s, op->name);
+    if (v) {
+        *out = *v;
+        return 1;
+    }
+    if (strncmp(op->name, ".LC", 3) == 0 || !is_register_candidate_name(op->name, s->scope) ||
+        set_contains(s->unstable, s->unstable_count, op->name) ||
+        is_name_defined_in_loop(op->name, s->loop_blocks, s->cfg))
+        return 0;
+    Symbol *sym = lookup_ir_name(op->name, s->scope);
+    if (sym && (sym->is_array || sym->kind == SYM_FUNCTION)) return 0;
+    out->sym = op->name;
+    return 1;
+}
+
+static int scev_fits(long long coef, long long off, SCEVValue *out) {
+    if (coef > SCEV_MAX_COEF || coef < -SCEV_MAX_COEF || off > INT_MAX || off < INT_MIN) return 0;
+    out->coef = (int)coef;
+    out->off = (int)off;
+    return 1;
+}
+
+/* The affine value `ins` computes, if it has one. */
+static int scev_eval(SCEVScan *s, IRInstr *ins, SCEVValue *out) {
+    SCEVValue a, b;
+    if (ins->kind == IR_ASSIGN) return scev_operand(s, &ins->src, out);
+    if (ins->kind == IR_UNOP) {
+        if (ins->unop != '-' || !scev_operand(s, &ins->unop_src, &a) || a.sym) return 0;
+        *out = a;
+        return scev_fits(-(long long)a.coef, -(long long)a.off, out);
+    }
+    if (ins->kind != IR_BINOP || !scev_operand(s, &ins->left, &a) || !scev_operand(s, &ins->right, &b))
+        return 0;
+    memset(out, 0, sizeof(*out));
+    switch (ins->binop) {
+        case '+':
+            if (a.sym && b.sym) return 0;
+            out->sym = a.sym ? a.sym : b.sym;
+            return scev_fits((long long)a.coef + b.coef, (long long)a.off + b.off, out);
+        case '-':
+            if (b.sym) return 0;
+            out->sym = a.sym;
+            return scev_fits((long long)a.coef - b.coef, (long long)a.off - b.off, out);
+        case '*':
+            if (a.coef == 0 && !a.sym) { SCEVValue t = a; a = b; b = t; }
+            if (b.coef != 0 || b.sym || (a.sym && b.off != 1)) return 0;
+            out->sym = a.sym;
+            return scev_fits((long long)a.coef * b.off, (long long)a.off * b.off, out);
+        case T_SHL:
+            if (b.coef != 0 || b.sym || b.off < 0 || b.off > 20 || (a.sym && b.off != 0)) return 0;
+            out->sym = a.sym;
+            return scev_fits((long long)a.coef << b.off, (long long)a.off * (1LL << b.off), out);
+        default:
+            return 0;
+    }
+}
+
+/* Step the scan over one instruction. */
+static void scev_transfer(SCEVScan *s, IRInstr *ins) {
+    if (!ins->result) return;
+    SCEVValue v;
+    if (!set_contains(s->unstable, s->unstable_count, ins->result) &&
+        is_register_candidate_name(ins->result, s->scope) && scev_eval(s, ins, &v))
+        scev_set(s, ins->result, v.coef, v.sym, v.off);
+    else
+        scev_kill(s, ins->result);
+}
+
+/* Every block of the loop at h, whichever back edge it leads to. */
+static int* scev_whole_loop(CFG *cfg, BasicBlock *h) {
+    int *loop = calloc(cfg->block_count, sizeof(int));
+    int *one = malloc(sizeof(int) * cfg->block_count);
+    for (int i = 0; i < h->pred_count; i++) {
+        BasicBlock *p = h->preds[i];
+        if (!p->doms || !p->doms[h->id]) continue;
+        compute_natural_loop(h, p, one, cfg);
+        for (int m = 0; m < cfg->block_count; m++) loop[m] |= one[m];
+    }
+    free(one);
+    return loop;
+}
+
+/* Step of iv per trip around the loop at h, or 0. */
+static int scev_loop_step(CFG *cfg, BasicBlock *h, int *loop, const char *iv) {
+    /* Blocks of inner loops may run any number of times per iteration. */
+    int *inner = calloc(cfg->block_count, sizeof(int));
+    int *one = malloc(sizeof(int) * cfg->block_count);
+    for (BasicBlock *bb = cfg->blocks; bb; bb = bb->next) {
+        if (!loop[bb->id] || bb == h) continue;
+        for (int i = 0; i < bb->pred_count; i++) {
+            BasicBlock *p = bb->preds[i];
+            if (!loop[p->id] || !p->doms || !p->doms[bb->id]) continue;
+            compute_natural_loop(bb, p, one, cfg);
+            for (int m = 0; m < cfg->block_count; m++) inner[m] |= one[m];
+        }
+    }
+    free(one);
+
+    /* The blocks every iteration runs once (they dominate each latch), in
+       dominance order; whatever the others write is unknown to the scan. */
+    SCEVScan s;
+    scev_begin(&s, cfg, loop, iv);
+    BasicBlock **chain = malloc(sizeof(BasicBlock *) * cfg->block_count);
+    int *depth = malloc(sizeof(int) * cfg->block_count);
+    int n = 0, ok = 1;
+    for (BasicBlock *bb = cfg->blocks; bb; bb = bb->next) {
+        if (!loop[bb->id]) continue;
+        int every = !inner[bb->id];
+        for (int i = 0; every && i < h->pred_count; i++) {
+            BasicBlock *p = h->preds[i];
+            if (loop[p->id] && !p->doms[bb->id]) every = 0;
+        }
+        if (every) {
+            int d = 0;
+            for (int m = 0; m < cfg->block_count; m++) d += bb->doms[m] != 0;
+            int k = n++;
+            while (k > 0 && depth[k - 1] > d) {
+                chain[k] = chain[k - 1];
+                depth[k] = depth[k - 1];
+                k--;
+            }
+            chain[k] = bb;
+            depth[k] = d;
+            continue;
+        }
+        for (IRInstr *cur = bb->instrs; cur; cur = (cur == bb->last) ? NULL : cur->next) {
+            if (!cur->result) continue;
+            if (strcmp(cur->result, iv) == 0) ok = 0;
+            if (!set_contains(s.unstable, s.unstable_count, cur->result))
+                set_add(&s.unstable, &s.unstable_count, cur->result);
+        }
+    }
+    for (int k = 0; ok && k < n; k++)
+        for (IRInstr *cur = chain[k]->instrs; cur; cur = (cur == chain[k]->last) ? NULL : cur->next)
+            scev_transfer(&s, cur);
+
+    SCEVValue *v = ok ? scev_find(&s, iv) : NULL;
+    int step = (v && v->coef == 1 && !v->sym) ? v->off : 0;
+    scev_end(&s);
+    free(chain);
+    free(depth);
+    free(inner);
+    return step;
+}
+
+/* Constant `name` holds on entry to the loop: set in the preheader, or in
+   the straight-line code that leads into it. */
+static int scev_initial_value(BasicBlock *pre, const char *name, Scope *scope, int *value) {
+    BasicBlock *bb = pre;
+    IRInstr *stop = NULL;       /* look at bb only above this */
+    for (int walk = 0; bb && walk < SCEV_MAX_WALK; walk++) {
+        IRInstr *last = NULL;
+        for (IRInstr *cur = bb->instrs; cur && cur != stop; cur = (cur == bb->last) ? NULL : cur->next)
+            if (cur->result && strcmp(cur->result, name) == 0) last = cur;
+        if (last) {
+            if (last->kind != IR_ASSIGN || (!last->src.is_const && !last->src.name)) return 0;
+            if (last->src.is_const) {
+                *value = last->src.const_val;
+                return 1;
+            }
+            /* A copy (j := lo ahead of a reversed loop): follow it. */
+            if (!is_register_candidate_name(last->src.name, scope)) return 0;
+            name = last->src.name;
+            stop = last;
+            continue;
+        }
+        /* Past the preheader, calls and stores could change a name that
+           lives in memory. */
+        if (!is_register_candidate_name(name, scope)) return 0;
+        bb = (bb->pred_count == 1 && bb->preds[0] != pre) ? bb->preds[0] : NULL;
+        stop = NULL;
+    }
+    return 0;
+}
+
+typedef struct {
+    const char *ivar;
+    IROperand *bound;   /* loop-invariant */
+    IRRelop relop;      /* keep iterating while ivar relop bound */
+    int step;
+} SCEVCounter;
+
+/* Read the test at the end of the header h: one operand an add-recurrence,
+   the other invariant. */
+static int scev_counter(CFG *cfg, BasicBlock *h, int *loop_blocks, BasicBlock *body_entry,
+                        BasicBlock *exit_block, SCEVCounter *c) {
+    IRInstr *test = h->last;
+    memset(c, 0, sizeof(*c));
+    if (!test || test->kind != IR_IF) return 0;
+    int *loop = scev_whole_loop(cfg, h);
+    c->relop = test->relop;
+    if (test->if_left.name && (c->step = scev_loop_step(cfg, h, loop, test->if_left.name))) {
+        c->ivar = test->if_left.name;
+        c->bound = &test->if_right;
+    } else if (test->if_right.name && (c->step = scev_loop_step(cfg, h, loop, test->if_right.name))) {
+        c->ivar = test->if_right.name;
+        c->bound = &test->if_left;
+        c->relop = swap_relop(c->relop);
+    }
+    int ok = c->ivar && !(c->bound->name && (strcmp(c->bound->name, c->ivar) == 0 ||
+                                             is_name_defined_in_loop(c->bound->name, loop, cfg)));
+    /* A global or address-taken bound can also change behind a store or call. */
+    if (ok && c->bound->name && loop_writes_memory(loop, cfg)) {
+        Symbol *fsym = lookup(cfg->func_name);
+        Scope *scope = (fsym && fsym->kind == SYM_FUNCTION) ? fsym->scope : NULL;
+        ok = is_register_candidate_name(c->bound->name, scope);
+    }
+    free(loop);
+    if (!ok) return 0;
+
+    BasicBlock *if_taken = find_bb_by_label(cfg->blocks, test->label);
+    if (if_taken == exit_block || (if_taken && !loop_blocks[if_taken->id])) c->relop = negate_relop(c->relop);
+    else if (if_taken != body_entry) return 0;
+    return 1;
+}
+
+/* --- Dependence Analysis ---
+ *
+ * Whether a load or store in iteration I of a counted loop and another in
+ * iteration I' can touch the same memory, in which directions and at
+ * which distance I' - I (src/dependence.c). A subscript is the access's
+ * index as Scalar Evolution reads it, coef * i + k + off, the counter
+ * ranging over the values the loop gives it; a row of a flattened 2-D
+ * array, r * m + j in the loop on j, has r * m as its invariant k, so the
+ * linearized index is one dimension. Accesses to different bases are
+ * independent when Memory Disambiguation says they cannot meet, and
+ * otherwise carry a dependence of unknown direction. The vectorizer, the
+ * idiom recognizer and loop reversal all ask here.
+ */
+
+/* The subscript keeps its own copy of k: the scan frees its values as
+   names are redefined. */
+static void dep_subscript(int known, SCEVValue *v, DepSubscript *s) {
+    memset(s, 0, sizeof(*s));
+    if (!known) return;
+    s->affine = 1;
+    s->coef[0] = v->coef;
+    s->sym = v->sym ? strdup(v->sym) : NULL;
+    s->off = v->off;
+}
+
+/* Values the counter takes, when the code before the loop sets both its
+   start and the (invariant) bound to constants. */
+static void dep_counter_range(BasicBlock *pre, const char *ivar, IROperand *bound, IRRelop relop,
+                              Scope *scope, DepLoop *l) {
+    int init = 0, end = 0;
+    memset(l, 0, sizeof(*l));
+    if (bound->is_const) end = bound->const_val;
+    else if (!bound->name || !scev_initial_value(pre, bound->name, scope, &end)) return;
+    if (!scev_initial_value(pre, ivar, scope, &init)) return;
+    long long b = end;
+    l->known = 1;
+    switch (relop) {
+        case IR_LT: l->lo = init; l->hi = b - 1; break;
+        case IR_LE: l->lo = init; l->hi = b; break;
+        case IR_GT: l->lo = b + 1; l->hi = init; break;
+        case IR_GE: l->lo = b; l->hi = init; break;
+        default: l->known = 0; break;
+    }
+}
+
+/* Access x in iteration I against y in I'. Returns 0 when they never touch
+   the same memory; otherwise fills dep (a counter running down swaps the
+   meaning of DEP_LT and DEP_GT). */
+static int access_dependence(CFG *cfg, IRInstr *x, const DepSubscript *sx, IRInstr *y,
+                             const DepSubscript *sy, const DepLoop *l, Dependence *dep) {
+    memset(dep, 0, sizeof(*dep));
+    dep->dir[0] = DEP_ALL;
+    if (!accesses_may_alias(cfg, x, y)) {
+        dep->independent = 1;
+        return 0;
+    }
+    if (x->base.is_const || !x->base.name || y->base.is_const || !y->base.name ||
+        strcmp(x->base.name, y->base.name) != 0 || x->scale != y->scale)
+        return 1;
+    DepSubscript a = *sx, b = *sy;
+    if (a.sym && b.sym && strcmp(a.sym, b.sym) == 0) b.sym = a.sym;
+    return dep_test(&a, &b, 1, l, 1, dep);
+}
+
+/* -fprofile-use: a loop whose header never ran in the training run is not
+   worth growing the code for. */
+static int profile_cold_loop(BasicBlock *h) {
+    return profile_available() && h->count == 0;
+}
+
+/* Average trips per entry into the loop (the header runs once more than the
+   body each time), -1 without a profile. */
+static long long profile_loop_trips(BasicBlock *h, BasicBlock *preheader) {
+    if (!profile_available() || h->count < 0 || preheader->count <= 0) return -1;
+    return (h->count - preheader->count) / preheader->count;
+}
+
+static int unroll_loop_runtime(CFG *cfg, BasicBlock *h, BasicBlock *latch, int *loop_blocks,
+                               BasicBlock *preheader, BasicBlock *body_entry, BasicBlock *exit_block) {
+    IRInstr *if_instr = h->last;
+    if (!h->instrs || h->instrs->kind != IR_LABEL || h->instrs->next != if_instr) return 0;
+    if (!loop_is_innermost(h, loop_blocks, cfg)) return 0;
+
+    for (int i = 0; i < h->pred_count; i++) {
+        if (loop_blocks[h->preds[i]->id] && h->preds[i] != latch) return 0;
+    }
+
+    SCEVCounter ctr;
+    if (!scev_counter(cfg, h, loop_blocks, body_entry, exit_block, &ctr)) return 0;
+    const char *ivar = ctr.ivar;
+    IROperand *bound = ctr.bound;
+    IRRelop relop = ctr.relop;
+    int step = ctr.step;
+    if (!(((relop == IR_LT || relop == IR_LE) && step > 0) || ((relop == IR_GT || relop == IR_GE) && step < 0)))
+        return 0;
+
+    Symbol *fsym = lookup(cfg->func_name);
+    Scope *scope = (fsym && fsym->kind == SYM_FUNCTION) ? fsym->scope : NULL;
+    if (!is_register_candidate_name(ivar, scope) || !is_register_candidate_name(bound->name, scope)) return 0;
+
+    BasicBlock *body_blocks[256];
+    int body_count = build_body_block_list(cfg, loop_blocks, h, body_blocks, 256);
+    if (body_count <= 0) return 0;
+    int entry_idx = find_block_index(body_blocks, body_count, body_entry);
+    if (entry_idx < 0) return 0;
+    for (int i = 0; i < body_count; i++) {
+        for (IRInstr *cur = body_blocks[i]->instrs; cur; cur = cur->next) {
+            if (cur->kind == IR_TRY_BEGIN || cur->kind == IR_TRY_END || cur->kind == IR_RETURN) return 0;
+            if (cur == body_blocks[i]->last) break;
+        }
+    }
+
+    int body_instrs = count_loop_body_instrs(body_blocks, body_count);
+    int factor;
+    if (body_instrs <= RUNTIME_UNROLL_SMALL_BODY) factor = 4;
+    else if (body_instrs <= RUNTIME_UNROLL_MAX_BODY) factor = 2;
+    else return 0;
+    int live = count_loop_live_names(loop_blocks, cfg);
+    if (live > 2 * RUNTIME_UNROLL_MAX_LIVE) return 0;
+    if (live > RUNTIME_UNROLL_MAX_LIVE) factor = 2;
+
+    /* Profiled trips too short for the unrolled loop: the copies would only
+       add the remainder checks. */
+    long long trips = profile_loop_trips(h, preheader);
+    if (trips >= 0 && trips < factor) {
+        if (trips < 2) return 0;
+        factor = 2;
+    }
+
+    /* The unrolled copies run while i stays on the safe side of bound - span;
+       a constant limit that leaves the int range cannot be tested. */
+    long long span = (long long)(factor - 1) * step;
+    long long const_limit = bound->is_const ? (long long)bound->const_val - span : 0;
+    if (bound->is_const && (const_limit < INT_MIN || const_limit > INT_MAX)) return 0;
+
+    IRInstr *pre_term = preheader->last;
+    int pre_jumps = pre_term && (pre_term->kind == IR_GOTO || pre_term->kind == IR_IF) &&
+                    pre_term->label && strcmp(pre_term->label, h->instrs->label) == 0;
+    if (!pre_jumps && preheader->next != h) return 0;
+
+    /* Every label the copies need exists before the preheader is touched,
+       so a failed allocation leaves the loop as it was. */
+    char **iter_labels[4] = { NULL, NULL, NULL, NULL };
+    for (int copy = 0; copy < factor; copy++) {
+        iter_labels[copy] = alloc_iteration_labels(body_count);
+        if (!iter_labels[copy]) {
+            for (int j = 0; j < copy; j++) free_iteration_labels(iter_labels[j], body_count);
+            return 0;
+        }
+    }
+
+    /* ir_gen shares label strings between a LABEL and its jumps, so keep
+       a private copy before the preheader's jump is retargeted below. */
+    char *header_label = strdup(h->instrs->label);
+    char *entry_label = ir_new_label();
+    char *unrolled_label = ir_new_label();
+    int line = if_instr->line;
+
+    /* Send the preheader into the new code instead of the original header. */
+    if (pre_jumps) {
+        free(pre_term->label);
+        pre_term->label = strdup(entry_label);
+    }
+
+    IRInstr *new_head = NULL, *new_tail = NULL;
+    append_instr(&new_head, &new_tail, ir_make_label(entry_label, line));
+
+    IROperand limit;
+    if (bound->is_const) {
+        limit = ir_op_const((int)const_limit);
+    } else {
+        char *lim = new_opt_temp("lim");
+        append_instr(&new_head, &new_tail, ir_make_binop(lim, *bound, ir_op_const((int)span), '-', line));
+        limit = ir_op_name(lim);
+    }
+
+    append_instr(&new_head, &new_tail, ir_make_label(unrolled_label, line));
+    append_instr(&new_head, &new_tail,
+                 ir_make_if(ir_op_name((char *)ivar), limit, negate_relop(relop), header_label, line));
+
+    char *orig_labels[256];
+    for (int j = 0; j < body_count; j++) {
+        IRInstr *ins = body_blocks[j]->instrs;
+        orig_labels[j] = (ins && ins->kind == IR_LABEL && ins->label) ? ins->label : NULL;
+    }
+
+    append_instr(&new_head, &new_tail, ir_make_goto(iter_labels[0][entry_idx], line));
+
+    for (int copy = 0; copy < factor; copy++) {
+        const char *next_target = copy + 1 < factor ? iter_labels[copy + 1][entry_idx] : unrolled_label;
+        IRInstr *iter_tail = NULL;
+        IRInstr *iter_head = clone_loop_iteration(body_blocks, body_count, orig_labels, iter_labels[copy],
+                                                  header_label, next_target, &iter_tail);
+        append_instr_list(&new_head, &new_tail, iter_head, iter_tail);
+    }
+    for (int copy = 0; copy < factor; copy++) free_iteration_labels(iter_labels[copy], body_count);
+
+    new_tail->next = h->instrs;
+    h->instrs = new_head;
+    free(header_label);
+    free(entry_label);
+    free(unrolled_label);
+    return 1;
+}
+
+/* --- Loop Unswitching ---
+ *
+ * A branch inside a loop whose operands the loop never changes goes the same
+ * way on every iteration. Duplicate the loop and decide once, up front:
+ *
+ *     Ls: if a relop b goto L0      (new preheader test)
+ *         goto L0'
+ *     L0': loop copy, IF dropped    (condition false: always falls through)
+ *     L0: original loop, IF -> goto (condition true: always taken)
+ *
+ * The outermost loop in which the condition is invariant is chosen, so the
+ * test leaves the whole nest. Loops are capped at UNSWITCH_MAX_LOOP_INSTRS and
+ * each function may grow by at most UNSWITCH_MAX_GROWTH instructions, which
+ * bounds the 2^k blow-up of loops with several invariant conditions. As with
+ * the runtime unroller only the header's instruction list is rewritten; the
+ * caller rebuilds the CFG after every unswitch.
+ */
+
+#define UNSWITCH_MAX_LOOP_INSTRS 80
+#define UNSWITCH_MAX_GROWTH      240
+
+typedef struct {
+    char *orig;
+    char *fresh;
+} LabelMap;
+
+static const char* map_label(LabelMap *map, int count, const char *label) {
+    if (!label) return NULL;
+    for (int i = 0; i < count; i++) {
+        if (strcmp(map[i].orig, label) == 0) return map[i].fresh;
+    }
+    return label;
+}
+
+/* Can control run off the end of bb into bb->next? */
+static int falls_through(BasicBlock *bb) {
+    return !bb->last || (bb->last->kind != IR_GOTO && bb->last->kind != IR_SWITCH &&
+                         bb->last->kind != IR_RETURN && bb->last->kind != IR_THROW);
+}
+
+static int is_invariant_operand(IROperand *op, int *loop_blocks, CFG *cfg, Scope *scope, int has_mem_effects) {
+    if (op->is_const) return 1;
+    if (!op->name || strncmp(op->name, ".LC", 3) == 0) return 0;
+    if (is_name_defined_in_loop(op->name, loop_blocks, cfg)) return 0;
+    /* Globals and address-taken locals can change behind a store or call. */
+    return !has_mem_effects || is_register_candidate_name(op->name, scope);
+}
+
+/* Check that the loop can be cloned as a unit and return its size, or -1. */
+static int unswitchable_loop_size(CFG *cfg, BasicBlock *h, int *loop_blocks, BasicBlock *preheader,
+                                  int *has_mem_effects) {
+    if (!h->instrs || h->instrs->kind != IR_LABEL) return -1;
+    for (int i = 0; i < h->pred_count; i++) {
+        BasicBlock *p = h->preds[i];
+        if (p != preheader && !loop_blocks[p->id]) return -1;
+    }
+
+    /* The new test block is placed right before the header, so only the
+       preheader may fall into it. */
+    BasicBlock *before_h = NULL;
+    for (BasicBlock *bb = cfg->blocks; bb && bb != h; bb = bb->next) before_h = bb;
+    if (before_h && before_h != preheader && falls_through(before_h)) return -1;
+
+    IRInstr *pre_term = preheader->last;
+    int pre_jumps = pre_term && (pre_term->kind == IR_GOTO || pre_term->kind == IR_IF) &&
+                    pre_term->label && strcmp(pre_term->label, h->instrs->label) == 0;
+    if (!pre_jumps && preheader->next != h) return -1;
+
+    int size = 0;
+    *has_mem_effects = 0;
+    for (BasicBlock *bb = cfg->blocks; bb; bb = bb->next) {
+        if (!loop_blocks[bb->id]) continue;
+        for (IRInstr *cur = bb->instrs; cur; cur = cur->next) {
+            if (cur->kind == IR_TRY_BEGIN || cur->kind == IR_TRY_END || cur->kind == IR_ALLOCA ||
+                cur->kind == IR_SWITCH)
+                return -1;
+            if (cur->kind == IR_CALL || cur->kind == IR_CALL_INDIRECT || cur->kind == IR_STORE)
+                *has_mem_effects = 1;
+            size++;
+            if (cur == bb->last) break;
+        }
+        /* A copy placed elsewhere cannot rely on falling out of the loop. */
+        if (falls_through(bb) && bb->next && !loop_blocks[bb->next->id] && !loop_exit_label(bb->next))
+            return -1;
+        if (falls_through(bb) && !bb->next) return -1;
+    }
+    return size;
+}
+
+static void unswitch_loop(CFG *cfg, BasicBlock *h, int *loop_blocks, BasicBlock *preheader, IRInstr *cond) {
+    char *header_label = strdup(h->instrs->label);
+    char *test_label = ir_new_label();
+    int line = cond->line;
+
+    LabelMap map[256];
+    int map_count = 0;
+    for (BasicBlock *bb = cfg->blocks; bb; bb = bb->next) {
+        if (!loop_blocks[bb->id]) continue;
+        for (IRInstr *cur = bb->instrs; cur && map_count < 256; cur = cur->next) {
+            if (cur->kind == IR_LABEL && cur->label) {
+                map[map_count].orig = cur->label;
+                map[map_count].fresh = ir_new_label();
+                map_count++;
+            }
+            if (cur == bb->last) break;
+        }
+    }
+
+    IRInstr *new_head = NULL, *new_tail = NULL;
+    append_instr(&new_head, &new_tail, ir_make_label(test_label, line));
+    append_instr(&new_head, &new_tail, ir_make_if(cond->if_left, cond->if_right, cond->relop, header_label, line));
+    append_instr(&new_head, &new_tail, ir_make_goto((char *)map_label(map, map_count, header_label), line));
+
+    /* False copy: the invariant IF never branches, so it simply disappears. */
+    for (BasicBlock *bb = cfg->blocks; bb; bb = bb->next) {
+        if (!loop_blocks[bb->id]) continue;
+        for (IRInstr *cur = bb->instrs; cur; cur = cur->next) {
+            if (cur != cond) {
+                IRInstr *dup = clone_instr(cur);
+                if (dup->label) {
+                    const char *target = map_label(map, map_count, dup->label);
+                    if (target != dup->label) {
+                        free(dup->label);
+                        dup->label = strdup(target);
+                    }
+                }
+                append_instr(&new_head, &new_tail, dup);
+            }
+            if (cur == bb->last) break;
+        }
+        if ((falls_through(bb) || bb->last == cond) && !loop_blocks[bb->next->id])
+            append_instr(&new_head, &new_tail, ir_make_goto((char *)loop_exit_label(bb->next), line));
+    }
+
+    /* True copy: the original loop, with the IF turned into its jump. */
+    cond->kind = IR_GOTO;
+    ir_free_operand(&cond->if_left);
+    ir_free_operand(&cond->if_right);
+    cond->if_left = ir_op_const(0);
+    cond->if_right = ir_op_const(0);
+
+    IRInstr *pre_term = preheader->last;
+    if (pre_term && (pre_term->kind == IR_GOTO || pre_term->kind == IR_IF) &&
+        pre_term->label && strcmp(pre_term->label, header_label) == 0) {
+        pre_term->label = strdup(test_label);
+    }
+
+    new_tail->next = h->instrs;
+    h->instrs = new_head;
+
+    for (int i = 0; i < map_count; i++) free(map[i].fresh);
+    free(header_label);
+    free(test_label);
+}
+
+/* Unswitch one loop of the function. Returns the number of instructions
+   added, 0 when nothing was done. */
+static int unswitch_one_loop(CFG *cfg, int budget) {
+    Symbol *fsym = lookup(cfg->func_name);
+    Scope *scope = (fsym && fsym->kind == SYM_FUNCTION) ? fsym->scope : NULL;
+
+    int *loop_blocks = malloc(sizeof(int) * cfg->block_count);
+    int *best_blocks = malloc(sizeof(int) * cfg->block_count);
+    if (!loop_blocks || !best_blocks) {
+        free(loop_blocks);
+        free(best_blocks);
+        return 0;
+    }
+
+    BasicBlock *best_h = NULL, *best_pre = NULL;
+    IRInstr *best_cond = NULL;
+    int best_size = 0;
+
+    for (BasicBlock *b = cfg->blocks; b; b = b->next) {
+        for (int s = 0; s < b->succ_count; s++) {
+            BasicBlock *h = b->succs[s];
+            if (!b->doms || !b->doms[h->id]) continue;
+            if (!compute_natural_loop(h, b, loop_blocks, cfg)) continue;
+            BasicBlock *pre = find_preheader(h, loop_blocks);
+            if (!pre || profile_cold_loop(h)) continue;
+
+            int has_mem_effects;
+            int size = unswitchable_loop_size(cfg, h, loop_blocks, pre, &has_mem_effects);
+            if (size < 0 || size > UNSWITCH_MAX_LOOP_INSTRS || size > budget || size <= best_size) continue;
+
+            for (BasicBlock *bb = cfg->blocks; bb; bb = bb->next) {
+                if (!loop_blocks[bb->id] || bb == h) continue;
+                IRInstr *cond = bb->last;
+                if (!cond || cond->kind != IR_IF) continue;
+                if (cond->if_left.is_const && cond->if_right.is_const) continue;
+                if (!is_invariant_operand(&cond->if_left, loop_blocks, cfg, scope, has_mem_effects) ||
+                    !is_invariant_operand(&cond->if_right, loop_blocks, cfg, scope, has_mem_effects))
+                    continue;
+                best_h = h;
+                best_pre = pre;
+                best_cond = cond;
+                best_size = size;
+                memcpy(best_blocks, loop_blocks, sizeof(int) * cfg->block_count);
+                break;
+            }
+        }
+    }
+
+    if (best_h) unswitch_loop(cfg, best_h, best_blocks, best_pre, best_cond);
+    free(loop_blocks);
+    free(best_blocks);
+    return best_h ? best_size : 0;
+}
+
+static void merge_trivial_blocks(CFG *cfg);
+
+static CFG* unswitch_loops(IRFunc *f, CFG *cfg) {
+    int budget = UNSWITCH_MAX_GROWTH;
+    int grown;
+    while (cfg && (grown = unswitch_one_loop(cfg, budget)) > 0) {
+        budget -= grown;
+        f->instrs = flatten_cfg(cfg);
+        free_cfg(cfg);
+        cfg = build_cfg(f);
+        if (!cfg) break;
+        /* Each copy's dead side of the former IF is now unreachable. */
+        mark_reachable_and_cleanup(cfg);
+        merge_trivial_blocks(cfg);
+        compute_dominators(cfg);
+    }
+    return cfg;
+}
+
+/* --- Loop Vectorization ---
+ *
+ * With -march=rv64gcv, an innermost counted loop
+ *
+ *     L0: if i < n goto L1          (or i <= n; i steps by 1)
+ *         goto exit
+ *     L1: body; i := i + 1; goto L0
+ *
+ * whose body is straight-line int work on elements a[i + k] (k a constant
+ * or loop-invariant) is outlined into a VecKernel, which the backend runs
+ * as strip-mined RVV code, and the loop is replaced by
+ *
+ *         param i; param n; param <bases>; param <invariants>
+ *         r := call __vec_f_N, argc
+ *         s := s + r                (sum reduction, if any)
+ *         i := i < n ? n : i        (the counter's value after the loop)
+ *         goto exit
+ *
+ * which every later pass already knows how to treat. Legality:
+ *  - a name the body defines is a per-iteration value, the counter, or the
+ *    single sum reduction s := s + v; nothing else is carried from one
+ *    iteration to the next or used after the loop;
+ *  - accesses are unit-stride int elements of loop-invariant bases;
+ *  - memory dependences: a store may not touch memory another base of
+ *    the loop might reach (see Memory Disambiguation; a versioned loop's
+ *    checked copy passes this). Within one base, a load
+ *    of a[i + d] and a store to a[i + e] may both stay when d == e, or when
+ *    d > e and the load comes first (it reads the old value either way);
+ *    d < e is a dependence carried across iterations, unless the counter's
+ *    range is shorter than e - d (see Dependence Analysis).
+ *
+ * Every loop looked at gets a line in vectorize_report.txt.
+ */
+
+#define VEC_MAX_BODY   24   /* keeps every value in a register group */
+#define VEC_MAX_PARAMS 8    /* a0-a7 */
+#define VEC_MIN_TRIPS  8
+
+typedef struct {
+    const char *base;
+    const char *koff;   /* loop-invariant part of the index, NULL if none */
+    int off;            /* constant part of the index */
+    int is_store;
+    int pos;
+} VecAccess;
+
+static char **vec_report = NULL;
+static int vec_report_count = 0;
+
+static int vec_note(CFG *cfg, IRInstr *at, const char *msg) {
+    char line[256];
+    snprintf(line, sizeof(line), "%s: loop at line %d: %s", cfg->func_name, at ? at->line : 0, msg);
+    set_add(&vec_report, &vec_report_count, line);
+    return 0;
+}
+
+static void write_vectorize_report(const char *path) {
+    FILE *out = fopen(path, "w");
+    if (!out) return;
+    fprintf(out, "Loop vectorization (RVV, e32, unit stride)\n");
+    for (int i = 0; i < vec_report_count; i++) fprintf(out, "%s\n", vec_report[i]);
+    if (vec_report_count == 0) fprintf(out, "no loops\n");
+    fclose(out);
+    set_free(vec_report, vec_report_count);
+    vec_report = NULL;
+    vec_report_count = 0;
+}
+
+static int vec_is_name(IROperand *op, const char *name) {
+    return op && !op->is_const && op->name && name && strcmp(op->name, name) == 0;
+}
+
+/* 1: a local array, 2: a pointer to int, 3: a local VLA (its name holds
+   the address of its own block), 0: anything else. */
+static int vec_base_kind(const char *name, Scope *scope) {
+    Symbol *sym = lookup_ir_name(name, scope);
+    if (!sym || sym->type != TYPE_INT) return 0;
+    if (sym->is_vla && sym->kind != SYM_PARAMETER) return 3;
+    if (sym->is_array && sym->kind != SYM_PARAMETER && sym->scope_level > 0) return 1;
+    if (sym->pointer_level == 1 || (sym->is_array && sym->kind == SYM_PARAMETER)) return 2;
+    return 0;
+}
+
+/* Split a body access's index into i + koff + off. The index is i itself
+   or a name the body set earlier to i + c, c + i, i - c or i + k. */
+static int vec_split_index(IROperand *idx, const char *ivar, IRInstr **body, int pos,
+                           int *loop_blocks, CFG *cfg, const char **koff, int *off) {
+    *koff = NULL;
+    *off = 0;
+    if (vec_is_name(idx, ivar)) return 1;
+    if (idx->is_const || !idx->name) return 0;
+
+    IRInstr *def = NULL;
+    for (int j = 0; j < pos; j++)
+        if (body[j]->result && strcmp(body[j]->result, idx->name) == 0) def = body[j];
+    if (!def || def->kind != IR_BINOP) return 0;
+
+    IROperand *k;
+    if (vec_is_name(&def->left, ivar)) k = &def->right;
+    else if (def->binop == '+' && vec_is_name(&def->right, ivar)) k = &def->left;
+    else return 0;
+
+    if (def->binop == '-' && k == &def->right && k->is_const) {
+        *off = -k->const_val;
+        return 1;
+    }
+    if (def->binop != '+') return 0;
+    if (k->is_const) {
+        *off = k->const_val;
+        return 1;
+    }
+    if (!k->name || is_name_defined_in_loop(k->name, loop_blocks, cfg)) return 0;
+    *koff = k->name;
+    return 1;
+}
+
+/* i + koff + off as Dependence Analysis takes it. */
+static void vec_subscript(const char *koff, int off, DepSubscript *s) {
+    memset(s, 0, sizeof(*s));
+    s->affine = 1;
+    s->coef[0] = 1;
+    s->sym = koff;
+    s->off = off;
+}
+
+/* i + c, c + i and i - c all become i + c in the kernel. */
+static void vec_canonical_index(IRInstr *ins, const char *ivar) {
+    if (ins->kind != IR_BINOP) return;
+    if (ins->binop == '+' && vec_is_name(&ins->right, ivar) && !vec_is_name(&ins->left, ivar)) {
+        IROperand t = ins->left;
+        ins->left = ins->right;
+        ins->right = t;
+    } else if (ins->binop == '-' && vec_is_name(&ins->left, ivar) && ins->right.is_const &&
+               ins->right.const_val != INT_MIN) {
+        ins->binop = '+';
+        ins->right.const_val = -ins->right.const_val;
+    }
+}
+
+static int vec_binop_supported(int op) {
+    return op == '+' || op == '-' || op == '*' || op == '/' || op == '%' ||
+           op == '&' || op == '|' || op == '^' || op == T_SHL || op == T_SHR;
+}
+
+/* Operands an instruction of the body reads (the index of an access is
+   left out: it is resolved by vec_split_index). */
+static int vec_value_operands(IRInstr *ins, IROperand **ops) {
+    switch (ins->kind) {
+        case IR_ASSIGN: ops[0] = &ins->src; return 1;
+        case IR_BINOP:  ops[0] = &ins->left; ops[1] = &ins->right; return 2;
+        case IR_UNOP:   ops[0] = &ins->unop_src; return 1;
+        case IR_STORE:  ops[0] = &ins->store_val; return 1;
+        default:        return 0;
+    }
+}
+
+static int vec_reads_name(IRInstr *ins, const char *name) {
+    IROperand *ops[2];
+    int n = vec_value_operands(ins, ops);
+    for (int i = 0; i < n; i++)
+        if (vec_is_name(ops[i], name)) return 1;
+    if (ins->kind == IR_LOAD || ins->kind == IR_STORE)
+        return vec_is_name(&ins->index, name) || vec_is_name(&ins->base, name);
+    return 0;
+}
+
+static void vec_add_param(char **params, int *count, const char *name) {
+    for (int i = 0; i < *count; i++)
+        if (strcmp(params[i], name) == 0) return;
+    if (*count < VEC_MAX_PARAMS + 1) params[(*count)++] = strdup(name);
+}
+
+/* An innermost loop of two blocks, header `if i < n` (or i <= n) and a
+   body ending in the i += 1 update, reached from a preheader and leaving
+   to a single exit. The vectorizer and the idiom recognizer work on it;
+   loop reversal also takes `if i > n` (or i >= n) with i -= 1. */
+typedef struct {
+    IRInstr *test;
+    BasicBlock *preheader, *exit_block;
+    const char *ivar;
+    IROperand *bound;           /* loop-invariant */
+    IRRelop relop;              /* IR_LT or IR_LE; IR_GT or IR_GE counting down */
+    int step;                   /* 1, or -1 if the caller allowed it */
+    IRInstr *body[VEC_MAX_BODY];    /* without the counter update */
+    int n;
+    IRInstr *upd_tmp;           /* t in i := t, if any */
+    int retarget;               /* the preheader jumps to the header */
+} CountedLoop;
+
+/* Fill cl for the loop at h; NULL, or why the loop does not qualify. */
+static const char* match_counted_loop(CFG *cfg, BasicBlock *h, BasicBlock *latch, int *loop_blocks,
+                                      Scope *scope, int allow_down, CountedLoop *cl) {
+    IRInstr *if_instr = h->last;
+    memset(cl, 0, sizeof(*cl));
+    cl->test = if_instr;
+    if (!if_instr || if_instr->kind != IR_IF || h->instrs->next != if_instr)
+        return "loop test is not a single compare";
+    if (!loop_is_innermost(h, loop_blocks, cfg)) return "not an innermost loop";
+
+    BasicBlock *body_entry = NULL;
+    cl->preheader = find_preheader(h, loop_blocks);
+    if (!cl->preheader || !find_loop_entry_exit(h, loop_blocks, &body_entry, &cl->exit_block) ||
+        has_side_exits(h, loop_blocks, cfg, cl->exit_block) || !loop_exit_label(cl->exit_block))
+        return "loop has no single entry and exit";
+    int block_count = 0;
+    for (int i = 0; i < cfg->block_count; i++) block_count += loop_blocks[i];
+    if (body_entry != latch || block_count != 2) return "control flow in the body";
+
+    /* Counter and bound, as for the runtime unroller. */
+    SCEVCounter ctr;
+    if (!scev_counter(cfg, h, loop_blocks, body_entry, cl->exit_block, &ctr))
+        return "no counter against a loop-invariant bound";
+    const char *ivar = cl->ivar = ctr.ivar;
+    IROperand *bound = cl->bound = ctr.bound;
+    cl->relop = ctr.relop;
+    cl->step = ctr.step;
+    if (cl->step == -1 && allow_down) {
+        if (cl->relop != IR_GT && cl->relop != IR_GE) return "loop test is not i > n or i >= n";
+    } else {
+        if (cl->step != 1) return "no counter stepping by 1";
+        if (cl->relop != IR_LT && cl->relop != IR_LE) return "loop test is not i < n or i <= n";
+    }
+    /* The end of i <= n is n + 1, which does not exist for n = INT_MAX. */
+    if (cl->relop == IR_LE && bound->is_const && bound->const_val == INT_MAX)
+        return "loop test is i <= INT_MAX";
+
+    Symbol *isym = lookup_ir_name(ivar, scope);
+    if ((isym && isym->type != TYPE_INT) || !is_register_candidate_name(ivar, scope) ||
+        !is_register_candidate_name(bound->name, scope))
+        return "counter or bound lives in memory";
+
+    /* Body: everything between the label and the counter update. */
+    IRInstr *upd = NULL;
+    IRInstr *cur = latch->instrs;
+    if (cur && cur->kind == IR_LABEL) cur = (cur == latch->last) ? NULL : cur->next;
+    IRInstr *iv_def = find_unique_def_in_loop(ivar, loop_blocks, cfg, NULL);
+    if (iv_def && iv_def->kind == IR_ASSIGN && iv_def->src.name)
+        cl->upd_tmp = find_unique_def_in_loop(iv_def->src.name, loop_blocks, cfg, NULL);
+    for (; cur; cur = (cur == latch->last) ? NULL : cur->next) {
+        if (cur == latch->last && cur->kind == IR_GOTO) break;
+        /* t := i + 1 may come early when CSE shared it with an a[i + 1]
+           index; it is then part of the body, and i := t ends it. */
+        if (cur == iv_def || (cur == cl->upd_tmp && cur->next == iv_def)) {
+            upd = cur;
+            continue;
+        }
+        if (upd) return "counter updated before the end of the body";
+        if (cl->n == VEC_MAX_BODY) return "body too large";
+        cl->body[cl->n++] = cur;
+    }
+    if (!upd || cl->n == 0) return "empty body";
+
+    /* The preheader must reach the new code: by its jump, or by falling in. */
+    IRInstr *pre_term = cl->preheader->last;
+    cl->retarget = pre_term && (pre_term->kind == IR_GOTO || pre_term->kind == IR_IF) &&
+                   pre_term->label && strcmp(pre_term->label, h->instrs->label) == 0;
+    if (!cl->retarget && cl->preheader->next != h) return "no preheader";
+    return NULL;
+}
+
+/* Start the code replacing the loop: a fresh entry label, then the end of
+   the iteration space (n, or n + 1 for i <= n) computed into end_name when
+   it is not already a name or a constant. */
+static IROperand counted_loop_begin(CountedLoop *cl, const char *end_name, char **entry_label,
+                                    IRInstr **head, IRInstr **tail) {
+    int line = cl->test->line;
+    *entry_label = ir_new_label();
+    append_instr(head, tail, ir_make_label(*entry_label, line));
+    if (cl->relop == IR_LT) return *cl->bound;
+    if (cl->bound->is_const) return ir_op_const(cl->bound->const_val + 1);
+    append_instr(head, tail, ir_make_binop((char *)end_name, *cl->bound, ir_op_const(1), '+', line));
+    return ir_op_name((char *)end_name);
+}
+
+/* Put the new code in front of the header, which then only the back edge
+   (or a branch of the new code) still reaches. */
+static void counted_loop_splice(CountedLoop *cl, BasicBlock *h, char *entry_label, IRInstr *head, IRInstr *tail) {
+    if (cl->retarget) {
+        free(cl->preheader->last->label);
+        cl->preheader->last->label = strdup(entry_label);
+    }
+    tail->next = h->instrs;
+    h->instrs = head;
+    free(entry_label);
+}
+
+/* Finish code that does the loop's work: i gets its exit value
+   max(i, end), and control goes to the exit. */
+static void counted_loop_replace(CountedLoop *cl, BasicBlock *h, char *entry_label, IROperand end,
+                                 IRInstr *head, IRInstr *tail) {
+    int line = cl->test->line;
+    append_instr(&head, &tail,
+                 ir_make_select((char *)cl->ivar, ir_op_name((char *)cl->ivar), end, IR_LT, end,
+                                ir_op_name((char *)cl->ivar), line));
+    append_instr(&head, &tail, ir_make_goto((char *)loop_exit_label(cl->exit_block), line));
+    counted_loop_splice(cl, h, entry_label, head, tail);
+}
+
+/* &base[at + koff + off] for an int array or pointer base, computed ahead
+   of the loop. */
+static IROperand element_address(const char *base, Scope *scope, IROperand at, const char *koff, int off,
+                                 int line, IRInstr **head, IRInstr **tail) {
+    char *addr = new_opt_temp("lia");
+    char *idx = new_opt_temp("lii");
+    char *elt = new_opt_temp("lie");
+    char *span = new_opt_temp("lio");
+    char *p = new_opt_temp("lip");
+    if (vec_base_kind(base, scope) == 1)
+        append_instr(head, tail, ir_make_unop(addr, ir_op_name((char *)base), '&', line));
+    else
+        append_instr(head, tail, ir_make_assign(addr, ir_op_name((char *)base), line));
+    IROperand k = koff ? ir_op_name((char *)koff) : ir_op_const(0);
+    append_instr(head, tail, ir_make_binop(idx, at, k, '+', line));
+    append_instr(head, tail, ir_make_binop(elt, ir_op_name(idx), ir_op_const(off), '+', line));
+    append_instr(head, tail, ir_make_binop(span, ir_op_name(elt), ir_op_const(4), '*', line));
+    append_instr(head, tail, ir_make_binop(p, ir_op_name(addr), ir_op_name(span), '+', line));
+    IROperand op = ir_op_name(p);
+    free(addr);
+    free(idx);
+    free(elt);
+    free(span);
+    free(p);
+    return op;
+}
+
+static int vectorize_loop(IRProgram *prog, CFG *cfg, BasicBlock *h, BasicBlock *latch, int *loop_blocks) {
+    char msg[200];
+    Symbol *fsym = lookup(cfg->func_name);
+    Scope *scope = (fsym && fsym->kind == SYM_FUNCTION) ? fsym->scope : NULL;
+    CountedLoop cl;
+    const char *why = match_counted_loop(cfg, h, latch, loop_blocks, scope, 0, &cl);
+    IRInstr *if_instr = cl.test ? cl.test : h->instrs;
+    if (why) {
+        snprintf(msg, sizeof(msg), "not vectorized: %s", why);
+        return vec_note(cfg, if_instr, msg);
+    }
+    const char *ivar = cl.ivar;
+    IROperand *bound = cl.bound;
+    IRRelop relop = cl.relop;
+    BasicBlock *exit_block = cl.exit_block;
+    IRInstr **body = cl.body;
+    int n = cl.n;
+    IRInstr *upd_tmp = cl.upd_tmp;
+
+    if (profile_cold_loop(h))
+        return vec_note(cfg, if_instr, "not vectorized: never ran in the training run");
+    long long trips = profile_loop_trips(h, cl.preheader);
+    int init = 0;
+    if (trips < 0 && bound->is_const && scev_initial_value(cl.preheader, ivar, scope, &init))
+        trips = (long long)bound->const_val - init + (relop == IR_LE);
+    if (trips >= 0 && trips < VEC_MIN_TRIPS) {
+        snprintf(msg, sizeof(msg), "not vectorized: only %lld iterations", trips);
+        return vec_note(cfg, if_instr, msg);
+    }
+
+    /* Operations and accesses. */
+    VecAccess acc[VEC_MAX_BODY];
+    int nacc = 0, loads = 0, stores = 0;
+    for (int j = 0; j < n; j++) {
+        IRInstr *ins = body[j];
+        if (ins->kind == IR_LOAD || ins->kind == IR_STORE) {
+            if (ins->base.is_const || !ins->base.name || ins->scale != 4 ||
+                !vec_base_kind(ins->base.name, scope) ||
+                is_name_defined_in_loop(ins->base.name, loop_blocks, cfg))
+                return vec_note(cfg, if_instr, "not vectorized: access is not to an int array");
+            VecAccess *a = &acc[nacc++];
+            a->base = ins->base.name;
+            a->is_store = ins->kind == IR_STORE;
+            a->pos = j;
+            if (!vec_split_index(&ins->index, ivar, body, j, loop_blocks, cfg, &a->koff, &a->off))
+                return vec_note(cfg, if_instr, "not vectorized: access is not unit-stride");
+            if (a->is_store) stores++; else loads++;
+        } else if (ins->kind == IR_BINOP) {
+            if (!vec_binop_supported(ins->binop)) return vec_note(cfg, if_instr, "not vectorized: unsupported operator");
+        } else if (ins->kind == IR_UNOP) {
+            if (ins->unop != '-' && ins->unop != '~') return vec_note(cfg, if_instr, "not vectorized: unsupported operator");
+        } else if (ins->kind == IR_CALL || ins->kind == IR_CALL_INDIRECT || ins->kind == IR_PARAM) {
+            return vec_note(cfg, if_instr, "not vectorized: call in the body");
+        } else if (ins->kind != IR_ASSIGN) {
+            return vec_note(cfg, if_instr, "not vectorized: unsupported instruction in the body");
+        }
+    }
+
+    /* Values: per-iteration, or the one sum reduction. */
+    compute_liveness(cfg);
+    const char *red = NULL;
+    int red_add = -1, red_copy = -1;
+    for (int j = 0; j < n; j++) {
+        const char *r = body[j]->result;
+        if (!r) continue;
+        Symbol *rs = lookup_ir_name(r, scope);
+        if ((rs && (rs->type != TYPE_INT || rs->pointer_level > 0 || rs->is_array)) || is_memory_resident_name(r)) {
+            snprintf(msg, sizeof(msg), "not vectorized: %s is not an int value", r);
+            return vec_note(cfg, if_instr, msg);
+        }
+        int carried = 0;
+        for (int q = 0; q <= j && !carried; q++)
+            if (vec_reads_name(body[q], r)) {
+                int redefined = 0;
+                for (int p = 0; p < q; p++)
+                    if (body[p]->result && strcmp(body[p]->result, r) == 0) redefined = 1;
+                carried = !redefined;
+            }
+        if (!carried) {
+            if (set_contains(exit_block->live_in, exit_block->live_in_count, r)) {
+                snprintf(msg, sizeof(msg), "not vectorized: %s is used after the loop", r);
+                return vec_note(cfg, if_instr, msg);
+            }
+            continue;
+        }
+
+        /* s := s + v, or t := s + v; s := t with t used nowhere else. */
+        int q = -1, uses = 0, defs = 0;
+        for (int p = 0; p < n; p++) {
+            if (vec_reads_name(body[p], r)) { uses++; q = p; }
+            if (body[p]->result && strcmp(body[p]->result, r) == 0) defs++;
+        }
+        IRInstr *add = (q >= 0) ? body[q] : NULL;
+        int ok = !red && uses == 1 && defs == 1 && add && add->kind == IR_BINOP && add->binop == '+' &&
+                 (vec_is_name(&add->left, r) != vec_is_name(&add->right, r));
+        if (ok && q != j) {
+            IRInstr *cp = body[j];
+            ok = q < j && cp->kind == IR_ASSIGN && vec_is_name(&cp->src, add->result) &&
+                 !set_contains(exit_block->live_in, exit_block->live_in_count, add->result);
+            for (int p = 0; ok && p < n; p++)
+                if (p != j && (vec_reads_name(body[p], add->result) ||
+                               (p != q && body[p]->result && strcmp(body[p]->result, add->result) == 0)))
+                    ok = 0;
+        }
+        if (!ok || !is_register_candidate_name(r, scope)) {
+            snprintf(msg, sizeof(msg), "not vectorized: %s is carried from one iteration to the next", r);
+            return vec_note(cfg, if_instr, msg);
+        }
+        red = r;
+        red_add = q;
+        red_copy = (q != j) ? j : -1;
+    }
+    if (upd_tmp && set_contains(exit_block->live_in, exit_block->live_in_count, upd_tmp->result))
+        return vec_note(cfg, if_instr, "not vectorized: counter update used after the loop");
+
+    /* Memory dependences. */
+    int ptr_store = 0;
+    for (int a = 0; a < nacc; a++)
+        if (acc[a].is_store && vec_base_kind(acc[a].base, scope) == 2) ptr_store = 1;
+    DepLoop range;
+    DepSubscript subs[VEC_MAX_BODY];
+    dep_counter_range(cl.preheader, ivar, bound, relop, scope, &range);
+    for (int a = 0; a < nacc; a++) vec_subscript(acc[a].koff, acc[a].off, &subs[a]);
+    for (int a = 0; a < nacc; a++) {
+        for (int b = 0; b < nacc; b++) {
+            /* each pair once, a load (if any) as a, the store as b */
+            if (a == b || !acc[b].is_store || (acc[a].is_store && a > b)) continue;
+            Dependence dep;
+            IRInstr *x = body[acc[a].pos], *y = body[acc[b].pos];
+            if (!access_dependence(cfg, x, &subs[a], y, &subs[b], &range, &dep)) continue;
+            if (strcmp(acc[a].base, acc[b].base) != 0) {
+                snprintf(msg, sizeof(msg), "not vectorized: %s and %s may alias", acc[a].base, acc[b].base);
+                return vec_note(cfg, if_instr, msg);
+            }
+            if (!dep.has_dist[0]) {
+                snprintf(msg, sizeof(msg), "not vectorized: unknown dependence distance on %s", acc[a].base);
+                return vec_note(cfg, if_instr, msg);
+            }
+            /* Two stores: the later iteration's value must land last.
+               A load and a store: the load may read an element a later
+               iteration stores (the old value either way) if it comes
+               first in the body; a store feeding a later load is a
+               dependence carried across iterations. */
+            long long d = dep.dist[0];
+            if (d != 0 && (acc[a].is_store || d < 0 || acc[a].pos > acc[b].pos)) {
+                snprintf(msg, sizeof(msg), "not vectorized: loop-carried dependence on %s (distance %lld)",
+                         acc[a].base, d < 0 ? -d : d);
+                return vec_note(cfg, if_instr, msg);
+            }
+        }
+    }
+
+    /* Kernel parameters: counter, end, bases, then invariant scalars. */
+    char *params[VEC_MAX_PARAMS + 1];
+    int np = 0;
+    char *end_name = (bound->name && relop == IR_LT) ? strdup(bound->name) : new_opt_temp("vend");
+    vec_add_param(params, &np, ivar);
+    vec_add_param(params, &np, end_name);
+    for (int a = 0; a < nacc; a++) vec_add_param(params, &np, acc[a].base);
+    int mem_invariant = 0;
+    for (int j = 0; j < n; j++) {
+        IROperand *ops[2];
+        int k = vec_value_operands(body[j], ops);
+        for (int i = 0; i < k; i++) {
+            const char *nm = ops[i]->is_const ? NULL : ops[i]->name;
+            if (!nm || strcmp(nm, ivar) == 0 || is_name_defined_in_loop(nm, loop_blocks, cfg)) continue;
+            Symbol *s = lookup_ir_name(nm, scope);
+            if (strncmp(nm, ".LC", 3) == 0 || (s && (s->is_array || s->pointer_level > 0 || s->kind == SYM_FUNCTION))) {
+                for (int p = 0; p < np; p++) free(params[p]);
+                free(end_name);
+                return vec_note(cfg, if_instr, "not vectorized: non-int operand");
+            }
+            if (is_memory_resident_name(nm)) mem_invariant = 1;
+            vec_add_param(params, &np, nm);
+        }
+    }
+    if (np > VEC_MAX_PARAMS || (mem_invariant && ptr_store)) {
+        for (int p = 0; p < np; p++) free(params[p]);
+        free(end_name);
+        return vec_note(cfg, if_instr, np > VEC_MAX_PARAMS ? "not vectorized: too many live-in values"
+                                                           : "not vectorized: a store may change an operand");
+    }
+
+    /* Outline the body. */
+    static int vec_kernel_counter = 0;
+    char kname[128];
+    snprintf(kname, sizeof(kname), "__vec_%s_%d", cfg->func_name, vec_kernel_counter++);
+    VecKernel *k = calloc(1, sizeof(VecKernel));
+    k->name = strdup(kname);
+    k->params = malloc(sizeof(char *) * np);
+    for (int p = 0; p < np; p++) k->params[p] = params[p];
+    k->param_count = np;
+    k->ivar = strdup(ivar);
+    k->reduction = red ? strdup(red) : NULL;
+    /* Values only the counter update read (t := i + 1 shared with an
+       index, then copied) are dropped. */
+    int keep[VEC_MAX_BODY];
+    for (int j = n - 1; j >= 0; j--) {
+        keep[j] = body[j]->kind == IR_STORE || j == red_add || j == red_copy;
+        for (int q = j + 1; q < n && !keep[j]; q++)
+            if (keep[q] && vec_reads_name(body[q], body[j]->result)) keep[j] = 1;
+    }
+    IRInstr *kb_tail = NULL;
+    for (int j = 0; j < n; j++) {
+        if (j == red_copy || !keep[j]) continue;
+        IRInstr *c;
+        if (j == red_add) {
+            IROperand v = vec_is_name(&body[j]->left, red) ? body[j]->right : body[j]->left;
+            c = ir_make_binop((char *)red, ir_op_name((char *)red), v, '+', body[j]->line);
+        } else {
+            c = clone_instr(body[j]);
+            vec_canonical_index(c, ivar);
+        }
+        append_instr(&k->body, &kb_tail, c);
+    }
+    VecKernel **kp = &prog->vec_kernels;
+    while (*kp) kp = &(*kp)->next;
+    *kp = k;
+
+    /* Replace the loop with the call. */
+    int line = if_instr->line;
+    char *entry_label;
+    IRInstr *new_head = NULL, *new_tail = NULL;
+    IROperand end = counted_loop_begin(&cl, end_name, &entry_label, &new_head, &new_tail);
+    IRInstr *args[VEC_MAX_PARAMS];
+    for (int p = 0; p < np; p++) {
+        IROperand arg = ir_op_name(params[p]);
+        if (p == 1) {
+            arg = end;
+        } else if (p >= 2 && vec_base_kind(params[p], scope) == 1) {
+            char *addr = new_opt_temp("vbase");
+            append_instr(&new_head, &new_tail, ir_make_unop(addr, ir_op_name(params[p]), '&', line));
+            arg = ir_op_name(addr);
+        }
+        args[p] = ir_make_param(arg, line);
+    }
+    for (int p = 0; p < np; p++) append_instr(&new_head, &new_tail, args[p]);
+    if (red) {
+        char *part = new_opt_temp("vsum");
+        append_instr(&new_head, &new_tail, ir_make_call(part, kname, np, line));
+        append_instr(&new_head, &new_tail,
+                     ir_make_binop((char *)red, ir_op_name((char *)red), ir_op_name(part), '+', line));
+    } else {
+        append_instr(&new_head, &new_tail, ir_make_call_void(kname, np, line));
+    }
+    counted_loop_replace(&cl, h, entry_label, end, new_head, new_tail);
+
+    snprintf(msg, sizeof(msg), "vectorized into %s (%d load%s, %d store%s%s%s)", kname,
+             loads, loads == 1 ? "" : "s", stores, stores == 1 ? "" : "s",
+             red ? ", sum into " : "", red ? red : "");
+    vec_note(cfg, if_instr, msg);
+    return 1;
+}
+
+typedef int (*LoopRewrite)(IRProgram *prog, CFG *cfg, BasicBlock *h, BasicBlock *latch, int *loop_blocks);
+
+static int rewrite_one_loop(IRProgram *prog, CFG *cfg, LoopRewrite rewrite, char ***seen, int *seen_count) {
+    for (BasicBlock *b = cfg->blocks; b; b = b->next) {
+        for (int i = 0; i < b->succ_count; i++) {
+            BasicBlock *h = b->succs[i];
+            if (!b->doms || !b->doms[h->id]) continue;
+            if (!h->instrs || h->instrs->kind != IR_LABEL) continue;
+            if (set_contains(*seen, *seen_count, h->instrs->label)) continue;
+            set_add(seen, seen_count, h->instrs->label);
+
+            int *loop_blocks = calloc(cfg->block_count, sizeof(int));
+            int done = compute_natural_loop(h, b, loop_blocks, cfg) &&
+                       rewrite(prog, cfg, h, b, loop_blocks);
+            free(loop_blocks);
+            if (done) return 1;
+        }
+    }
+    return 0;
+}
+
+/* Rewrite loops one at a time, rebuilding the CFG after each, so the
+   loop's old blocks are gone before the next one is looked at. */
+static CFG* rewrite_loops(IRProgram *prog, IRFunc *f, CFG *cfg, LoopRewrite rewrite) {
+    char **seen = NULL;
+    int seen_count = 0;
+    compute_dominators(cfg);
+    while (cfg && rewrite_one_loop(prog, cfg, rewrite, &seen, &seen_count)) {
+        f->instrs = flatten_cfg(cfg);
+        free_cfg(cfg);
+        cfg = build_cfg(f);
+        if (!cfg) break;
+        mark_reachable_and_cleanup(cfg);
+        merge_trivial_blocks(cfg);
+        compute_dominators(cfg);
+    }
+    set_free(seen, seen_count);
+    return cfg;
+}
+
+static CFG* vectorize_loops(IRProgram *prog, IRFunc *f, CFG *cfg) {
+    return rewrite_loops(prog, f, cfg, vectorize_loop);
+}
+
+/* --- Loop Idiom Recognition ---
+ *
+ * Counted loops that only fill or copy an int array,
+ *
+ *     for (; i < n; i++) a[i + c] = v;            v loop-invariant
+ *     for (; i < n; i++) a[i + c] = b[i + d];
+ *
+ * become one call into the runtime (src/mem_runtime.s):
+ *
+ *     __paninic_memset32(&a[i + c], v, n - i)
+ *     __paninic_memcpy(&a[i + c], &b[i + d], (n - i) * 4)
+ *
+ * which store 8 bytes at a time, or a vector register group at a time
+ * with -march=rv64gcv (the _rvv entry points, src/mem_runtime_rvv.s).
+ * Both return at once for a count <= 0, and i leaves with max(i, n), as
+ * the loop would. A copy needs source and destination ranges that cannot
+ * overlap: different arrays (see Memory Disambiguation), or two parts of
+ * one array that no pair of iterations reads and writes alike (Dependence
+ * Analysis). Runs after LICM and unswitching have moved the
+ * invariant parts out of the loop, and before the vectorizer, which would
+ * otherwise outline the same loops into kernels.
+ */
+
+#define IDIOM_MIN_TRIPS 16  /* shorter loops are left to the full unroller */
+
+/* An int array access in the body: invariant base, index i + koff + off. */
+static int idiom_access(IRInstr *ins, CountedLoop *cl, int pos, int *loop_blocks, CFG *cfg, Scope *scope,
+                        const char **koff, int *off) {
+    return !ins->base.is_const && ins->base.name && ins->scale == 4 &&
+           vec_base_kind(ins->base.name, scope) &&
+           !is_name_defined_in_loop(ins->base.name, loop_blocks, cfg) &&
+           vec_split_index(&ins->index, cl->ivar, cl->body, pos, loop_blocks, cfg, koff, off);
+}
+
+static int recognize_loop_idiom(IRProgram *prog, CFG *cfg, BasicBlock *h, BasicBlock *latch, int *loop_blocks) {
+    (void)prog;
+    Symbol *fsym = lookup(cfg->func_name);
+    Scope *scope = (fsym && fsym->kind == SYM_FUNCTION) ? fsym->scope : NULL;
+    CountedLoop cl;
+    if (match_counted_loop(cfg, h, latch, loop_blocks, scope, 0, &cl)) return 0;
+    long long trips = profile_loop_trips(h, cl.preheader);
+    int init = 0;
+    if (trips < 0 && cl.bound->is_const && scev_initial_value(cl.preheader, cl.ivar, scope, &init))
+        trips = (long long)cl.bound->const_val - init + (cl.relop == IR_LE);
+    if (trips >= 0 && trips < IDIOM_MIN_TRIPS) return 0;
+
+    /* One store, at most one load before it, and index arithmetic. */
+    int st = -1, ld = -1;
+    for (int j = 0; j < cl.n; j++) {
+        IRInstr *ins = cl.body[j];
+        if (ins->kind == IR_STORE && st < 0) st = j;
+        else if (ins->kind == IR_LOAD && ld < 0 && st < 0) ld = j;
+        else if (ins->kind != IR_BINOP || (ins->binop != '+' && ins->binop != '-')) return 0;
+    }
+    if (st < 0) return 0;
+    IRInstr *store = cl.body[st];
+    const char *dkoff, *skoff = NULL;
+    int doff, soff = 0;
+    if (!idiom_access(store, &cl, st, loop_blocks, cfg, scope, &dkoff, &doff)) return 0;
+
+    IRInstr *load = (ld >= 0) ? cl.body[ld] : NULL;
+    IROperand *v = &store->store_val;
+    if (load) {
+        /* b[i + d] goes straight into a[i + c], and nowhere else. */
+        if (!vec_is_name(v, load->result) ||
+            !idiom_access(load, &cl, ld, loop_blocks, cfg, scope, &skoff, &soff))
+            return 0;
+        for (int j = 0; j < cl.n; j++)
+            if (cl.body[j] != store && vec_reads_name(cl.body[j], load->result)) return 0;
+        /* No element is both read and written: the ranges are apart. */
+        DepLoop range;
+        DepSubscript ds, ss;
+        Dependence dep;
+        dep_counter_range(cl.preheader, cl.ivar, cl.bound, cl.relop, scope, &range);
+        vec_subscript(dkoff, doff, &ds);
+        vec_subscript(skoff, soff, &ss);
+        if (access_dependence(cfg, store, &ds, load, &ss, &range, &dep)) return 0;
+    } else if (!v->is_const) {
+        /* The fill value is read once, before the first store. */
+        Symbol *s = v->name ? lookup_ir_name(v->name, scope) : NULL;
+        if (!v->name || strcmp(v->name, cl.ivar) == 0 || is_name_defined_in_loop(v->name, loop_blocks, cfg) ||
+            strncmp(v->name, ".LC", 3) == 0 ||
+            (s && (s->is_array || s->pointer_level > 0 || s->kind == SYM_FUNCTION)) ||
+            (is_memory_resident_name(v->name) && vec_base_kind(store->base.name, scope) == 2))
+            return 0;
+    }
+
+    /* Nothing the body computes may be needed after the loop. */
+    compute_liveness(cfg);
+    BasicBlock *exit_block = cl.exit_block;
+    for (int j = 0; j < cl.n; j++)
+        if (cl.body[j]->result && set_contains(exit_block->live_in, exit_block->live_in_count, cl.body[j]->result))
+            return 0;
+    if (cl.upd_tmp && set_contains(exit_block->live_in, exit_block->live_in_count, cl.upd_tmp->result))
+        return 0;
+
+    int line = cl.test->line;
+    char *end_name = new_opt_temp("liend");
+    char *count = new_opt_temp("lin");
+    char *bytes = new_opt_temp("lib");
+    char *entry_label;
+    IRInstr *head = NULL, *tail = NULL;
+    IROperand end = counted_loop_begin(&cl, end_name, &entry_label, &head, &tail);
+    IROperand dst = element_address(store->base.name, scope, ir_op_name((char *)cl.ivar), dkoff, doff, line, &head, &tail);
+    IROperand src = load ? element_address(load->base.name, scope, ir_op_name((char *)cl.ivar), skoff, soff, line,
+                                           &head, &tail)
+                         : ir_op_copy(v);
+    append_instr(&head, &tail, ir_make_binop(count, end, ir_op_name((char *)cl.ivar), '-', line));
+    if (load) append_instr(&head, &tail, ir_make_binop(bytes, ir_op_name(count), ir_op_const(4), '*', line));
+    append_instr(&head, &tail, ir_make_param(dst, line));
+    append_instr(&head, &tail, ir_make_param(src, line));
+    append_instr(&head, &tail, ir_make_param(ir_op_name(load ? bytes : count), line));
+    const char *fn = load ? (riscv_ext_v ? "__paninic_memcpy_rvv" : "__paninic_memcpy")
+                          : (riscv_ext_v ? "__paninic_memset32_rvv" : "__paninic_memset32");
+    append_instr(&head, &tail, ir_make_call_void((char *)fn, 3, line));
+    counted_loop_replace(&cl, h, entry_label, end, head, tail);
+    free(end_name);
+    free(count);
+    free(bytes);
+
+    if (riscv_ext_v) {
+        char msg[200];
+        snprintf(msg, sizeof(msg), "%s idiom, replaced by a call to %s", load ? "copy" : "fill", fn);
+        vec_note(cfg, cl.test, msg);
+    }
+    return 1;
+}
+
+static CFG* recognize_loop_idioms(IRProgram *prog, IRFunc *f, CFG *cfg) {
+    return rewrite_loops(prog, f, cfg, recognize_loop_idiom);
+}
+
+/* --- Loop Reversal ---
+ *
+ * A counted loop running down,
+ *
+ *     for (; i >= n; i--) body(i)          (or i > n)
+ *
+ * whose iterations may run in any order is run upwards over the same
+ * values, on a fresh counter:
+ *
+ *     e := i
+ *     lo := n                              (n + 1 for i > n)
+ *     j := lo
+ *     i := i < lo ? i : lo - 1             (what the loop leaves in i)
+ *   header:
+ *     if j <= e goto body
+ *   body:
+ *     body(j)
+ *     j := j + 1
+ *
+ * so the idiom recognizer and the vectorizer, which only take loops
+ * counting up over elements a[i + k + c], see it. The order does not
+ * matter when no access that may reach memory a store touches does so in
+ * another iteration (Dependence Analysis: a[i] and a[i] meet only within
+ * one iteration, a[i + 32] and a[i] never while i < 32), nothing is
+ * carried from one iteration to the next but a sum s := s + v, and
+ * nothing else the body computes is used after the loop.
+ */
+
+static int instr_use_operands(IRInstr *ins, IROperand **ops);
+
+
+/* r is carried from one iteration to the next only as a sum: one
+   r := r + v (or t := r + v; r := t) and no other read of r. */
+static int reverse_sum_carried(CountedLoop *cl, const char *r) {
+    IRInstr *add = NULL, *def = NULL;
+    int reads = 0, defs = 0;
+    for (int j = 0; j < cl->n; j++) {
+        if (vec_reads_name(cl->body[j], r)) { reads++; add = cl->body[j]; }
+        if (cl->body[j]->result && strcmp(cl->body[j]->result, r) == 0) { defs++; def = cl->body[j]; }
+    }
+    if (reads != 1 || defs != 1 || add->kind != IR_BINOP || add->binop != '+' ||
+        vec_is_name(&add->left, r) == vec_is_name(&add->right, r))
+        return 0;
+    if (add == def) return 1;
+    if (def->kind != IR_ASSIGN || !vec_is_name(&def->src, add->result) ||
+        set_contains(cl->exit_block->live_in, cl->exit_block->live_in_count, add->result))
+        return 0;
+    for (int j = 0; j < cl->n; j++)
+        if (cl->body[j] != def && vec_reads_name(cl->body[j], add->result)) return 0;
+    return 1;
+}
+
+static int reverse_loop(IRProgram *prog, CFG *cfg, BasicBlock *h, BasicBlock *latch, int *loop_blocks) {
+    (void)prog;
+    Symbol *fsym = lookup(cfg->func_name);
+    Scope *scope = (fsym && fsym->kind == SYM_FUNCTION) ? fsym->scope : NULL;
+    CountedLoop cl;
+    if (match_counted_loop(cfg, h, latch, loop_blocks, scope, 1, &cl) || cl.step != -1 || profile_cold_loop(h))
+        return 0;
+    long long trips = profile_loop_trips(h, cl.preheader);
+    int init = 0;
+    if (trips < 0 && cl.bound->is_const && scev_initial_value(cl.preheader, cl.ivar, scope, &init))
+        trips = (long long)init - cl.bound->const_val + (cl.relop == IR_GE);
+    if (trips >= 0 && trips < VEC_MIN_TRIPS) return 0;
+    /* Without vector code to go to, the full unroller straightens a loop
+       of known length whichever way it runs. */
+    if (!riscv_ext_v && trips >= 0 && !profile_available()) return 0;
+
+    /* Accesses, with their indices in terms of i. */
+    IRInstr *acc[VEC_MAX_BODY];
+    DepSubscript subs[VEC_MAX_BODY];
+    int nacc = 0, stores = 0, reads_memory_name = 0;
+    SCEVScan s;
+    scev_begin(&s, cfg, loop_blocks, cl.ivar);
+    int ok = 1;
+    for (int j = 0; j < cl.n && ok; j++) {
+        IRInstr *ins = cl.body[j];
+        if (ins->kind == IR_LOAD || ins->kind == IR_STORE) {
+            SCEVValue idx;
+            int known = scev_operand(&s, &ins->index, &idx);
+            dep_subscript(known, &idx, &subs[nacc]);
+            acc[nacc++] = ins;
+            if (ins->kind == IR_STORE) stores++;
+            ok = known && idx.coef == 1;    /* what the loops counting up take */
+        } else if (ins->kind != IR_ASSIGN && ins->kind != IR_BINOP && ins->kind != IR_UNOP) {
+            ok = 0;
+        }
+        IROperand *ops[4];
+        int k = instr_use_operands(ins, ops);
+        for (int q = 0; q < k; q++)
+            if (!ops[q]->is_const && is_memory_resident_name(ops[q]->name)) reads_memory_name = 1;
+        scev_transfer(&s, ins);
+    }
+    DepLoop range;
+    dep_counter_range(cl.preheader, cl.ivar, cl.bound, cl.relop, scope, &range);
+    for (int a = 0; a < nacc && ok; a++) {
+        if (acc[a]->kind != IR_STORE) continue;
+        for (int b = 0; b < nacc && ok; b++) {
+            Dependence dep;
+            if (b < a && acc[b]->kind == IR_STORE) continue;
+            ok = !access_dependence(cfg, acc[a], &subs[a], acc[b], &subs[b], &range, &dep) ||
+                 dep.dir[0] == DEP_EQ;
+        }
+    }
+    scev_end(&s);
+    for (int a = 0; a < nacc; a++) free((void *)subs[a].sym);
+    if (!ok || nacc == 0 || (stores && reads_memory_name)) return 0;
+
+    /* Scalars: per-iteration values not used after the loop, or sums. */
+    compute_liveness(cfg);
+    for (int j = 0; j < cl.n; j++) {
+        const char *r = cl.body[j]->result;
+        if (!r) continue;
+        if (!is_register_candidate_name(r, scope)) return 0;
+        int carried = 0;
+        for (int q = 0; q <= j && !carried; q++)
+            if (vec_reads_name(cl.body[q], r)) {
+                int redefined = 0;
+                for (int p = 0; p < q; p++)
+                    if (cl.body[p]->result && strcmp(cl.body[p]->result, r) == 0) redefined = 1;
+                carried = !redefined;
+            }
+        if (carried ? !reverse_sum_carried(&cl, r)
+                    : set_contains(cl.exit_block->live_in, cl.exit_block->live_in_count, r))
+            return 0;
+    }
+    if (cl.upd_tmp && set_contains(cl.exit_block->live_in, cl.exit_block->live_in_count, cl.upd_tmp->result))
+        return 0;
+
+    /* Count up on j; i gets its exit value up front. */
+    int line = cl.test->line;
+    char *j = new_opt_temp("rvj");
+    char *e = new_opt_temp("rve");
+    char *lo = new_opt_temp("rvl");
+    char *last = new_opt_temp("rvx");
+    char *entry_label = ir_new_label();
+    IRInstr *head = NULL, *tail = NULL;
+    append_instr(&head, &tail, ir_make_label(entry_label, line));
+    append_instr(&head, &tail, ir_make_assign(e, ir_op_name((char *)cl.ivar), line));
+    if (cl.relop == IR_GE)
+        append_instr(&head, &tail, ir_make_assign(lo, *cl.bound, line));
+    else
+        append_instr(&head, &tail, ir_make_binop(lo, *cl.bound, ir_op_const(1), '+', line));
+    append_instr(&head, &tail, ir_make_assign(j, ir_op_name(lo), line));
+    append_instr(&head, &tail, ir_make_binop(last, ir_op_name(lo), ir_op_const(1), '-', line));
+    append_instr(&head, &tail, ir_make_select((char *)cl.ivar, ir_op_name((char *)cl.ivar), ir_op_name(lo), IR_LT,
+                                              ir_op_name((char *)cl.ivar), ir_op_name(last), line));
+
+    for (IRInstr *cur = latch->instrs, *prev = NULL; cur; prev = cur, cur = (cur == latch->last) ? NULL : cur->next) {
+        if (cur->result && strcmp(cur->result, cl.ivar) == 0) {
+            IRInstr *step = ir_make_binop(j, ir_op_name(j), ir_op_const(1), '+', cur->line);
+            step->next = cur->next;
+            if (prev) prev->next = step;
+            else latch->instrs = step;
+            if (latch->last == cur) latch->last = step;
+            free_instr_single(cur);
+            cur = step;
+            continue;
+        }
+        IROperand *ops[4];
+        int k = instr_use_operands(cur, ops);
+        for (int q = 0; q < k; q++)
+            if (vec_is_name(ops[q], cl.ivar)) {
+                ir_free_operand(ops[q]);
+                *ops[q] = ir_op_name(j);
+            }
+    }
+    IRInstr *test = cl.test;
+    int to_body = find_bb_by_label(cfg->blocks, test->label) == latch;
+    ir_free_operand(&test->if_left);
+    ir_free_operand(&test->if_right);
+    test->if_left = ir_op_name(j);
+    test->if_right = ir_op_name(e);
+    test->relop = to_body ? IR_LE : IR_GT;
+    counted_loop_splice(&cl, h, entry_label, head, tail);
+    free(j);
+    free(e);
+    free(lo);
+    free(last);
+    return 1;
+}
+
+static CFG* reverse_loops(IRProgram *prog, IRFunc *f, CFG *cfg) {
+    return rewrite_loops(prog, f, cfg, reverse_loop);
+}
+
+/* --- Loop Versioning ---
+ *
+ * A counted loop whose stores might reach memory its other accesses use,
+ * only because two bases cannot be told apart statically (two pointer
+ * parameters, a pointer and an array whose address was taken), gets a
+ * copy that assumes they do not overlap, chosen by a runtime check:
+ *
+ *     entry:  lo_a := &a[i + c_min]   hi_a := &a[n + c_max]     per base
+ *             if lo_a >= hi_b goto ok1                           per pair
+ *             if lo_b < hi_a goto slow
+ *     ok1:    ...
+ *     fast:   if i < n goto body'
+ *             goto exit
+ *     body':  the body, the accesses of each base in an alias set of
+ *             their own; goto fast
+ *     slow:   the original loop
+ *
+ * [lo, hi) covers every element the loop can reach through a base: its
+ * unit-stride accesses a[i + k + c], or the one element of an invariant
+ * index. When no stored range overlaps another, accesses through
+ * different bases of the copy never meet, which is what the alias sets
+ * tell LICM, the idiom recognizer, the vectorizer and the scheduler. A
+ * loop is versioned only when one of them gains: an invariant load behind
+ * a store, a copy a[i] = b[i], or with -march=rv64gcv any unit-stride
+ * loop. Runs before LICM, on loops not yet outlined or unrolled.
+ */
+
+#define VERSION_MAX_BASES  4
+#define VERSION_MAX_CHECKS 4
+
+typedef struct {
+    const char *base;
+    int unit;           /* 1: elements i + koff + [lo, hi], 0: koff + [lo, hi] */
+    const char *koff;   /* loop-invariant name, or NULL */
+    int lo, hi;
+    int stored, loaded;
+    int alias_set;
+} VersionRange;
+
+static int version_counter = 0;
+
+static int version_add_access(VersionRange *ranges, int *count, IRInstr *ins, CountedLoop *cl, int pos,
+                              int *loop_blocks, CFG *cfg, Scope *scope) {
+    if (ins->base.is_const || !ins->base.name || ins->scale != 4 || !vec_base_kind(ins->base.name, scope) ||
+        is_name_defined_in_loop(ins->base.name, loop_blocks, cfg))
+        return 0;
+    const char *koff = NULL;
+    int off = 0, unit = vec_split_index(&ins->index, cl->ivar, cl->body, pos, loop_blocks, cfg, &koff, &off);
+    if (!unit) {
+        /* A fixed element: a constant or loop-invariant index. */
+        if (ins->index.is_const) off = ins->index.const_val;
+        else if (ins->index.name && !is_name_defined_in_loop(ins->index.name, loop_blocks, cfg)) koff = ins->index.name;
+        else return 0;
+    }
+
+    VersionRange *r = NULL;
+    for (int k = 0; k < *count; k++)
+        if (strcmp(ranges[k].base, ins->base.name) == 0) r = &ranges[k];
+    if (!r) {
+        if (*count == VERSION_MAX_BASES) return 0;
+        r = &ranges[(*count)++];
+        memset(r, 0, sizeof(*r));
+        r->base = ins->base.name;
+        r->unit = unit;
+        r->koff = koff;
+        r->lo = r->hi = off;
+    } else {
+        /* One base, one form of index. */
+        if (r->unit != unit || (r->koff == NULL) != (koff == NULL) || (koff && strcmp(r->koff, koff) != 0))
+            return 0;
+        if (off < r->lo) r->lo = off;
+        if (off > r->hi) r->hi = off;
+    }
+    if (ins->kind == IR_STORE) r->stored = 1;
+    else r->loaded = 1;
+    return 1;
+}
+
+/* [lo, hi) of a range, ahead of the loop. */
+static void version_bounds(VersionRange *r, CountedLoop *cl, IROperand end, Scope *scope, int line,
+                           IRInstr **head, IRInstr **tail, IROperand *lo, IROperand *hi) {
+    if (r->unit) {
+        *lo = element_address(r->base, scope, ir_op_name((char *)cl->ivar), r->koff, r->lo, line, head, tail);
+        *hi = element_address(r->base, scope, end, r->koff, r->hi, line, head, tail);
+    } else {
+        *lo = element_address(r->base, scope, ir_op_const(0), r->koff, r->lo, line, head, tail);
+        *hi = element_address(r->base, scope, ir_op_const(0), r->koff, r->hi + 1, line, head, tail);
+    }
+}
+
+static int version_loop(IRProgram *prog, CFG *cfg, BasicBlock *h, BasicBlock *latch, int *loop_blocks) {
+    (void)prog;
+    Symbol *fsym = lookup(cfg->func_name);
+    Scope *scope = (fsym && fsym->kind == SYM_FUNCTION) ? fsym->scope : NULL;
+    CountedLoop cl;
+    if (match_counted_loop(cfg, h, latch, loop_blocks, scope, 0, &cl) || profile_cold_loop(h)) return 0;
+    if (latch->last->kind != IR_GOTO) return 0;
+    long long trips = profile_loop_trips(h, cl.preheader);
+    int init = 0;
+    if (trips < 0 && cl.bound->is_const && scev_initial_value(cl.preheader, cl.ivar, scope, &init))
+        trips = (long long)cl.bound->const_val - init + (cl.relop == IR_LE);
+    if (trips >= 0 && trips < VEC_MIN_TRIPS) return 0;
+
+    /* Ranges of the bases; a body already versioned has alias sets. */
+    VersionRange ranges[VERSION_MAX_BASES];
+    int nr = 0, loads = 0, stores = 0, calls = 0;
+    for (int j = 0; j < cl.n; j++) {
+        IRInstr *ins = cl.body[j];
+        if (ins->kind == IR_CALL || ins->kind == IR_CALL_INDIRECT) calls = 1;
+        if (ins->kind != IR_LOAD && ins->kind != IR_STORE) continue;
+        if (ins->alias_set || !version_add_access(ranges, &nr, ins, &cl, j, loop_blocks, cfg, scope)) return 0;
+        if (ins->kind == IR_STORE) stores++;
+        else loads++;
+    }
+
+    /* Pairs only a runtime check can tell apart. */
+    int check_a[VERSION_MAX_CHECKS], check_b[VERSION_MAX_CHECKS];
+    int nc = 0, gain = 0;
+    for (int a = 0; a < nr; a++) {
+        for (int b = 0; b < nr; b++) {
+            if (a == b || !ranges[a].stored || (ranges[b].stored && b < a)) continue;
+            if (!bases_may_alias(cfg, scope, ranges[a].base, ranges[b].base)) continue;
+            if (nc == VERSION_MAX_CHECKS) return 0;
+            check_a[nc] = a;
+            check_b[nc++] = b;
+            if (!ranges[b].unit && ranges[b].loaded && !calls) gain = 1;   /* LICM */
+        }
+    }
+    if (nc == 0) return 0;
+    int unit_only = 1;
+    for (int r = 0; r < nr; r++)
+        if (!ranges[r].unit) unit_only = 0;
+    if (unit_only && (riscv_ext_v || (loads == 1 && stores == 1 && cl.n <= 3))) gain = 1;
+    if (!gain) return 0;
+
+    int line = cl.test->line;
+    char *end_name = new_opt_temp("vrend");
+    char *entry_label;
+    IRInstr *head = NULL, *tail = NULL;
+    IROperand end = counted_loop_begin(&cl, end_name, &entry_label, &head, &tail);
+    IROperand lo[VERSION_MAX_BASES], hi[VERSION_MAX_BASES];
+    for (int r = 0; r < nr; r++) {
+        version_bounds(&ranges[r], &cl, end, scope, line, &head, &tail, &lo[r], &hi[r]);
+        ranges[r].alias_set = ++version_counter;
+    }
+
+    /* Disjoint when one range ends before the other starts. */
+    char *slow = ir_new_label();
+    for (int c = 0; c < nc; c++) {
+        int a = check_a[c], b = check_b[c];
+        char *ok = ir_new_label();
+        append_instr(&head, &tail, ir_make_if(lo[a], hi[b], IR_GE, ok, line));
+        append_instr(&head, &tail, ir_make_if(lo[b], hi[a], IR_LT, slow, line));
+        append_instr(&head, &tail, ir_make_label(ok, line));
+        free(ok);
+    }
+
+    /* The checked copy. */
+    char *fast = ir_new_label(), *fast_body = ir_new_label();
+    append_instr(&head, &tail, ir_make_label(fast, line));
+    append_instr(&head, &tail, ir_make_if(ir_op_name((char *)cl.ivar), *cl.bound, cl.relop, fast_body, line));
+    append_instr(&head, &tail, ir_make_goto((char *)loop_exit_label(cl.exit_block), line));
+    append_instr(&head, &tail, ir_make_label(fast_body, line));
+    IRInstr *first = latch->instrs->kind == IR_LABEL ? latch->instrs->next : latch->instrs;
+    for (IRInstr *cur = first; cur && cur != latch->last; cur = cur->next) {
+        IRInstr *c = clone_instr(cur);
+        if (c->kind == IR_LOAD || c->kind == IR_STORE)
+            for (int r = 0; r < nr; r++)
+                if (strcmp(ranges[r].base, c->base.name) == 0) c->alias_set = ranges[r].alias_set;
+        append_instr(&head, &tail, c);
+    }
+    append_instr(&head, &tail, ir_make_goto(fast, line));
+    append_instr(&head, &tail, ir_make_label(slow, line));
+    counted_loop_splice(&cl, h, entry_label, head, tail);
+    free(slow);
+    free(fast);
+    free(fast_body);
+    free(end_name);
+    return 1;
+}
+
+static CFG* version_loops(IRProgram *prog, IRFunc *f, CFG *cfg) {
+    return rewrite_loops(prog, f, cfg, version_loop);
+}
+
+/* --- Induction Variable Strength Reduction ---
+ *
+ * For an innermost loop with a basic induction variable i (every definition
+ * of i in the loop is i := i + step, possibly through temps, as in unrolled
+ * bodies), each access a[m * i + k + c] whose base is loop-invariant (m
+ * and c constants, k an optional invariant name, as Scalar Evolution
+ * reads the index) is given a pointer
+ *
+ *     preheader:             p := &a + (m * i + k) * scale
+ *     after each i update:   p := p + m * step * scale
+ *
+ * and becomes an access p[c]. Since p is advanced right next to every
+ * definition of i, p == &a + (m * i + k) * scale holds at every point of
+ * the loop, whichever way the body branches. The old IVE pass instead assumed a
+ * constant start value and rewrote derived values in place, which broke
+ * loops with internal control flow.
+ *
+ * Linear-function test replacement: if afterwards i (and the temps that
+ * only carry i + c) feed nothing but their own update and the loop tests,
+ * and none of them is live on exit, each test `i relop n` becomes
+ * `p relop &a + n * scale` for a pointer with m == 1 and no k, and the
+ * whole update chain is deleted.
+ *
+ * Runs after unrolling on the rebuilt CFG, so the unrollers still see the
+ * original counters.
+ */
+
+#define IVSR_MAX_PTRS    8
+#define IVSR_MAX_UPDATES 8
+#define IVSR_MAX_COEF    4096
+
+typedef struct {
+    char *base;     /* original array/pointer operand */
+    int scale;
+    int coef;       /* m */
+    char *sym;      /* k, or NULL */
+    char *addr;     /* &base (or base itself for pointers) */
+    char *ptr;      /* base + (m * i + k) * scale, maintained across the loop */
+} IVPointer;
+
+/* Is `name` a basic IV: is every definition of it in the loop provably
+   name := name + c? Returns the number of such definitions (0 if not). */
+static int count_iv_increments(const char *name, int *loop_blocks, CFG *cfg) {
+    int defs = 0;
+    for (BasicBlock *bb = cfg->blocks; bb; bb = bb->next) {
+        if (!loop_blocks[bb->id]) continue;
+        SCEVScan s;
+        scev_begin(&s, cfg, loop_blocks, name);
+        for (IRInstr *cur = bb->instrs; cur; cur = cur->next) {
+            if (cur->result && strcmp(cur->result, name) == 0) {
+                SCEVValue v;
+                if (!scev_eval(&s, cur, &v) || v.coef != 1 || v.sym) { scev_end(&s); return 0; }
+                defs++;
+            }
+            scev_transfer(&s, cur);
+            if (cur == bb->last) break;
+        }
+        scev_end(&s);
+    }
+    return defs;
+}
+
+/* Can `base` be turned into a loop-carried pointer? Returns 1 for an
+   array (address taken with &), 2 for a pointer value, 0 if not. */
+static int iv_base_kind(const char *base, int *loop_blocks, CFG *cfg, Scope *scope) {
+    if (!base || strncmp(base, ".LC", 3) == 0 || strncmp(base, "vtable_", 7) == 0) return 0;
+    if (is_name_defined_in_loop(base, loop_blocks, cfg)) return 0;
+    Symbol *sym = lookup_ir_name(base, scope);
+    if (!sym) return 2;
+    if (sym->scope_level == 0) return 0;
+    if (sym->pointer_level > 0 || sym->kind == SYM_PARAMETER || sym->is_vla)
+        return sym->is_address_taken ? 0 : 2;
+    return sym->is_array ? 1 : 0;
+}
+
+static void insert_instr_after(BasicBlock *bb, IRInstr *pos, IRInstr *ins) {
+    ins->next = pos->next;
+    pos->next = ins;
+    if (bb->last == pos) bb->last = ins;
+}
+
+/* Insert before the preheader's terminator (it falls or jumps into the loop). */
+static void append_to_preheader(BasicBlock *pre, IRInstr *ins) {
+    IRInstr *last = pre->last;
+    if (!last) {
+        pre->instrs = pre->last = ins;
+        return;
+    }
+    if (last->kind != IR_GOTO && last->kind != IR_IF && last->kind != IR_SWITCH) {
+        insert_instr_after(pre, last, ins);
+        return;
+    }
+    if (pre->instrs == last) {
+        ins->next = last;
+        pre->instrs = ins;
+        return;
+    }
+    IRInstr *prev = pre->instrs;
+    while (prev->next != last) prev = prev->next;
+    ins->next = last;
+    prev->next = ins;
+}
+
+static void remove_instr_from_block(BasicBlock *bb, IRInstr *ins) {
+    IRInstr *prev = NULL;
+    for (IRInstr *cur = bb->instrs; cur; prev = cur, cur = cur->next) {
+        if (cur != ins) {
+            if (cur == bb->last) return;
+            continue;
+        }
+        if (prev) prev->next = cur->next;
+        else bb->instrs = (cur == bb->last) ? NULL : cur->next;
+        if (bb->last == cur) bb->last = prev;
+        free_instr_single(cur);
+        return;
+    }
+}
+
+static int instr_use_operands(IRInstr *ins, IROperand **ops) {
+    int n = 0;
+    switch (ins->kind) {
+        case IR_ASSIGN: case IR_RETURN: case IR_THROW: case IR_PARAM: case IR_ALLOCA: case IR_SWITCH:
+            ops[n++] = &ins->src; break;
+        case IR_BINOP: ops[n++] = &ins->left; ops[n++] = &ins->right; break;
+        case IR_UNOP: ops[n++] = &ins->unop_src; break;
+        case IR_IF: ops[n++] = &ins->if_left; ops[n++] = &ins->if_right; break;
+        case IR_SELECT:
+            ops[n++] = &ins->if_left; ops[n++] = &ins->if_right;
+            ops[n++] = &ins->left; ops[n++] = &ins->right; break;
+        case IR_LOAD: case IR_PREFETCH: ops[n++] = &ins->base; ops[n++] = &ins->index; break;
+        case IR_STORE: ops[n++] = &ins->base; ops[n++] = &ins->index; ops[n++] = &ins->store_val; break;
+        case IR_CALL_INDIRECT: ops[n++] = &ins->base; break;
+        default: break;
+    }
+    return n;
+}
+
+static int name_in_set(char **set, int count, const char *name) {
+    return name && set_contains(set, count, name);
+}
+
+/* Is `ins` a definition of the form x := f or x := f +/- c with f in the family? */
+static int is_family_update(IRInstr *ins, char **family, int fam_count) {
+    if (ins->kind == IR_ASSIGN)
+        return !ins->src.is_const && name_in_set(family, fam_count, ins->src.name);
+    if (ins->kind != IR_BINOP || (ins->binop != '+' && ins->binop != '-')) return 0;
+    if (ins->right.is_const && name_in_set(family, fam_count, ins->left.name)) return 1;
+    return ins->binop == '+' && ins->left.is_const && name_in_set(family, fam_count, ins->right.name);
+}
+
+/* Linear-function test replacement for i, using pointer `ptr` of `scale`
+   anchored at `addr`. Returns 1 if the loop tests were rewritten. */
+static int replace_iv_tests(CFG *cfg, int *loop_blocks, BasicBlock *pre, const char *iv,
+                            IVPointer *ptr, Scope *scope) {
+    /* The family: i plus every name whose loop definitions all carry i + c. */
+    char **family = NULL;
+    int fam_count = 0;
+    set_add(&family, &fam_count, iv);
+    int grew = 1;
+    while (grew) {
+        grew = 0;
+        for (BasicBlock *bb = cfg->blocks; bb; bb = bb->next) {
+            if (!loop_blocks[bb->id]) continue;
+            for (IRInstr *cur = bb->instrs; cur; cur = cur->next) {
+                if (cur->result && !name_in_set(family, fam_count, cur->result) &&
+                    is_family_update(cur, family, fam_count) &&
+                    is_register_candidate_name(cur->result, scope)) {
+                    int all = 1;
+                    for (BasicBlock *ob = cfg->blocks; ob && all; ob = ob->next) {
+                        if (!loop_blocks[ob->id]) continue;
+                        for (IRInstr *d = ob->instrs; d; d = d->next) {
+                            if (d->result && strcmp(d->result, cur->result) == 0 &&
+                                !is_family_update(d, family, fam_count)) { all = 0; break; }
+                            if (d == ob->last) break;
+                        }
+                    }
+                    if (all) { set_add(&family, &fam_count, cur->result); grew = 1; }
+                }
+                if (cur == bb->last) break;
+            }
+        }
+    }
+
+    /* Every use of the family must be a family update or a test of i
+       against a loop-invariant value, and nothing may be live on exit.
+       The limit is computed once in the preheader, so a global or
+       address-taken bound must not change behind a store or call. */
+    int has_mem_effects = loop_writes_memory(loop_blocks, cfg);
+    int ok = 1, tests = 0;
+    for (BasicBlock *bb = cfg->blocks; bb && ok; bb = bb->next) {
+        if (!loop_blocks[bb->id]) continue;
+        for (int k = 0; k < bb->succ_count && ok; k++) {
+            BasicBlock *succ = bb->succs[k];
+            if (loop_blocks[succ->id]) continue;
+            for (int f = 0; f < fam_count; f++)
+                if (set_contains(succ->live_in, succ->live_in_count, family[f])) { ok = 0; break; }
+        }
+        for (IRInstr *cur = bb->instrs; cur && ok; cur = cur->next) {
+            IROperand *ops[4];
+            int n = instr_use_operands(cur, ops);
+            int uses_family = 0;
+            for (int k = 0; k < n; k++)
+                if (!ops[k]->is_const && name_in_set(family, fam_count, ops[k]->name)) uses_family = 1;
+            if (uses_family && !(cur->result && name_in_set(family, fam_count, cur->result))) {
+                if (cur->kind != IR_IF) { ok = 0; break; }
+                IROperand *ivop = NULL, *other = NULL;
+                if (cur->if_left.name && strcmp(cur->if_left.name, iv) == 0) { ivop = &cur->if_left; other = &cur->if_right; }
+                else if (cur->if_right.name && strcmp(cur->if_right.name, iv) == 0) { ivop = &cur->if_right; other = &cur->if_left; }
+                if (!ivop || (!other->is_const && name_in_set(family, fam_count, other->name)) ||
+                    !is_invariant_operand(other, loop_blocks, cfg, scope, has_mem_effects)) {
+                    ok = 0; break;
+                }
+                tests++;
+            }
+            if (cur == bb->last) break;
+        }
+    }
+    if (!ok || tests == 0) {
+        set_free(family, fam_count);
+        return 0;
+    }
+
+    int line = pre->last ? pre->last->line : 0;
+    for (BasicBlock *bb = cfg->blocks; bb; bb = bb->next) {
+        if (!loop_blocks[bb->id]) continue;
+        IRInstr *cur = bb->instrs;
+        while (cur) {
+            IRInstr *next = (cur == bb->last) ? NULL : cur->next;
+            if (cur->kind == IR_IF) {
+                IROperand *ivop = NULL, *other = NULL;
+                if (cur->if_left.name && strcmp(cur->if_left.name, iv) == 0) { ivop = &cur->if_left; other = &cur->if_right; }
+                else if (cur->if_right.name && strcmp(cur->if_right.name, iv) == 0) { ivop = &cur->if_right; other = &cur->if_left; }
+                if (ivop) {
+                    /* i relop n  <=>  addr + i*scale relop addr + n*scale  (scale > 0) */
+                    char *limit = new_opt_temp("ivl");
+                    if (other->is_const) {
+                        append_to_preheader(pre, ir_make_binop(limit, ir_op_name(ptr->addr),
+                                                               ir_op_const(other->const_val * ptr->scale), '+', line));
+                    } else {
+                        char *span = new_opt_temp("ivo");
+                        append_to_preheader(pre, ir_make_binop(span, *other, ir_op_const(ptr->scale), '*', line));
+                        append_to_preheader(pre, ir_make_binop(limit, ir_op_name(ptr->addr), ir_op_name(span), '+', line));
+                        free(span);
+                    }
+                    ir_free_operand(ivop);
+                    *ivop = ir_op_name(ptr->ptr);
+                    ir_free_operand(other);
+                    *other = ir_op_name(limit);
+                    free(limit);
+                }
+            } else if (cur->result && name_in_set(family, fam_count, cur->result)) {
+                remove_instr_from_block(bb, cur);
+            }
+            cur = next;
+        }
+    }
+    set_free(family, fam_count);
+    return 1;
+}
+
+static void strength_reduce_loop(CFG *cfg, BasicBlock *h, int *loop_blocks, BasicBlock *pre, Scope *scope) {
+    /* Candidate basic IVs: every name defined in the loop. */
+    char **cands = NULL;
+    int cand_count = 0;
+    for (BasicBlock *bb = cfg->blocks; bb; bb = bb->next) {
+        if (!loop_blocks[bb->id]) continue;
+        for (IRInstr *cur = bb->instrs; cur; cur = cur->next) {
+            if (cur->kind == IR_TRY_BEGIN || cur->kind == IR_TRY_END) { set_free(cands, cand_count); return; }
+            if (cur->result && !set_contains(cands, cand_count, cur->result))
+                set_add(&cands, &cand_count, cur->result);
+            if (cur == bb->last) break;
+        }
+    }
+
+    for (int c = 0; c < cand_count; c++) {
+        const char *iv = cands[c];
+        if (!is_register_candidate_name(iv, scope)) continue;
+        int def_count = count_iv_increments(iv, loop_blocks, cfg);
+        if (def_count == 0 || def_count > IVSR_MAX_UPDATES) continue;
+
+        /* Every update of i, with the block it sits in and its step. */
+        IRInstr *upd[IVSR_MAX_UPDATES];
+        BasicBlock *upd_bb[IVSR_MAX_UPDATES];
+        int upd_step[IVSR_MAX_UPDATES];
+        int upd_count = 0;
+
+        IVPointer ptrs[IVSR_MAX_PTRS];
+        int ptr_count = 0;
+        int line = h->instrs ? h->instrs->line : 0;
+
+        for (BasicBlock *bb = cfg->blocks; bb; bb = bb->next) {
+            if (!loop_blocks[bb->id]) continue;
+            /* Values are in terms of i at the top of the block; i itself
+               has moved by `moved` since. */
+            SCEVScan s;
+            scev_begin(&s, cfg, loop_blocks, iv);
+            for (IRInstr *cur = bb->instrs; cur; cur = cur->next) {
+                SCEVValue *now = scev_find(&s, iv);
+                int moved = now ? now->off : 0;
+                SCEVValue e;
+                if ((cur->kind == IR_LOAD || cur->kind == IR_STORE) && cur->scale > 0 &&
+                    !cur->index.is_const && cur->index.name && cur->base.name &&
+                    scev_operand(&s, &cur->index, &e) && e.coef != 0 &&
+                    e.coef >= -IVSR_MAX_COEF && e.coef <= IVSR_MAX_COEF) {
+                    long long at = (long long)e.off - (long long)e.coef * moved;
+                    int kind = (at >= INT_MIN && at <= INT_MAX) ? iv_base_kind(cur->base.name, loop_blocks, cfg, scope) : 0;
+                    IVPointer *ptr = NULL;
+                    for (int k = 0; kind && k < ptr_count; k++)
+                        if (ptrs[k].scale == cur->scale && ptrs[k].coef == e.coef &&
+                            strcmp(ptrs[k].base, cur->base.name) == 0 &&
+                            (ptrs[k].sym ? e.sym && strcmp(ptrs[k].sym, e.sym) == 0 : !e.sym))
+                            ptr = &ptrs[k];
+                    if (kind && !ptr && ptr_count < IVSR_MAX_PTRS) {
+                        ptr = &ptrs[ptr_count++];
+                        ptr->base = strdup(cur->base.name);
+                        ptr->scale = cur->scale;
+                        ptr->coef = e.coef;
+                        ptr->sym = e.sym ? strdup(e.sym) : NULL;
+                        ptr->addr = new_opt_temp("iva");
+                        ptr->ptr = new_opt_temp("ivp");
+                        char *span = new_opt_temp("ivo");
+                        if (kind == 1)
+                            append_to_preheader(pre, ir_make_unop(ptr->addr, ir_op_name(ptr->base), '&', line));
+                        else
+                            append_to_preheader(pre, ir_make_assign(ptr->addr, ir_op_name(ptr->base), line));
+                        IROperand lin = ir_op_name((char *)iv);
+                        if (ptr->coef != 1) {
+                            char *scaled = new_opt_temp("ivm");
+                            append_to_preheader(pre, ir_make_binop(scaled, lin, ir_op_const(ptr->coef), '*', line));
+                            lin = ir_op_name(scaled);
+                            free(scaled);
+                        }
+                        if (ptr->sym) {
+                            char *moved_by = new_opt_temp("ivk");
+                            append_to_preheader(pre, ir_make_binop(moved_by, lin, ir_op_name(ptr->sym), '+', line));
+                            ir_free_operand(&lin);
+                            lin = ir_op_name(moved_by);
+                            free(moved_by);
+                        }
+                        append_to_preheader(pre, ir_make_binop(span, lin, ir_op_const(ptr->scale), '*', line));
+                        ir_free_operand(&lin);
+                        append_to_preheader(pre, ir_make_binop(ptr->ptr, ir_op_name(ptr->addr), ir_op_name(span), '+', line));
+                        free(span);
+                    }
+                    if (ptr) {
+                        ir_free_operand(&cur->base);
+                        cur->base = ir_op_name(ptr->ptr);
+                        ir_free_operand(&cur->index);
+                        cur->index = ir_op_const((int)at);
+                    }
+                }
+                if (cur->result && strcmp(cur->result, iv) == 0) {
+                    SCEVValue v;
+                    scev_eval(&s, cur, &v);
+                    upd[upd_count] = cur;
+                    upd_bb[upd_count] = bb;
+                    upd_step[upd_count++] = v.off - moved;
+                }
+                scev_transfer(&s, cur);
+                if (cur == bb->last) break;
+            }
+            scev_end(&s);
+        }
+
+        if (ptr_count == 0) continue;
+        for (int u = 0; u < upd_count; u++) {
+            for (int k = ptr_count - 1; k >= 0; k--) {
+                insert_instr_after(upd_bb[u], upd[u],
+                                   ir_make_binop(ptrs[k].ptr, ir_op_name(ptrs[k].ptr),
+                                                 ir_op_const(upd_step[u] * ptrs[k].coef * ptrs[k].scale), '+',
+                                                 upd[u]->line));
+            }
+        }
+        for (int k = 0; k < ptr_count; k++) {
+            if (ptrs[k].coef == 1 && !ptrs[k].sym) {
+                replace_iv_tests(cfg, loop_blocks, pre, iv, &ptrs[k], scope);
+                break;
+            }
+        }
+        for (int k = 0; k < ptr_count; k++) {
+            free(ptrs[k].base);
+            free(ptrs[k].sym);
+            free(ptrs[k].addr);
+            free(ptrs[k].ptr);
+        }
+    }
+    set_free(cands, cand_count);
+}
+
+static void strength_reduce_ivs(CFG *cfg) {
+    if (!cfg) return;
+    compute_dominators(cfg);
+    compute_liveness(cfg);
+    Symbol *fsym = lookup(cfg->func_name);
+    Scope *scope = (fsym && fsym->kind == SYM_FUNCTION) ? fsym->scope : NULL;
+
+    for (BasicBlock *latch = cfg->blocks; latch; latch = latch->next) {
+        for (int i = 0; i < latch->succ_count; i++) {
+            BasicBlock *h = latch->succs[i];
+            if (!latch->doms[h->id]) continue; /* back edges only: h dominates latch */
+
+            int *loop_blocks = calloc(cfg->block_count + 1, sizeof(int));
+            if (!loop_blocks) continue;
+            if (!compute_natural_loop(h, latch, loop_blocks, cfg) ||
+                !loop_is_innermost(h, loop_blocks, cfg)) {
+                free(loop_blocks);
+                continue;
+            }
+            int latches = 0;
+            for (int k = 0; k < h->pred_count; k++)
+                if (loop_blocks[h->preds[k]->id]) latches++;
+            BasicBlock *pre = find_preheader(h, loop_blocks);
+            if (latches == 1 && pre && pre->succ_count == 1) {
+                strength_reduce_loop(cfg, h, loop_blocks, pre, scope);
+                optimize_bb(pre); /* fold the setup against the IV's start value */
+            }
+            free(loop_blocks);
+        }
+    }
+}
+
+/* --- Scalar Promotion of Memory in Loops ---
+ *
+ * A global counter, or a field p->f, updated in a loop is loaded and
+ * stored on every iteration. When nothing else in the loop can reach the
+ * location, a temp stands in for it for the duration of the loop:
+ *
+ *     preheader:      t := g                  t := load p[c]
+ *     in the loop:    g read and set as t     loads of p[c] read t, stores set t
+ *     on each exit:   g := t                  store p[c] := t
+ *
+ * with the stores back only when the loop writes the location. Loops with
+ * calls, returns or exception handling are left alone. A global or
+ * address-taken scalar must not have its address taken in the loop, and
+ * if it was taken elsewhere, the loop may only load and store through
+ * array objects. For p[c], p is loop-invariant, every other access is to
+ * other bytes of p or to a base that cannot alias it (see Memory
+ * Disambiguation), and no address-taken scalar is touched. The preheader
+ * load runs even when the loop body does not, so p must point somewhere:
+ * it holds the address of a local, or the code just ahead of the loop
+ * dereferences it with no call since.
+ *
+ * Runs right after LICM, one loop at a time; an inner loop's preheader
+ * loads and exit stores become part of the outer loop's body, where they
+ * are promoted in turn.
+ */
+
+#define LOOP_PROMOTE_MAX 6      /* each holds a register across the loop */
+
+typedef struct {
+    char *name;         /* the scalar, or the base p */
+    int field;          /* p[index] rather than a name */
+    int index;
+    int scale;
+    int written;
+    char *temp;
+} PromotedLoc;
+
+/* A scalar a temp can stand in for: int or pointer, not an aggregate. */
+static int loop_promote_type(Symbol *sym) {
+    return sym && sym->kind != SYM_FUNCTION && !sym->is_array && !sym->is_vla &&
+           (sym->pointer_level > 0 || sym->type == TYPE_INT);
+}
+
+static int loop_promote_match(PromotedLoc *loc, IRInstr *ins) {
+    return loc->field && (ins->kind == IR_LOAD || ins->kind == IR_STORE) && ins->index.is_const &&
+           !ins->base.is_const && ins->base.name && strcmp(ins->base.name, loc->name) == 0 &&
+           ins->index.const_val == loc->index && ins->scale == loc->scale;
+}
+
+/* Can p be dereferenced ahead of the loop? */
+static int loop_promote_base_valid(CFG *cfg, BasicBlock *pre, const char *p) {
+    IRInstr *def = unique_def(cfg, p);
+    if (def && def->kind == IR_UNOP && def->unop == '&') return 1;
+    BasicBlock *bb = pre;
+    for (int walk = 0; bb && walk < SCEV_MAX_WALK; walk++) {
+        int found = 0, clobbered = 0;
+        for (IRInstr *cur = bb->instrs; cur; cur = (cur == bb->last) ? NULL : cur->next) {
+            if ((cur->kind == IR_LOAD || cur->kind == IR_STORE) && !cur->base.is_const &&
+                cur->base.name && strcmp(cur->base.name, p) == 0)
+                found = 1;
+            if (cur->kind == IR_CALL || cur->kind == IR_CALL_INDIRECT ||
+                (cur->result && strcmp(cur->result, p) == 0)) {
+                found = 0;
+                clobbered = 1;
+            }
+        }
+        if (found) return 1;
+        if (clobbered) return 0;
+        bb = (bb->pred_count == 1 && bb->preds[0] != pre) ? bb->preds[0] : NULL;
+    }
+    return 0;
+}
+
+/* Is `site`'s location p[c] reached by nothing else in the loop? */
+static int loop_promote_field_ok(CFG *cfg, int *loop_blocks, Scope *scope, PromotedLoc *loc, IRInstr *site) {
+    long long lo = (long long)loc->index * loc->scale, hi = lo + loc->scale;
+    for (BasicBlock *bb = cfg->blocks; bb; bb = bb->next) {
+        if (!loop_blocks[bb->id]) continue;
+        for (IRInstr *cur = bb->instrs; cur; cur = (cur == bb->last) ? NULL : cur->next) {
+            IROperand *ops[4];
+            int n = instr_use_operands(cur, ops);
+            for (int k = 0; k < n; k++) {
+                Symbol *sym = (!ops[k]->is_const && ops[k]->name) ? lookup_ir_name(ops[k]->name, scope) : NULL;
+                if (sym && sym->is_address_taken) return 0;
+            }
+            Symbol *rsym = cur->result ? lookup_ir_name(cur->result, scope) : NULL;
+            if (rsym && rsym->is_address_taken) return 0;
+            if (cur->kind != IR_LOAD && cur->kind != IR_STORE) continue;
+            if (loop_promote_match(loc, cur)) continue;
+            if (!cur->base.is_const && cur->base.name && strcmp(cur->base.name, loc->name) == 0 &&
+                cur->index.is_const) {
+                long long at = (long long)cur->index.const_val * cur->scale;
+                if (at + cur->scale <= lo || at >= hi) continue;
+                return 0;
+            }
+            if (accesses_may_alias(cfg, cur, site)) return 0;
+        }
+    }
+    return 1;
+}
+
+/* Store what the loop wrote back to memory, after `pos` in bb (at the top
+   of bb when pos is NULL). */
+static void loop_promote_store_back(BasicBlock *bb, IRInstr *pos, PromotedLoc *locs, int count, int line) {
+    for (int k = count - 1; k >= 0; k--) {
+        if (!locs[k].written) continue;
+        IRInstr *st = locs[k].field
+            ? ir_make_store(ir_op_name(locs[k].name), ir_op_const(locs[k].index), locs[k].scale,
+                            ir_op_name(locs[k].temp), line)
+            : ir_make_assign(locs[k].name, ir_op_name(locs[k].temp), line);
+        if (pos) {
+            insert_instr_after(bb, pos, st);
+        } else {
+            st->next = bb->instrs;
+            bb->instrs = st;
+            if (!bb->last) bb->last = st;
+        }
+    }
+}
+
+/* Do all of x's predecessors lie in the loop? */
+static int loop_only_entry(BasicBlock *x, int *loop_blocks) {
+    for (int p = 0; p < x->pred_count; p++)
+        if (!loop_blocks[x->preds[p]->id]) return 0;
+    return 1;
+}
+
+static int promote_loop_memory(IRProgram *prog, CFG *cfg, BasicBlock *h, BasicBlock *latch, int *loop_blocks) {
+    (void)prog;
+    (void)latch;
+    Symbol *fsym = lookup(cfg->func_name);
+    Scope *scope = (fsym && fsym->kind == SYM_FUNCTION) ? fsym->scope : NULL;
+    BasicBlock *pre = find_preheader(h, loop_blocks);
+    if (!pre || pre->succ_count != 1) return 0;
+
+    /* Whole-loop conditions, and whether every access goes to an array
+       object (which no address of a scalar points into). */
+    int only_arrays = 1;
+    BasicBlock *tail = NULL;
+    for (BasicBlock *bb = cfg->blocks; bb; bb = bb->next) {
+        tail = bb;
+        if (!loop_blocks[bb->id]) continue;
+        for (IRInstr *cur = bb->instrs; cur; cur = (cur == bb->last) ? NULL : cur->next) {
+            switch (cur->kind) {
+                case IR_CALL: case IR_CALL_INDIRECT: case IR_RETURN: case IR_THROW:
+                case IR_TRY_BEGIN: case IR_TRY_END: case IR_SWITCH: case IR_ALLOCA:
+                    return 0;
+                case IR_LOAD: case IR_STORE:
+                    if (cur->base.is_const || !cur->base.name ||
+                        !is_array_object(lookup_ir_name(cur->base.name, scope)))
+                        only_arrays = 0;
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    /* A jump out of the loop to a block also entered from elsewhere goes
+       through new code after the function's last block, which must not
+       fall through into it. */
+    for (BasicBlock *bb = cfg->blocks; bb; bb = bb->next) {
+        if (!loop_blocks[bb->id]) continue;
+        for (int s = 0; s < bb->succ_count; s++) {
+            BasicBlock *x = bb->succs[s];
+            if (loop_blocks[x->id] || loop_only_entry(x, loop_blocks) || bb->next == x) continue;
+            if (!tail->last || (tail->last->kind != IR_RETURN && tail->last->kind != IR_GOTO &&
+                                tail->last->kind != IR_THROW))
+                return 0;
+        }
+    }
+
+    /* Candidates, in the order the loop first touches them. */
+    PromotedLoc locs[LOOP_PROMOTE_MAX];
+    int count = 0;
+    char **rejected = NULL;
+    int rejected_count = 0;
+    for (BasicBlock *bb = cfg->blocks; bb; bb = bb->next) {
+        if (!loop_blocks[bb->id]) continue;
+        for (IRInstr *cur = bb->instrs; cur; cur = (cur == bb->last) ? NULL : cur->next) {
+            if (cur->kind == IR_UNOP && cur->unop == '&' && !cur->unop_src.is_const && cur->unop_src.name)
+                set_add(&rejected, &rejected_count, cur->unop_src.name);
+        }
+    }
+    for (BasicBlock *bb = cfg->blocks; bb && count < LOOP_PROMOTE_MAX; bb = bb->next) {
+        if (!loop_blocks[bb->id]) continue;
+        for (IRInstr *cur = bb->instrs; cur && count < LOOP_PROMOTE_MAX;
+             cur = (cur == bb->last) ? NULL : cur->next) {
+            IROperand *ops[4];
+            int n = instr_use_operands(cur, ops);
+            const char *names[5];
+            int nn = 0;
+            for (int k = 0; k < n; k++)
+                if (!ops[k]->is_const && ops[k]->name) names[nn++] = ops[k]->name;
+            if (cur->result) names[nn++] = cur->result;
+            for (int k = 0; k < nn && count < LOOP_PROMOTE_MAX; k++) {
+                const char *name = names[k];
+                if (!is_memory_resident_name(name) || set_contains(rejected, rejected_count, name)) continue;
+                Symbol *sym = lookup_ir_name(name, scope);
+                set_add(&rejected, &rejected_count, name);      /* seen */
+                if (!loop_promote_type(sym) || (sym->is_address_taken && !only_arrays)) continue;
+                memset(&locs[count], 0, sizeof(PromotedLoc));
+                locs[count++].name = strdup(name);
+            }
+
+            if ((cur->kind != IR_LOAD && cur->kind != IR_STORE) || count >= LOOP_PROMOTE_MAX) continue;
+            if (!cur->index.is_const || (cur->scale != 4 && cur->scale != 8) ||
+                cur->base.is_const || !cur->base.name || is_memory_resident_name(cur->base.name) ||
+                is_array_object(lookup_ir_name(cur->base.name, scope)) ||
+                is_name_defined_in_loop(cur->base.name, loop_blocks, cfg))
+                continue;
+            int known = 0;
+            for (int m = 0; m < count; m++)
+                if (loop_promote_match(&locs[m], cur)) known = 1;
+            if (known) continue;
+            PromotedLoc *loc = &locs[count];
+            memset(loc, 0, sizeof(PromotedLoc));
+            loc->name = cur->base.name;
+            loc->field = 1;
+            loc->index = cur->index.const_val;
+            loc->scale = cur->scale;
+            if (loop_promote_field_ok(cfg, loop_blocks, scope, loc, cur) &&
+                loop_promote_base_valid(cfg, pre, cur->base.name)) {
+                loc->name = strdup(cur->base.name);
+                count++;
+            }
+        }
+    }
+    set_free(rejected, rejected_count);
+    if (count == 0) return 0;
+
+    int line = h->instrs ? h->instrs->line : 0;
+    for (int k = 0; k < count; k++) {
+        locs[k].temp = new_opt_temp("prm");
+        append_to_preheader(pre, locs[k].field
+            ? ir_make_load(locs[k].temp, ir_op_name(locs[k].name), ir_op_const(locs[k].index), locs[k].scale, line)
+            : ir_make_assign(locs[k].temp, ir_op_name(locs[k].name), line));
+    }
+
+    for (BasicBlock *bb = cfg->blocks; bb; bb = bb->next) {
+        if (!loop_blocks[bb->id]) continue;
+        for (IRInstr *cur = bb->instrs; cur; cur = (cur == bb->last) ? NULL : cur->next) {
+            for (int k = 0; k < count; k++) {
+                PromotedLoc *loc = &locs[k];
+                if (loc->field) {
+                    if (!loop_promote_match(loc, cur)) continue;
+                    ir_free_operand(&cur->base);
+                    ir_free_operand(&cur->index);
+                    memset(&cur->base, 0, sizeof(IROperand));
+                    memset(&cur->index, 0, sizeof(IROperand));
+                    if (cur->kind == IR_LOAD) {
+                        cur->src = ir_op_name(loc->temp);
+                    } else {
+                        cur->src = cur->store_val;
+                        memset(&cur->store_val, 0, sizeof(IROperand));
+                        cur->result = strdup(loc->temp);
+                        loc->written = 1;
+                    }
+                    cur->kind = IR_ASSIGN;
+                    cur->scale = 0;
+                    cur->alias_set = 0;
+                    break;
+                }
+                IROperand *ops[4];
+                int n = instr_use_operands(cur, ops);
+                for (int u = 0; u < n; u++)
+                    if (!ops[u]->is_const && ops[u]->name && strcmp(ops[u]->name, loc->name) == 0) {
+                        free(ops[u]->name);
+                        ops[u]->name = strdup(loc->temp);
+                    }
+                if (cur->result && strcmp(cur->result, loc->name) == 0) {
+                    free(cur->result);
+                    cur->result = strdup(loc->temp);
+                    loc->written = 1;
+                }
+            }
+        }
+    }
+
+    /* Store back on every way out: at the top of an exit block only the
+       loop reaches, after the branch that falls out of the loop, or in a
+       new block a jump out is sent through. */
+    char **done = NULL;     /* exit blocks already given the stores */
+    int done_count = 0;
+    for (BasicBlock *bb = cfg->blocks; bb; bb = bb->next) {
+        if (!loop_blocks[bb->id]) continue;
+        for (int s = 0; s < bb->succ_count; s++) {
+            BasicBlock *x = bb->succs[s];
+            if (loop_blocks[x->id]) continue;
+            IRInstr *head = (x->instrs && x->instrs->kind == IR_LABEL) ? x->instrs : NULL;
+            if (loop_only_entry(x, loop_blocks)) {
+                if (head && set_contains(done, done_count, head->label)) continue;
+                if (head) set_add(&done, &done_count, head->label);
+                loop_promote_store_back(x, head, locs, count, line);
+                continue;
+            }
+            IRInstr *term = bb->last;
+            if (bb->next == x && term->kind != IR_GOTO) {
+                loop_promote_store_back(bb, term, locs, count, line);
+            } else if (head && (term->kind == IR_IF || term->kind == IR_GOTO) &&
+                       strcmp(term->label, head->label) == 0) {
+                char *fresh = ir_new_label();
+                IRInstr *lbl = ir_make_label(fresh, line);
+                insert_instr_after(tail, tail->last, lbl);
+                loop_promote_store_back(tail, lbl, locs, count, line);
+                insert_instr_after(tail, tail->last, ir_make_goto(head->label, line));
+                free(term->label);
+                term->label = fresh;
+            }
+        }
+    }
+    set_free(done, done_count);
+    for (int k = 0; k < count; k++) {
+        free(locs[k].name);
+        free(locs[k].temp);
+    }
+    return 1;
+}
+
+static CFG* promote_loop_memories(IRProgram *prog, IRFunc *f, CFG *cfg) {
+    return rewrite_loops(prog, f, cfg, promote_loop_memory);
+}
+
+/* --- Software Prefetching (-fprefetch-loop-arrays) ---
+ *
+ * Runs after IV strength reduction, when the strided accesses of an
+ * innermost loop come in two shapes: p[c] with p a pointer the loop
+ * advances by a constant, and a[idx] with a loop-invariant base and idx
+ * affine in a counter (global arrays, which IVSR leaves alone). Each cache
+ * line a stream touches in a block gets one hint, placed right before the
+ * first access to it:
+ *
+ *     prefetch.r p[c * scale + ahead]          (scale 1)
+ *     t := idx + ahead / scale; prefetch.r a[t]
+ *
+ * ahead is the prefetch distance rounded up to whole iterations, in the
+ * direction the stream moves; a line the loop stores to gets prefetch.w.
+ * Hints never fault, so running past the end of an array is harmless.
+ */
+
+#define PREFETCH_LINE      64
+#define PREFETCH_MAX_HINTS 8    /* per loop: more than a core keeps in flight */
+
+int prefetch_loop_arrays = 0;
+
+typedef struct {
+    IRInstr *first;         /* access the hint goes ahead of */
+    BasicBlock *bb;
+    BasicBlock *home;       /* offsets are from the top of this block, NULL: of the loop */
+    const char *key;        /* the pointer's IV, or the invariant base */
+    const char *sym;        /* invariant part of the index, or NULL */
+    long long stride;       /* bytes per iteration */
+    long long line;
+    int write;
+} PrefetchStream;
+
+static long long prefetch_line_of(long long off) {
+    return off >= 0 ? off / PREFETCH_LINE : -((PREFETCH_LINE - 1 - off) / PREFETCH_LINE);
+}
+
+static void insert_instr_before(BasicBlock *bb, IRInstr *pos, IRInstr *ins) {
+    ins->next = pos;
+    if (bb->instrs == pos) {
+        bb->instrs = ins;
+        return;
+    }
+    IRInstr *prev = bb->instrs;
+    while (prev->next != pos) prev = prev->next;
+    prev->next = ins;
+}
+
+/* Record the line `ins` touches; returns 0 once the loop has its fill. */
+static int prefetch_note(PrefetchStream *st, int *count, IRInstr *ins, BasicBlock *bb, BasicBlock *home,
+                         const char *key, const char *sym, long long stride, long long off) {
+    long long line = prefetch_line_of(off);
+    for (int k = 0; k < *count; k++) {
+        PrefetchStream *p = &st[k];
+        if (p->home == home && p->stride == stride && p->line == line && strcmp(p->key, key) == 0 &&
+            (p->sym ? sym && strcmp(p->sym, sym) == 0 : !sym)) {
+            p->write |= ins->kind == IR_STORE;
+            return 1;
+        }
+    }
+    if (*count == PREFETCH_MAX_HINTS) return 0;
+    PrefetchStream *p = &st[(*count)++];
+    p->first = ins;
+    p->bb = bb;
+    p->home = home;
+    p->key = key;
+    p->sym = sym;
+    p->stride = stride;
+    p->line = line;
+    p->write = ins->kind == IR_STORE;
+    return 1;
+}
+
+static void prefetch_loop(CFG *cfg, BasicBlock *h, int *loop_blocks, Scope *scope) {
+    char **ivs = NULL;
+    int iv_count = 0;
+    for (BasicBlock *bb = cfg->blocks; bb; bb = bb->next) {
+        if (!loop_blocks[bb->id]) continue;
+        for (IRInstr *cur = bb->instrs; cur; cur = (cur == bb->last) ? NULL : cur->next) {
+            if (cur->kind == IR_TRY_BEGIN || cur->kind == IR_TRY_END) { set_free(ivs, iv_count); return; }
+            if (cur->result && !set_contains(ivs, iv_count, cur->result))
+                set_add(&ivs, &iv_count, cur->result);
+        }
+    }
+
+    PrefetchStream st[PREFETCH_MAX_HINTS];
+    int count = 0, full = 0;
+    IRInstr **seen = NULL;          /* accesses already given a stream */
+    int seen_count = 0;
+    /* How far the IV has moved since the top of the loop, on entry to and
+       exit from each block (when every way in agrees), so that the copies
+       of an unrolled body with branches share their hints. */
+    long long *shift_in = calloc(cfg->block_count + 1, sizeof(long long));
+    long long *shift_out = calloc(cfg->block_count + 1, sizeof(long long));
+    int *known_in = calloc(cfg->block_count + 1, sizeof(int));
+    int *known_out = calloc(cfg->block_count + 1, sizeof(int));
+    for (int v = 0; v < iv_count && !full; v++) {
+        if (!is_register_candidate_name(ivs[v], scope)) continue;
+        int step = scev_loop_step(cfg, h, loop_blocks, ivs[v]);
+        if (step == 0) continue;
+        memset(known_out, 0, sizeof(int) * (cfg->block_count + 1));
+        for (BasicBlock *bb = cfg->blocks; bb && !full; bb = bb->next) {
+            if (!loop_blocks[bb->id]) continue;
+            known_in[bb->id] = bb == h;
+            shift_in[bb->id] = 0;
+            for (int k = 0; bb != h && k < bb->pred_count; k++) {
+                BasicBlock *p = bb->preds[k];
+                if (!loop_blocks[p->id]) continue;
+                if (!known_out[p->id] || (k && known_in[bb->id] && shift_in[bb->id] != shift_out[p->id])) {
+                    known_in[bb->id] = 0;
+                    break;
+                }
+                known_in[bb->id] = 1;
+                shift_in[bb->id] = shift_out[p->id];
+            }
+            long long at = shift_in[bb->id];
+            BasicBlock *home = known_in[bb->id] ? NULL : bb;
+
+            SCEVScan s;
+            scev_begin(&s, cfg, loop_blocks, ivs[v]);
+            for (IRInstr *cur = bb->instrs; cur && !full; cur = (cur == bb->last) ? NULL : cur->next) {
+                SCEVValue a;
+                int access = (cur->kind == IR_LOAD || cur->kind == IR_STORE) && cur->scale > 0 &&
+                             cur->base.name && strncmp(cur->base.name, ".LC", 3) != 0 &&
+                             strncmp(cur->base.name, "vtable_", 7) != 0;
+                for (int k = 0; access && k < seen_count; k++)
+                    if (seen[k] == cur) access = 0;
+                if (access && cur->index.is_const && scev_operand(&s, &cur->base, &a) && a.coef && !a.sym) {
+                    /* p[c]: p moves with the IV itself. */
+                    full = !prefetch_note(st, &count, cur, bb, home, ivs[v], NULL, (long long)a.coef * step,
+                                          a.coef * at + a.off + (long long)cur->index.const_val * cur->scale);
+                    seen = realloc(seen, sizeof(IRInstr *) * (seen_count + 1));
+                    seen[seen_count++] = cur;
+                } else if (access && !cur->index.is_const && cur->index.name &&
+                           !is_name_defined_in_loop(cur->base.name, loop_blocks, cfg) &&
+                           scev_operand(&s, &cur->index, &a) && a.coef) {
+                    /* a[m * i + k + c] */
+                    full = !prefetch_note(st, &count, cur, bb, home, cur->base.name, a.sym,
+                                          (long long)a.coef * step * cur->scale,
+                                          (a.coef * at + a.off) * cur->scale);
+                    seen = realloc(seen, sizeof(IRInstr *) * (seen_count + 1));
+                    seen[seen_count++] = cur;
+                }
+                scev_transfer(&s, cur);
+            }
+            SCEVValue *now = scev_find(&s, ivs[v]);
+            known_out[bb->id] = known_in[bb->id] && now && now->coef == 1 && !now->sym;
+            shift_out[bb->id] = known_out[bb->id] ? at + now->off : 0;
+            scev_end(&s);
+        }
+    }
+    free(shift_in);
+    free(shift_out);
+    free(known_in);
+    free(known_out);
+
+    for (int k = 0; k < count; k++) {
+        PrefetchStream *p = &st[k];
+        IRInstr *at = p->first;
+        long long span = p->stride < 0 ? -p->stride : p->stride;
+        long long ahead = (prefetch_loop_arrays + span - 1) / span * p->stride;
+        if (at->index.is_const) {
+            long long off = (long long)at->index.const_val * at->scale + ahead;
+            if (off < INT_MIN || off > INT_MAX) continue;
+            insert_instr_before(p->bb, at,
+                                ir_make_prefetch(at->base, ir_op_const((int)off), 1, p->write, at->line));
+        } else {
+            long long elems = ahead / at->scale;
+            if (elems < INT_MIN || elems > INT_MAX) continue;
+            char *t = new_opt_temp("pf");
+            insert_instr_before(p->bb, at, ir_make_binop(t, at->index, ir_op_const((int)elems), '+', at->line));
+            insert_instr_before(p->bb, at, ir_make_prefetch(at->base, ir_op_name(t), at->scale, p->write, at->line));
+            free(t);
+        }
+    }
+    free(seen);
+    set_free(ivs, iv_count);
+}
+
+static void prefetch_loops(CFG *cfg) {
+    if (!cfg || prefetch_loop_arrays <= 0) return;
+    compute_dominators(cfg);
+    Symbol *fsym = lookup(cfg->func_name);
+    Scope *scope = (fsym && fsym->kind == SYM_FUNCTION) ? fsym->scope : NULL;
+
+    for (BasicBlock *latch = cfg->blocks; latch; latch = latch->next) {
+        for (int i = 0; i < latch->succ_count; i++) {
+            BasicBlock *h = latch->succs[i];
+            if (!latch->doms[h->id] || profile_cold_loop(h)) continue;
+
+            int *loop_blocks = calloc(cfg->block_count + 1, sizeof(int));
+            if (!loop_blocks) continue;
+            int latches = 0;
+            if (compute_natural_loop(h, latch, loop_blocks, cfg) && loop_is_innermost(h, loop_blocks, cfg))
+                for (int k = 0; k < h->pred_count; k++)
+                    if (loop_blocks[h->preds[k]->id]) latches++;
+            if (latches == 1) prefetch_loop(cfg, h, loop_blocks, scope);
+            free(loop_blocks);
+        }
+    }
+}
+
+/* --- Reassociation ---
+ *
+ * Chains of single-use temps over one associative operator are flattened
+ * into their leaves and rebuilt in a canonical order:
+ *
+ *   linear sums   +, -, unary -, and * or << by a constant: each leaf
+ *                 carries an integer coefficient, so (x + 1) + 2 is x + 3,
+ *                 x * 4 * 2 is x * 8 and a + b - a is b;
+ *   *, &, |, ^    of two names: leaves with a multiplicity (x ^ x drops
+ *                 out, x & x is x) and one combined constant.
+ *
+ * Leaves are ranked by the loop depth of their definitions, then by where
+ * they are first defined, then by name. Rebuilding left-deep in that order
+ * puts the loop-invariant part of a sum in its own instructions, which
+ * LICM then hoists, and gives expressions that only differed in operand
+ * order the same shape for CSE. The constant joins the invariant part
+ * when there is one, otherwise it comes last and becomes an immediate.
+ *
+ * All arithmetic is modulo 2^64, like the registers it runs in, so
+ * regrouping is exact; coefficients and constants must still fit an int.
+ * A chain is only rewritten when it gets no longer.
+ */
+
+#define REASSOC_MAX_TERMS 12
+#define REASSOC_MAX_NODES 16
+
+typedef struct {
+    const char *name;   /* borrowed from the instruction that reads it */
+    long long coef;     /* coefficient, or multiplicity outside sums */
+    int at;             /* block position of that instruction */
+    int depth;
+    int order;
+} ReassocTerm;
+
+typedef struct {
+    int op;             /* '+' for linear sums, else '*', '&', '|' or '^' */
+    ReassocTerm terms[REASSOC_MAX_TERMS];
+    int count;
+    long long konst;
+    int nodes[REASSOC_MAX_NODES];   /* absorbed instructions */
+    int node_count;
+    int failed;
+} ReassocChain;
+
+typedef struct {
+    char *name;
+    int depth;          /* deepest loop holding a definition */
+    int order;          /* position of the first definition */
+} ReassocRank;
+
+static int reassoc_fits_int(long long v) {
+    return v >= -2147483647LL - 1 && v <= 2147483647LL;
+}
+
+static long long reassoc_mul(long long a, long long b) {
+    return (long long)((unsigned long long)a * (unsigned long long)b);
+}
+
+static int reassoc_is_linear(IRInstr *ins) {
+    if (ins->kind == IR_UNOP) return ins->unop == '-';
+    if (ins->kind != IR_BINOP) return 0;
+    switch (ins->binop) {
+        case '+': case '-': return 1;
+        case '*': return ins->left.is_const != ins->right.is_const;
+        case T_SHL: return !ins->left.is_const && ins->right.is_const &&
+                           ins->right.const_val >= 0 && ins->right.const_val <= 30;
+        default: return 0;
+    }
+}
+
+/* The family `ins` roots, or 0: '+' for sums, else the operator. */
+static int reassoc_family(IRInstr *ins) {
+    if (reassoc_is_linear(ins)) return '+';
+    if (ins->kind != IR_BINOP) return 0;
+    if (ins->binop == '&' || ins->binop == '|' || ins->binop == '^' ||
+        (ins->binop == '*' && !ins->left.is_const && !ins->right.is_const))
+        return ins->binop;
+    return 0;
+}
+
+static int reassoc_in_family(IRInstr *ins, int op) {
+    if (op == '+') return reassoc_is_linear(ins);
+    return ins->kind == IR_BINOP && ins->binop == op;
+}
+
+static int reassoc_reads(IRInstr *ins, const char *name) {
+    IROperand *ops[4];
+    int n = instr_use_operands(ins, ops);
+    for (int k = 0; k < n; k++)
+        if (!ops[k]->is_const && ops[k]->name && strcmp(ops[k]->name, name) == 0) return 1;
+    return 0;
+}
+
+/* Position of the definition of `name` read by ins[user] when it can be
+   folded into the chain: a same-family instruction in this block whose
+   value is read by ins[user] alone. Otherwise -1. */
+static int reassoc_absorbable(IRInstr **ins, int n, int *gone, int user, const char *name,
+                              int op, BasicBlock *bb) {
+    if (is_memory_resident_name(name)) return -1;
+    int d = user - 1;
+    while (d >= 0 && !(ins[d]->result && strcmp(ins[d]->result, name) == 0)) d--;
+    if (d < 0 || gone[d] || !reassoc_in_family(ins[d], op) || reassoc_reads(ins[d], name)) return -1;
+
+    for (int j = d + 1; j < n; j++) {
+        /* Absorbed instructions still count as readers: their operands
+           are read again by the rewritten root. */
+        if (j != user && reassoc_reads(ins[j], name)) return -1;
+        if (ins[j]->result && strcmp(ins[j]->result, name) == 0) return d;
+    }
+    return set_contains(bb->live_out, bb->live_out_count, name) ? -1 : d;
+}
+
+static void reassoc_add_term(ReassocChain *c, const char *name, long long coef, int at) {
+    for (int k = 0; k < c->count; k++) {
+        if (strcmp(c->terms[k].name, name) != 0) continue;
+        c->terms[k].coef += coef;
+        if (at < c->terms[k].at) c->terms[k].at = at;
+        return;
+    }
+    if (c->count == REASSOC_MAX_TERMS) { c->failed = 1; return; }
+    ReassocTerm *t = &c->terms[c->count++];
+    t->name = name;
+    t->coef = coef;
+    t->at = at;
+}
+
+static int reassoc_take_node(ReassocChain *c, int d) {
+    for (int k = 0; k < c->node_count; k++)
+        if (c->nodes[k] == d) return 1;   /* read twice, as in t + t */
+    if (c->node_count == REASSOC_MAX_NODES) { c->failed = 1; return 0; }
+    c->nodes[c->node_count++] = d;
+    return 1;
+}
+
+/* Adds scale * op, read by ins[at], to the sum. */
+static void reassoc_flatten_linear(ReassocChain *c, IRInstr **ins, int n, int *gone, int at,
+                                   IROperand *op, long long scale, BasicBlock *bb) {
+    if (c->failed) return;
+    if (op->is_const) { c->konst += reassoc_mul(scale, op->const_val); return; }
+    if (!op->name) { c->failed = 1; return; }
+
+    int d = reassoc_absorbable(ins, n, gone, at, op->name, '+', bb);
+    if (d < 0 || !reassoc_take_node(c, d)) {
+        reassoc_add_term(c, op->name, scale, at);
+        return;
+    }
+    IRInstr *def = ins[d];
+    if (def->kind == IR_UNOP) {
+        reassoc_flatten_linear(c, ins, n, gone, d, &def->unop_src, -scale, bb);
+    } else if (def->binop == T_SHL) {
+        reassoc_flatten_linear(c, ins, n, gone, d, &def->left, reassoc_mul(scale, 1LL << def->right.const_val), bb);
+    } else if (def->binop == '*') {
+        IROperand *k = def->left.is_const ? &def->left : &def->right;
+        IROperand *x = def->left.is_const ? &def->right : &def->left;
+        reassoc_flatten_linear(c, ins, n, gone, d, x, reassoc_mul(scale, k->const_val), bb);
+    } else {
+        reassoc_flatten_linear(c, ins, n, gone, d, &def->left, scale, bb);
+        reassoc_flatten_linear(c, ins, n, gone, d, &def->right, def->binop == '-' ? -scale : scale, bb);
+    }
+}
+
+static void reassoc_flatten_ac(ReassocChain *c, IRInstr **ins, int n, int *gone, int at,
+                               IROperand *op, BasicBlock *bb) {
+    if (c->failed) return;
+    if (op->is_const) {
+        switch (c->op) {
+            case '*': c->konst = reassoc_mul(c->konst, op->const_val); break;
+            case '&': c->konst &= op->const_val; break;
+            case '|': c->konst |= op->const_val; break;
+            default:  c->konst ^= op->const_val; break;
+        }
+        return;
+    }
+    if (!op->name) { c->failed = 1; return; }
+
+    int d = reassoc_absorbable(ins, n, gone, at, op->name, c->op, bb);
+    if (d < 0 || !reassoc_take_node(c, d)) {
+        reassoc_add_term(c, op->name, 1, at);
+        return;
+    }
+    reassoc_flatten_ac(c, ins, n, gone, d, &ins[d]->left, bb);
+    reassoc_flatten_ac(c, ins, n, gone, d, &ins[d]->right, bb);
+}
+
+/* A leaf first read at ins[t->at] is read again at the root: nothing in between
+   may redefine it, or (for a name living in memory) store or call. */
+static int reassoc_leaf_stable(IRInstr **ins, int root, ReassocTerm *t) {
+    int in_memory = is_memory_resident_name(t->name);
+    for (int j = t->at + 1; j < root; j++) {
+        if (ins[j]->result && strcmp(ins[j]->result, t->name) == 0) return 0;
+        if (in_memory && (ins[j]->kind == IR_STORE || ins[j]->kind == IR_CALL ||
+                          ins[j]->kind == IR_CALL_INDIRECT)) return 0;
+    }
+    return 1;
+}
+
+static int reassoc_term_cmp(const void *a, const void *b) {
+    const ReassocTerm *x = a, *y = b;
+    if (x->depth != y->depth) return x->depth - y->depth;
+    if (x->order != y->order) return x->order - y->order;
+    return strcmp(x->name, y->name);
+}
+
+static void reassoc_rank_term(ReassocTerm *t, ReassocRank *ranks, int rank_count) {
+    t->depth = 0;
+    t->order = -1;   /* parameters and other names with no definition */
+    for (int k = 0; k < rank_count; k++) {
+        if (strcmp(ranks[k].name, t->name) != 0) continue;
+        t->depth = ranks[k].depth;
+        t->order = ranks[k].order;
+        return;
+    }
+}
+
+/* Appends `dst := l op r` (or a unop when r is NULL) under a fresh name and
+   returns that name as an operand. */
+static IROperand reassoc_emit(IRInstr **head, IRInstr **tail, IROperand l, IROperand *r, int op, int line) {
+    char *tmp = new_opt_temp("ra");
+    IRInstr *ins = r ? ir_make_binop(tmp, l, *r, op, line) : ir_make_unop(tmp, l, op, line);
+    append_instr(head, tail, ins);
+    IROperand res = { 0 };
+    res.name = ins->result;
+    free(tmp);
+    return res;
+}
+
+/* Builds the linear chain in rank order. `split` is where the constant goes. */
+static int reassoc_build_linear(ReassocChain *c, int split, int line, IRInstr **head, IRInstr **tail) {
+    IROperand acc = { 0 };
+    int have_acc = 0, emitted = 0;
+    for (int k = 0; k <= c->count; k++) {
+        if (k == split && c->konst != 0) {
+            IROperand kop = ir_op_const((int)c->konst);
+            if (have_acc) { acc = reassoc_emit(head, tail, acc, &kop, '+', line); emitted++; }
+            else { acc = kop; have_acc = 1; }
+        }
+        if (k == c->count) break;
+
+        ReassocTerm *t = &c->terms[k];
+        if (t->coef == 0) continue;
+        IROperand leaf = { 0 };
+        leaf.name = (char *)t->name;
+        long long mag = t->coef < 0 ? -t->coef : t->coef;
+        if (!have_acc) {
+            if (t->coef == 1) acc = leaf;
+            else if (t->coef == -1) { acc = reassoc_emit(head, tail, leaf, NULL, '-', line); emitted++; }
+            else {
+                IROperand kop = ir_op_const((int)t->coef);
+                acc = reassoc_emit(head, tail, leaf, &kop, '*', line); emitted++;
+            }
+            have_acc = 1;
+            continue;
+        }
+        IROperand v = leaf;
+        if (mag != 1) {
+            IROperand kop = ir_op_const((int)mag);
+            v = reassoc_emit(head, tail, leaf, &kop, '*', line); emitted++;
+        }
+        acc = reassoc_emit(head, tail, acc, &v, t->coef < 0 ? '-' : '+', line); emitted++;
+    }
+    if (!have_acc) acc = ir_op_const(0);
+    if (!*tail || !acc.name || acc.name != (*tail)->result) {
+        append_instr(head, tail, ir_make_assign(NULL, acc, line));
+        emitted++;
+    }
+    return emitted;
+}
+
+static int reassoc_build_ac(ReassocChain *c, int line, IRInstr **head, IRInstr **tail) {
+    long long identity = c->op == '*' ? 1 : (c->op == '&' ? -1 : 0);
+    int absorbing = (c->op == '*' && c->konst == 0) || (c->op == '&' && c->konst == 0) ||
+                    (c->op == '|' && c->konst == -1);
+    IROperand acc = { 0 };
+    int have_acc = 0, emitted = 0;
+    for (int k = 0; k < c->count && !absorbing; k++) {
+        ReassocTerm *t = &c->terms[k];
+        long long times = c->op == '*' ? t->coef : (c->op == '^' ? (t->coef & 1) : 1);
+        IROperand leaf = { 0 };
+        leaf.name = (char *)t->name;
+        for (long long m = 0; m < times; m++) {
+            if (have_acc) { acc = reassoc_emit(head, tail, acc, &leaf, c->op, line); emitted++; }
+            else { acc = leaf; have_acc = 1; }
+        }
+    }
+    if (absorbing || !have_acc) {
+        acc = ir_op_const(absorbing ? (int)c->konst : (int)identity);
+    } else if (c->konst != identity) {
+        IROperand kop = ir_op_const((int)c->konst);
+        acc = reassoc_emit(head, tail, acc, &kop, c->op, line); emitted++;
+    }
+    if (!*tail || !acc.name || acc.name != (*tail)->result) {
+        append_instr(head, tail, ir_make_assign(NULL, acc, line));
+        emitted++;
+    }
+    return emitted;
+}
+
+/* Rewrites the chain rooted at ins[root]. Returns the replacement list
+   (ending in a definition of the root's result) or NULL. */
+static IRInstr* reassociate_root(IRInstr **ins, int n, int *gone, int root, BasicBlock *bb,
+                                 int depth, ReassocRank *ranks, int rank_count) {
+    IRInstr *r = ins[root];
+    ReassocChain c;
+    memset(&c, 0, sizeof(c));
+    c.op = reassoc_family(r);
+    if (c.op == '+') {
+        if (r->kind == IR_UNOP) {
+            reassoc_flatten_linear(&c, ins, n, gone, root, &r->unop_src, -1, bb);
+        } else if (r->binop == T_SHL) {
+            reassoc_flatten_linear(&c, ins, n, gone, root, &r->left, 1LL << r->right.const_val, bb);
+        } else if (r->binop == '*') {
+            IROperand *k = r->left.is_const ? &r->left : &r->right;
+            reassoc_flatten_linear(&c, ins, n, gone, root, r->left.is_const ? &r->right : &r->left,
+                                   k->const_val, bb);
+        } else {
+            reassoc_flatten_linear(&c, ins, n, gone, root, &r->left, 1, bb);
+            reassoc_flatten_linear(&c, ins, n, gone, root, &r->right, r->binop == '-' ? -1 : 1, bb);
+        }
+    } else {
+        c.konst = c.op == '*' ? 1 : (c.op == '&' ? -1 : 0);
+        reassoc_flatten_ac(&c, ins, n, gone, root, &r->left, bb);
+        reassoc_flatten_ac(&c, ins, n, gone, root, &r->right, bb);
+    }
+    if (c.failed || c.node_count == 0 || !reassoc_fits_int(c.konst)) return NULL;
+
+    int live = 0;
+    for (int k = 0; k < c.count; k++) {
+        ReassocTerm *t = &c.terms[k];
+        if (!reassoc_leaf_stable(ins, root, t)) return NULL;
+        if (c.op == '+' && (!reassoc_fits_int(t->coef) || t->coef == -2147483647LL - 1)) return NULL;
+        if (c.op == '*' && t->coef > 4) return NULL;
+        reassoc_rank_term(t, ranks, rank_count);
+        if (t->coef != 0) live++;
+    }
+    qsort(c.terms, c.count, sizeof(ReassocTerm), reassoc_term_cmp);
+
+    IRInstr *head = NULL, *tail = NULL;
+    int cost;
+    if (c.op == '+') {
+        int split = 0;
+        while (split < c.count && c.terms[split].depth < depth) split++;
+        if (split == 0 || split == c.count || live == 0) split = c.count;
+        cost = reassoc_build_linear(&c, split, r->line, &head, &tail);
+    } else {
+        cost = reassoc_build_ac(&c, r->line, &head, &tail);
+    }
+    if (cost > c.node_count + 1) {
+        while (head) { IRInstr *next = head->next; free_instr_single(head); head = next; }
+        return NULL;
+    }
+    free(tail->result);
+    tail->result = strdup(r->result);
+    for (int k = 0; k < c.node_count; k++) gone[c.nodes[k]] = 1;
+    return head;
+}
+
+/* Two-operand instructions that are not rewritten still get a canonical
+   operand order: constants right, lower-ranked names left. Updates of the
+   form x := x op y keep their shape for the induction variable passes. */
+static void reassoc_canonicalize(IRInstr *ins, ReassocRank *ranks, int rank_count) {
+    if (ins->kind != IR_BINOP) return;
+    if (ins->binop != '+' && ins->binop != '*' && ins->binop != '&' && ins->binop != '|' && ins->binop != '^')
+        return;
+    int swap = 0;
+    if (ins->left.is_const || ins->right.is_const) {
+        swap = ins->left.is_const && !ins->right.is_const;
+    } else if (ins->left.name && ins->right.name && ins->result &&
+               strcmp(ins->left.name, ins->result) != 0 && strcmp(ins->right.name, ins->result) != 0) {
+        ReassocTerm a = { 0 }, b = { 0 };
+        a.name = ins->left.name;
+        b.name = ins->right.name;
+        reassoc_rank_term(&a, ranks, rank_count);
+        reassoc_rank_term(&b, ranks, rank_count);
+        swap = reassoc_term_cmp(&a, &b) > 0;
+    }
+    if (swap) {
+        IROperand t = ins->left;
+        ins->left = ins->right;
+        ins->right = t;
+    }
+}
+
+static void reassociate(CFG *cfg) {
+    if (!cfg || cfg->block_count == 0) return;
+    compute_dominators(cfg);
+    compute_liveness(cfg);
+
+    /* Loop depth of every block, one level per natural loop around it. */
+    int *depth = calloc(cfg->block_count, sizeof(int));
+    int *body = calloc(cfg->block_count, sizeof(int));
+    int *one_latch = calloc(cfg->block_count, sizeof(int));
+    for (BasicBlock *h = cfg->blocks; h; h = h->next) {
+        int has_latch = 0;
+        memset(body, 0, sizeof(int) * cfg->block_count);
+        for (int k = 0; k < h->pred_count; k++) {
+            BasicBlock *latch = h->preds[k];
+            if (!latch->doms || !latch->doms[h->id]) continue;
+            compute_natural_loop(h, latch, one_latch, cfg);
+            for (int m = 0; m < cfg->block_count; m++) body[m] |= one_latch[m];
+            has_latch = 1;
+        }
+        if (has_latch)
+            for (int m = 0; m < cfg->block_count; m++) depth[m] += body[m];
+    }
+    free(one_latch);
+    free(body);
+
+    int rank_count = 0, rank_cap = 64, order = 0;
+    ReassocRank *ranks = malloc(sizeof(ReassocRank) * rank_cap);
+    for (BasicBlock *bb = cfg->blocks; bb; bb = bb->next) {
+        for (IRInstr *ins = bb->instrs; ins; ins = ins->next) {
+            if (ins->result) {
+                int k = 0;
+                while (k < rank_count && strcmp(ranks[k].name, ins->result) != 0) k++;
+                if (k == rank_count) {
+                    if (rank_count == rank_cap) {
+                        rank_cap *= 2;
+                        ranks = realloc(ranks, sizeof(ReassocRank) * rank_cap);
+                    }
+                    ranks[k].name = ins->result;
+                    ranks[k].depth = depth[bb->id];
+                    ranks[k].order = order;
+                    rank_count++;
+                } else if (depth[bb->id] > ranks[k].depth) {
+                    ranks[k].depth = depth[bb->id];
+                }
+            }
+            order++;
+            if (ins == bb->last) break;
+        }
+    }
+
+    for (BasicBlock *bb = cfg->blocks; bb; bb = bb->next) {
+        int n = count_block_instrs(bb);
+        if (n == 0) continue;
+        IRInstr **ins = malloc(sizeof(IRInstr *) * n);
+        IRInstr **repl = calloc(n, sizeof(IRInstr *));
+        int *gone = calloc(n, sizeof(int));
+        IRInstr *cur = bb->instrs;
+        for (int i = 0; i < n; i++) { ins[i] = cur; cur = cur->next; }
+
+        int changed = 0;
+        for (int i = n - 1; i >= 0; i--) {
+            if (gone[i] || !ins[i]->result || !reassoc_family(ins[i])) continue;
+            repl[i] = reassociate_root(ins, n, gone, i, bb, depth[bb->id], ranks, rank_count);
+            if (repl[i]) changed = 1;
+            else reassoc_canonicalize(ins[i], ranks, rank_count);
+        }
+
+        if (changed) {
+            IRInstr *after = bb->last->next;
+            IRInstr *head = NULL, *tail = NULL;
+            for (int i = 0; i < n; i++) {
+                if (repl[i]) {
+                    IRInstr *last = repl[i];
+                    while (last->next) last = last->next;
+                    append_instr_list(&head, &tail, repl[i], last);
+                    free_instr_single(ins[i]);
+                } else if (gone[i]) {
+                    free_instr_single(ins[i]);
+                } else {
+                    append_instr(&head, &tail, ins[i]);
+                }
+            }
+            tail->next = after;
+            bb->instrs = head;
+            bb->last = tail;
+            optimize_bb(bb);
+        }
+        free(gone);
+        free(repl);
+        free(ins);
+    }
+    free(ranks);
+    free(depth);
+}
+
+void unroll_loops(CFG *cfg) {
+
+    if (!cfg) return;
+    compute_dominators(cfg);
+    Symbol *fsym = lookup(cfg->func_name);
+    Scope *scope = (fsym && fsym->kind == SYM_FUNCTION) ? fsym->scope : NULL;
+
+    long growth = 0;
+    BasicBlock *b = cfg->blocks;
+    while (b) {
+        for (int i = 0; i < b->succ_count; i++) {
+            BasicBlock *h = b->succs[i];
+            if (!b->doms[h->id]) continue;
+            if (!h->last || h->last->kind != IR_IF) continue;
+            if (!h->instrs || h->instrs->kind != IR_LABEL) continue;
+
+            int *loop_blocks = calloc(cfg->block_count, sizeof(int));
+            if (!compute_natural_loop(h, b, loop_blocks, cfg)) {
+                free(loop_blocks);
+                continue;
+            }
+
+            BasicBlock *preheader = find_preheader(h, loop_blocks);
+            if (!preheader || profile_cold_loop(h)) {
+                free(loop_blocks);
+                continue;
+            }
+
+            BasicBlock *body_entry = NULL;
+            BasicBlock *exit_block = NULL;
+            if (!find_loop_entry_exit(h, loop_blocks, &body_entry, &exit_block)) {
+                free(loop_blocks);
+                continue;
+            }
+            if (has_side_exits(h, loop_blocks, cfg, exit_block)) {
+                free(loop_blocks);
+                continue;
+            }
+
+            const char *exit_label = loop_exit_label(exit_block);
+            if (!exit_label) {
+                free(loop_blocks);
+                continue;
+            }
+
+            IRInstr *if_instr = h->last;
+            SCEVCounter ctr;
+            if (!scev_counter(cfg, h, loop_blocks, body_entry, exit_block, &ctr)) {
+                free(loop_blocks);
+                continue;
+            }
+
+            /* Constant start and bound: full unroll; otherwise the runtime unroller. */
+            int init = 0, bound = 0;
+            if (!scev_initial_value(preheader, ctr.ivar, scope, &init) ||
+                !(ctr.bound->is_const ? (bound = ctr.bound->const_val, 1)
+                                      : scev_initial_value(preheader, ctr.bound->name, scope, &bound))) {
+                unroll_loop_runtime(cfg, h, b, loop_blocks, preheader, body_entry, exit_block);
+                free(loop_blocks);
+                continue;
+            }
+            int step = ctr.step;
+            IRRelop relop = ctr.relop;
+
+            long trip_count = 0;
+            if (!compute_trip_count(init, bound, step, relop, &trip_count)) {
+                free(loop_blocks);
+                continue;
+            }
+
+            BasicBlock *body_blocks[256];
+            int body_count = build_body_block_list(cfg, loop_blocks, h, body_blocks, 256);
+            if (body_count <= 0) {
+                free(loop_blocks);
+                continue;
+            }
+
+            int entry_idx = find_block_index(body_blocks, body_count, body_entry);
+            if (entry_idx < 0) {
+                free(loop_blocks);
+                continue;
+            }
+
+            int body_instrs = count_unrolled_copy_instrs(body_blocks, body_count);
+            if (body_instrs < 1) body_instrs = 1;  /* the copies' labels still cost */
+            if (trip_count > 0) {
+                if (!loop_is_innermost(h, loop_blocks, cfg) ||
+                    trip_count > (MAX_FULL_UNROLL_INSTRUCTIONS / body_instrs) ||
+                    growth + (trip_count - 1) * body_instrs > MAX_FULL_UNROLL_GROWTH) {
+                    free(loop_blocks);
+                    continue;
+                }
+                growth += (trip_count - 1) * body_instrs;
+            }
+
+            const char *header_label = h->instrs->label;
+
+            char *orig_labels[256];
+            for (int j = 0; j < body_count; j++) {
+                IRInstr *ins = body_blocks[j]->instrs;
+                orig_labels[j] = (ins && ins->kind == IR_LABEL && ins->label) ? ins->label : NULL;
+            }
+
+            IRInstr *new_head = ir_make_label((char *)header_label, h->instrs->line);
+            IRInstr *new_tail = new_head;
+            if (!new_head) {
+                free(loop_blocks);
+                continue;
+            }
+
+            if (trip_count == 0) {
+                IRInstr *to_exit = ir_make_goto((char *)exit_label, if_instr->line);
+                append_instr(&new_head, &new_tail, to_exit);
+                free_block_instr_list(h);
+                h->instrs = new_head;
+                h->last = new_tail;
+                free(loop_blocks);
+                continue;
+            }
+
+            char **curr_labels = alloc_iteration_labels(body_count);
+            if (!curr_labels) {
+                free_block_instr_list(h);
+                free(loop_blocks);
+                continue;
+            }
+
+            IRInstr *jump_to_first = ir_make_goto(curr_labels[entry_idx], if_instr->line);
+            append_instr(&new_head, &new_tail, jump_to_first);
+
+            int ok = 1;
+            for (long iter = 0; iter < trip_count; iter++) {
+                char **next_labels = NULL;
+                const char *next_target = exit_label;
+
+                if (iter + 1 < trip_count) {
+                    next_labels = alloc_iteration_labels(body_count);
+                    if (!next_labels) {
+                        ok = 0;
+                        break;
+                    }
+                    next_target = next_labels[entry_idx];
+                }
+
+                IRInstr *iter_tail = NULL;
+                IRInstr *iter_head = clone_loop_iteration(body_blocks, body_count, orig_labels, curr_labels,
+                                                         header_label, next_target, &iter_tail);
+                if (!iter_head || !iter_tail) {
+                    ok = 0;
+                    if (next_labels) free_iteration_labels(next_labels, body_count);
+                    break;
+                }
+
+                append_instr_list(&new_head, &new_tail, iter_head, iter_tail);
+
+                free_iteration_labels(curr_labels, body_count);
+                curr_labels = next_labels;
+            }
+            if (curr_labels) free_iteration_labels(curr_labels, body_count);
+
+            if (!ok) {
+                free_block_instr_list(h);
+                h->instrs = new_head;
+                h->last = new_tail;
+                free(loop_blocks);
+                continue;
+            }
+
+            free_block_instr_list(h);
+            h->instrs = new_head;
+            h->last = new_tail;
+            free(loop_blocks);
+        }
+        b = b->next;
+    }
+}
+
+static void merge_trivial_blocks(CFG *cfg) {
+    if (!cfg || !cfg->blocks) return;
+    int changed = 1;
+    while (changed) {
+        changed = 0;
+        BasicBlock *bb = cfg->blocks;
+        while (bb) {
+            /* A conditional branch to its own fall-through also has one
+               successor, but it still names the label. */
+            if (bb->succ_count == 1 && !(bb->last && (bb->last->kind == IR_SWITCH ||
+                                                     bb->last->kind == IR_IF))) {
+                BasicBlock *succ = bb->succs[0];
+                if (succ->pred_count == 1 && succ != bb && succ != cfg->entry && succ == bb->next) {
+                    if (bb->last && bb->last->kind == IR_GOTO) {
+                        IRInstr *p = bb->instrs, *prev = NULL;
+                        while(p && p != bb->last) { prev = p; p = p->next; }
+                        if (prev) prev->next = NULL;
+                        else bb->instrs = NULL;
+                        free_instr_single(bb->last);
+                        bb->last = prev;
+                    }
+                    IRInstr *to_add = succ->instrs;
+                    if (to_add && to_add->kind == IR_LABEL) {
+                        IRInstr *lbl = to_add;
+                        /* A label-only block has nothing left to splice in. */
+                        to_add = (lbl == succ->last) ? NULL : lbl->next;
+                        free_instr_single(lbl);
+                    }
+                    if (to_add) {
+                        if (bb->last) bb->last->next = to_add;
+                        else bb->instrs = to_add;
+                        bb->last = succ->last;
+                    }
+                    free(bb->succs);
+                    bb->succ_count = succ->succ_count;
+                    bb->succs = malloc(sizeof(BasicBlock*) * bb->succ_count);
+                    for (int i = 0; i < bb->succ_count; i++) {
+                        bb->succs[i] = succ->succs[i];
+                        BasicBlock *child = bb->succs[i];
+                        for (int j = 0; j < child->pred_count; j++) {
+                            if (child->preds[j] == succ) child->preds[j] = bb;
+                        }
+                    }
+                    succ->instrs = NULL;
+                    succ->last = NULL;
+                    succ->pred_count = 0;
+                    succ->succ_count = 0;
+                    bb->next = succ->next;
+                    free(succ);
+                    changed = 1;
+                }
             }
+            bb = bb->next;
+        }
+    }
+}
 
-            BasicBlock *preheader = find_preheader(h, loop_blocks);
-            if (!preheader) {
-                free(loop_blocks);
-                continue;
+/* --- Jump Threading ---
+ *
+ * When a predecessor P of a block B already determines the outcome of B's
+ * final IF -- an earlier branch on the same operands, or constants assigned
+ * to them on the way -- give P a private copy of B that jumps straight to
+ * the known successor:
+ *
+ *     P: ... x := 1; goto B          P: ... x := 1; goto B'
+ *     B: t := ...                    B': t := ...; goto Ltrue
+ *        if x != 0 goto Ltrue   =>   B:  t := ...
+ *                                        if x != 0 goto Ltrue
+ *
+ * Facts are gathered by walking back along single-predecessor chains, which
+ * covers repeated tests (`if (x > 0) ...; if (x > 0) ...`) and flags set on
+ * one arm of an if and tested after the join. Only small blocks are copied,
+ * and loop headers are left alone so later loop passes still see their
+ * loops. A block with a single predecessor that decides its test simply has
+ * the test folded. The CFG is rebuilt after every thread.
+ */
+
+#define THREAD_MAX_DUP_INSTRS 8
+#define THREAD_MAX_WALK       6
+#define THREAD_MAX_PER_FUNC   64
+
+/* Relations as subsets of {<, =, >}. */
+static int relop_mask(IRRelop relop) {
+    switch (relop) {
+        case IR_LT: return 1;
+        case IR_EQ: return 2;
+        case IR_GT: return 4;
+        case IR_LE: return 3;
+        case IR_GE: return 6;
+        case IR_NE: return 5;
+        default: return 7;
+    }
+}
+
+static int same_operand(IROperand *a, IROperand *b) {
+    if (a->is_const || b->is_const)
+        return a->is_const && b->is_const && a->const_val == b->const_val;
+    return a->name && b->name && strcmp(a->name, b->name) == 0;
+}
+
+typedef struct {
+    IROperand *op[2];
+    int known[2];
+    int val[2];
+    int in_memory[2];
+    int redefined;   /* an operand was assigned after the walk began */
+} BranchFacts;
+
+/* Account for the instructions of bb that run before `stop` (NULL: the whole
+   block), last to first. Returns 0 once an operand's value is lost. */
+static int scan_block_defs(BasicBlock *bb, IRInstr *stop, BranchFacts *bf) {
+    IRInstr *ins_buf[256];
+    int n = 0;
+    for (IRInstr *cur = bb->instrs; cur && cur != stop; cur = cur->next) {
+        if (n == 256) return 0;
+        ins_buf[n++] = cur;
+        if (cur == bb->last) break;
+    }
+    for (int i = n - 1; i >= 0; i--) {
+        IRInstr *ins = ins_buf[i];
+        int clobbers = ins->kind == IR_CALL || ins->kind == IR_CALL_INDIRECT || ins->kind == IR_STORE;
+        for (int k = 0; k < 2; k++) {
+            if (bf->known[k]) continue;
+            if (clobbers && bf->in_memory[k]) return 0;
+            if (!ins->result || strcmp(ins->result, bf->op[k]->name) != 0) continue;
+            if (ins->kind != IR_ASSIGN || !ins->src.is_const) return 0;
+            bf->known[k] = 1;
+            bf->val[k] = ins->src.const_val;
+            bf->redefined = 1;
+        }
+    }
+    return 1;
+}
+
+/* The relation mask known to hold for cur's IF on the edge into `to`,
+   or -1 when the edge says nothing. */
+static int edge_relation(CFG *cfg, BasicBlock *cur, BasicBlock *to) {
+    IRInstr *t = cur->last;
+    BasicBlock *taken = find_bb_by_label(cfg->blocks, t->label);
+    if (taken == cur->next) return -1;
+    if (to == taken) return relop_mask(t->relop);
+    if (to == cur->next) return 7 & ~relop_mask(t->relop);
+    return -1;
+}
+
+/* Outcome of b's final IF when entered from p: 1 taken, 0 not, -1 unknown. */
+static int known_branch_outcome(CFG *cfg, BasicBlock *b, BasicBlock *p, Scope *scope) {
+    IRInstr *cond = b->last;
+    BranchFacts bf;
+    bf.op[0] = &cond->if_left;
+    bf.op[1] = &cond->if_right;
+    bf.redefined = 0;
+    for (int k = 0; k < 2; k++) {
+        IROperand *op = bf.op[k];
+        if (!op->is_const && (!op->name || strncmp(op->name, ".LC", 3) == 0)) return -1;
+        bf.known[k] = op->is_const;
+        bf.val[k] = op->const_val;
+        bf.in_memory[k] = !op->is_const && !is_register_candidate_name(op->name, scope);
+    }
+    if (!scan_block_defs(b, cond, &bf)) return -1;
+
+    BasicBlock *to = b, *cur = p;
+    for (int depth = 0; depth < THREAD_MAX_WALK && cur && cur != b; depth++) {
+        if (bf.known[0] && bf.known[1]) break;
+        IRInstr *t = cur->last;
+        if (!bf.redefined && t && t->kind == IR_IF) {
+            int fact = edge_relation(cfg, cur, to);
+            if (fact >= 0) {
+                if (same_operand(&t->if_left, bf.op[1]) && same_operand(&t->if_right, bf.op[0]))
+                    fact = ((fact & 1) << 2) | (fact & 2) | ((fact & 4) >> 2);
+                else if (!same_operand(&t->if_left, bf.op[0]) || !same_operand(&t->if_right, bf.op[1]))
+                    fact = -1;
             }
+            if (fact >= 0) {
+                int want = relop_mask(cond->relop);
+                if ((fact & ~want) == 0) return 1;
+                if ((fact & want) == 0) return 0;
+            }
+        }
+        if (!scan_block_defs(cur, NULL, &bf)) return -1;
+        if (cur->pred_count != 1) break;
+        to = cur;
+        cur = cur->preds[0];
+    }
+    if (bf.known[0] && bf.known[1]) return eval_relop(bf.val[0], bf.val[1], cond->relop);
+    return -1;
+}
 
-            /* Step 1: Detect Basic Induction Variables (BIVs) */
-            InductionVar ivs[128];
-            int iv_count = 0;
+static int is_loop_header(BasicBlock *b) {
+    for (int i = 0; i < b->pred_count; i++) {
+        BasicBlock *p = b->preds[i];
+        if (p->doms && p->doms[b->id]) return 1;
+    }
+    return 0;
+}
 
-            BasicBlock *lb = cfg->blocks;
-            while (lb) {
-                if (loop_blocks[lb->id]) {
-                    IRInstr *ins = lb->instrs;
-                    while (ins) {
-                        int delta = 0;
-                        int matched = 0;
-                        char *ivar_name = NULL;
-
-                        if (ins->kind == IR_BINOP && ins->result && ins->left.name &&
-                            iv_name_match(ins->result, ins->left.name) && ins->right.is_const &&
-                            (ins->binop == '+' || ins->binop == '-')) {
-                            matched = 1;
-                            delta = (ins->binop == '+') ? ins->right.const_val : -ins->right.const_val;
-                            ivar_name = ins->result;
-                        }
-                        /* Pattern: tmp = i + 1; i = tmp */
-                        else if (ins->kind == IR_BINOP && ins->result && ins->left.name && ins->right.is_const &&
-                                 (ins->binop == '+' || ins->binop == '-')) {
-                            IRInstr *nx = ins->next;
-                            if (nx && nx->kind == IR_ASSIGN && !nx->src.is_const && nx->src.name &&
-                                strcmp(nx->src.name, ins->result) == 0 && iv_name_match(nx->result, ins->left.name)) {
-                                matched = 1;
-                                delta = (ins->binop == '+') ? ins->right.const_val : -ins->right.const_val;
-                                ivar_name = nx->result;
-                            }
-                        }
+/* Thread one edge of the function. Returns 1 if the IR was changed. */
+static int thread_one_jump(CFG *cfg, Scope *scope) {
+    BasicBlock *last_block = NULL;
+    for (BasicBlock *bb = cfg->blocks; bb; bb = bb->next) last_block = bb;
+
+    for (BasicBlock *b = cfg->blocks; b; b = b->next) {
+        IRInstr *cond = b->last;
+        if (!cond || cond->kind != IR_IF || !b->instrs || is_loop_header(b)) continue;
+
+        /* A sole predecessor that decides the test needs no copy: make the
+           IF constant and let simplify_control_flow fold it. */
+        if (b->pred_count == 1 && !(cond->if_left.is_const && cond->if_right.is_const)) {
+            int outcome = known_branch_outcome(cfg, b, b->preds[0], scope);
+            if (outcome < 0) continue;
+            ir_free_operand(&cond->if_left);
+            ir_free_operand(&cond->if_right);
+            cond->if_left = ir_op_const(0);
+            cond->if_right = ir_op_const(0);
+            cond->relop = outcome ? IR_EQ : IR_NE;
+            return 1;
+        }
+        if (b->pred_count < 2 || b->instrs->kind != IR_LABEL) continue;
+
+        /* The copied middle of b: everything between its label and the IF. */
+        IRInstr *first = b->instrs->next;
+        int dup_count = 0, ok = 1;
+        for (IRInstr *cur = first; cur && cur != cond; cur = cur->next) {
+            if (cur->kind == IR_LABEL || cur->kind == IR_TRY_BEGIN || cur->kind == IR_TRY_END ||
+                cur->kind == IR_ALLOCA)
+                ok = 0;
+            dup_count++;
+        }
+        if (!ok || dup_count > THREAD_MAX_DUP_INSTRS) continue;
+
+        BasicBlock *prev_b = NULL;
+        for (BasicBlock *bb = cfg->blocks; bb && bb != b; bb = bb->next) prev_b = bb;
+
+        for (int i = 0; i < b->pred_count; i++) {
+            BasicBlock *p = b->preds[i];
+            if (p == b || !p->last) continue;
+            int outcome = known_branch_outcome(cfg, b, p, scope);
+            if (outcome < 0) continue;
+
+            const char *target = outcome ? cond->label : (b->next ? loop_exit_label(b->next) : NULL);
+            BasicBlock *target_bb = outcome ? find_bb_by_label(cfg->blocks, cond->label) : b->next;
+            if (!target || target_bb == b) continue;
+
+            /* How does p reach b? Both edges of an IF into b cannot be split. */
+            const char *b_label = b->instrs->label;
+            int jumps = (p->last->kind == IR_GOTO || p->last->kind == IR_IF) &&
+                        p->last->label && strcmp(p->last->label, b_label) == 0;
+            int falls = falls_through(p) && p->next == b;
+            if (jumps == falls) continue;
+
+            /* Place the copy right before b when nothing else falls into it
+               there, otherwise at the end of the function. */
+            int before_b = (prev_b == p && falls) || (prev_b && !falls_through(prev_b));
+            if (!before_b && (falls || falls_through(last_block))) continue;
+
+            char *copy_label = ir_new_label();
+            IRInstr *new_head = NULL, *new_tail = NULL;
+            append_instr(&new_head, &new_tail, ir_make_label(copy_label, cond->line));
+            for (IRInstr *cur = first; cur != cond; cur = cur->next)
+                append_instr(&new_head, &new_tail, clone_instr(cur));
+            append_instr(&new_head, &new_tail, ir_make_goto((char *)target, cond->line));
+
+            if (jumps) p->last->label = strdup(copy_label);
+            if (before_b) {
+                new_tail->next = b->instrs;
+                b->instrs = new_head;
+            } else {
+                last_block->last->next = new_head;
+                last_block->last = new_tail;
+            }
+            free(copy_label);
+            return 1;
+        }
+    }
+    return 0;
+}
 
-                        if (matched && iv_count < 128) {
-                            ivs[iv_count].name      = strdup(ivar_name);
-                            ivs[iv_count].base_iv   = strdup(ivar_name);
-                            ivs[iv_count].multiplier = 1;
-                            ivs[iv_count].offset    = 0;
-                            ivs[iv_count].is_basic  = 1;
-                            ivs[iv_count].delta     = delta;
-                            iv_count++;
-                        }
-                        if (ins == lb->last) break;
-                        ins = ins->next;
-                    }
-                }
-                lb = lb->next;
+static CFG* thread_jumps(IRFunc *f, CFG *cfg) {
+    Symbol *fsym = lookup(cfg->func_name);
+    Scope *scope = (fsym && fsym->kind == SYM_FUNCTION) ? fsym->scope : NULL;
+    /* Fold chains of label-only blocks so joins end in the IF they test. */
+    merge_trivial_blocks(cfg);
+    compute_dominators(cfg);
+    for (int n = 0; n < THREAD_MAX_PER_FUNC && thread_one_jump(cfg, scope); n++) {
+        f->instrs = flatten_cfg(cfg);
+        free_cfg(cfg);
+        f->instrs = simplify_control_flow(f->instrs);
+        cfg = build_cfg(f);
+        if (!cfg) break;
+        mark_reachable_and_cleanup(cfg);
+        merge_trivial_blocks(cfg);
+        compute_dominators(cfg);
+    }
+    return cfg;
+}
+
+/* --- If-Conversion ---
+ *
+ * Short diamonds and triangles whose arms only compute values
+ *
+ *     if a < b goto L1              t1 := ...          (arm 1, renamed)
+ *     goto L2                       t2 := ...          (arm 2, renamed)
+ *   L1: m := a; goto L3      =>     m := a < b ? a : b
+ *   L2: m := b                      goto L3
+ *   L3:
+ *
+ * are speculated and merged with IR_SELECT, which the backend lowers
+ * without a branch. Each arm's definitions are renamed to fresh temps so
+ * neither arm can disturb the other or the condition; one select per
+ * assigned name then picks the surviving value. Arms may hold only
+ * assignments, unary and non-trapping binary operations, and must stay
+ * within IFCONV_MAX_ARM_INSTRS; at most IFCONV_MAX_SELECTS selects are made
+ * per diamond, so the speculated work stays below a mispredict's cost.
+ */
+
+#define IFCONV_MAX_ARM_INSTRS 4
+#define IFCONV_MAX_SELECTS    3
+#define IFCONV_MAX_PER_FUNC   64
+
+typedef struct {
+    char *name;        /* variable or temp assigned in the arm */
+    IROperand value;   /* its value at the end of the arm */
+} ArmDef;
+
+static int block_is_empty(BasicBlock *bb) {
+    for (IRInstr *cur = bb->instrs; cur; cur = cur->next) {
+        if (cur->kind != IR_LABEL && cur->kind != IR_GOTO) return 0;
+        if (cur == bb->last) break;
+    }
+    return 1;
+}
+
+/* Follow one successor s of the IF block to the join. *body is the single
+   block holding the arm's work (NULL for an empty arm). */
+static int find_arm(BasicBlock *s, BasicBlock **body, BasicBlock **join) {
+    *body = NULL;
+    if (s->pred_count != 1) { *join = s; return 1; }
+    BasicBlock *cur = s;
+    while (block_is_empty(cur)) {
+        if (cur->succ_count != 1) return 0;
+        BasicBlock *n = cur->succs[0];
+        if (n->pred_count != 1) { *join = n; return 1; }
+        cur = n;
+    }
+    if (cur->succ_count != 1) return 0;
+    *body = cur;
+    *join = cur->succs[0];
+    return 1;
+}
+
+static int arm_is_convertible(BasicBlock *body, Scope *scope) {
+    if (!body) return 1;
+    int n = 0;
+    for (IRInstr *cur = body->instrs; cur; cur = cur->next) {
+        if (cur->kind != IR_LABEL && cur->kind != IR_GOTO) {
+            if (cur->kind != IR_ASSIGN && cur->kind != IR_UNOP && cur->kind != IR_BINOP) return 0;
+            if (cur->kind == IR_BINOP && (cur->binop == '/' || cur->binop == '%')) return 0;
+            if (cur->kind == IR_UNOP && cur->unop == '&') return 0;
+            if (!cur->result || !is_register_candidate_name(cur->result, scope)) return 0;
+            if (++n > IFCONV_MAX_ARM_INSTRS) return 0;
+        }
+        if (cur == body->last) break;
+    }
+    return 1;
+}
+
+static int arm_defines(BasicBlock *body, const char *name) {
+    if (!body || !name) return 0;
+    for (IRInstr *cur = body->instrs; cur; cur = cur->next) {
+        if (cur->result && strcmp(cur->result, name) == 0) return 1;
+        if (cur == body->last) break;
+    }
+    return 0;
+}
+
+static ArmDef* find_arm_def(ArmDef *defs, int count, const char *name) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(defs[i].name, name) == 0) return &defs[i];
+    }
+    return NULL;
+}
+
+static int rename_arm_operand(IROperand *op, ArmDef *defs, int count) {
+    if (op->is_const || !op->name) return 0;
+    ArmDef *d = find_arm_def(defs, count, op->name);
+    if (!d) return 0;
+    free(op->name);
+    *op = ir_op_copy(&d->value);
+    return 1;
+}
+
+/* Emit the arm's work with renamed results; record each name's final value. */
+static void speculate_arm(BasicBlock *body, BasicBlock *other, ArmDef *defs, int *count,
+                          IRInstr **head, IRInstr **tail) {
+    if (!body) return;
+    for (IRInstr *cur = body->instrs; cur; cur = cur->next) {
+        if (cur->kind == IR_ASSIGN || cur->kind == IR_UNOP || cur->kind == IR_BINOP) {
+            IRInstr *dup = clone_instr(cur);
+            int renamed = rename_arm_operand(&dup->src, defs, *count);
+            rename_arm_operand(&dup->left, defs, *count);
+            rename_arm_operand(&dup->right, defs, *count);
+            rename_arm_operand(&dup->unop_src, defs, *count);
+
+            IROperand value;
+            /* A copy of a value no select will overwrite feeds the select directly. */
+            if (dup->kind == IR_ASSIGN &&
+                (dup->src.is_const || renamed ||
+                 (!arm_defines(body, dup->src.name) && !arm_defines(other, dup->src.name)))) {
+                value = ir_op_copy(&dup->src);
+                ir_free_instr(dup);
+            } else {
+                char *fresh = new_opt_temp("sel");
+                free(dup->result);
+                dup->result = fresh;
+                value = ir_op_name(fresh);
+                append_instr(head, tail, dup);
             }
 
-            /* Step 2: Detect Derived Induction Variables (DIVs) */
-            lb = cfg->blocks;
-            while (lb) {
-                if (loop_blocks[lb->id]) {
-                    IRInstr *ins = lb->instrs;
-                    while (ins) {
-                        if (ins->kind == IR_BINOP && ins->result) {
-                            InductionVar *base = NULL;
-                            int mult = 1, off = 0;
-
-                            if (ins->binop == '*') {
-                                base = find_iv(ivs, iv_count, ins->left.name);
-                                if (base && ins->right.is_const) {
-                                    mult = ins->right.const_val;
-                                } else if (ins->right.name && (base = find_iv(ivs, iv_count, ins->right.name)) && ins->left.is_const) {
-                                    mult = ins->left.const_val;
-                                }
-                                if (base && iv_count < 128) {
-                                    ivs[iv_count].name       = strdup(ins->result);
-                                    ivs[iv_count].base_iv    = strdup(base->base_iv);
-                                    ivs[iv_count].multiplier = base->multiplier * mult;
-                                    ivs[iv_count].offset     = base->offset * mult;
-                                    ivs[iv_count].is_basic   = 0;
-                                    ivs[iv_count].delta      = base->delta * mult;
-                                    iv_count++;
-                                }
-                            } else if (ins->binop == '+') {
-                                base = find_iv(ivs, iv_count, ins->left.name);
-                                if (base && ins->right.is_const) {
-                                    off = ins->right.const_val;
-                                } else if (ins->right.name && (base = find_iv(ivs, iv_count, ins->right.name)) && ins->left.is_const) {
-                                    off = ins->left.const_val;
-                                }
-                                if (base && iv_count < 128) {
-                                    ivs[iv_count].name       = strdup(ins->result);
-                                    ivs[iv_count].base_iv    = strdup(base->base_iv);
-                                    ivs[iv_count].multiplier = base->multiplier;
-                                    ivs[iv_count].offset     = base->offset + off;
-                                    ivs[iv_count].is_basic   = 0;
-                                    ivs[iv_count].delta      = base->delta;
-                                    iv_count++;
-                                }
-                            }
-                        }
-                        if (ins == lb->last) break;
-                        ins = ins->next;
-                    }
+            ArmDef *d = find_arm_def(defs, *count, cur->result);
+            if (d) {
+                ir_free_operand(&d->value);
+            } else {
+                d = &defs[(*count)++];
+                d->name = cur->result;
+            }
+            d->value = value;
+        }
+        if (cur == body->last) break;
+    }
+}
+
+static int if_convert_one(CFG *cfg, Scope *scope) {
+    for (BasicBlock *b = cfg->blocks; b; b = b->next) {
+        IRInstr *cond = b->last;
+        if (!cond || cond->kind != IR_IF || b->succ_count != 2) continue;
+        if (cond->if_left.is_const && cond->if_right.is_const) continue;
+
+        BasicBlock *taken = find_bb_by_label(cfg->blocks, cond->label);
+        BasicBlock *fall = b->next;
+        if (!taken || !fall || taken == fall) continue;
+
+        BasicBlock *t_body, *f_body, *t_join, *f_join;
+        if (!find_arm(taken, &t_body, &t_join) || !find_arm(fall, &f_body, &f_join)) continue;
+        if (t_join != f_join || t_join == b || (!t_body && !f_body)) continue;
+        if (t_body == b || f_body == b) continue;
+        if (!t_join->instrs || t_join->instrs->kind != IR_LABEL) continue;
+        if (!arm_is_convertible(t_body, scope) || !arm_is_convertible(f_body, scope)) continue;
+
+        /* Count the selects: names assigned in either arm. */
+        const char *names[2 * IFCONV_MAX_ARM_INSTRS];
+        int name_count = 0;
+        BasicBlock *arms[2] = { t_body, f_body };
+        for (int a = 0; a < 2; a++) {
+            if (!arms[a]) continue;
+            for (IRInstr *cur = arms[a]->instrs; cur; cur = cur->next) {
+                if (cur->result) {
+                    int seen = 0;
+                    for (int k = 0; k < name_count; k++)
+                        if (strcmp(names[k], cur->result) == 0) seen = 1;
+                    if (!seen) names[name_count++] = cur->result;
                 }
-                lb = lb->next;
+                if (cur == arms[a]->last) break;
             }
+        }
+        if (name_count > IFCONV_MAX_SELECTS) continue;
+
+        int line = cond->line;
+        IRInstr *new_head = NULL, *new_tail = NULL;
+
+        /* The selects overwrite arm-assigned names one by one; if the
+           condition reads one of them, test a snapshot instead. */
+        IROperand cl = ir_op_copy(&cond->if_left), cr = ir_op_copy(&cond->if_right);
+        IROperand *cond_ops[2] = { &cl, &cr };
+        for (int k = 0; k < 2; k++) {
+            IROperand *op = cond_ops[k];
+            if (op->is_const || !op->name) continue;
+            if (!arm_defines(t_body, op->name) && !arm_defines(f_body, op->name)) continue;
+            char *snap = new_opt_temp("sel");
+            append_instr(&new_head, &new_tail, ir_make_assign(snap, *op, line));
+            free(op->name);
+            *op = ir_op_name(snap);
+            free(snap);
+        }
 
-            /* Step 3: Strength Reduction */
-            for (int k = 0; k < iv_count; k++) {
-                if (ivs[k].is_basic) continue;
-
-                int init = 0;
-                if (!get_initial_value_from_block(preheader, ivs[k].base_iv, &init)) continue;
-
-                char *j_new = ir_new_temp();
-                IROperand init_op; init_op.is_const = 1; init_op.name = NULL;
-                init_op.const_val = (long)ivs[k].multiplier * init + ivs[k].offset;
-                IRInstr *init_ins = ir_make_assign(strdup(j_new), init_op, h->instrs->line);
-
-                /* Append init_ins to preheader before any branch */
-                IRInstr *pcur = preheader->instrs;
-                while (pcur && pcur->next) {
-                    if (pcur->next->kind == IR_GOTO || pcur->next->kind == IR_IF || pcur->next->kind == IR_RETURN) break;
-                    pcur = pcur->next;
-                }
-                if (pcur) {
-                    init_ins->next = pcur->next;
-                    pcur->next = init_ins;
-                    if (pcur == preheader->last) preheader->last = init_ins;
-                }
-
-                /* Insert update after each BIV update inside the loop */
-                lb = cfg->blocks;
-                while (lb) {
-                    if (loop_blocks[lb->id]) {
-                        IRInstr *ins = lb->instrs;
-                        while (ins) {
-                            if (ins->result && iv_name_match(ins->result, ivs[k].base_iv)) {
-                                IROperand j_op;     j_op.is_const = 0; j_op.name = strdup(j_new); j_op.const_val = 0;
-                                IROperand delta_op; delta_op.is_const = 1; delta_op.const_val = ivs[k].delta; delta_op.name = NULL;
-                                IRInstr *upd = ir_make_binop(strdup(j_new), j_op, delta_op, '+', ins->line);
-                                upd->next = ins->next;
-                                ins->next = upd;
-                                if (ins == lb->last) lb->last = upd;
-                            }
-                            if (ins == lb->last) break;
-                            ins = ins->next;
-                        }
-                    }
-                    lb = lb->next;
-                }
-
-                /* Replace DIV definitions/uses with j_new */
-                lb = cfg->blocks;
-                while (lb) {
-                    if (loop_blocks[lb->id]) {
-                        IRInstr *ins = lb->instrs;
-                        while (ins) {
-                            if (ins->result && strcmp(ins->result, ivs[k].name) == 0) {
-                                IROperand j_op; j_op.is_const = 0; j_op.name = strdup(j_new); j_op.const_val = 0;
-                                convert_to_assign(ins, j_op);
-                            } else {
-                                IROperand *ops[5] = {NULL}; int nops = 0;
-                                if (ins->kind == IR_ASSIGN)  { ops[0] = &ins->src; nops = 1; }
-                                else if (ins->kind == IR_BINOP) { ops[0] = &ins->left; ops[1] = &ins->right; nops = 2; }
-                                else if (ins->kind == IR_IF) { ops[0] = &ins->if_left; ops[1] = &ins->if_right; nops = 2; }
-                                else if (ins->kind == IR_RETURN) { ops[0] = &ins->src; nops = 1; }
-                                for (int m = 0; m < nops; m++) {
-                                    if (ops[m] && !ops[m]->is_const && ops[m]->name &&
-                                        strcmp(ops[m]->name, ivs[k].name) == 0) {
-                                        free(ops[m]->name);
-                                        ops[m]->name = strdup(j_new);
-                                    }
-                                }
-                            }
-                            if (ins == lb->last) break;
-                            ins = ins->next;
-                        }
+        ArmDef t_defs[IFCONV_MAX_ARM_INSTRS], f_defs[IFCONV_MAX_ARM_INSTRS];
+        int t_count = 0, f_count = 0;
+        speculate_arm(t_body, f_body, t_defs, &t_count, &new_head, &new_tail);
+        speculate_arm(f_body, t_body, f_defs, &f_count, &new_head, &new_tail);
+
+        for (int k = 0; k < name_count; k++) {
+            ArmDef *td = find_arm_def(t_defs, t_count, names[k]);
+            ArmDef *fd = find_arm_def(f_defs, f_count, names[k]);
+            IROperand keep = ir_op_name((char *)names[k]);
+            append_instr(&new_head, &new_tail,
+                         ir_make_select((char *)names[k], cl, cr, cond->relop,
+                                        td ? td->value : keep, fd ? fd->value : keep, line));
+            ir_free_operand(&keep);
+        }
+        append_instr(&new_head, &new_tail, ir_make_goto(t_join->instrs->label, line));
+
+        for (int k = 0; k < t_count; k++) ir_free_operand(&t_defs[k].value);
+        for (int k = 0; k < f_count; k++) ir_free_operand(&f_defs[k].value);
+        ir_free_operand(&cl);
+        ir_free_operand(&cr);
+
+        /* Replace the IF; the arm blocks become unreachable. */
+        IRInstr *prev = NULL;
+        for (IRInstr *cur = b->instrs; cur && cur != cond; cur = cur->next) prev = cur;
+        if (prev) prev->next = new_head;
+        else b->instrs = new_head;
+        b->last = new_tail;
+        free_instr_single(cond);
+        return 1;
+    }
+    return 0;
+}
+
+static CFG* if_convert(IRFunc *f, CFG *cfg) {
+    Symbol *fsym = lookup(cfg->func_name);
+    Scope *scope = (fsym && fsym->kind == SYM_FUNCTION) ? fsym->scope : NULL;
+    merge_trivial_blocks(cfg);
+    int n = 0;
+    while (n < IFCONV_MAX_PER_FUNC && if_convert_one(cfg, scope)) {
+        n++;
+        f->instrs = flatten_cfg(cfg);
+        free_cfg(cfg);
+        f->instrs = simplify_control_flow(f->instrs);
+        cfg = build_cfg(f);
+        if (!cfg) return NULL;
+        mark_reachable_and_cleanup(cfg);
+        /* A converted inner diamond leaves a plain block the outer one can absorb. */
+        merge_trivial_blocks(cfg);
+    }
+    /* Forward the copies the arms left in front of their selects. */
+    if (n > 0) {
+        for (BasicBlock *bb = cfg->blocks; bb; bb = bb->next)
+            optimize_bb(bb);
+    }
+    return cfg;
+}
+
+/* --- Loop Rotation ---
+ *
+ * ir_gen lowers while/for loops top-tested:
+ *
+ *     Lh:  <cond>
+ *          if a relop b goto Lt
+ *          goto Lf                  (or fall through into Lf:)
+ *          ...
+ *          goto Lh                  <- back edge
+ *
+ * so every iteration pays the back-edge jump on top of the test. A jump to
+ * Lh is equivalent to executing the header inline, so the back edge is
+ * replaced by a copy of <cond> and the test, jumping straight to the header's
+ * targets. The original header then runs once, as the entry guard, and the
+ * loop is closed by a single conditional branch at the latch.
+ *
+ * This works on the flat list after unrolling, whose matchers expect the
+ * top-tested shape.
+ */
+
+#define ROTATE_MAX_COND_INSTRS 6
+
+/* Is `label` defined strictly between `from` and `to` in list order? */
+static int label_between(IRInstr *from, IRInstr *to, const char *label) {
+    for (IRInstr *p = from ? from->next : NULL; p && p != to; p = p->next)
+        if (p->kind == IR_LABEL && strcmp(p->label, label) == 0) return 1;
+    return 0;
+}
+
+/* Matches a rotatable header at label `hdr`. On success returns the IF and
+   sets the two targets: `taken` when the test holds, `fallthru` otherwise. */
+static IRInstr* match_rotatable_header(IRInstr *hdr, int *cond_count,
+                                       const char **taken, const char **fallthru) {
+    int n = 0;
+    IRInstr *p = hdr->next;
+    while (p && (p->kind == IR_ASSIGN || p->kind == IR_BINOP ||
+                 p->kind == IR_UNOP || p->kind == IR_LOAD)) {
+        if (++n > ROTATE_MAX_COND_INSTRS) return NULL;
+        p = p->next;
+    }
+    if (!p || p->kind != IR_IF || !p->label) return NULL;
+
+    IRInstr *after = p->next;
+    if (!after) return NULL;
+    if (after->kind == IR_GOTO) *fallthru = after->label;
+    else if (after->kind == IR_LABEL) *fallthru = after->label;
+    else return NULL;
+    if (!*fallthru) return NULL;
+
+    /* A header that branches to itself is not a loop header shape we know. */
+    if (strcmp(p->label, hdr->label) == 0 || strcmp(*fallthru, hdr->label) == 0)
+        return NULL;
+
+    *taken = p->label;
+    *cond_count = n;
+    return p;
+}
+
+static IRInstr* rotate_loops(IRInstr *head) {
+    for (IRInstr *hdr = head; hdr; hdr = hdr->next) {
+        if (hdr->kind != IR_LABEL || !hdr->label) continue;
+
+        int cond_count;
+        const char *taken, *fallthru;
+        IRInstr *test = match_rotatable_header(hdr, &cond_count, &taken, &fallthru);
+        if (!test) continue;
+
+        /* Rewrite every backward `goto hdr` that follows the header. */
+        IRInstr **pp = &test->next;
+        while (*pp) {
+            IRInstr *back = *pp;
+            if (back->kind == IR_TRY_BEGIN || back->kind == IR_TRY_END) break;
+            if (back->kind != IR_GOTO || strcmp(back->label, hdr->label) != 0) {
+                pp = &back->next;
+                continue;
+            }
+
+            /* Branch on whichever outcome does not simply fall through to
+               the code after the latch; prefer a backward (in-loop) target. */
+            IRRelop relop = test->relop;
+            const char *target = taken, *other = fallthru;
+            if (label_run_contains(back->next, taken) ||
+                (!label_run_contains(back->next, fallthru) &&
+                 label_between(hdr, back, fallthru) && !label_between(hdr, back, taken))) {
+                relop = negate_relop(relop);
+                target = fallthru;
+                other = taken;
+            }
+
+            IRInstr *new_head = NULL, *new_tail = NULL;
+            IRInstr *c = hdr->next;
+            for (int i = 0; i < cond_count; i++, c = c->next)
+                append_instr(&new_head, &new_tail, clone_instr(c));
+
+            IRInstr *branch = clone_instr(test);
+            free(branch->label);
+            branch->label = strdup(target);
+            branch->relop = relop;
+            append_instr(&new_head, &new_tail, branch);
+
+            if (!label_run_contains(back->next, other))
+                append_instr(&new_head, &new_tail, ir_make_goto((char *)other, back->line));
+
+            new_tail->next = back->next;
+            *pp = new_head;
+            free_instr_single(back);
+            pp = &new_tail->next;
+        }
+    }
+    return head;
+}
+
+/* --- Block Placement ---
+ *
+ * Blocks otherwise stay in the order ir_gen produced them, so a hot path
+ * can jump over cold code placed inline with it (error handling, throw
+ * sites), and taken branches can appear where a fall-through would do.
+ * The placement works in three steps:
+ *
+ *   1. Every block gets a frequency. With -fprofile-use and a function
+ *      the training run entered, this is the block count. Otherwise it is
+ *      a static estimate of 8^loop depth. Blocks ending in a throw, catch
+ *      handlers, and blocks that can only be reached from, or can only
+ *      lead to, such blocks are cold and get 0.
+ *   2. Edges are visited from heaviest (min of the two frequencies)
+ *      to lightest. An edge whose source ends a chain and whose target
+ *      starts another joins the two chains, so the edge becomes a
+ *      fall-through (Pettis-Hansen). Hot blocks never chain to cold ones.
+ *   3. The entry chain comes first. Each following hot chain is the one
+ *      most heavily branched to from what is already placed; the cold
+ *      chains go at the end of the function.
+ *
+ * The branches are then fixed up to match: a conditional whose taken
+ * target now follows it is inverted, and a lost fall-through gets an
+ * explicit goto.
+ */
+
+#define PLACE_LOOP_WEIGHT 8
+#define PLACE_MAX_DEPTH   5
+
+typedef struct {
+    BasicBlock *src, *dst;
+    long long weight;
+    long long dst_freq; /* breaks weight ties towards the hotter target */
+    int order;          /* source position of the edge, for stable ties */
+} PlaceEdge;
+
+static int place_edge_cmp(const void *a, const void *b) {
+    const PlaceEdge *x = a, *y = b;
+    if (x->weight != y->weight) return x->weight > y->weight ? -1 : 1;
+    if (x->dst_freq != y->dst_freq) return x->dst_freq > y->dst_freq ? -1 : 1;
+    return x->order - y->order;
+}
+
+/* Target of the implicit fall-through out of `bb`, NULL if it has none. */
+static BasicBlock* place_fallthrough(BasicBlock *bb) {
+    IRInstr *last = bb->last;
+    if (last->kind == IR_GOTO || last->kind == IR_SWITCH ||
+        last->kind == IR_RETURN || last->kind == IR_THROW) return NULL;
+    return bb->next;
+}
+
+/* Labels and a goto: branches into it get forwarded past it anyway. */
+static int is_forwarding_block(BasicBlock *bb) {
+    if (bb->last->kind != IR_GOTO) return 0;
+    for (IRInstr *i = bb->instrs; i != bb->last; i = i->next)
+        if (i->kind != IR_LABEL) return 0;
+    return 1;
+}
+
+static int is_catch_handler(CFG *cfg, BasicBlock *bb) {
+    if (!bb->instrs || bb->instrs->kind != IR_LABEL) return 0;
+    for (BasicBlock *p = cfg->blocks; p; p = p->next)
+        if (p->last->kind == IR_TRY_BEGIN && strcmp(p->last->label, bb->instrs->label) == 0)
+            return 1;
+    return 0;
+}
+
+/* Statically cold blocks: throw sites and catch handlers, spread to blocks
+   that are only reached from cold code or can only end in it. */
+static void mark_static_cold(CFG *cfg, int *cold) {
+    for (BasicBlock *bb = cfg->blocks; bb; bb = bb->next)
+        cold[bb->id] = bb->last->kind == IR_THROW || is_catch_handler(cfg, bb);
+
+    int changed = 1;
+    while (changed) {
+        changed = 0;
+        for (BasicBlock *bb = cfg->blocks; bb; bb = bb->next) {
+            if (cold[bb->id] || bb == cfg->entry) continue;
+            int all_preds = bb->pred_count > 0, all_succs = bb->succ_count > 0;
+            for (int i = 0; i < bb->pred_count; i++)
+                if (!cold[bb->preds[i]->id]) all_preds = 0;
+            for (int i = 0; i < bb->succ_count; i++)
+                if (!cold[bb->succs[i]->id]) all_succs = 0;
+            if (all_preds || all_succs) {
+                cold[bb->id] = 1;
+                changed = 1;
+            }
+        }
+    }
+}
+
+static void estimate_block_freqs(CFG *cfg, long long *freq, int *cold) {
+    int n = cfg->block_count;
+    if (profile_available() && cfg->entry->count > 0) {
+        for (BasicBlock *bb = cfg->blocks; bb; bb = bb->next) {
+            freq[bb->id] = bb->count > 0 ? bb->count : 0;
+            cold[bb->id] = freq[bb->id] == 0;
+        }
+        return;
+    }
+
+    /* Loop depth from the natural loops of all back edges into each header. */
+    int *depth = calloc(n, sizeof(int));
+    int *in_loop = calloc(n, sizeof(int));
+    int *body = malloc(sizeof(int) * n);
+    compute_dominators(cfg);
+    for (BasicBlock *h = cfg->blocks; h; h = h->next) {
+        int is_header = 0;
+        memset(in_loop, 0, sizeof(int) * n);
+        for (int i = 0; i < h->pred_count; i++) {
+            BasicBlock *latch = h->preds[i];
+            if (!latch->doms || !latch->doms[h->id]) continue;
+            compute_natural_loop(h, latch, body, cfg);
+            for (int j = 0; j < n; j++) in_loop[j] |= body[j];
+            is_header = 1;
+        }
+        if (!is_header) continue;
+        for (int j = 0; j < n; j++) depth[j] += in_loop[j];
+    }
+
+    mark_static_cold(cfg, cold);
+    for (BasicBlock *bb = cfg->blocks; bb; bb = bb->next) {
+        long long f = 1;
+        for (int d = 0; d < depth[bb->id] && d < PLACE_MAX_DEPTH; d++) f *= PLACE_LOOP_WEIGHT;
+        freq[bb->id] = cold[bb->id] ? 0 : f;
+    }
+    free(depth);
+    free(in_loop);
+    free(body);
+}
+
+/* Gives `bb` a leading label if it has none and returns it. */
+static const char* place_label_of(BasicBlock *bb) {
+    if (bb->instrs->kind == IR_LABEL) return bb->instrs->label;
+    char *name = ir_new_label();
+    IRInstr *lbl = ir_make_label(name, bb->instrs->line);
+    free(name);
+    lbl->next = bb->instrs;
+    bb->instrs = lbl;
+    return lbl->label;
+}
+
+static void place_append_goto(BasicBlock *bb, BasicBlock *target) {
+    IRInstr *g = ir_make_goto((char *)place_label_of(target), bb->last->line);
+    g->next = bb->last->next;
+    bb->last->next = g;
+    bb->last = g;
+}
+
+static void place_blocks(IRFunc *f) {
+    CFG *cfg = build_cfg(f);
+    if (!cfg) return;
+    int n = cfg->block_count;
+    if (n < 3) { free_cfg(cfg); return; }
+
+    long long *freq = calloc(n, sizeof(long long));
+    int *cold = calloc(n, sizeof(int));
+    estimate_block_freqs(cfg, freq, cold);
+
+    BasicBlock **fall = calloc(n, sizeof(BasicBlock*));
+    BasicBlock **order = calloc(n, sizeof(BasicBlock*));
+    int *pos = calloc(n, sizeof(int));
+    int edge_count = 0, p = 0;
+    for (BasicBlock *bb = cfg->blocks; bb; bb = bb->next) {
+        fall[bb->id] = place_fallthrough(bb);
+        order[p] = bb;
+        pos[bb->id] = p++;
+        edge_count += bb->succ_count;
+    }
+
+    /* Candidate fall-through edges. A switch always jumps, and chaining
+       through a forwarding block only drags its target away from where the
+       source put it; the path out of try_begin stays its fall-through. */
+    PlaceEdge *edges = malloc(sizeof(PlaceEdge) * (edge_count ? edge_count : 1));
+    int ne = 0;
+    for (BasicBlock *bb = cfg->blocks; bb; bb = bb->next) {
+        if (bb->last->kind == IR_SWITCH || is_forwarding_block(bb)) continue;
+        for (int i = 0; i < bb->succ_count; i++) {
+            BasicBlock *s = bb->succs[i];
+            int forced = bb->last->kind == IR_TRY_BEGIN && s == fall[bb->id];
+            if (s == bb || s == cfg->entry) continue;
+            if (bb->last->kind == IR_TRY_BEGIN && !forced) continue;
+            if (!forced && cold[bb->id] != cold[s->id]) continue;
+            PlaceEdge *e = &edges[ne++];
+            e->src = bb;
+            e->dst = s;
+            e->weight = freq[bb->id] < freq[s->id] ? freq[bb->id] : freq[s->id];
+            if (forced) e->weight = LLONG_MAX;
+            e->dst_freq = freq[s->id];
+            /* On equal weight keep the fall-throughs the code already had. */
+            e->order = pos[bb->id] + (s != fall[bb->id] ? n : 0);
+        }
+    }
+    qsort(edges, ne, sizeof(PlaceEdge), place_edge_cmp);
+
+    /* Chains: head[] and tail[] are valid for a chain's representative. */
+    int *chain = malloc(sizeof(int) * n);
+    BasicBlock **head = calloc(n, sizeof(BasicBlock*));
+    BasicBlock **tail = calloc(n, sizeof(BasicBlock*));
+    BasicBlock **link = calloc(n, sizeof(BasicBlock*));
+    for (BasicBlock *bb = cfg->blocks; bb; bb = bb->next) {
+        chain[bb->id] = bb->id;
+        head[bb->id] = tail[bb->id] = bb;
+    }
+    for (int i = 0; i < ne; i++) {
+        int a = chain[edges[i].src->id], b = chain[edges[i].dst->id];
+        if (a == b || tail[a] != edges[i].src || head[b] != edges[i].dst) continue;
+        link[tail[a]->id] = head[b];
+        tail[a] = tail[b];
+        for (BasicBlock *m = head[b]; m; m = link[m->id]) chain[m->id] = a;
+    }
+
+    /* Ties, and hot chains nothing placed branches to, go in source order. */
+    BasicBlock *new_head = NULL, *new_tail = NULL;
+    int *placed = calloc(n, sizeof(int));
+    int *hot = calloc(n, sizeof(int));
+    long long *pull = malloc(sizeof(long long) * n);
+    for (int i = 0; i < p; i++) {
+        if (!cold[order[i]->id]) hot[chain[order[i]->id]] = 1;
+        pull[order[i]->id] = -1;
+    }
+    BasicBlock *next_chain = cfg->entry;
+    for (int pass = 0; pass < 2; pass++) {
+        for (;;) {
+            if (!next_chain) {
+                long long best = -1;
+                for (int i = 0; i < p; i++) {
+                    int c = chain[order[i]->id];
+                    if (placed[c] || head[c] != order[i] || hot[c] != !pass) continue;
+                    if (!next_chain || pull[c] > best) {
+                        next_chain = order[i];
+                        best = pull[c];
                     }
-                    lb = lb->next;
                 }
+                if (!next_chain) break;
+            }
+            placed[chain[next_chain->id]] = 1;
+            for (BasicBlock *m = next_chain; m; m = link[m->id]) {
+                if (new_tail) new_tail->next = m; else new_head = m;
+                new_tail = m;
+                for (int i = 0; i < m->succ_count; i++) {
+                    BasicBlock *s = m->succs[i];
+                    int c = chain[s->id];
+                    long long w = freq[m->id] < freq[s->id] ? freq[m->id] : freq[s->id];
+                    if (head[c] == s && w > pull[c]) pull[c] = w;
+                }
+            }
+            next_chain = NULL;
+        }
+    }
+
+    new_tail->next = NULL;
+
+    for (BasicBlock *bb = new_head; bb; bb = bb->next) {
+        BasicBlock *ft = fall[bb->id];
+        if (!ft || ft == bb->next) continue;
+        IRInstr *last = bb->last;
+        BasicBlock *taken = last->kind == IR_IF ? find_bb_by_label(new_head, last->label) : NULL;
+        if (taken && taken == bb->next) {
+            free(last->label);
+            last->label = strdup(place_label_of(ft));
+            last->relop = negate_relop(last->relop);
+        } else {
+            place_append_goto(bb, ft);
+        }
+    }
+    cfg->blocks = new_head;
+
+    f->instrs = flatten_cfg(cfg);
+    free_cfg(cfg);
+
+    /* Forwarding blocks the branches now bypass are left unreachable;
+       dropping them can put a goto right before its target. */
+    f->instrs = simplify_control_flow(f->instrs);
+    cfg = build_cfg(f);
+    mark_reachable_and_cleanup(cfg);
+    f->instrs = flatten_cfg(cfg);
+    free_cfg(cfg);
+    f->instrs = simplify_control_flow(f->instrs);
+
+    free(edges);
+    free(chain);
+    free(head);
+    free(tail);
+    free(link);
+    free(placed);
+    free(hot);
+    free(pull);
+    free(freq);
+    free(cold);
+    free(fall);
+    free(order);
+    free(pos);
+}
 
-                free(j_new);
-            }
+/* --- Scalar Replacement of Aggregates ---
+ *
+ * A local struct whose address never escapes is only touched through
+ * `load s[k]` / `store s[k]` with constant k (NODE_MEMBER_ACCESS). Each
+ * int- or pointer-sized field of such a struct becomes a scalar of its own,
+ * named s.field, which the allocator can keep in a register like any other
+ * local. Narrower fields stay in memory: their stores truncate, and a
+ * register would not. Copies between structs already arrive field by
+ * field from ir_gen; any other use of the struct name (its address, a
+ * variable index) leaves the struct alone.
+ */
 
-            for (int k = 0; k < iv_count; k++) {
-                free(ivs[k].name);
-                free(ivs[k].base_iv);
-            }
-            free(loop_blocks);
+typedef struct {
+    int offset;     /* bytes from the start of the struct */
+    int scale;
+    char *name;     /* the scalar standing in for the field, or NULL */
+} SroaField;
+
+#define SROA_MAX_FIELDS 32
+
+static int sroa_candidate(Symbol *sym) {
+    return sym && sym->kind == SYM_VARIABLE && sym->scope_level != 0 && sym->struct_def &&
+           sym->pointer_level == 0 && !sym->is_array && !sym->is_vla && !sym->is_address_taken &&
+           sym->struct_def->vtable_size == 0 && !sym->struct_def->virtual_methods;
+}
+
+/* Collects the fields of `name`, or returns -1 when it is used as a whole. */
+static int sroa_collect_fields(IRInstr *head, const char *name, int size, SroaField *fields) {
+    int count = 0;
+    for (IRInstr *ins = head; ins; ins = ins->next) {
+        int access = (ins->kind == IR_LOAD || ins->kind == IR_STORE) && !ins->base.is_const &&
+                     ins->base.name && strcmp(ins->base.name, name) == 0;
+        if (ins->result && strcmp(ins->result, name) == 0) return -1;
+        IROperand *ops[4];
+        int n = instr_use_operands(ins, ops);
+        for (int k = 0; k < n; k++) {
+            if (access && ops[k] == &ins->base) continue;
+            if (!ops[k]->is_const && ops[k]->name && strcmp(ops[k]->name, name) == 0) return -1;
         }
-        b = b->next;
+        if (!access) continue;
+
+        if (!ins->index.is_const || ins->scale <= 0) return -1;
+        int off = ins->index.const_val * ins->scale;
+        if (off < 0 || off + ins->scale > size) return -1;
+        int k = 0;
+        while (k < count && fields[k].offset != off) k++;
+        if (k < count) {
+            if (fields[k].scale != ins->scale) return -1;
+            continue;
+        }
+        if (count == SROA_MAX_FIELDS) return -1;
+        fields[count].offset = off;
+        fields[count].scale = ins->scale;
+        fields[count].name = NULL;
+        count++;
     }
+    for (int a = 0; a < count; a++)
+        for (int b = 0; b < count; b++)
+            if (a != b && fields[a].offset < fields[b].offset &&
+                fields[a].offset + fields[a].scale > fields[b].offset) return -1;
+    return count;
 }
 
-void unroll_loops(CFG *cfg) {
-
-    if (!cfg) return;
-    compute_dominators(cfg);
+static char* sroa_field_name(const char *var, Symbol *def, int offset) {
+    char buf[256];
+    Symbol *m = def->members;
+    while (m && m->struct_offset != offset) m = m->next_member;
+    if (m) snprintf(buf, sizeof(buf), "%s.%s", var, m->name);
+    else snprintf(buf, sizeof(buf), "%s.%d", var, offset);
+    return strdup(buf);
+}
 
-    BasicBlock *b = cfg->blocks;
-    while (b) {
-        for (int i = 0; i < b->succ_count; i++) {
-            BasicBlock *h = b->succs[i];
-            if (!b->doms[h->id]) continue;
-            if (!h->last || h->last->kind != IR_IF) continue;
-            if (!h->instrs || h->instrs->kind != IR_LABEL) continue;
+static void scalarize_local_structs(IRFunc *f) {
+    char **seen = NULL;
+    int seen_count = 0;
+    for (IRInstr *cand = f->instrs; cand; cand = cand->next) {
+        if ((cand->kind != IR_LOAD && cand->kind != IR_STORE) || cand->base.is_const || !cand->base.name ||
+            set_contains(seen, seen_count, cand->base.name))
+            continue;
+        set_add(&seen, &seen_count, cand->base.name);
+        const char *name = seen[seen_count - 1];   /* outlives the rewrite of cand */
+        Symbol *sym = lookup_all_scopes(name);
+        if (!sroa_candidate(sym)) continue;
+
+        SroaField fields[SROA_MAX_FIELDS];
+        int count = sroa_collect_fields(f->instrs, name, sym->struct_def->struct_size, fields);
+        int split = 0;
+        for (int k = 0; k < count; k++) {
+            if (fields[k].scale < 4) continue;
+            fields[k].name = sroa_field_name(name, sym->struct_def, fields[k].offset);
+            split++;
+        }
+        if (split == 0) continue;
 
-            int *loop_blocks = calloc(cfg->block_count, sizeof(int));
-            if (!compute_natural_loop(h, b, loop_blocks, cfg)) {
-                free(loop_blocks);
+        for (IRInstr *ins = f->instrs; ins; ins = ins->next) {
+            if ((ins->kind != IR_LOAD && ins->kind != IR_STORE) || ins->base.is_const ||
+                !ins->base.name || strcmp(ins->base.name, name) != 0)
                 continue;
+            int off = ins->index.const_val * ins->scale;
+            int k = 0;
+            while (fields[k].offset != off) k++;
+            if (!fields[k].name) continue;
+
+            ir_free_operand(&ins->base);
+            ir_free_operand(&ins->index);
+            memset(&ins->base, 0, sizeof(IROperand));
+            memset(&ins->index, 0, sizeof(IROperand));
+            if (ins->kind == IR_LOAD) {
+                ins->src = ir_op_name(fields[k].name);
+            } else {
+                ins->result = strdup(fields[k].name);
+                ins->src = ins->store_val;
+                memset(&ins->store_val, 0, sizeof(IROperand));
             }
+            ins->kind = IR_ASSIGN;
+            ins->scale = 0;
+        }
+        for (int k = 0; k < count; k++) free(fields[k].name);
+    }
+    set_free(seen, seen_count);
+}
 
-            BasicBlock *preheader = find_preheader(h, loop_blocks);
-            if (!preheader) {
-                free(loop_blocks);
-                continue;
-            }
+/* --- Promotion of Address-Taken Scalars ---
+ *
+ * `&x` keeps x out of the allocator for the whole function, although the
+ * address is usually only handed to scanf or to a helper that writes
+ * through it. When every use of the address (and of local pointers
+ * copied from it) is
+ *
+ *   - a load or store through it, or
+ *   - an argument of a call that does not capture it: scanf, printf, or a
+ *     function of this program that only loads and stores through that
+ *     parameter,
+ *
+ * x is renamed to a register candidate x.r. Loads and stores through the
+ * address become copies of x.r, and around each such call x.r is stored
+ * to x's frame slot before the arguments (unless nothing but calls ever
+ * writes x) and reloaded after the call. Without calls left, the slot is
+ * not used at all.
+ */
 
-            BasicBlock *body_entry = NULL;
-            BasicBlock *exit_block = NULL;
-            if (!find_loop_entry_exit(h, loop_blocks, &body_entry, &exit_block)) {
-                free(loop_blocks);
-                continue;
-            }
-            if (has_side_exits(h, loop_blocks, cfg, exit_block)) {
-                free(loop_blocks);
-                continue;
-            }
+#define PROMOTE_MAX_ALIASES 16
+#define PROMOTE_MAX_CALLS   64
 
-            if (!exit_block->instrs || exit_block->instrs->kind != IR_LABEL || !exit_block->instrs->label) {
-                free(loop_blocks);
-                continue;
-            }
+static int promote_candidate(Symbol *sym) {
+    return sym && sym->kind == SYM_VARIABLE && sym->scope_level != 0 && sym->is_address_taken &&
+           !sym->is_array && !sym->is_vla && sym->array_dim_count == 0 &&
+           (sym->pointer_level > 0 || !sym->struct_def);
+}
 
-            const char *ivar = NULL;
-            IRInstr *if_instr = h->last;
-            int bound = 0;
-            IRRelop relop;
-            if (!extract_induction_condition(if_instr, preheader, loop_blocks, cfg, &ivar, &bound, &relop)) {
-                free(loop_blocks);
-                continue;
-            }
+static int count_name_defs(IRInstr *head, const char *name) {
+    int defs = 0;
+    for (IRInstr *i = head; i; i = i->next)
+        if (i->result && strcmp(i->result, name) == 0) defs++;
+    return defs;
+}
 
-            BasicBlock *if_taken = find_bb_by_label(cfg->blocks, if_instr->label);
-            if (if_taken && if_taken == exit_block) {
-                relop = negate_relop(relop);
-            }
+/* Does `fn` only load and store through its parameter `index`? */
+static int call_keeps_pointer(IRProgram *prog, const char *fn, int index) {
+    if (strcmp(fn, "scanf") == 0 || strcmp(fn, "printf") == 0) return 1;
+    Symbol *fsym = lookup(fn);
+    if (!fsym || fsym->kind != SYM_FUNCTION || index >= fsym->param_count) return 0;
+    IRFunc *callee = prog->funcs;
+    while (callee && strcmp(callee->name, fn) != 0) callee = callee->next;
+    if (!callee) return 0;
+
+    Symbol *p = lookup_in_scope(fsym->scope, fsym->param_names[index]);
+    const char *pname = p ? p->ir_name : fsym->param_names[index];
+    for (IRInstr *ins = callee->instrs; ins; ins = ins->next) {
+        if (ins->result && strcmp(ins->result, pname) == 0) return 0;
+        IROperand *ops[4];
+        int n = instr_use_operands(ins, ops);
+        for (int k = 0; k < n; k++) {
+            if (ops[k]->is_const || !ops[k]->name || strcmp(ops[k]->name, pname) != 0) continue;
+            if ((ins->kind == IR_LOAD || ins->kind == IR_STORE) && ops[k] == &ins->base) continue;
+            return 0;
+        }
+    }
+    return 1;
+}
 
-            int init = 0;
-            if (!get_initial_value_from_block(preheader, ivar, &init)) {
-                free(loop_blocks);
-                continue;
-            }
+/* For `param A` at `ins`: the call it feeds, if A stays uncaptured there. */
+static IRInstr* promote_param_call(IRProgram *prog, IRInstr *ins) {
+    int pos = 0;
+    IRInstr *call = ins->next;
+    while (call && call->kind == IR_PARAM) { pos++; call = call->next; }
+    if (!call || call->kind != IR_CALL || !call->call_fn || pos >= call->arg_count) return NULL;
+    return call_keeps_pointer(prog, call->call_fn, call->arg_count - 1 - pos) ? call : NULL;
+}
 
-            int step = 0;
-            if (!compute_loop_step(loop_blocks, cfg, ivar, &step)) {
-                free(loop_blocks);
-                continue;
-            }
+static int promote_is_alias(char **aliases, int count, IROperand *op) {
+    return !op->is_const && op->name && set_contains(aliases, count, op->name);
+}
 
-            long trip_count = 0;
-            if (!compute_trip_count(init, bound, step, relop, &trip_count)) {
-                free(loop_blocks);
-                continue;
+/* Collects the names holding &x; 0 if the address escapes. */
+static int promote_collect_aliases(IRProgram *prog, IRFunc *f, const char *var, int size,
+                                   char ***aliases, int *count) {
+    for (IRInstr *ins = f->instrs; ins; ins = ins->next)
+        if (ins->kind == IR_UNOP && ins->unop == '&' && ins->unop_src.name &&
+            strcmp(ins->unop_src.name, var) == 0 && ins->result)
+            set_add(aliases, count, ins->result);
+
+    for (int a = 0; a < *count; a++) {
+        const char *name = (*aliases)[a];
+        if (count_name_defs(f->instrs, name) != 1 || is_memory_resident_name(name)) return 0;
+        for (IRInstr *ins = f->instrs; ins; ins = ins->next) {
+            IROperand *ops[4];
+            int n = instr_use_operands(ins, ops);
+            for (int k = 0; k < n; k++) {
+                if (ops[k]->is_const || !ops[k]->name || strcmp(ops[k]->name, name) != 0) continue;
+                if ((ins->kind == IR_LOAD || ins->kind == IR_STORE) && ops[k] == &ins->base) {
+                    if (!ins->index.is_const || ins->index.const_val != 0 || ins->scale != size) return 0;
+                } else if (ins->kind == IR_PARAM) {
+                    if (!promote_param_call(prog, ins)) return 0;
+                } else if (ins->kind == IR_ASSIGN && ins->result) {
+                    Symbol *p = lookup_all_scopes(ins->result);
+                    if (p && (p->is_address_taken || p->scope_level == 0)) return 0;
+                    if (*count == PROMOTE_MAX_ALIASES) return 0;
+                    set_add(aliases, count, ins->result);
+                } else {
+                    return 0;
+                }
             }
+        }
+    }
+    return 1;
+}
 
-            BasicBlock *body_blocks[256];
-            int body_count = build_body_block_list(cfg, loop_blocks, h, body_blocks, 256);
-            if (body_count <= 0) {
-                free(loop_blocks);
-                continue;
-            }
+static void promote_rename(IROperand *op, const char *from, const char *to) {
+    if (op->is_const || !op->name || strcmp(op->name, from) != 0) return;
+    free(op->name);
+    op->name = strdup(to);
+}
 
-            int entry_idx = find_block_index(body_blocks, body_count, body_entry);
-            if (entry_idx < 0) {
-                free(loop_blocks);
+static void promote_address_taken(IRProgram *prog, IRFunc *f) {
+    for (IRInstr *ins = f->instrs; ins; ins = ins->next)
+        if (ins->kind == IR_TRY_BEGIN) return;   /* a handler would see stale copies */
+
+    char **seen = NULL;
+    int seen_count = 0;
+    for (IRInstr *cand = f->instrs; cand; cand = cand->next) {
+        if (cand->kind != IR_UNOP || cand->unop != '&' || !cand->unop_src.name ||
+            set_contains(seen, seen_count, cand->unop_src.name))
+            continue;
+        set_add(&seen, &seen_count, cand->unop_src.name);
+        const char *var = seen[seen_count - 1];
+        Symbol *sym = lookup_all_scopes(var);
+        if (!promote_candidate(sym)) continue;
+        int size = get_type_size(sym->type, sym->pointer_level, sym->struct_def);
+
+        char **aliases = NULL;
+        int alias_count = 0;
+        if (!promote_collect_aliases(prog, f, var, size, &aliases, &alias_count)) {
+            set_free(aliases, alias_count);
+            continue;
+        }
+
+        char reg[160];
+        snprintf(reg, sizeof(reg), "%s.r", var);
+
+        /* Calls that receive the address, with the instruction before their
+           argument list (NULL at the head of the function). */
+        IRInstr *calls[PROMOTE_MAX_CALLS], *before[PROMOTE_MAX_CALLS];
+        int call_count = 0;
+        IRInstr *run_before = NULL, *prev = NULL;
+        int ok = 1;
+        for (IRInstr *ins = f->instrs; ins; prev = ins, ins = ins->next) {
+            if (ins->kind == IR_PARAM && (!prev || prev->kind != IR_PARAM)) run_before = prev;
+            if (ins->kind != IR_PARAM || !promote_is_alias(aliases, alias_count, &ins->src)) continue;
+            IRInstr *call = promote_param_call(prog, ins);
+            int k = 0;
+            while (k < call_count && calls[k] != call) k++;
+            if (k < call_count) continue;
+            if (call_count == PROMOTE_MAX_CALLS) { ok = 0; break; }
+            calls[call_count] = call;
+            before[call_count++] = run_before;
+        }
+        if (!ok) {
+            set_free(aliases, alias_count);
+            continue;
+        }
+
+        /* A variable only ever written through calls (the scanf target)
+           needs no spills: its slot and x.r never disagree. */
+        int written = 0;
+        for (IRInstr *ins = f->instrs; ins; ins = ins->next)
+            if ((ins->result && strcmp(ins->result, var) == 0) ||
+                (ins->kind == IR_STORE && promote_is_alias(aliases, alias_count, &ins->base)))
+                written = 1;
+
+        for (IRInstr *ins = f->instrs; ins; ins = ins->next) {
+            if (ins->kind == IR_UNOP && ins->unop == '&') continue;   /* still names the slot */
+            if ((ins->kind == IR_LOAD || ins->kind == IR_STORE) &&
+                promote_is_alias(aliases, alias_count, &ins->base)) {
+                ir_free_operand(&ins->base);
+                ir_free_operand(&ins->index);
+                memset(&ins->base, 0, sizeof(IROperand));
+                memset(&ins->index, 0, sizeof(IROperand));
+                if (ins->kind == IR_LOAD) {
+                    ins->src = ir_op_name(reg);
+                } else {
+                    ins->result = strdup(reg);
+                    ins->src = ins->store_val;
+                    memset(&ins->store_val, 0, sizeof(IROperand));
+                }
+                ins->kind = IR_ASSIGN;
+                ins->scale = 0;
                 continue;
             }
+            if (ins->result && strcmp(ins->result, var) == 0) {
+                free(ins->result);
+                ins->result = strdup(reg);
+            }
+            IROperand *ops[4];
+            int n = instr_use_operands(ins, ops);
+            for (int k = 0; k < n; k++) promote_rename(ops[k], var, reg);
+        }
 
-            int body_instrs = count_loop_body_instrs(body_blocks, body_count);
-            if (trip_count > 0 && body_instrs > 0) {
-                if (trip_count > (MAX_FULL_UNROLL_INSTRUCTIONS / body_instrs)) {
-                    free(loop_blocks);
-                    continue;
+        /* Around each call: x := x.r before the arguments, x.r := x after. */
+        for (int k = 0; k < call_count; k++) {
+            if (written) {
+                IROperand r = ir_op_name(reg);
+                IRInstr *spill = ir_make_assign((char *)var, r, calls[k]->line);
+                ir_free_operand(&r);
+                if (before[k]) {
+                    spill->next = before[k]->next;
+                    before[k]->next = spill;
+                } else {
+                    spill->next = f->instrs;
+                    f->instrs = spill;
                 }
             }
+            IROperand v = ir_op_name((char *)var);
+            IRInstr *reload = ir_make_assign(reg, v, calls[k]->line);
+            ir_free_operand(&v);
+            reload->next = calls[k]->next;
+            calls[k]->next = reload;
+        }
+        set_free(aliases, alias_count);
+    }
+    set_free(seen, seen_count);
+}
 
-            const char *header_label = h->instrs->label;
-            const char *exit_label = exit_block->instrs->label;
+/* --- Accumulator Introduction (tail recursion modulo accumulator) ---
+ *
+ * Rewrites linear self-recursion of the form
+ *
+ *     t := call f, n
+ *     r := x OP t          (OP is '+' or '*', either operand order)
+ *     return r
+ *
+ * into a loop. An accumulator starts at the identity of OP, each recursive
+ * site folds its pending operand into it, reassigns the parameters from
+ * the call's PARAMs and jumps back to the top of the body; every remaining
+ * return yields `acc OP value`. Plain self tail calls in the same function
+ * are turned into the same back jump (the accumulator carries through).
+ * Stack usage drops from O(n) to O(1) and the calls disappear entirely.
+ */
 
-            char *orig_labels[256];
-            for (int j = 0; j < body_count; j++) {
-                IRInstr *ins = body_blocks[j]->instrs;
-                orig_labels[j] = (ins && ins->kind == IR_LABEL && ins->label) ? ins->label : NULL;
-            }
+typedef struct {
+    IRInstr *first_param; /* first IR_PARAM feeding the call (or the call) */
+    IRInstr *call;
+    IRInstr *combine;     /* NULL for a plain tail call */
+    IRInstr *ret;
+    IROperand pending;    /* the non-recursive operand of `combine` */
+} AccSite;
+
+static int count_name_uses(IRInstr *head, const char *name) {
+    int uses = 0;
+    for (IRInstr *i = head; i; i = i->next) {
+        IROperand *ops[] = { &i->src, &i->left, &i->right, &i->unop_src, &i->base,
+                             &i->index, &i->store_val, &i->if_left, &i->if_right };
+        for (int k = 0; k < 9; k++) {
+            if (ops[k]->name && strcmp(ops[k]->name, name) == 0) uses++;
+        }
+    }
+    return uses;
+}
 
-            IRInstr *new_head = ir_make_label((char *)header_label, h->instrs->line);
-            IRInstr *new_tail = new_head;
-            if (!new_head) {
-                free(loop_blocks);
-                continue;
-            }
+/* A value is safe to carry across the (removed) call only if the callee
+   could not have changed it: constants, temps and locals whose address
+   never escapes. */
+static int is_call_invariant_operand(IROperand *op, Scope *scope) {
+    if (op->is_const) return 1;
+    if (!op->name) return 0;
+    Symbol *sym = lookup_in_scope(scope, op->name);
+    if (!sym) return 1;
+    if (sym->scope_level == 0 || sym->is_address_taken) return 0;
+    return 1;
+}
 
-            if (trip_count == 0) {
-                IRInstr *to_exit = ir_make_goto((char *)exit_label, if_instr->line);
-                append_instr(&new_head, &new_tail, to_exit);
-                free_block_instr_list(h);
-                h->instrs = new_head;
-                h->last = new_tail;
-                free(loop_blocks);
-                continue;
-            }
+static int match_acc_site(IRInstr *prev_params[], IRInstr *call, int param_count,
+                          IRInstr *head, Scope *scope, AccSite *site) {
+    if (call->arg_count != param_count) return 0;
+    for (int k = 0; k < param_count; k++) {
+        if (!prev_params[k] || prev_params[k]->kind != IR_PARAM) return 0;
+    }
 
-            char **curr_labels = alloc_iteration_labels(body_count);
-            if (!curr_labels) {
-                free_block_instr_list(h);
-                free(loop_blocks);
-                continue;
-            }
+    memset(site, 0, sizeof(*site));
+    site->first_param = param_count > 0 ? prev_params[0] : call;
+    site->call = call;
 
-            IRInstr *jump_to_first = ir_make_goto(curr_labels[entry_idx], if_instr->line);
-            append_instr(&new_head, &new_tail, jump_to_first);
+    IRInstr *next = call->next;
+    if (!next || !call->result) return 0;
 
-            int ok = 1;
-            for (long iter = 0; iter < trip_count; iter++) {
-                char **next_labels = NULL;
-                const char *next_target = exit_label;
+    if (next->kind == IR_RETURN) {
+        if (!next->src.name || strcmp(next->src.name, call->result) != 0) return 0;
+        site->ret = next;
+        return 1;
+    }
 
-                if (iter + 1 < trip_count) {
-                    next_labels = alloc_iteration_labels(body_count);
-                    if (!next_labels) {
-                        ok = 0;
-                        break;
-                    }
-                    next_target = next_labels[entry_idx];
-                }
+    if (next->kind != IR_BINOP || (next->binop != '+' && next->binop != '*')) return 0;
+    IROperand *other = NULL;
+    if (next->right.name && strcmp(next->right.name, call->result) == 0) other = &next->left;
+    else if (next->left.name && strcmp(next->left.name, call->result) == 0) other = &next->right;
+    if (!other) return 0;
+    if (other->name && strcmp(other->name, call->result) == 0) return 0;
+    if (!is_call_invariant_operand(other, scope)) return 0;
+
+    IRInstr *ret = next->next;
+    if (!ret || ret->kind != IR_RETURN || !ret->src.name || !next->result ||
+        strcmp(ret->src.name, next->result) != 0) return 0;
+    if (count_name_uses(head, call->result) != 1 || count_name_uses(head, next->result) != 1) return 0;
+
+    site->combine = next;
+    site->ret = ret;
+    site->pending = *other;
+    return 1;
+}
 
-                IRInstr *iter_tail = NULL;
-                IRInstr *iter_head = clone_loop_iteration(body_blocks, body_count, orig_labels, curr_labels,
-                                                         header_label, next_target, &iter_tail);
-                if (!iter_head || !iter_tail) {
-                    ok = 0;
-                    if (next_labels) free_iteration_labels(next_labels, body_count);
-                    break;
-                }
+#define ACC_MAX_SITES 16
 
-                append_instr_list(&new_head, &new_tail, iter_head, iter_tail);
+static void introduce_accumulator(IRFunc *f) {
+    if (!f || !f->instrs || !f->name) return;
+    if (f->ret_type != TYPE_INT && f->ret_type != TYPE_CHAR) return;
 
-                free_iteration_labels(curr_labels, body_count);
-                curr_labels = next_labels;
-            }
-            if (curr_labels) free_iteration_labels(curr_labels, body_count);
+    Symbol *fsym = lookup(f->name);
+    if (!fsym || fsym->kind != SYM_FUNCTION || !fsym->scope) return;
+    int param_count = fsym->param_count;
+    if (param_count > 8) return;
 
-            if (!ok) {
-                free_block_instr_list(h);
-                h->instrs = new_head;
-                h->last = new_tail;
-                free(loop_blocks);
-                continue;
-            }
+    const char *param_irs[8];
+    for (int k = 0; k < param_count; k++) {
+        Symbol *ps = lookup_in_scope(fsym->scope, fsym->param_names[k]);
+        if (!ps || ps->is_address_taken) return;
+        if (ps->type == TYPE_STRUCT && ps->pointer_level == 0 && !ps->is_array) return;
+        param_irs[k] = ps->ir_name;
+    }
 
-            free_block_instr_list(h);
-            h->instrs = new_head;
-            h->last = new_tail;
-            free(loop_blocks);
+    AccSite sites[ACC_MAX_SITES];
+    int site_count = 0;
+    int op = 0;
+    IRInstr *window[8] = {0}; /* the last param_count instructions before curr */
+
+    for (IRInstr *curr = f->instrs; curr; curr = curr->next) {
+        if (curr->kind == IR_TRY_BEGIN || curr->kind == IR_THROW || curr->kind == IR_ALLOCA) return;
+        if (curr->kind == IR_CALL && curr->call_fn && strcmp(curr->call_fn, f->name) == 0) {
+            if (site_count == ACC_MAX_SITES) return;
+            AccSite *site = &sites[site_count];
+            if (!match_acc_site(window, curr, param_count, f->instrs, fsym->scope, site)) return;
+            if (site->combine) {
+                if (op && op != site->combine->binop) return;
+                op = site->combine->binop;
+            }
+            site_count++;
+        }
+        if (param_count > 0) {
+            for (int k = 0; k + 1 < param_count; k++) window[k] = window[k + 1];
+            window[param_count - 1] = curr;
         }
-        b = b->next;
     }
-}
+    /* Without a combining site this is plain tail recursion; TCO handles it. */
+    if (!op) return;
 
-static void merge_trivial_blocks(CFG *cfg) {
-    if (!cfg || !cfg->blocks) return;
-    int changed = 1;
-    while (changed) {
-        changed = 0;
-        BasicBlock *bb = cfg->blocks;
-        while (bb) {
-            if (bb->succ_count == 1) {
-                BasicBlock *succ = bb->succs[0];
-                if (succ->pred_count == 1 && succ != bb && succ != cfg->entry && succ == bb->next) {
-                    if (bb->last && bb->last->kind == IR_GOTO) {
-                        IRInstr *p = bb->instrs, *prev = NULL;
-                        while(p && p != bb->last) { prev = p; p = p->next; }
-                        if (prev) prev->next = NULL;
-                        else bb->instrs = NULL;
-                        free_instr_single(bb->last);
-                        bb->last = prev;
-                    }
-                    IRInstr *to_add = succ->instrs;
-                    if (to_add && to_add->kind == IR_LABEL) {
-                        IRInstr *lbl = to_add;
-                        to_add = to_add->next;
-                        free_instr_single(lbl);
-                    }
-                    if (to_add) {
-                        if (bb->last) bb->last->next = to_add;
-                        else bb->instrs = to_add;
-                        bb->last = succ->last;
-                    }
-                    free(bb->succs);
-                    bb->succ_count = succ->succ_count;
-                    bb->succs = malloc(sizeof(BasicBlock*) * bb->succ_count);
-                    for (int i = 0; i < bb->succ_count; i++) {
-                        bb->succs[i] = succ->succs[i];
-                        BasicBlock *child = bb->succs[i];
-                        for (int j = 0; j < child->pred_count; j++) {
-                            if (child->preds[j] == succ) child->preds[j] = bb;
-                        }
-                    }
-                    succ->instrs = NULL;
-                    succ->last = NULL;
-                    succ->pred_count = 0;
-                    succ->succ_count = 0;
-                    bb->next = succ->next;
-                    free(succ);
-                    changed = 1;
-                }
+    for (IRInstr *curr = f->instrs; curr; curr = curr->next) {
+        if (curr->kind == IR_RETURN && !curr->src.name && !curr->src.is_const) return;
+    }
+
+    char *acc = new_opt_temp("acc");
+    char *loop_label = ir_new_label();
+    IROperand acc_op = ir_op_name(acc);
+
+    /* Remaining returns yield `acc OP value`. Done first so the rewritten
+       recursive sites below are not visited. */
+    for (IRInstr *curr = f->instrs; curr; curr = curr->next) {
+        if (curr->kind != IR_RETURN) continue;
+        int is_site = 0;
+        for (int k = 0; k < site_count; k++) if (sites[k].ret == curr) is_site = 1;
+        if (is_site) continue;
+
+        char *t = new_opt_temp("acc");
+        IRInstr *combine = ir_make_binop(t, acc_op, curr->src, op, curr->line);
+        IROperand t_op = ir_op_name(t);
+        /* Turn the return into `t := acc OP v` followed by `return t`. */
+        IRInstr *ret = ir_make_return_val(t_op, curr->line);
+        ret->next = curr->next;
+        *curr = *combine;
+        curr->next = ret;
+        free(combine);
+        curr = ret;
+    }
+
+    for (int s = 0; s < site_count; s++) {
+        AccSite *site = &sites[s];
+        int line = site->call->line;
+        IRInstr *head = NULL;
+
+        if (site->combine)
+            ir_append(&head, ir_make_binop(acc, acc_op, site->pending, op, line));
+
+        /* Parameters are reassigned in parallel: an argument that reads an
+           earlier-assigned parameter goes through a temp first. */
+        IRInstr *p = site->first_param;
+        IROperand args[8];
+        for (int k = 0; k < param_count; k++, p = p->next) args[k] = p->src;
+        for (int k = 0; k < param_count; k++) {
+            int clobbered = 0;
+            for (int j = 0; j < k; j++) {
+                if (args[k].name && strcmp(args[k].name, param_irs[j]) == 0) clobbered = 1;
+            }
+            if (clobbered) {
+                char *t = new_opt_temp("arg");
+                ir_append(&head, ir_make_assign(t, args[k], line));
+                args[k] = ir_op_name(t);
             }
-            bb = bb->next;
+        }
+        for (int k = 0; k < param_count; k++) {
+            if (args[k].name && strcmp(args[k].name, param_irs[k]) == 0) continue;
+            ir_append(&head, ir_make_assign((char *)param_irs[k], args[k], line));
+        }
+        ir_append(&head, ir_make_goto(loop_label, line));
+
+        /* Splice: [first_param .. ret] -> head */
+        IRInstr *after = site->ret->next;
+        IRInstr *tail = head;
+        while (tail->next) tail = tail->next;
+        tail->next = after;
+
+        IRInstr **link = &f->instrs;
+        while (*link && *link != site->first_param) link = &(*link)->next;
+        if (!*link) continue;
+        IRInstr *dead = *link;
+        *link = head;
+        while (dead != after) {
+            IRInstr *n = dead->next;
+            free_instr_single(dead);
+            dead = n;
         }
     }
+
+    IRInstr *init = ir_make_assign(acc, ir_op_const(op == '*' ? 1 : 0), f->instrs->line);
+    IRInstr *lbl = ir_make_label(loop_label, f->instrs->line);
+    init->next = lbl;
+    lbl->next = f->instrs;
+    f->instrs = init;
 }
 
 /* --- Tail Call Optimization (TCO) Detection --- */
@@ -3068,6 +7978,12 @@ void optimize_program(IRProgram *prog, OptLevel level, CompilerMetrics *metrics)
 
     IRFunc *f = prog->funcs;
     while (f) {
+        if (level > OPT_O0) {
+            scalarize_local_structs(f);
+            promote_address_taken(prog, f);
+        }
+        if (level >= OPT_O2)
+            introduce_accumulator(f);
         if (level > OPT_O0)
             f->instrs = simplify_control_flow(f->instrs);
 
@@ -3107,13 +8023,15 @@ void optimize_program(IRProgram *prog, OptLevel level, CompilerMetrics *metrics)
                 /* <-- Future SSA-based passes go here (SCCP, GVN, SSA-DCE, ...) */
                 // ssa_destruct(cfg);
 
-                /* Temporarily disabled: current IVE can miscompile loops with branches
-                 * by over-aggressively rewriting derived values.
-                 * Re-enable only after dominance/use-safety checks are strengthened.
-                 */
-                // induction_variable_elimination(cfg);
+                reassociate(cfg);
+                cfg = version_loops(prog, f, cfg);
                 optimize_loops(cfg);
-                unroll_loops(cfg);
+                cfg = promote_loop_memories(prog, f, cfg);
+                if (cfg) cfg = unswitch_loops(f, cfg);
+                if (cfg) cfg = reverse_loops(prog, f, cfg);
+                if (cfg) cfg = recognize_loop_idioms(prog, f, cfg);
+                if (cfg && riscv_ext_v) cfg = vectorize_loops(prog, f, cfg);
+                if (cfg) unroll_loops(cfg);
 
             }
 
@@ -3125,13 +8043,32 @@ void optimize_program(IRProgram *prog, OptLevel level, CompilerMetrics *metrics)
             cfg = build_cfg(f);
             if (cfg) {
                 mark_reachable_and_cleanup(cfg);
+                if (level >= OPT_O2) {
+                    /* Unrolled copies expose new local redundancy; clean it up. */
+                    merge_trivial_blocks(cfg);
+                    for (BasicBlock *ub = cfg->blocks; ub; ub = ub->next)
+                        optimize_bb(ub);
+                    eliminate_dead_code(cfg, metrics);
+                    strength_reduce_ivs(cfg);
+                    eliminate_dead_code(cfg, metrics);
+                    prefetch_loops(cfg);
+                    cfg = thread_jumps(f, cfg);
+                    cfg = if_convert(f, cfg);
+                    eliminate_dead_code(cfg, metrics);
+                }
                 f->instrs = flatten_cfg(cfg);
                 free_cfg(cfg);
             }
             
             f->instrs = simplify_control_flow(f->instrs);
+            if (level >= OPT_O2) {
+                f->instrs = rotate_loops(f->instrs);
+                place_blocks(f);
+            }
             detect_tail_calls(f);
         }
         f = f->next;
     }
+    if (level >= OPT_O2 && riscv_ext_v)
+        write_vectorize_report("vectorize_report.txt");
 }
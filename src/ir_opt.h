@@ -42,6 +42,9 @@ typedef struct BasicBlock {
     /* Dominance Frontier (SSA construction) */
     int *df;   /* bitset of block IDs: df[i]=1 means block i is in this block's DF */
 
+    /* -fprofile-use execution count, -1 when no profile is loaded */
+    long long count;
+
     struct BasicBlock *next; /* For linear list of blocks in function */
 } BasicBlock;
 
@@ -56,6 +59,11 @@ typedef struct CFG {
 /* Main entry point for IR optimizations (metrics may be NULL; O0 skips all IR opts) */
 void optimize_program(IRProgram *prog, OptLevel level, struct CompilerMetrics *metrics);
 
+/* -fprefetch-loop-arrays[=BYTES]: at -O2, prefetch strided accesses of
+ * innermost loops this far ahead; 0 (the default) inserts no hints. */
+#define PREFETCH_DEFAULT_DISTANCE 256
+extern int prefetch_loop_arrays;
+
 /* CFG Lifecycle */
 CFG* build_cfg(IRFunc *f);
 void free_cfg(CFG *cfg);
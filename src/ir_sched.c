@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "ir_sched.h"
+#include "symbol_table.h"
 
 /* -------------------------------------------------------------------------
  * Instruction Scheduler internal structures
@@ -64,6 +65,11 @@ typedef struct {
     SchedNode **recent_loads;
     int num_loads;
     int load_cap;
+
+    /* Stores since last call */
+    SchedNode **recent_stores;
+    int num_stores;
+    int store_cap;
 } DepTracker;
 
 static void init_tracker(DepTracker *t) {
@@ -76,6 +82,7 @@ static void free_tracker(DepTracker *t) {
     }
     if (t->vars) free(t->vars);
     if (t->recent_loads) free(t->recent_loads);
+    if (t->recent_stores) free(t->recent_stores);
 }
 
 static VarState *get_var(DepTracker *t, const char *name) {
@@ -114,6 +121,13 @@ static void add_edge(SchedNode *pred, SchedNode *succ) {
     succ->num_preds++;
 }
 
+/* A load may go ahead of a store when the two carry different alias sets
+ * (the checked copy of a versioned loop). */
+static int may_conflict(IRInstr *load, IRInstr *store) {
+    return load->kind != IR_LOAD || store->kind != IR_STORE || !load->alias_set ||
+           !store->alias_set || load->alias_set == store->alias_set;
+}
+
 static void record_use(DepTracker *t, SchedNode *n, const char *name) {
     if (!name) return;
     VarState *v = get_var(t, name);
@@ -156,12 +170,79 @@ static int is_barrier(IRInstr *instr) {
         case IR_LABEL:
         case IR_GOTO:
         case IR_IF:
+        case IR_SWITCH:
         case IR_RETURN:
+        case IR_ALLOCA:     /* moves sp; its result has no other dependences */
             return 1;
         default: return 0;
     }
 }
 
+/* Operands an instruction reads and the variable it writes. */
+static int collect_operands(IRInstr *inst, IROperand **uses, char **def) {
+    int n_use = 0;
+    *def = NULL;
+    switch (inst->kind) {
+        case IR_ASSIGN:
+            uses[n_use++] = &inst->src;
+            *def = inst->result;
+            break;
+        case IR_BINOP:
+            uses[n_use++] = &inst->left;
+            uses[n_use++] = &inst->right;
+            *def = inst->result;
+            break;
+        case IR_UNOP:
+            uses[n_use++] = &inst->unop_src;
+            *def = inst->result;
+            break;
+        case IR_SELECT:
+            uses[n_use++] = &inst->if_left;
+            uses[n_use++] = &inst->if_right;
+            uses[n_use++] = &inst->left;
+            uses[n_use++] = &inst->right;
+            *def = inst->result;
+            break;
+        case IR_PARAM:
+            uses[n_use++] = &inst->src;
+            break;
+        case IR_CALL:
+            *def = inst->result;
+            break;
+        case IR_CALL_INDIRECT:
+            uses[n_use++] = &inst->base;
+            *def = inst->result;
+            break;
+        case IR_LOAD:
+            uses[n_use++] = &inst->base;
+            uses[n_use++] = &inst->index;
+            *def = inst->result;
+            break;
+        case IR_STORE:
+            uses[n_use++] = &inst->base;
+            uses[n_use++] = &inst->index;
+            uses[n_use++] = &inst->store_val;
+            break;
+        case IR_PREFETCH:
+            /* Only its address: a hint neither waits for stores nor
+             * holds back the accesses after it. */
+            uses[n_use++] = &inst->base;
+            uses[n_use++] = &inst->index;
+            break;
+        default: break;
+    }
+    return n_use;
+}
+
+/* Variables a call or a store through a pointer can change behind the
+ * IR's back: globals and locals whose address escapes (scanf("%d", &n)). */
+static int is_memory_resident(const char *name) {
+    if (!name) return 0;
+    Symbol *sym = lookup_all_scopes(name);
+    if (!sym || sym->kind == SYM_FUNCTION || sym->is_array) return 0;
+    return sym->is_address_taken || sym->scope_level == 0;
+}
+
 static void build_dag(SchedNode *nodes, int count) {
     DepTracker tracker;
     init_tracker(&tracker);
@@ -182,6 +263,17 @@ static void build_dag(SchedNode *nodes, int count) {
             continue;
         }
         
+        IROperand *uses[6] = {0};
+        char *def = NULL;
+        int n_use = collect_operands(inst, uses, &def);
+
+        /* Reads and writes of memory-resident variables order like loads
+         * and stores against calls and pointer stores. */
+        int is_load = n->is_load, is_store = n->is_store;
+        for (int u = 0; u < n_use; u++)
+            if (!uses[u]->is_const && is_memory_resident(uses[u]->name)) is_load = 1;
+        if (def && is_memory_resident(def)) is_store = 1;
+
         /* Memory dependencies */
         if (n->is_call) {
             /* Call depends on prior calls, stores, and loads */
@@ -191,18 +283,26 @@ static void build_dag(SchedNode *nodes, int count) {
                 add_edge(tracker.recent_loads[j], n);
             tracker.last_call = n;
             tracker.num_loads = 0; /* Call acts as a barrier, reset loads */
+            tracker.num_stores = 0;
         }
-        else if (n->is_store) {
+        else if (is_store) {
             if (tracker.last_call) add_edge(tracker.last_call, n);
             if (tracker.last_store) add_edge(tracker.last_store, n);
             for (int j = 0; j < tracker.num_loads; j++) 
                 add_edge(tracker.recent_loads[j], n);
             tracker.last_store = n;
             tracker.num_loads = 0; 
+            if (tracker.num_stores == tracker.store_cap) {
+                tracker.store_cap = tracker.store_cap ? tracker.store_cap * 2 : 4;
+                tracker.recent_stores = realloc(tracker.recent_stores, sizeof(SchedNode*) * tracker.store_cap);
+            }
+            tracker.recent_stores[tracker.num_stores++] = n;
         }
-        else if (n->is_load) {
+        else if (is_load) {
             if (tracker.last_call) add_edge(tracker.last_call, n);
-            if (tracker.last_store) add_edge(tracker.last_store, n);
+            for (int j = 0; j < tracker.num_stores; j++)
+                if (may_conflict(inst, tracker.recent_stores[j]->instr))
+                    add_edge(tracker.recent_stores[j], n);
             
             if (tracker.num_loads == tracker.load_cap) {
                 tracker.load_cap = tracker.load_cap ? tracker.load_cap * 2 : 4;
@@ -212,47 +312,6 @@ static void build_dag(SchedNode *nodes, int count) {
         }
         
         /* Register/Variable dependencies */
-        IROperand *uses[6] = {0};
-        int n_use = 0;
-        char *def = NULL;
-        
-        switch (inst->kind) {
-            case IR_ASSIGN: 
-                uses[n_use++] = &inst->src; 
-                def = inst->result; 
-                break;
-            case IR_BINOP:  
-                uses[n_use++] = &inst->left; 
-                uses[n_use++] = &inst->right; 
-                def = inst->result; 
-                break;
-            case IR_UNOP:   
-                uses[n_use++] = &inst->unop_src; 
-                def = inst->result; 
-                break;
-            case IR_PARAM:  
-                uses[n_use++] = &inst->src; 
-                break;
-            case IR_CALL:   
-                def = inst->result; 
-                break;
-            case IR_CALL_INDIRECT:
-                uses[n_use++] = &inst->base;
-                def = inst->result; 
-                break;
-            case IR_LOAD:   
-                uses[n_use++] = &inst->base; 
-                uses[n_use++] = &inst->index; 
-                def = inst->result; 
-                break;
-            case IR_STORE:  
-                uses[n_use++] = &inst->base; 
-                uses[n_use++] = &inst->index; 
-                uses[n_use++] = &inst->store_val; 
-                break;
-            default: break;
-        }
-        
         for (int u = 0; u < n_use; u++) {
             if (!uses[u]->is_const) record_use(&tracker, n, uses[u]->name);
         }
@@ -281,6 +340,8 @@ static void compute_priorities(SchedNode *nodes, int count) {
     /* Initialize latencies */
     for (int i = 0; i < count; i++) {
         nodes[i].latency = nodes[i].is_load ? 3 : 1; /* Assign higher latency to loads */
+        /* Issue prefetches early too, though nothing waits for them. */
+        if (nodes[i].instr->kind == IR_PREFETCH) nodes[i].latency = 3;
         nodes[i].est_completion_time = -1;
     }
     
@@ -319,7 +380,9 @@ static IRInstr *schedule_block(IRInstr *first, IRInstr *last, int count) {
         nodes[i].index = i;
         nodes[i].is_barrier = is_barrier(curr);
         nodes[i].is_load = (curr->kind == IR_LOAD);
-        nodes[i].is_store = (curr->kind == IR_STORE);
+        /* A block counter bumps memory: it must not pass a call that may
+         * never return, or the profile would count a block that did not run. */
+        nodes[i].is_store = (curr->kind == IR_STORE || curr->kind == IR_PROFILE_COUNTER);
         nodes[i].is_call = (curr->kind == IR_CALL || curr->kind == IR_CALL_INDIRECT);
         curr = curr->next;
     }
@@ -0,0 +1,1165 @@
+/**
+ * loop_nest.c - AST-level loop nest restructuring (-O2)
+ * Interchanges, tiles and unroll-and-jams counted for-loop nests over
+ * arrays before IR generation, while the nest structure and the
+ * per-dimension subscripts that get_index_info() linearizes are still
+ * visible.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ast.h"
+#include "semantic.h"
+#include "y.tab.h"
+#include "loop_nest.h"
+#include "dependence.h"
+#include "riscv_gen.h"
+
+#define NEST_MAX_REFS    64
+#define NEST_MAX_SCALARS 32
+#define NEST_MAX_DIMS    16
+
+/* Bytes of the reused strip a tile keeps resident: one sixteenth of a
+ * 32 KiB L1, leaving room for the streamed operands. */
+#define LOOP_TILE_BYTES  2048
+
+/* for (v = lo; v < hi; v++) / v <= hi */
+typedef struct {
+    Symbol *var;
+    ASTNode *lo;
+    ASTNode *hi;
+    int relop;
+} CountedLoop;
+
+typedef struct {
+    ASTNode *node;               /* outermost NODE_INDEX */
+    Symbol *base;
+    ASTNode *subs[NEST_MAX_DIMS]; /* outermost dimension first */
+    int dims;
+    int is_write;
+} ArrayRef;
+
+enum {
+    SCALAR_READ,        /* read only: invariant in the nest */
+    SCALAR_PRIVATE,     /* assigned before any use on every iteration */
+    SCALAR_REDUCTION    /* only ever s = s + e */
+};
+
+typedef struct {
+    Symbol *sym;
+    int state;
+} ScalarUse;
+
+typedef struct {
+    Symbol *ivs[2];
+    ArrayRef refs[NEST_MAX_REFS];
+    int ref_count;
+    ScalarUse scalars[NEST_MAX_SCALARS];
+    int scalar_count;
+    int ok;
+} NestBody;
+
+typedef struct {
+    int interchange;
+    int tile;           /* tile size in iterations, 0 = no tiling */
+} NestPlan;
+
+static int tile_counter = 0;
+
+/* --- AST helpers --- */
+
+static ASTNode* clone_list(ASTNode *n);
+
+static ASTNode* clone_tree(ASTNode *n) {
+    if (!n) return NULL;
+    ASTNode *c = malloc(sizeof(ASTNode));
+    *c = *n;
+    if (n->str_val) c->str_val = strdup(n->str_val);
+    c->left = clone_list(n->left);
+    c->right = clone_list(n->right);
+    c->cond = clone_list(n->cond);
+    c->body = clone_list(n->body);
+    c->init = clone_list(n->init);
+    c->incr = clone_list(n->incr);
+    c->params = clone_list(n->params);
+    c->next = NULL;
+    return c;
+}
+
+static ASTNode* clone_list(ASTNode *n) {
+    ASTNode *head = NULL, **tail = &head;
+    for (; n; n = n->next) {
+        *tail = clone_tree(n);
+        tail = &(*tail)->next;
+    }
+    return head;
+}
+
+static ASTNode* var_ref(Symbol *sym) {
+    ASTNode *v = create_var_node(sym->name);
+    v->sym = sym;
+    v->data_type = sym->type;
+    return v;
+}
+
+/* Optimizer-private int variable; ir_gen falls back to the raw name. */
+static ASTNode* temp_ref(const char *name) {
+    ASTNode *v = create_var_node((char *)name);
+    v->data_type = TYPE_INT;
+    return v;
+}
+
+static ASTNode* make_assign(ASTNode *lhs, ASTNode *rhs, int line) {
+    ASTNode *a = create_node(NODE_ASSIGN);
+    a->left = lhs;
+    a->right = rhs;
+    a->data_type = TYPE_INT;
+    a->line_number = line;
+    return a;
+}
+
+static ASTNode* make_binop(int op, ASTNode *l, ASTNode *r, int line) {
+    ASTNode *b = create_binary_node(op, l, r);
+    b->data_type = TYPE_INT;
+    b->line_number = line;
+    return b;
+}
+
+static int is_var(ASTNode *e, Symbol *sym) {
+    return e && e->type == NODE_VAR && e->sym == sym;
+}
+
+static int is_const(ASTNode *e, int val) {
+    return e && e->type == NODE_CONST_INT && e->int_val == val;
+}
+
+static int mentions(ASTNode *e, Symbol *sym) {
+    if (!e || !sym) return 0;
+    if (e->type == NODE_VAR) return e->sym == sym;
+    return mentions(e->left, sym) || mentions(e->right, sym);
+}
+
+static int ast_equal(ASTNode *a, ASTNode *b) {
+    if (!a || !b) return a == b;
+    if (a->type != b->type || a->int_val != b->int_val) return 0;
+    switch (a->type) {
+        case NODE_CONST_INT:
+        case NODE_CONST_CHAR:
+            return 1;
+        case NODE_VAR:
+            return a->sym == b->sym;
+        case NODE_INDEX:
+        case NODE_BIN_OP:
+        case NODE_UN_OP:
+            return ast_equal(a->left, b->left) && ast_equal(a->right, b->right);
+        default:
+            return 0;
+    }
+}
+
+/* --- Nest recognition --- */
+
+static int is_plain_scalar(Symbol *sym) {
+    return sym && (sym->kind == SYM_VARIABLE || sym->kind == SYM_PARAMETER) &&
+           !sym->is_array && !sym->is_vla && sym->array_dim_count == 0 &&
+           !(sym->struct_def && sym->pointer_level == 0);
+}
+
+/* Arrays that are their own storage, so two distinct symbols never alias. */
+static int is_plain_array(Symbol *sym) {
+    return sym && sym->kind == SYM_VARIABLE && sym->is_array &&
+           sym->pointer_level == 0 && !sym->struct_def;
+}
+
+static int parse_counted_loop(ASTNode *f, CountedLoop *cl) {
+    if (!f || f->type != NODE_FOR || !f->init || !f->cond || !f->incr)
+        return 0;
+
+    if (f->init->type == NODE_ASSIGN && f->init->left &&
+        f->init->left->type == NODE_VAR) {
+        cl->var = f->init->left->sym;
+        cl->lo = f->init->right;
+    } else if (f->init->type == NODE_VAR_DECL && f->init->right) {
+        cl->var = f->init->sym;
+        cl->lo = f->init->right;
+    } else {
+        return 0;
+    }
+    if (!is_plain_scalar(cl->var) || cl->var->is_address_taken ||
+        cl->var->type != TYPE_INT || cl->var->pointer_level != 0 ||
+        !cl->lo || mentions(cl->lo, cl->var))
+        return 0;
+
+    ASTNode *c = f->cond;
+    if (c->type != NODE_BIN_OP || (c->int_val != '<' && c->int_val != T_LE) ||
+        !is_var(c->left, cl->var) || !c->right || mentions(c->right, cl->var))
+        return 0;
+    cl->hi = c->right;
+    cl->relop = c->int_val;
+
+    ASTNode *inc = f->incr;
+    if ((inc->type == NODE_POST_INC || inc->type == NODE_PRE_INC) &&
+        is_var(inc->left, cl->var))
+        return 1;
+    if (inc->type == NODE_ASSIGN && is_var(inc->left, cl->var) && inc->right &&
+        inc->right->type == NODE_BIN_OP && inc->right->int_val == '+') {
+        ASTNode *a = inc->right->left, *b = inc->right->right;
+        return (is_var(a, cl->var) && is_const(b, 1)) ||
+               (is_const(a, 1) && is_var(b, cl->var));
+    }
+    return 0;
+}
+
+/* 1 = loop runs at least once, 0 = never runs, -1 = not known here */
+static int loop_runs(CountedLoop *cl) {
+    if (cl->lo->type != NODE_CONST_INT || cl->hi->type != NODE_CONST_INT)
+        return -1;
+    int lo = cl->lo->int_val, hi = cl->hi->int_val;
+    return cl->relop == '<' ? lo < hi : lo <= hi;
+}
+
+/* The only statement in a loop body, if it is itself a for loop. */
+static ASTNode* single_inner_for(ASTNode *body) {
+    if (!body) return NULL;
+    if (body->type == NODE_FOR) return body;
+    if (body->type != NODE_BLOCK) return NULL;
+    ASTNode *found = NULL;
+    for (ASTNode *s = body->left; s; s = s->next) {
+        if (s->type == NODE_EMPTY) continue;
+        if (found) return NULL;
+        found = s;
+    }
+    return single_inner_for(found);
+}
+
+/* --- Body scan: array references and scalar roles --- */
+
+static int is_iv(NestBody *b, Symbol *sym) {
+    return sym && (sym == b->ivs[0] || sym == b->ivs[1]);
+}
+
+static ScalarUse* find_scalar(NestBody *b, Symbol *sym) {
+    for (int i = 0; i < b->scalar_count; i++)
+        if (b->scalars[i].sym == sym) return &b->scalars[i];
+    return NULL;
+}
+
+static void add_scalar(NestBody *b, Symbol *sym, int state) {
+    if (b->scalar_count >= NEST_MAX_SCALARS) {
+        b->ok = 0;
+        return;
+    }
+    b->scalars[b->scalar_count].sym = sym;
+    b->scalars[b->scalar_count].state = state;
+    b->scalar_count++;
+}
+
+static void note_scalar_read(NestBody *b, Symbol *sym) {
+    if (is_iv(b, sym)) return;
+    ScalarUse *u = find_scalar(b, sym);
+    if (!u) add_scalar(b, sym, SCALAR_READ);
+    else if (u->state == SCALAR_REDUCTION) b->ok = 0;
+}
+
+/* A write is only safe to reorder if the scalar is private: every iteration
+ * assigns it, unconditionally, before reading it. */
+static void note_scalar_write(NestBody *b, Symbol *sym, int unconditional) {
+    if (is_iv(b, sym) || !is_plain_scalar(sym) || sym->is_address_taken) {
+        b->ok = 0;
+        return;
+    }
+    ScalarUse *u = find_scalar(b, sym);
+    if (!u) {
+        if (unconditional) add_scalar(b, sym, SCALAR_PRIVATE);
+        else b->ok = 0;
+    } else if (u->state != SCALAR_PRIVATE) {
+        b->ok = 0;
+    }
+}
+
+static void scan_expr(NestBody *b, ASTNode *e);
+
+/* VLA dimension expressions are not resolved by semantic analysis; ir_gen
+ * looks their variables up by name, so do the same. */
+static void note_dim_reads(NestBody *b, ASTNode *e) {
+    if (!e) return;
+    if (e->type == NODE_VAR) {
+        Symbol *sym = e->sym ? e->sym : lookup_all_scopes(e->str_val);
+        if (!sym || !is_plain_scalar(sym)) b->ok = 0;
+        else note_scalar_read(b, sym);
+        return;
+    }
+    note_dim_reads(b, e->left);
+    note_dim_reads(b, e->right);
+}
+
+static void scan_index(NestBody *b, ASTNode *e, int is_write) {
+    if (b->ref_count >= NEST_MAX_REFS) {
+        b->ok = 0;
+        return;
+    }
+    ArrayRef *r = &b->refs[b->ref_count];
+    ASTNode *base = e;
+    int n = 0;
+    while (base->type == NODE_INDEX && n < NEST_MAX_DIMS) {
+        r->subs[n++] = base->right;
+        base = base->left;
+    }
+    if (base->type != NODE_VAR || !is_plain_array(base->sym)) {
+        b->ok = 0;
+        return;
+    }
+    int want = base->sym->array_dim_count > 0 ? base->sym->array_dim_count : 1;
+    if (n != want) {            /* partial indexing yields an address */
+        b->ok = 0;
+        return;
+    }
+    for (int i = 0; i < n / 2; i++) {
+        ASTNode *t = r->subs[i];
+        r->subs[i] = r->subs[n - 1 - i];
+        r->subs[n - 1 - i] = t;
+    }
+    r->node = e;
+    r->base = base->sym;
+    r->dims = n;
+    r->is_write = is_write;
+    b->ref_count++;
+    for (int i = 0; i < n; i++)
+        scan_expr(b, r->subs[i]);
+    if (base->sym->is_vla) {    /* strides re-read the dimension expressions */
+        for (int i = 1; i < n; i++)
+            if (base->sym->array_sizes[i] <= 0)
+                note_dim_reads(b, base->sym->array_dim_exprs[i]);
+    }
+}
+
+/* s = s + e / s = e + s / s = s - e, e not mentioning s */
+static ASTNode* reduction_operand(ASTNode *assign) {
+    Symbol *s = assign->left->sym;
+    ASTNode *r = assign->right;
+    if (!r || r->type != NODE_BIN_OP || !s || s->type != TYPE_INT || s->pointer_level != 0)
+        return NULL;
+    if (r->int_val == '+' && is_var(r->left, s) && !mentions(r->right, s)) return r->right;
+    if (r->int_val == '+' && is_var(r->right, s) && !mentions(r->left, s)) return r->left;
+    if (r->int_val == '-' && is_var(r->left, s) && !mentions(r->right, s)) return r->right;
+    return NULL;
+}
+
+static void scan_assign(NestBody *b, ASTNode *a, int top) {
+    ASTNode *lhs = a->left;
+    if (!lhs) {
+        b->ok = 0;
+        return;
+    }
+    if (lhs->type == NODE_VAR) {
+        ASTNode *operand = top ? reduction_operand(a) : NULL;
+        if (operand && is_plain_scalar(lhs->sym) && !lhs->sym->is_address_taken &&
+            !is_iv(b, lhs->sym)) {
+            scan_expr(b, operand);
+            if (find_scalar(b, lhs->sym)) b->ok = 0;
+            else add_scalar(b, lhs->sym, SCALAR_REDUCTION);
+            return;
+        }
+        scan_expr(b, a->right);
+        note_scalar_write(b, lhs->sym, top);
+    } else if (lhs->type == NODE_INDEX) {
+        scan_expr(b, a->right);
+        scan_index(b, lhs, 1);
+    } else {
+        b->ok = 0;
+    }
+}
+
+static void scan_expr(NestBody *b, ASTNode *e) {
+    if (!b->ok || !e) return;
+    switch (e->type) {
+        case NODE_CONST_INT:
+        case NODE_CONST_CHAR:
+            break;
+        case NODE_VAR:
+            if (!e->sym || !(is_iv(b, e->sym) || is_plain_scalar(e->sym)))
+                b->ok = 0;
+            else
+                note_scalar_read(b, e->sym);
+            break;
+        case NODE_INDEX:
+            scan_index(b, e, 0);
+            break;
+        case NODE_BIN_OP:
+            scan_expr(b, e->left);
+            scan_expr(b, e->right);
+            break;
+        case NODE_UN_OP:
+            if (e->int_val == '*' || e->int_val == '&') b->ok = 0;
+            else scan_expr(b, e->left);
+            break;
+        case NODE_ASSIGN:
+            scan_assign(b, e, 0);
+            break;
+        case NODE_PRE_INC:
+        case NODE_PRE_DEC:
+        case NODE_POST_INC:
+        case NODE_POST_DEC:
+            if (e->left && e->left->type == NODE_VAR) {
+                scan_expr(b, e->left);
+                note_scalar_write(b, e->left->sym, 0);
+            } else if (e->left && e->left->type == NODE_INDEX) {
+                scan_index(b, e->left, 0);
+                scan_index(b, e->left, 1);
+            } else {
+                b->ok = 0;
+            }
+            break;
+        default:
+            b->ok = 0;
+            break;
+    }
+}
+
+/* top: the statement runs on every iteration (not under an if). */
+static void scan_stmt(NestBody *b, ASTNode *s, int top) {
+    if (!b->ok || !s) return;
+    switch (s->type) {
+        case NODE_EMPTY:
+            break;
+        case NODE_BLOCK:
+            for (ASTNode *c = s->left; c; c = c->next)
+                scan_stmt(b, c, top);
+            break;
+        case NODE_VAR_DECL:
+            if (!is_plain_scalar(s->sym) || s->sym->is_address_taken ||
+                find_scalar(b, s->sym)) {
+                b->ok = 0;
+                break;
+            }
+            scan_expr(b, s->right);
+            add_scalar(b, s->sym, SCALAR_PRIVATE);
+            break;
+        case NODE_ASSIGN:
+            scan_assign(b, s, top);
+            break;
+        case NODE_IF:
+            scan_expr(b, s->cond);
+            scan_stmt(b, s->left, 0);
+            scan_stmt(b, s->right, 0);
+            break;
+        case NODE_PRE_INC:
+        case NODE_PRE_DEC:
+        case NODE_POST_INC:
+        case NODE_POST_DEC:
+            scan_expr(b, s);
+            break;
+        default:
+            b->ok = 0;     /* calls, I/O, nested loops, jumps */
+            break;
+    }
+}
+
+/* --- Dependence testing --- */
+
+/* iv, iv + c, c + iv, iv - c: a separable single-index subscript. */
+static Symbol* siv_var(NestBody *b, ASTNode *sub) {
+    if (sub->type == NODE_VAR && is_iv(b, sub->sym)) return sub->sym;
+    if (sub->type != NODE_BIN_OP) return NULL;
+    if (sub->int_val == '+' && sub->left->type == NODE_VAR && is_iv(b, sub->left->sym) &&
+        sub->right->type == NODE_CONST_INT)
+        return sub->left->sym;
+    if (sub->int_val == '+' && sub->right->type == NODE_VAR && is_iv(b, sub->right->sym) &&
+        sub->left->type == NODE_CONST_INT)
+        return sub->right->sym;
+    if (sub->int_val == '-' && sub->left->type == NODE_VAR && is_iv(b, sub->left->sym) &&
+        sub->right->type == NODE_CONST_INT)
+        return sub->left->sym;
+    return NULL;
+}
+
+static int mentions_written_scalar(NestBody *b, ASTNode *e) {
+    if (!e) return 0;
+    if (e->type == NODE_VAR) {
+        ScalarUse *u = find_scalar(b, e->sym);
+        return u && u->state != SCALAR_READ;
+    }
+    return mentions_written_scalar(b, e->left) || mentions_written_scalar(b, e->right);
+}
+
+/* Subscripts as dependence.h takes them: affine in the nest's IVs, plus
+ * at most one scalar the body only reads. A subscript using a scalar the
+ * body writes, or anything else, is left unknown. */
+static int affine_term(NestBody *b, ASTNode *e, long long mul, DepSubscript *s) {
+    if (!e || mul > (1 << 20) || mul < -(1 << 20)) return 0;
+    switch (e->type) {
+        case NODE_CONST_INT:
+            s->off += mul * e->int_val;
+            return 1;
+        case NODE_VAR:
+            for (int k = 0; k < 2; k++)
+                if (b->ivs[k] && e->sym == b->ivs[k]) {
+                    s->coef[k] += mul;
+                    return 1;
+                }
+            if (mul != 1 || s->sym || !e->sym || mentions_written_scalar(b, e)) return 0;
+            s->sym = e->sym;
+            return 1;
+        case NODE_BIN_OP:
+            if (e->int_val == '+')
+                return affine_term(b, e->left, mul, s) && affine_term(b, e->right, mul, s);
+            if (e->int_val == '-')
+                return affine_term(b, e->left, mul, s) && affine_term(b, e->right, -mul, s);
+            if (e->int_val == '*' && e->right && e->right->type == NODE_CONST_INT)
+                return affine_term(b, e->left, mul * e->right->int_val, s);
+            if (e->int_val == '*' && e->left && e->left->type == NODE_CONST_INT)
+                return affine_term(b, e->right, mul * e->left->int_val, s);
+            return 0;
+        case NODE_UN_OP:
+            return e->int_val == '-' && affine_term(b, e->left, -mul, s);
+        default:
+            return 0;
+    }
+}
+
+static void ref_subscripts(NestBody *b, ArrayRef *r, DepSubscript *subs) {
+    for (int d = 0; d < r->dims; d++) {
+        memset(&subs[d], 0, sizeof(subs[d]));
+        subs[d].affine = affine_term(b, r->subs[d], 1, &subs[d]);
+    }
+}
+
+static void nest_loop_range(CountedLoop *cl, DepLoop *l) {
+    l->known = cl->lo->type == NODE_CONST_INT && cl->hi->type == NODE_CONST_INT;
+    if (!l->known) return;
+    l->lo = cl->lo->int_val;
+    l->hi = cl->hi->int_val - (cl->relop == '<');
+}
+
+/* Reference x of body bx in iteration (i, j) against y of by in (i', j'),
+ * over the loops o (i) and n (j); n may be NULL for a body outside the
+ * inner loop. */
+static int nest_dep_test(NestBody *bx, ArrayRef *x, NestBody *by, ArrayRef *y,
+                         CountedLoop *o, CountedLoop *n, Dependence *dep) {
+    DepSubscript sx[NEST_MAX_DIMS], sy[NEST_MAX_DIMS];
+    DepLoop loops[2];
+    memset(loops, 0, sizeof(loops));
+    nest_loop_range(o, &loops[0]);
+    if (n) nest_loop_range(n, &loops[1]);
+    ref_subscripts(bx, x, sx);
+    ref_subscripts(by, y, sy);
+    return dep_test(sx, sy, x->dims < y->dims ? x->dims : y->dims, loops, 2, dep);
+}
+
+/* Interchange and tiling both reorder the two loops: every dependence
+ * between references to a written array must keep its direction in both
+ * orders, i.e. never run forwards in one loop and backwards in the other.
+ * (=,*) and (<,<=) pass; (<,>), as for a[i][j] = a[i - 1][j + 1], does not. */
+static int nest_dependences_ok(NestBody *b, CountedLoop *o, CountedLoop *n) {
+    for (int i = 0; i < b->ref_count; i++) {
+        ArrayRef *x = &b->refs[i];
+        for (int j = i; j < b->ref_count; j++) {
+            ArrayRef *y = &b->refs[j];
+            Dependence dep;
+            if (y->base != x->base || (!x->is_write && !y->is_write)) continue;
+            if (nest_dep_test(b, x, b, y, o, n, &dep) && dep_crosses(&dep, 0, 1)) return 0;
+        }
+    }
+    return 1;
+}
+
+/* Bounds must be simple arithmetic on invariant scalars. */
+static int is_bound_expr(ASTNode *e, CountedLoop *o, CountedLoop *n) {
+    if (!e) return 0;
+    switch (e->type) {
+        case NODE_CONST_INT:
+            return 1;
+        case NODE_VAR:
+            return is_plain_scalar(e->sym) && e->sym != o->var && e->sym != n->var;
+        case NODE_BIN_OP:
+            return (e->int_val == '+' || e->int_val == '-' || e->int_val == '*') &&
+                   is_bound_expr(e->left, o, n) && is_bound_expr(e->right, o, n);
+        default:
+            return 0;
+    }
+}
+
+static int analyze_nest(CountedLoop *o, CountedLoop *n, ASTNode *body, NestBody *b) {
+    memset(b, 0, sizeof(*b));
+    b->ok = 1;
+    b->ivs[0] = o->var;
+    b->ivs[1] = n->var;
+    if (o->var == n->var) return 0;
+
+    ASTNode *bounds[4] = { o->lo, o->hi, n->lo, n->hi };
+    for (int i = 0; i < 4; i++) {
+        if (!is_bound_expr(bounds[i], o, n)) return 0;
+        scan_expr(b, bounds[i]);   /* a later write in the body fails the scan */
+    }
+    scan_stmt(b, body, 1);
+    return b->ok && nest_dependences_ok(b, o, n);
+}
+
+/* --- Cost model --- */
+
+/* 0 = invariant in iv, 1 = unit stride (last dimension), 2 = strided */
+static int ref_stride_cost(NestBody *b, ArrayRef *r, Symbol *iv) {
+    int uses = 0, last = 0;
+    for (int d = 0; d < r->dims; d++) {
+        if (!mentions(r->subs[d], iv)) continue;
+        uses++;
+        if (d == r->dims - 1 && siv_var(b, r->subs[d]) == iv) last = 1;
+    }
+    if (uses == 0) return 0;
+    return (uses == 1 && last) ? 1 : 2;
+}
+
+/* A read and a write of the same element share their cache line: count
+ * each (array, subscripts) group once. */
+static int is_group_leader(NestBody *b, int idx) {
+    ArrayRef *r = &b->refs[idx];
+    for (int i = 0; i < idx; i++) {
+        ArrayRef *p = &b->refs[i];
+        if (p->base != r->base || p->dims != r->dims) continue;
+        int same = 1;
+        for (int d = 0; d < r->dims && same; d++)
+            same = ast_equal(p->subs[d], r->subs[d]);
+        if (same) return 0;
+    }
+    return 1;
+}
+
+static int plan_nest(NestBody *b, CountedLoop *o, CountedLoop *n, NestPlan *plan) {
+    int cost_o = 0, cost_n = 0;
+    for (int i = 0; i < b->ref_count; i++) {
+        if (!is_group_leader(b, i)) continue;
+        cost_o += ref_stride_cost(b, &b->refs[i], o->var);
+        cost_n += ref_stride_cost(b, &b->refs[i], n->var);
+    }
+    plan->interchange = cost_n > cost_o;
+
+    /* Tile the (new) inner loop when it walks memory with unit stride and
+     * the outer loop comes back to the same strip: strip-mine the inner
+     * loop and move the strip loop outermost so the strip stays in cache. */
+    CountedLoop *outer = plan->interchange ? n : o;
+    CountedLoop *inner = plan->interchange ? o : n;
+    int reuse = 0, streams = 0, elem = 1;
+    for (int i = 0; i < b->ref_count; i++) {
+        ArrayRef *r = &b->refs[i];
+        int ci = ref_stride_cost(b, r, inner->var);
+        int co = ref_stride_cost(b, r, outer->var);
+        if (ci == 2) {
+            reuse = 0;
+            break;
+        }
+        if (ci == 1 && co == 0) reuse = 1;
+        if (co > 0) streams = 1;
+        int size = get_type_size(r->node->data_type, r->node->pointer_level, r->node->struct_def);
+        if (size > elem) elem = size;
+    }
+    plan->tile = 0;
+    if (reuse && streams) {
+        int tile = LOOP_TILE_BYTES / elem;
+        if (inner->lo->type == NODE_CONST_INT && inner->hi->type == NODE_CONST_INT) {
+            int extent = inner->hi->int_val - inner->lo->int_val + (inner->relop == T_LE);
+            if (extent <= tile) tile = 0;
+        }
+        plan->tile = tile;
+    }
+    return plan->interchange || plan->tile;
+}
+
+/* --- Unroll and jam --- */
+
+/*   for (v = lo; v < hi; v++)                for (v = lo; v < hi - (F - 1); v = v + F)
+ *       for (w ...) B(v)            ->           for (w ...) { B(v); B(v + 1); ... B(v + F - 1) }
+ *                                            for (; v < hi; v++)
+ *                                                for (w ...) B(v)
+ *
+ * Each block of F outer iterations runs interchanged with the inner loop,
+ * so the nest must pass the interchange test. It pays off when the copies
+ * touch the same elements: c[i][j] or b[k][j] in a loop that does not
+ * index them, neighbouring rows of a stencil. Such a group is kept in a
+ * temp across the jammed body (the IR does not reuse loads), loaded once
+ * at the top and, if written, stored once at the end.
+ *
+ * Not with -march=rv64gcv: the vectorizer takes the inner loops, and a
+ * jammed body has more live-in values than a vector kernel is passed. */
+
+/* Outer iterations jammed into one inner iteration, at most. */
+#define JAM_MAX_FACTOR  4
+/* Values the jammed loop keeps in registers: the replaced groups, the
+ * inner-invariant elements LICM hoists, one pointer per row it walks, the
+ * counters and the scalars it reads, out of the 15 allocatable registers;
+ * expression temporaries take the rest. */
+#define JAM_MAX_LIVE    11
+/* AST nodes in the jammed inner body. */
+#define JAM_MAX_NODES   400
+
+typedef struct {
+    ArrayRef *lead;
+    DepSubscript subs[NEST_MAX_DIMS];
+    int refs;
+    int written;
+    int replace;
+} JamGroup;
+
+int loop_unroll_and_jam = 1;
+static int jam_counter = 0;
+
+static int tree_size(ASTNode *n) {
+    int size = 0;
+    for (; n; n = n->next)
+        size += 1 + tree_size(n->left) + tree_size(n->right) + tree_size(n->cond) +
+                tree_size(n->body) + tree_size(n->init) + tree_size(n->incr) +
+                tree_size(n->params);
+    return size;
+}
+
+/* Every reference runs on every iteration: no if, no && or ||. */
+static int straight_line(ASTNode *n) {
+    for (; n; n = n->next) {
+        if (n->type == NODE_IF) return 0;
+        if (n->type == NODE_BIN_OP && (n->int_val == T_AND || n->int_val == T_OR)) return 0;
+        if (!straight_line(n->left) || !straight_line(n->right)) return 0;
+    }
+    return 1;
+}
+
+/* Every read of v becomes v + c. */
+static void shift_iv(ASTNode **slot, Symbol *v, int c) {
+    for (; *slot; slot = &(*slot)->next) {
+        ASTNode *e = *slot;
+        if (e->type == NODE_VAR && e->sym == v) {
+            ASTNode *sum = make_binop('+', var_ref(v), create_int_node(c), e->line_number);
+            sum->next = e->next;
+            *slot = sum;
+            continue;
+        }
+        shift_iv(&e->left, v, c);
+        shift_iv(&e->right, v, c);
+        shift_iv(&e->cond, v, c);
+        shift_iv(&e->body, v, c);
+    }
+}
+
+static int same_element(DepSubscript *a, DepSubscript *b, int dims) {
+    for (int d = 0; d < dims; d++)
+        if (!a[d].affine || !b[d].affine || a[d].sym != b[d].sym || a[d].off != b[d].off ||
+            a[d].coef[0] != b[d].coef[0] || a[d].coef[1] != b[d].coef[1])
+            return 0;
+    return 1;
+}
+
+static int varies_inner(JamGroup *g) {
+    for (int d = 0; d < g->lead->dims; d++)
+        if (g->subs[d].coef[1]) return 1;
+    return 0;
+}
+
+/* Elements a fixed distance apart along the last dimension: one pointer
+ * walks both once the IV is strength-reduced. */
+static int same_stream(JamGroup *a, JamGroup *b) {
+    int last = a->lead->dims - 1;
+    if (a->lead->base != b->lead->base) return 0;
+    return same_element(a->subs, b->subs, last) && a->subs[last].sym == b->subs[last].sym &&
+           a->subs[last].coef[0] == b->subs[last].coef[0] &&
+           a->subs[last].coef[1] == b->subs[last].coef[1];
+}
+
+/* Group the references of the F copies by element and pick the groups to
+ * keep in temps: int elements of an array the body does not write, or the
+ * single element it writes. Returns the loads and stores saved per inner
+ * iteration; *live gets the register estimate (JAM_MAX_LIVE). */
+static int jam_groups(NestBody *copies, int factor, JamGroup *groups, int *group_of,
+                      int *ngroups, int *live) {
+    int n = 0, idx = 0;
+    for (int c = 0; c < factor; c++) {
+        for (int i = 0; i < copies[c].ref_count; i++, idx++) {
+            ArrayRef *r = &copies[c].refs[i];
+            DepSubscript subs[NEST_MAX_DIMS];
+            ref_subscripts(&copies[c], r, subs);
+            group_of[idx] = -1;
+            int g = 0;
+            while (g < n && !(groups[g].lead->base == r->base &&
+                              same_element(groups[g].subs, subs, r->dims)))
+                g++;
+            if (g == n) {
+                if (!same_element(subs, subs, r->dims)) continue;    /* not affine */
+                if (n >= NEST_MAX_REFS) return 0;
+                memset(&groups[n], 0, sizeof(groups[n]));
+                groups[n].lead = r;
+                memcpy(groups[n].subs, subs, sizeof(subs));
+                n++;
+            }
+            group_of[idx] = g;
+            groups[g].refs++;
+            groups[g].written |= r->is_write;
+        }
+    }
+
+    int saved = 0;
+    *live = 2;
+    for (int g = 0; g < n; g++) {
+        Symbol *base = groups[g].lead->base;
+        int written = 0, others = 0;
+        idx = 0;
+        for (int c = 0; c < factor; c++)
+            for (int i = 0; i < copies[c].ref_count; i++, idx++) {
+                if (copies[c].refs[i].base != base) continue;
+                written |= copies[c].refs[i].is_write;
+                if (group_of[idx] != g) others = 1;
+            }
+        int gain = groups[g].refs - 1 - groups[g].written;
+        groups[g].replace = base->type == TYPE_INT && gain > 0 && (!written || !others);
+        if (groups[g].replace) {
+            saved += gain;
+            (*live)++;
+        }
+        if (varies_inner(&groups[g])) {
+            int h = 0;
+            while (h < g && !(varies_inner(&groups[h]) && same_stream(&groups[g], &groups[h])))
+                h++;
+            *live += h == g;
+        } else if (!written && !groups[g].replace) {
+            (*live)++;
+        }
+    }
+    for (int i = 0; i < copies[0].scalar_count; i++)
+        if (copies[0].scalars[i].state != SCALAR_PRIVATE) (*live)++;
+    *ngroups = n;
+    return saved;
+}
+
+static void become_temp(ASTNode *n, const char *name) {
+    int line = n->line_number;
+    ASTNode *next = n->next;
+    memset(n, 0, sizeof(*n));
+    n->type = NODE_VAR;
+    n->str_val = strdup(name);
+    n->data_type = TYPE_INT;
+    n->line_number = line;
+    n->next = next;
+}
+
+/* Jam the nest at *slot (outer loop co around the counted inner loop
+ * n_loop, cn), when some factor both saves memory operations and fits
+ * JAM_MAX_LIVE. The nest has passed analyze_nest. */
+static void try_unroll_and_jam(ASTNode **slot, CountedLoop *co, ASTNode *n_loop,
+                               CountedLoop *cn) {
+    static NestBody copies[JAM_MAX_FACTOR];
+    static JamGroup groups[NEST_MAX_REFS];
+    static int group_of[JAM_MAX_FACTOR * NEST_MAX_REFS];
+    ASTNode *o_loop = *slot;
+    ASTNode *body = n_loop->body;
+    int line = o_loop->line_number;
+    if (!loop_unroll_and_jam || riscv_ext_v || !straight_line(body)) return;
+
+    int trips = JAM_MAX_FACTOR;
+    if (co->lo->type == NODE_CONST_INT && co->hi->type == NODE_CONST_INT)
+        trips = co->hi->int_val - co->lo->int_val + (co->relop == T_LE);
+
+    int factor, ngroups = 0;
+    ASTNode *stmts[JAM_MAX_FACTOR];
+    for (factor = JAM_MAX_FACTOR; factor >= 2; factor--) {
+        if (factor > trips || factor * tree_size(body) > JAM_MAX_NODES) continue;
+        int ok = 1;
+        for (int c = 0; c < factor && ok; c++) {
+            stmts[c] = clone_tree(body);
+            if (c) shift_iv(&stmts[c], co->var, c);
+            memset(&copies[c], 0, sizeof(copies[c]));
+            copies[c].ok = 1;
+            copies[c].ivs[0] = co->var;
+            copies[c].ivs[1] = cn->var;
+            scan_stmt(&copies[c], stmts[c], 1);
+            ok = copies[c].ok;
+        }
+        int live;
+        if (ok && jam_groups(copies, factor, groups, group_of, &ngroups, &live) >= factor - 1 &&
+            live <= JAM_MAX_LIVE)
+            break;
+    }
+    if (factor < 2) return;
+
+    /* Loads and stores of the replaced groups, then the references. */
+    ASTNode *loads = NULL, *stores = NULL, **ltail = &loads, **stail = &stores;
+    char names[NEST_MAX_REFS][32];
+    for (int g = 0; g < ngroups; g++) {
+        if (!groups[g].replace) continue;
+        snprintf(names[g], sizeof(names[g]), "__jam%d", jam_counter++);
+        *ltail = make_assign(temp_ref(names[g]), clone_tree(groups[g].lead->node), line);
+        ltail = &(*ltail)->next;
+        if (groups[g].written) {
+            *stail = make_assign(clone_tree(groups[g].lead->node), temp_ref(names[g]), line);
+            stail = &(*stail)->next;
+        }
+    }
+    int idx = 0;
+    for (int c = 0; c < factor; c++)
+        for (int i = 0; i < copies[c].ref_count; i++, idx++)
+            if (group_of[idx] >= 0 && groups[group_of[idx]].replace)
+                become_temp(copies[c].refs[i].node, names[group_of[idx]]);
+
+    *ltail = stmts[0];
+    for (int c = 1; c < factor; c++) {
+        ASTNode *t = stmts[c - 1];
+        while (t->next) t = t->next;
+        t->next = stmts[c];
+    }
+    ASTNode *t = stmts[factor - 1];
+    while (t->next) t = t->next;
+    t->next = stores;
+
+    ASTNode *jblk = create_node(NODE_BLOCK);
+    jblk->line_number = line;
+    jblk->left = loads;
+    ASTNode *jinner = create_for_node(clone_tree(n_loop->init), clone_tree(n_loop->cond),
+                                      clone_tree(n_loop->incr), jblk);
+    jinner->line_number = n_loop->line_number;
+    ASTNode *jam = create_for_node(
+        clone_tree(o_loop->init),
+        make_binop(co->relop, var_ref(co->var),
+                   make_binop('-', clone_tree(co->hi), create_int_node(factor - 1), line), line),
+        make_assign(var_ref(co->var),
+                    make_binop('+', var_ref(co->var), create_int_node(factor), line), line),
+        jinner);
+    jam->line_number = line;
+
+    /* The original loop, entered at the first iteration left over. */
+    ASTNode *wrap = create_node(NODE_BLOCK);
+    wrap->line_number = line;
+    wrap->left = jam;
+    jam->next = o_loop;
+    wrap->next = o_loop->next;
+    o_loop->next = NULL;
+    o_loop->init = NULL;
+    *slot = wrap;
+}
+
+/* --- Rewriting --- */
+
+/*   for (T = lo; T < hi; T = T + tile) {
+ *       E = T + tile; if (E > hi) E = hi;
+ *       outer { for (v = T; v < E; v++) body }
+ *   }                                            (v <= hi: E = T + tile - 1) */
+static ASTNode* tile_inner_loop(ASTNode *outer, ASTNode *inner, CountedLoop *cin,
+                                int tile, int line) {
+    char tname[32], ename[32];
+    snprintf(tname, sizeof(tname), "__tile%d", tile_counter);
+    snprintf(ename, sizeof(ename), "__tend%d", tile_counter);
+    tile_counter++;
+
+    inner->init = make_assign(var_ref(cin->var), temp_ref(tname), line);
+    inner->cond = make_binop(cin->relop, var_ref(cin->var), temp_ref(ename), line);
+
+    int span = cin->relop == T_LE ? tile - 1 : tile;
+    ASTNode *set_end = make_assign(temp_ref(ename),
+                                   make_binop('+', temp_ref(tname), create_int_node(span), line),
+                                   line);
+    ASTNode *clamp = create_if_node(make_binop('>', temp_ref(ename), clone_tree(cin->hi), line),
+                                    make_assign(temp_ref(ename), clone_tree(cin->hi), line),
+                                    NULL);
+    clamp->line_number = line;
+    ASTNode *blk = create_node(NODE_BLOCK);
+    blk->line_number = line;
+    blk->left = set_end;
+    set_end->next = clamp;
+    clamp->next = outer;
+    outer->next = NULL;
+
+    ASTNode *strip = create_for_node(
+        make_assign(temp_ref(tname), clone_tree(cin->lo), line),
+        make_binop(cin->relop, temp_ref(tname), clone_tree(cin->hi), line),
+        make_assign(temp_ref(tname),
+                    make_binop('+', temp_ref(tname), create_int_node(tile), line), line),
+        blk);
+    strip->line_number = line;
+    return strip;
+}
+
+static ASTNode* runs_test(CountedLoop *cl, int line) {
+    return make_binop(cl->relop, clone_tree(cl->lo), clone_tree(cl->hi), line);
+}
+
+/* Replace the nest at *slot. The reordered nest only runs when both loops
+ * run at least once; otherwise a copy of the original keeps the IVs' exit
+ * values (a zero-trip inner loop leaves the outer IV at its bound). */
+static void rewrite_nest(ASTNode **slot, ASTNode *o_loop, CountedLoop *co,
+                         ASTNode *n_loop, CountedLoop *cn, NestPlan *plan) {
+    ASTNode *next = o_loop->next;
+    int line = o_loop->line_number;
+    ASTNode *original = clone_tree(o_loop);
+
+    ASTNode *guard = NULL;
+    if (loop_runs(co) != 1) guard = runs_test(co, line);
+    int same_range = co->relop == cn->relop && ast_equal(co->lo, cn->lo) &&
+                     ast_equal(co->hi, cn->hi);
+    if (loop_runs(cn) != 1 && !(guard && same_range)) {
+        ASTNode *t = runs_test(cn, line);
+        guard = guard ? make_binop(T_AND, guard, t, line) : t;
+    }
+
+    ASTNode *body = n_loop->body;
+    ASTNode *outer = plan->interchange ? n_loop : o_loop;
+    ASTNode *inner = plan->interchange ? o_loop : n_loop;
+    outer->body = inner;
+    inner->body = body;
+    inner->next = NULL;
+
+    ASTNode *top = outer, **jam_slot = &top;
+    if (plan->tile) {
+        top = tile_inner_loop(outer, inner, plan->interchange ? co : cn, plan->tile, line);
+        jam_slot = &top->body->left->next->next;    /* after the clamp */
+    }
+    if (plan->interchange)
+        try_unroll_and_jam(jam_slot, cn, inner, co);
+    else
+        try_unroll_and_jam(jam_slot, co, inner, cn);
+
+    if (guard) {
+        top = create_if_node(guard, top, original);
+        top->line_number = line;
+    }
+    top->next = next;
+    *slot = top;
+}
+
+static int scalars_disjoint(NestBody *a, NestBody *b) {
+    for (int i = 0; i < a->scalar_count; i++) {
+        if (a->scalars[i].state == SCALAR_READ) continue;
+        if (find_scalar(b, a->scalars[i].sym)) return 0;
+    }
+    return 1;
+}
+
+/* Distribution runs S for every j before any of the inner loops: no
+ * dependence between the halves may have its inner-loop end at an earlier
+ * j than its S end. */
+static int arrays_separable(NestBody *a, NestBody *b, CountedLoop *co, CountedLoop *ci) {
+    for (int i = 0; i < a->ref_count; i++) {
+        ArrayRef *x = &a->refs[i];
+        for (int j = 0; j < b->ref_count; j++) {
+            ArrayRef *y = &b->refs[j];
+            Dependence dep;
+            if (y->base != x->base || (!x->is_write && !y->is_write)) continue;
+            if (nest_dep_test(a, x, b, y, co, ci, &dep) && (dep.dir[0] & DEP_GT)) return 0;
+        }
+    }
+    return 1;
+}
+
+/* for j { S; for k { B } }  ->  for j { S }  for j { for k { B } }
+ * when the (j, k) nest is worth restructuring and S only shares data
+ * with the inner loop through elements indexed by j. */
+static void try_distribute(ASTNode **slot, ASTNode *o_loop, CountedLoop *co) {
+    ASTNode *blk = o_loop->body;
+    if (!blk || blk->type != NODE_BLOCK) return;
+    ASTNode *last = NULL, *before_last = NULL;
+    for (ASTNode *s = blk->left; s; s = s->next) {
+        if (s->type == NODE_EMPTY) continue;
+        before_last = last;
+        last = s;
+    }
+    if (!last || !before_last || last->type != NODE_FOR) return;
+
+    CountedLoop ci;
+    NestBody inner, head;
+    NestPlan plan;
+    if (!parse_counted_loop(last, &ci) || !analyze_nest(co, &ci, last->body, &inner) ||
+        !plan_nest(&inner, co, &ci, &plan))
+        return;
+    if (loop_runs(co) == 0 || loop_runs(&ci) == 0) return;
+
+    memset(&head, 0, sizeof(head));
+    head.ok = 1;
+    head.ivs[0] = co->var;
+    scan_expr(&head, co->lo);
+    scan_expr(&head, co->hi);
+    for (ASTNode *s = blk->left; s && s != last; s = s->next)
+        scan_stmt(&head, s, 1);
+    if (!head.ok || find_scalar(&head, ci.var) ||
+        !scalars_disjoint(&head, &inner) || !scalars_disjoint(&inner, &head) ||
+        !arrays_separable(&head, &inner, co, &ci))
+        return;
+
+    /* Unlink the inner loop from the first half. */
+    ASTNode **link = &blk->left;
+    while (*link != last) link = &(*link)->next;
+    *link = last->next;
+
+    ASTNode *second = create_for_node(clone_tree(o_loop->init), clone_tree(o_loop->cond),
+                                      clone_tree(o_loop->incr), last);
+    second->line_number = o_loop->line_number;
+
+    ASTNode *wrap = create_node(NODE_BLOCK);
+    wrap->line_number = o_loop->line_number;
+    wrap->next = o_loop->next;
+    wrap->left = o_loop;
+    o_loop->next = second;
+    second->next = NULL;
+    *slot = wrap;
+
+    rewrite_nest(&o_loop->next, second, co, last, &ci, &plan);
+}
+
+static void try_restructure(ASTNode **slot) {
+    ASTNode *o_loop = *slot;
+    CountedLoop co, cn;
+    if (!parse_counted_loop(o_loop, &co)) return;
+
+    ASTNode *n_loop = single_inner_for(o_loop->body);
+    if (!n_loop) {
+        try_distribute(slot, o_loop, &co);
+        return;
+    }
+
+    NestBody body;
+    NestPlan plan;
+    if (!parse_counted_loop(n_loop, &cn) || !analyze_nest(&co, &cn, n_loop->body, &body))
+        return;
+    if (loop_runs(&co) == 0 || loop_runs(&cn) == 0) return;
+    if (!plan_nest(&body, &co, &cn, &plan)) {
+        try_unroll_and_jam(slot, &co, n_loop, &cn);
+        return;
+    }
+    rewrite_nest(slot, o_loop, &co, n_loop, &cn, &plan);
+}
+
+static void restructure_stmt(ASTNode **slot);
+
+static void restructure_list(ASTNode **link) {
+    for (; *link; link = &(*link)->next)
+        restructure_stmt(link);
+}
+
+/* Innermost nests first; a rewritten nest is no longer a candidate for the
+ * loop around it. */
+static void restructure_stmt(ASTNode **slot) {
+    ASTNode *s = *slot;
+    if (!s) return;
+    switch (s->type) {
+        case NODE_BLOCK:
+            restructure_list(&s->left);
+            break;
+        case NODE_FOR:
+        case NODE_WHILE:
+            restructure_stmt(&s->body);
+            break;
+        case NODE_IF:
+            restructure_stmt(&s->left);
+            restructure_stmt(&s->right);
+            break;
+        default:
+            break;
+    }
+    if (s->type == NODE_FOR)
+        try_restructure(slot);
+}
+
+void restructure_loop_nests(ASTNode *root) {
+    for (ASTNode *n = root; n; n = n->next) {
+        if (n->type == NODE_FUNC_DEF) {
+            restructure_stmt(&n->body);
+        } else if (n->type == NODE_STRUCT_DEF) {
+            for (ASTNode *m = n->body; m; m = m->next)
+                if (m->type == NODE_FUNC_DEF)
+                    restructure_stmt(&m->body);
+        }
+    }
+}
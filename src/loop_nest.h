@@ -0,0 +1,19 @@
+/**
+ * loop_nest.h - AST-level loop nest restructuring
+ * Interchange, tiling and unroll-and-jam of counted for-loop nests over
+ * arrays (-O2).
+ */
+
+#ifndef LOOP_NEST_H
+#define LOOP_NEST_H
+
+#include "ast.h"
+
+/* Unroll and jam outer loops (on by default; -fno-loop-unroll-and-jam). */
+extern int loop_unroll_and_jam;
+
+/* Restructure loop nests in every function. Call after semantic analysis,
+ * before IR generation. */
+void restructure_loop_nests(ASTNode *root);
+
+#endif /* LOOP_NEST_H */
@@ -0,0 +1,37 @@
+  # RVV versions of the mem_runtime.s routines, called instead of them
+  # in -march=rv64gcv builds: one vector register group (LMUL=8) per
+  # store, strip-mined by vsetvli. A count <= 0 does nothing.
+
+  .text
+
+  # __paninic_memset32_rvv(int *dst, int value, int count)
+  .globl __paninic_memset32_rvv
+__paninic_memset32_rvv:
+  blez a2, .Lvms_done
+  vsetvli t0, zero, e32, m8, ta, ma
+  vmv.v.x v8, a1
+.Lvms_loop:
+  vsetvli t0, a2, e32, m8, ta, ma
+  vse32.v v8, (a0)
+  slli t1, t0, 2
+  add a0, a0, t1
+  sub a2, a2, t0
+  bnez a2, .Lvms_loop
+.Lvms_done:
+  ret
+
+  # __paninic_memcpy_rvv(void *dst, const void *src, long n)
+  # n bytes, forward; dst and src must not overlap.
+  .globl __paninic_memcpy_rvv
+__paninic_memcpy_rvv:
+  blez a2, .Lvmc_done
+.Lvmc_loop:
+  vsetvli t0, a2, e8, m8, ta, ma
+  vle8.v v8, (a1)
+  vse8.v v8, (a0)
+  add a0, a0, t0
+  add a1, a1, t0
+  sub a2, a2, t0
+  bnez a2, .Lvmc_loop
+.Lvmc_done:
+  ret
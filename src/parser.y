@@ -8,11 +8,13 @@
 #include "symbol_table.h"
 #include "semantic.h"
 #include "ir_gen.h"
+#include "loop_nest.h"
 #include "ir_opt.h"
 #include "reg_alloc.h"
 #include "ir_sched.h"
 #include "riscv_gen.h"
 #include "compiler_metrics.h"
+#include "profile.h"
 
 void print_vtables() {
     Scope *global = current_scope;
@@ -147,17 +149,21 @@ static int token_can_start_statement(const char *tok) {
 %token <intval> T_ARROW T_TILDE
 
 /* Operators */
-%token <intval> T_EQ T_NEQ T_LE T_GE T_AND T_OR T_INC T_DEC
+%token <intval> T_EQ T_NEQ T_LE T_GE T_AND T_OR T_INC T_DEC T_SHL T_SHR
 
 /* Precedence (lowest to highest) */
 %right '='
 %left T_OR
 %left T_AND
+%left '|'
+%left '^'
+%left '&'
 %left T_EQ T_NEQ
 %left '<' '>' T_LE T_GE
+%left T_SHL T_SHR
 %left '+' '-'
 %left '*' '/' '%'
-%right '!'
+%right '!' T_TILDE
 %nonassoc LOWER_THAN_ELSE
 %nonassoc T_ELSE
 
@@ -170,7 +176,8 @@ static int token_can_start_statement(const char *tok) {
 %type <node> switch_statement switch_clause_list switch_clause
 %type <node> statement_list statement_list_opt
 %type <node> expression assignment_expression logical_or_expression logical_and_expression
-%type <node> equality_expression relational_expression additive_expression
+%type <node> inclusive_or_expression exclusive_or_expression and_expression
+%type <node> equality_expression relational_expression shift_expression additive_expression
 %type <node> multiplicative_expression unary_expression postfix_expression primary_expression
 %type <node> argument_expression_list
 %type <node> try_statement catch_clause_list catch_clause throw_statement
@@ -488,6 +495,12 @@ struct_specifier
         node->str_val = strdup($2);
         $$ = node;
     }
+    | T_STRUCT T_TYPE_NAME {
+        /* `struct S` once S is defined: the lexer now returns the tag as a type name. */
+        ASTNode *node = create_type_node(T_STRUCT);
+        node->str_val = strdup($2);
+        $$ = node;
+    }
     ;
 
 class_head
@@ -832,13 +845,37 @@ logical_or_expression
     ;
 
 logical_and_expression
-    : equality_expression { $$ = $1; }
-    | logical_and_expression T_AND equality_expression {
+    : inclusive_or_expression { $$ = $1; }
+    | logical_and_expression T_AND inclusive_or_expression {
         $$ = create_binary_node(T_AND, $1, $3);
         SET_LINE($$);
     }
     ;
 
+inclusive_or_expression
+    : exclusive_or_expression { $$ = $1; }
+    | inclusive_or_expression '|' exclusive_or_expression {
+        $$ = create_binary_node('|', $1, $3);
+        SET_LINE($$);
+    }
+    ;
+
+exclusive_or_expression
+    : and_expression { $$ = $1; }
+    | exclusive_or_expression '^' and_expression {
+        $$ = create_binary_node('^', $1, $3);
+        SET_LINE($$);
+    }
+    ;
+
+and_expression
+    : equality_expression { $$ = $1; }
+    | and_expression '&' equality_expression {
+        $$ = create_binary_node('&', $1, $3);
+        SET_LINE($$);
+    }
+    ;
+
 equality_expression
     : relational_expression { $$ = $1; }
     | equality_expression T_EQ relational_expression {
@@ -852,25 +889,37 @@ equality_expression
     ;
 
 relational_expression
-    : additive_expression { $$ = $1; }
-    | relational_expression '<' additive_expression {
+    : shift_expression { $$ = $1; }
+    | relational_expression '<' shift_expression {
         $$ = create_binary_node('<', $1, $3);
         SET_LINE($$);
     }
-    | relational_expression '>' additive_expression {
+    | relational_expression '>' shift_expression {
         $$ = create_binary_node('>', $1, $3);
         SET_LINE($$);
     }
-    | relational_expression T_LE additive_expression {
+    | relational_expression T_LE shift_expression {
         $$ = create_binary_node(T_LE, $1, $3);
         SET_LINE($$);
     }
-    | relational_expression T_GE additive_expression {
+    | relational_expression T_GE shift_expression {
         $$ = create_binary_node(T_GE, $1, $3);
         SET_LINE($$);
     }
     ;
 
+shift_expression
+    : additive_expression { $$ = $1; }
+    | shift_expression T_SHL additive_expression {
+        $$ = create_binary_node(T_SHL, $1, $3);
+        SET_LINE($$);
+    }
+    | shift_expression T_SHR additive_expression {
+        $$ = create_binary_node(T_SHR, $1, $3);
+        SET_LINE($$);
+    }
+    ;
+
 additive_expression
     : multiplicative_expression { $$ = $1; }
     | additive_expression '+' multiplicative_expression {
@@ -963,6 +1012,10 @@ unary_expression
         $$ = create_unary_node('!', $2);
         SET_LINE($$);
     }
+    | T_TILDE unary_expression {
+        $$ = create_unary_node('~', $2);
+        SET_LINE($$);
+    }
     | '&' unary_expression {
         $$ = create_unary_node('&', $2);
         SET_LINE($$);
@@ -1126,6 +1179,71 @@ int main(int argc, char **argv) {
             want_metrics = 1;
             continue;
         }
+        if (strcmp(argv[arg_idx], "-mzicond") == 0) {
+            arg_idx++;
+            riscv_ext_zicond = 1;
+            continue;
+        }
+        if (strcmp(argv[arg_idx], "-mzba") == 0) {
+            arg_idx++;
+            riscv_ext_zba = 1;
+            continue;
+        }
+        if (strncmp(argv[arg_idx], "-march=", 7) == 0) {
+            if (!riscv_set_march(argv[arg_idx] + 7)) {
+                fprintf(stderr, "Unknown architecture: %s (use rv64gc or rv64gcv, optionally followed by _zba, _zicond)\n", argv[arg_idx] + 7);
+                return 1;
+            }
+            arg_idx++;
+            continue;
+        }
+        if (strcmp(argv[arg_idx], "-floop-unroll-and-jam") == 0 ||
+            strcmp(argv[arg_idx], "-fno-loop-unroll-and-jam") == 0) {
+            loop_unroll_and_jam = argv[arg_idx][2] != 'n';
+            arg_idx++;
+            continue;
+        }
+        if (strcmp(argv[arg_idx], "-fno-prefetch-loop-arrays") == 0) {
+            prefetch_loop_arrays = 0;
+            arg_idx++;
+            continue;
+        }
+        if (strncmp(argv[arg_idx], "-fprefetch-loop-arrays", 22) == 0) {
+            const char *rest = argv[arg_idx] + 22;
+            char *end = (char *)rest;
+            long dist = PREFETCH_DEFAULT_DISTANCE;
+            if (*rest == '=')
+                dist = strtol(rest + 1, &end, 10);
+            if (*end || end == rest + 1 || dist <= 0 || dist > 65536) {
+                fprintf(stderr, "Unknown option: %s (use -fprefetch-loop-arrays[=bytes], 1 to 65536)\n", argv[arg_idx]);
+                return 1;
+            }
+            prefetch_loop_arrays = (int)dist;
+            arg_idx++;
+            continue;
+        }
+        if (strncmp(argv[arg_idx], "-mtune=", 7) == 0) {
+            if (!riscv_set_tune(argv[arg_idx] + 7)) {
+                fprintf(stderr, "Unknown tuning target: %s (use generic, sifive-7-series or rocket)\n", argv[arg_idx] + 7);
+                return 1;
+            }
+            arg_idx++;
+            continue;
+        }
+        if (strncmp(argv[arg_idx], "-fprofile-generate", 18) == 0 ||
+            strncmp(argv[arg_idx], "-fprofile-use", 13) == 0) {
+            int gen = argv[arg_idx][10] == 'g';
+            const char *rest = argv[arg_idx] + (gen ? 18 : 13);
+            if (*rest == '=' && rest[1])
+                profile_file = rest + 1;
+            else if (*rest) {
+                fprintf(stderr, "Unknown option: %s (use -fprofile-generate[=file] or -fprofile-use[=file])\n", argv[arg_idx]);
+                return 1;
+            }
+            profile_mode = gen ? PROFILE_GENERATE : PROFILE_USE;
+            arg_idx++;
+            continue;
+        }
         if (strncmp(argv[arg_idx], "-O", 2) == 0) {
             const char *lvl = argv[arg_idx] + 2;
             if (strcmp(lvl, "0") == 0)
@@ -1165,8 +1283,12 @@ int main(int argc, char **argv) {
           print_symbol_table();
           printf("Semantic analysis successful.\n");
 
+          if (opt_level == OPT_O2)
+              restructure_loop_nests(root);
+
           IRProgram *ir = ir_generate(root);
           if (ir) {
+            profile_prepare_program(ir);
             CompilerMetrics metrics = {0};
             if (want_metrics)
                 compiler_metrics_init(&metrics);
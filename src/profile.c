@@ -0,0 +1,145 @@
+/**
+ * profile.c - Profile-guided optimization: block numbering, counter
+ * insertion for -fprofile-generate and count loading for -fprofile-use.
+ *
+ * Profile file (little-endian 64-bit words, written by profile_runtime.s):
+ *   magic, checksum, counter count N, then N block counts.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "profile.h"
+
+#define PROFILE_MAGIC 0x50524f46ULL   /* "FORP" */
+
+ProfileMode profile_mode = PROFILE_NONE;
+const char *profile_file = PROFILE_DEFAULT_FILE;
+
+static int profile_block_total = 0;
+static unsigned long long profile_checksum = 0;
+static long long *profile_counts = NULL;   /* indexed by block number - 1 */
+
+static void checksum_mix(unsigned long long v) {
+    for (int i = 0; i < 8; i++) {
+        profile_checksum ^= (v >> (8 * i)) & 0xff;
+        profile_checksum *= 0x100000001b3ULL;
+    }
+}
+
+static void checksum_mix_str(const char *s) {
+    for (; *s; s++) checksum_mix((unsigned char)*s);
+}
+
+/* Same block boundaries as build_cfg(): a label starts a block, a branch,
+ * return or throw ends one. */
+static int ends_block(const IRInstr *instr) {
+    return instr->kind == IR_GOTO || instr->kind == IR_IF || instr->kind == IR_SWITCH ||
+           instr->kind == IR_RETURN || instr->kind == IR_TRY_BEGIN || instr->kind == IR_THROW;
+}
+
+static IRInstr *make_counter(int block, int line) {
+    IRInstr *c = calloc(1, sizeof(IRInstr));
+    c->kind = IR_PROFILE_COUNTER;
+    c->line = line;
+    c->prof_block = block;
+    return c;
+}
+
+static void number_function(IRFunc *f) {
+    int first = profile_block_total;
+    IRInstr *prev = NULL;
+    int leader = 1;
+    for (IRInstr *cur = f->instrs; cur; prev = cur, cur = cur->next) {
+        if (cur->kind == IR_LABEL) leader = 1;
+        if (leader) {
+            int block = ++profile_block_total;
+            if (profile_mode == PROFILE_GENERATE) {
+                IRInstr *c = make_counter(block, cur->line);
+                if (cur->kind == IR_LABEL) {
+                    c->next = cur->next;
+                    cur->next = c;
+                    cur = c;
+                } else {
+                    c->next = cur;
+                    if (prev) prev->next = c; else f->instrs = c;
+                }
+            } else {
+                cur->prof_block = block;
+            }
+        }
+        leader = ends_block(cur);
+    }
+    checksum_mix_str(f->name);
+    checksum_mix((unsigned long long)(profile_block_total - first));
+}
+
+static long long *read_profile(const char *path) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        fprintf(stderr, "warning: profile '%s' not found, compiling without it\n", path);
+        return NULL;
+    }
+    unsigned long long hdr[3];
+    long long *counts = NULL;
+    if (fread(hdr, sizeof(hdr[0]), 3, fp) != 3 || hdr[0] != PROFILE_MAGIC) {
+        fprintf(stderr, "warning: '%s' is not a profile, compiling without it\n", path);
+    } else if (hdr[1] != profile_checksum || hdr[2] != (unsigned long long)profile_block_total) {
+        fprintf(stderr, "warning: profile '%s' was recorded for different code "
+                        "(same source and -O level needed), compiling without it\n", path);
+    } else {
+        counts = calloc(profile_block_total ? profile_block_total : 1, sizeof(long long));
+        if (fread(counts, sizeof(long long), profile_block_total, fp) != (size_t)profile_block_total) {
+            fprintf(stderr, "warning: profile '%s' is truncated, compiling without it\n", path);
+            free(counts);
+            counts = NULL;
+        }
+    }
+    fclose(fp);
+    return counts;
+}
+
+void profile_prepare_program(IRProgram *prog) {
+    if (profile_mode == PROFILE_NONE || !prog) return;
+    profile_block_total = 0;
+    profile_checksum = 0xcbf29ce484222325ULL;
+    for (IRFunc *f = prog->funcs; f; f = f->next)
+        number_function(f);
+    checksum_mix((unsigned long long)profile_block_total);
+
+    if (profile_mode == PROFILE_USE)
+        profile_counts = read_profile(profile_file);
+}
+
+int profile_available(void) {
+    return profile_counts != NULL;
+}
+
+long long profile_block_count(const IRInstr *instr) {
+    if (!profile_counts || !instr || instr->prof_block <= 0 || instr->prof_block > profile_block_total)
+        return -1;
+    return profile_counts[instr->prof_block - 1];
+}
+
+void profile_emit_data(FILE *out) {
+    if (profile_mode != PROFILE_GENERATE) return;
+    fprintf(out, "  .data\n");
+    fprintf(out, "  .globl __prof_counters\n");
+    fprintf(out, "  .balign 8\n");
+    fprintf(out, "__prof_counters:\n");
+    fprintf(out, "  .zero %d\n", 8 * (profile_block_total ? profile_block_total : 1));
+    fprintf(out, "  .globl __prof_header\n");
+    fprintf(out, "__prof_header:\n");
+    fprintf(out, "  .dword 0x%llx\n", PROFILE_MAGIC);
+    fprintf(out, "  .dword 0x%llx\n", profile_checksum);
+    fprintf(out, "  .dword %d\n", profile_block_total);
+    fprintf(out, "  .globl __prof_path\n");
+    fprintf(out, "__prof_path:\n");
+    fprintf(out, "  .asciz \"");
+    for (const char *c = profile_file; *c; c++) {
+        if (*c == '"' || *c == '\\') fputc('\\', out);
+        fputc(*c, out);
+    }
+    fprintf(out, "\"\n");
+    fprintf(out, "  .text\n\n");
+}
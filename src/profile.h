@@ -0,0 +1,46 @@
+/**
+ * profile.h - Profile-guided optimization
+ * -fprofile-generate[=file]: count how often each IR basic block runs;
+ *     src/profile_runtime.s writes the counters to the file at exit.
+ * -fprofile-use[=file]: read those counts back and attach them to the
+ *     blocks of the same program (BasicBlock.count).
+ *
+ * Blocks are numbered on the IR straight out of ir_generate(), before any
+ * optimization, so both builds agree on the numbering as long as the
+ * source and the -O level match. A checksum over that numbering guards
+ * against stale profiles.
+ */
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdio.h>
+#include "ir.h"
+
+typedef enum {
+    PROFILE_NONE,
+    PROFILE_GENERATE,
+    PROFILE_USE
+} ProfileMode;
+
+#define PROFILE_DEFAULT_FILE "pgo.profile"
+
+extern ProfileMode profile_mode;
+extern const char *profile_file;
+
+/* Number the blocks of every function. With -fprofile-generate a counter
+ * increment is inserted at the top of each block; with -fprofile-use the
+ * block leaders are tagged and the counts are read from profile_file
+ * (a missing or mismatched file only draws a warning). */
+void profile_prepare_program(IRProgram *prog);
+
+/* Were counts loaded for this compilation? */
+int profile_available(void);
+
+/* Execution count of the original block `instr` leads, -1 if unknown. */
+long long profile_block_count(const IRInstr *instr);
+
+/* Counter table, checksum and output path for the instrumented binary. */
+void profile_emit_data(FILE *out);
+
+#endif /* PROFILE_H */
@@ -0,0 +1,106 @@
+  # Runtime for -fprofile-generate binaries.
+  # The compiler emits __prof_counters (one dword per IR block),
+  # __prof_header (magic, checksum, counter count) and __prof_path.
+  # __prof_dump runs at exit through .fini_array, adds the counts of an
+  # earlier run of the same program already in the file, and rewrites it.
+
+  .section .fini_array, "aw"
+  .balign 8
+  .dword __prof_dump
+
+  .text
+  .globl __prof_dump
+__prof_dump:
+  addi sp, sp, -64
+  sd ra, 56(sp)
+  sd s0, 48(sp)
+  sd s1, 40(sp)
+  sd s2, 32(sp)
+
+  # fd = openat(AT_FDCWD, __prof_path, O_RDWR | O_CREAT, 0644)
+  li a0, -100
+  la a1, __prof_path
+  li a2, 66
+  li a3, 420
+  li a7, 56
+  ecall
+  bltz a0, .Lprof_done
+  mv s0, a0
+
+  # An earlier profile of the same program: header must match ours.
+  mv a0, s0
+  mv a1, sp
+  li a2, 24
+  li a7, 63
+  ecall
+  li t0, 24
+  bne a0, t0, .Lprof_write
+  la t2, __prof_header
+  ld t0, 0(sp)
+  ld t1, 0(t2)
+  bne t0, t1, .Lprof_write
+  ld t0, 8(sp)
+  ld t1, 8(t2)
+  bne t0, t1, .Lprof_write
+  ld t0, 16(sp)
+  ld s2, 16(t2)
+  bne t0, s2, .Lprof_write
+
+  # Accumulate its counts, one dword at a time.
+  la s1, __prof_counters
+.Lprof_merge:
+  beqz s2, .Lprof_write
+  mv a0, s0
+  mv a1, sp
+  li a2, 8
+  li a7, 63
+  ecall
+  li t0, 8
+  bne a0, t0, .Lprof_write
+  ld t0, 0(sp)
+  ld t1, 0(s1)
+  add t1, t1, t0
+  sd t1, 0(s1)
+  addi s1, s1, 8
+  addi s2, s2, -1
+  j .Lprof_merge
+
+.Lprof_write:
+  # lseek(fd, 0, SEEK_SET)
+  mv a0, s0
+  li a1, 0
+  li a2, 0
+  li a7, 62
+  ecall
+  # write(fd, __prof_header, 24)
+  mv a0, s0
+  la a1, __prof_header
+  li a2, 24
+  li a7, 64
+  ecall
+  # write(fd, __prof_counters, 8 * count)
+  la t0, __prof_header
+  ld s2, 16(t0)
+  slli s2, s2, 3
+  mv a0, s0
+  la a1, __prof_counters
+  mv a2, s2
+  li a7, 64
+  ecall
+  # ftruncate(fd, 24 + 8 * count): drop the tail of a longer old file
+  mv a0, s0
+  addi a1, s2, 24
+  li a7, 46
+  ecall
+  # close(fd)
+  mv a0, s0
+  li a7, 57
+  ecall
+
+.Lprof_done:
+  ld ra, 56(sp)
+  ld s0, 48(sp)
+  ld s1, 40(sp)
+  ld s2, 32(sp)
+  addi sp, sp, 64
+  ret
@@ -17,6 +17,7 @@
 #include "reg_alloc.h"
 #include "ir_opt.h"
 #include "ir_sched.h"
+#include "profile.h"
 
 /* -----------------------------------------------------------------------
  * Physical register table
@@ -119,6 +120,10 @@ static int is_allocatable(const char *name, Scope *scope) {
 
     /* Skip variables whose address is taken (must stay on stack for correctness) */
     if (sym && sym->is_address_taken) return 0;
+    /* An array object is an address in the frame, never a value: the code
+       generator computes it from s0, and a spill reload would read the
+       first element instead. */
+    if (sym && sym->is_array && !sym->is_vla && sym->kind != SYM_PARAMETER) return 0;
 
     return 1;
 }
@@ -229,6 +234,7 @@ static InterferenceGraph *build_interference_graph(IRFunc *f, CFG *cfg, char **p
                 !is_persisted_spill(instr->result, persisted_spills, persisted_count)) {
                 
                 int def_idx = ig_get_or_add(ig, instr->result);
+                if (bb->count > 0) ig->nodes[def_idx].spill_cost += bb->count;
                 for (int j = 0; j < live_count; j++) {
                     if (strcmp(live[j], instr->result) == 0) continue;
                     int nb_idx = ig_get_or_add(ig, live[j]);
@@ -254,13 +260,20 @@ static InterferenceGraph *build_interference_graph(IRFunc *f, CFG *cfg, char **p
                 case IR_UNOP:          ops[nops++] = &instr->unop_src; break;
                 case IR_PARAM:         ops[nops++] = &instr->src; break;
                 case IR_RETURN:        ops[nops++] = &instr->src; break;
+                case IR_SWITCH:        ops[nops++] = &instr->src; break;
                 case IR_IF:            ops[nops++] = &instr->if_left;
                                        ops[nops++] = &instr->if_right; break;
+                case IR_SELECT:        ops[nops++] = &instr->if_left;
+                                       ops[nops++] = &instr->if_right;
+                                       ops[nops++] = &instr->left;
+                                       ops[nops++] = &instr->right; break;
                 case IR_LOAD:          ops[nops++] = &instr->base;
                                        ops[nops++] = &instr->index; break;
                 case IR_STORE:         ops[nops++] = &instr->base;
                                        ops[nops++] = &instr->index;
                                        ops[nops++] = &instr->store_val; break;
+                case IR_PREFETCH:      ops[nops++] = &instr->base;
+                                       ops[nops++] = &instr->index; break;
                 case IR_CALL_INDIRECT: ops[nops++] = &instr->base; break;
                 case IR_ALLOCA:        ops[nops++] = &instr->src; break;
                 case IR_THROW:         ops[nops++] = &instr->src; break;
@@ -271,7 +284,8 @@ static InterferenceGraph *build_interference_graph(IRFunc *f, CFG *cfg, char **p
                 if (!is_allocatable(ops[j]->name, fsym ? fsym->scope : NULL)) continue;
                 if (is_persisted_spill(ops[j]->name, persisted_spills, persisted_count)) continue;
 
-                ig_get_or_add(ig, ops[j]->name);
+                int use_idx = ig_get_or_add(ig, ops[j]->name);
+                if (bb->count > 0) ig->nodes[use_idx].spill_cost += bb->count;
                 /* Add to live set if not already present */
                 int found = 0;
                 for (int k = 0; k < live_count; k++)
@@ -335,10 +349,19 @@ static int *simplify(InterferenceGraph *ig, int *stack_size) {
 
         if (found == -1) {
             /* All remaining nodes have degree >= K — must spill.
-             * Heuristic: choose highest-degree node (most constrained). */
+             * Heuristic: choose highest-degree node (most constrained).
+             * With a profile, the cheapest spill per neighbour freed:
+             * lowest executed defs+uses over degree. */
             int best = -1, best_deg = -1;
             for (int i = 0; i < n; i++) {
-                if (!ig->nodes[i].removed && deg[i] > best_deg) {
+                if (ig->nodes[i].removed) continue;
+                if (best != -1 && profile_available()) {
+                    double cost = (double)ig->nodes[i].spill_cost * best_deg;
+                    double best_cost = (double)ig->nodes[best].spill_cost * deg[i];
+                    if (cost < best_cost || (cost == best_cost && deg[i] > best_deg)) {
+                        best_deg = deg[i]; best = i;
+                    }
+                } else if (deg[i] > best_deg) {
                     best_deg = deg[i]; best = i;
                 }
             }
@@ -432,13 +455,22 @@ static int select_colors(InterferenceGraph *ig,
  *   - At each def of v: replace result with t_new,
  *     insert  store(s0, O) := t_new  after the instruction.
  *
- * We generate new temporaries using ir_new_temp(). Because we insert these
+ * We generate new temporaries using new_spill_temp(). Because we insert these
  * fresh temps, they will have no interferences (only short live ranges) and
  * almost certainly get registers in the next round.
  *
  * Returns 1 if any rewrite was performed (triggering another allocation round).
  * ----------------------------------------------------------------------- */
 
+/* Fresh temp for a spill load/store. ir_new_temp() restarts per function
+ * during IR generation, so its t<N> names may already be in use here. */
+static char *new_spill_temp(void) {
+    static int spill_temp_counter = 0;
+    char *buf = malloc(32);
+    snprintf(buf, 32, "__sp%d", spill_temp_counter++);
+    return buf;
+}
+
 /* Helper: is this operand a reference to var `name`? */
 static int op_is(IROperand *op, const char *name) {
     return op && !op->is_const && op->name && strcmp(op->name, name) == 0;
@@ -495,13 +527,20 @@ static int rewrite_spills(IRFunc *f, InterferenceGraph *ig) {
                 case IR_UNOP:          use_ops[n_use++] = &instr->unop_src; break;
                 case IR_PARAM:         use_ops[n_use++] = &instr->src; break;
                 case IR_RETURN:        use_ops[n_use++] = &instr->src; break;
+                case IR_SWITCH:        use_ops[n_use++] = &instr->src; break;
                 case IR_IF:            use_ops[n_use++] = &instr->if_left;
                                        use_ops[n_use++] = &instr->if_right; break;
+                case IR_SELECT:        use_ops[n_use++] = &instr->if_left;
+                                       use_ops[n_use++] = &instr->if_right;
+                                       use_ops[n_use++] = &instr->left;
+                                       use_ops[n_use++] = &instr->right; break;
                 case IR_LOAD:          use_ops[n_use++] = &instr->base;
                                        use_ops[n_use++] = &instr->index; break;
                 case IR_STORE:         use_ops[n_use++] = &instr->base;
                                        use_ops[n_use++] = &instr->index;
                                        use_ops[n_use++] = &instr->store_val; break;
+                case IR_PREFETCH:      use_ops[n_use++] = &instr->base;
+                                       use_ops[n_use++] = &instr->index; break;
                 case IR_CALL_INDIRECT: use_ops[n_use++] = &instr->base; break;
                 case IR_ALLOCA:        use_ops[n_use++] = &instr->src; break;
                 default: break;
@@ -511,7 +550,7 @@ static int rewrite_spills(IRFunc *f, InterferenceGraph *ig) {
                 if (!op_is(use_ops[u], sname)) continue;
 
                 /* Insert:  t_new := load(s0, soff)  before current instr */
-                char *t_new = ir_new_temp();
+                char *t_new = new_spill_temp();
                 IRInstr *load_instr = ir_make_assign(t_new, ir_op_name(strdup(sname)), instr->line);
 
                 /* Insert before instr */
@@ -530,7 +569,7 @@ static int rewrite_spills(IRFunc *f, InterferenceGraph *ig) {
             /* --- Handle def of spilled variable --- */
             if (instr->result && strcmp(instr->result, sname) == 0) {
                 /* Replace result with a fresh temp, then store to spill slot */
-                char *t_def = ir_new_temp();
+                char *t_def = new_spill_temp();
                 free(instr->result);
                 instr->result = strdup(t_def);
 
@@ -597,8 +636,14 @@ static RegAllocResult *build_result(InterferenceGraph *ig, const char *func_name
  * Iterates build→simplify→select→spill-rewrite until stable.
  * ----------------------------------------------------------------------- */
 static RegAllocResult *allocate_function(IRFunc *f) {
-    /* Spill slot counter: starts at -512 (below the fixed frame area) */
+    /* Spill slot counter: starts at -512 (below the fixed frame area), or
+       below the locals and every callee-saved slot when they reach further. */
     int spill_offset_base = -512;
+    Symbol *fsym = lookup(f->name);
+    if (fsym) {
+        int fixed = 16 + 8 * (RA_NUM_REGS - RA_FIRST_CALLEE_SAVED) + fsym->local_vars_size;
+        if (-fixed < spill_offset_base) spill_offset_base = -((fixed + 7) & ~7);
+    }
 
     InterferenceGraph *ig   = NULL;
     RegAllocResult    *res  = NULL;
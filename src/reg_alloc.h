@@ -68,6 +68,7 @@ typedef struct IGNode {
     /* Bookkeeping during simplify/select */
     int    removed;       /* 1 if already pushed onto the simplify stack  */
     int    interferes_with_caller_saved; /* 1 if live across a call */
+    long long spill_cost; /* profiled executions of its defs and uses (-fprofile-use) */
 } IGNode;
 
 /* -----------------------------------------------------------------------
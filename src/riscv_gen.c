@@ -13,12 +13,15 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 #include "ir.h"
 #include "ast.h"
 #include "symbol_table.h"
 #include "semantic.h"
 #include "reg_alloc.h"
 #include "riscv_gen.h"
+#include "profile.h"
+#include "y.tab.h"
 
 /* -----------------------------------------------------------------------
  * Stack-slot fallback (kept from original implementation for spilled vars
@@ -106,6 +109,10 @@ static const char *get_reg(const char *name) {
  *   2. vtable ref → la dst, vtable_NAME
  *   3. Variable with register assigned → mv dst, phys_reg  (if dst != phys_reg)
  *   4. Variable spilled / not allocated → lw dst, offset(s0)
+ *
+ * A slot beyond the 12-bit offset range is addressed through dst itself,
+ * so no other register changes: emit_select keeps its mask in t2 while
+ * it loads the arms.
  * ----------------------------------------------------------------------- */
 static int get_operand_size(const char *name) {
     if (!name) return 4;
@@ -145,12 +152,12 @@ static void load_operand(FILE *out, IROperand op, const char *dst_reg) {
             else
                 fprintf(out, "  lw %s, %d(s0)\n", dst_reg, offset);
         } else {
-            fprintf(out, "  li t2, %d\n", offset);
-            fprintf(out, "  add t2, s0, t2\n");
+            fprintf(out, "  li %s, %d\n", dst_reg, offset);
+            fprintf(out, "  add %s, s0, %s\n", dst_reg, dst_reg);
             if (size == 8)
-                fprintf(out, "  ld %s, 0(t2)\n", dst_reg);
+                fprintf(out, "  ld %s, 0(%s)\n", dst_reg, dst_reg);
             else
-                fprintf(out, "  lw %s, 0(t2)\n", dst_reg);
+                fprintf(out, "  lw %s, 0(%s)\n", dst_reg, dst_reg);
         }
     }
 }
@@ -159,7 +166,8 @@ static void load_operand(FILE *out, IROperand op, const char *dst_reg) {
  * Store a result (already computed in src_reg) to its destination.
  *
  * If the result variable has a physical register, emit mv dest_phys, src_reg.
- * If spilled, emit sw or sd src_reg, offset(s0).
+ * If spilled, emit sw or sd src_reg, offset(s0). A slot beyond the 12-bit
+ * offset range is addressed through t2, or t1 when the value is in t2.
  */
 static void store_result(FILE *out, const char *result_name, const char *src_reg) {
     if (!result_name) return;
@@ -177,12 +185,13 @@ static void store_result(FILE *out, const char *result_name, const char *src_reg
             else
                 fprintf(out, "  sw %s, %d(s0)\n", src_reg, offset);
         } else {
-            fprintf(out, "  li t2, %d\n", offset);
-            fprintf(out, "  add t2, s0, t2\n");
+            const char *addr = strcmp(src_reg, "t2") == 0 ? "t1" : "t2";
+            fprintf(out, "  li %s, %d\n", addr, offset);
+            fprintf(out, "  add %s, s0, %s\n", addr, addr);
             if (size == 8)
-                fprintf(out, "  sd %s, 0(t2)\n", src_reg);
+                fprintf(out, "  sd %s, 0(%s)\n", src_reg, addr);
             else
-                fprintf(out, "  sw %s, 0(t2)\n", src_reg);
+                fprintf(out, "  sw %s, 0(%s)\n", src_reg, addr);
         }
     }
 }
@@ -222,8 +231,10 @@ static void load_address(FILE *out, IROperand op, const char *dst_reg) {
                     fprintf(out, "  lw %s, 0(t2)\n", dst_reg);
             }
         }
-    } else if (!sym && get_reg(op.name)) {
-        fprintf(out, "  mv %s, %s\n", dst_reg, get_reg(op.name));
+    } else if (!sym) {
+        /* Compiler temps used as a base (e.g. strength-reduced IV pointers)
+           hold the address itself, in a register or in their spill slot. */
+        load_operand(out, op, dst_reg);
     } else {
         if (off >= -2048 && off <= 2047) {
             fprintf(out, "  addi %s, s0, %d\n", dst_reg, off);
@@ -234,6 +245,463 @@ static void load_address(FILE *out, IROperand op, const char *dst_reg) {
     }
 }
 
+static int emit_mul_by_const(FILE *out, const char *dst, const char *x, const char *tmp, long long c);
+
+/*
+ * Compute the address of base[index] (scaled) into t0, using t1/t2 as
+ * scratch. A constant index that fits the 12-bit displacement is not added
+ * in; it is returned for the caller's load/store to use as its offset.
+ * With Zba a shift of 1-3 in the scale folds into the add (shNadd).
+ */
+static int emit_element_address(FILE *out, IRInstr *instr) {
+    int scale = instr->scale > 0 ? instr->scale : 1;
+    if (instr->index.is_const) {
+        long disp = (long)instr->index.const_val * scale;
+        if (disp >= -2048 && disp <= 2047) {
+            load_address(out, instr->base, "t0");
+            return (int)disp;
+        }
+    }
+    int shift = 0;
+    while (!((scale >> shift) & 1)) shift++;
+    int fuse = riscv_ext_zba && shift >= 1 && shift <= 3;
+    long long mult = fuse ? (scale >> shift) : scale;
+
+    if (scale >> shift > 1) {
+        /* Struct elements: scale the index before the base is loaded, since
+           loading the base may use t2. */
+        load_operand(out, instr->index, "t2");
+        if (!emit_mul_by_const(out, "t1", "t2", "t0", mult))
+            fprintf(out, "  li t1, %lld\n  mul t1, t2, t1\n", mult);
+        load_address(out, instr->base, "t0");
+    } else {
+        load_address(out, instr->base, "t0");
+        load_operand(out, instr->index, "t1");
+        if (shift > 0 && !fuse)
+            fprintf(out, "  slli t1, t1, %d\n", shift);
+    }
+    if (fuse)
+        fprintf(out, "  sh%dadd t0, t1, t0\n", shift);
+    else
+        fprintf(out, "  add t0, t0, t1\n");
+    return 0;
+}
+
+/* -----------------------------------------------------------------------
+ * Branch-free select
+ * ----------------------------------------------------------------------- */
+
+int riscv_ext_zicond = 0;
+
+/*
+ * result := (l relop r) ? a : b without a branch. The condition becomes a
+ * 0/1 bit in t2; relations that need an extra xori are computed inverted
+ * and the arms swapped instead. The arms are then combined either with
+ * Zicond (czero.eqz/czero.nez + or) or with the mask identity
+ * b ^ ((a ^ b) & -c). min, max and abs after if-conversion all land here.
+ */
+static void emit_select(FILE *out, IRInstr *instr) {
+    IROperand if_true = instr->left, if_false = instr->right;
+    load_operand(out, instr->if_left,  "t0");
+    load_operand(out, instr->if_right, "t1");
+    switch (instr->relop) {
+        case IR_LT: fprintf(out, "  slt t2, t0, t1\n"); break;
+        case IR_GT: fprintf(out, "  slt t2, t1, t0\n"); break;
+        case IR_LE: fprintf(out, "  slt t2, t1, t0\n"); if_true = instr->right; if_false = instr->left; break;
+        case IR_GE: fprintf(out, "  slt t2, t0, t1\n"); if_true = instr->right; if_false = instr->left; break;
+        case IR_NE: fprintf(out, "  sub t2, t0, t1\n  snez t2, t2\n"); break;
+        case IR_EQ: fprintf(out, "  sub t2, t0, t1\n  snez t2, t2\n"); if_true = instr->right; if_false = instr->left; break;
+        default: break;
+    }
+    if (riscv_ext_zicond) {
+        load_operand(out, if_true, "t0");
+        fprintf(out, "  czero.eqz t0, t0, t2\n");
+        load_operand(out, if_false, "t1");
+        fprintf(out, "  czero.nez t1, t1, t2\n");
+        fprintf(out, "  or t2, t0, t1\n");
+    } else {
+        fprintf(out, "  neg t2, t2\n");
+        load_operand(out, if_true, "t0");
+        load_operand(out, if_false, "t1");
+        fprintf(out, "  xor t0, t0, t1\n");
+        fprintf(out, "  and t0, t0, t2\n");
+        fprintf(out, "  xor t2, t1, t0\n");
+    }
+    store_result(out, instr->result, "t2");
+}
+
+/* -----------------------------------------------------------------------
+ * Division by constants
+ *
+ * div/rem take tens of cycles on most RISC-V cores; by a known divisor
+ * they become a multiply-high and a few shifts (Granlund-Montgomery, as
+ * in Hacker's Delight 10-4). Values live sign-extended in 64-bit
+ * registers and the generic path divides with the 64-bit div, so the
+ * magic numbers are computed for 64 bits: the sequences agree with div
+ * on every register value, and in particular on all 32-bit ints.
+ * Remainders are x - q * d, with the sign of the dividend as C requires.
+ * ----------------------------------------------------------------------- */
+
+/* Smallest m, s with floor(m * x / 2^(64+s)) == x / d (rounded toward 0
+   after the sign fix-up) for all 64-bit x; |d| >= 2. */
+static void signed_div_magic(long long d, long long *magic, int *shift) {
+    const unsigned long long two63 = 1ULL << 63;
+    unsigned long long ad = d < 0 ? -(unsigned long long)d : (unsigned long long)d;
+    unsigned long long t = two63 + ((unsigned long long)d >> 63);
+    unsigned long long anc = t - 1 - t % ad;           /* |nc| */
+    unsigned long long q1 = two63 / anc, r1 = two63 - q1 * anc;
+    unsigned long long q2 = two63 / ad,  r2 = two63 - q2 * ad;
+    unsigned long long delta;
+    int p = 63;
+    do {
+        p++;
+        q1 *= 2; r1 *= 2;
+        if (r1 >= anc) { q1++; r1 -= anc; }
+        q2 *= 2; r2 *= 2;
+        if (r2 >= ad) { q2++; r2 -= ad; }
+        delta = ad - r2;
+    } while (q1 < delta || (q1 == delta && r1 == 0));
+    *magic = (long long)(q2 + 1);
+    if (d < 0) *magic = -*magic;
+    *shift = p - 64;
+}
+
+static int log2_exact(long long v) {
+    int k = 0;
+    if (v <= 0 || (v & (v - 1))) return -1;
+    while ((1LL << k) != v) k++;
+    return k;
+}
+
+/*
+ * t2 := t0 / d or t0 % d for a constant d outside {-1, 0, 1}; clobbers t1.
+ * Powers of two round toward zero by adding |d| - 1 to negative dividends
+ * before the arithmetic shift (or the mask, for %).
+ */
+static void emit_div_by_const(FILE *out, int op, long long d) {
+    long long ad = d < 0 ? -d : d;
+    int k = log2_exact(ad);
+
+    if (k > 0) {
+        fprintf(out, "  srai t1, t0, 63\n");
+        fprintf(out, "  srli t1, t1, %d\n", 64 - k);
+        fprintf(out, "  add t1, t0, t1\n");
+        if (op == '/') {
+            fprintf(out, "  srai t2, t1, %d\n", k);
+            if (d < 0) fprintf(out, "  neg t2, t2\n");
+        } else {
+            if (ad <= 2048) {
+                fprintf(out, "  andi t1, t1, %lld\n", -ad);
+            } else {
+                fprintf(out, "  li t2, %lld\n", -ad);
+                fprintf(out, "  and t1, t1, t2\n");
+            }
+            fprintf(out, "  sub t2, t0, t1\n");
+        }
+        return;
+    }
+
+    long long magic;
+    int shift;
+    signed_div_magic(d, &magic, &shift);
+    fprintf(out, "  li t1, %lld\n", magic);
+    fprintf(out, "  mulh t2, t0, t1\n");
+    if (d > 0 && magic < 0) fprintf(out, "  add t2, t2, t0\n");
+    if (d < 0 && magic > 0) fprintf(out, "  sub t2, t2, t0\n");
+    if (shift > 0) fprintf(out, "  srai t2, t2, %d\n", shift);
+    fprintf(out, "  srli t1, t2, 63\n");
+    fprintf(out, "  add t2, t2, t1\n");
+    if (op == '%') {
+        fprintf(out, "  li t1, %lld\n", d);
+        fprintf(out, "  mul t1, t2, t1\n");
+        fprintf(out, "  sub t2, t0, t1\n");
+    }
+}
+
+/* -----------------------------------------------------------------------
+ * Multiplication by constants
+ *
+ * x * c becomes a chain of shifts and adds (sh1add..sh3add with Zba)
+ * when the chain's latency does not exceed the core's multiply latency.
+ * Ties go to the chain: it needs no li for the constant and issues on
+ * any ALU. The chain is found by an iterative-deepening search backwards
+ * from c: an even c is a shift of c >> tz, an odd one adds x to or
+ * subtracts it from a neighbour, or applies a (2^k +- 1) factor of c as
+ * (t << k) +- t. Every step depends on the previous one, so the chain's
+ * latency is the sum of its step costs.
+ * ----------------------------------------------------------------------- */
+
+int riscv_ext_zba = 0;
+
+typedef struct {
+    const char *name;
+    int mul_latency;
+} RiscvTuning;
+
+static const RiscvTuning riscv_tunings[] = {
+    { "generic",         3 },
+    { "sifive-7-series", 3 },
+    { "rocket",          8 },   /* iterative multiplier, 8 bits a cycle */
+};
+
+static const RiscvTuning *cur_tune = &riscv_tunings[0];
+
+int riscv_set_tune(const char *name) {
+    for (size_t i = 0; i < sizeof(riscv_tunings) / sizeof(riscv_tunings[0]); i++) {
+        if (strcmp(riscv_tunings[i].name, name) == 0) {
+            cur_tune = &riscv_tunings[i];
+            return 1;
+        }
+    }
+    return 0;
+}
+
+typedef enum {
+    MC_SHL,        /* t = t << k       */
+    MC_ADD_X,      /* t = t + x        */
+    MC_SUB_X,      /* t = t - x        */
+    MC_RSUB_X,     /* t = x - t        */
+    MC_NEG,        /* t = -t           */
+    MC_ADD_SHL,    /* t = (t << k) + t */
+    MC_SUB_SHL,    /* t = (t << k) - t */
+    MC_SHADD_X,    /* t = (t << k) + x, Zba */
+    MC_X_SHADD     /* t = (x << k) + t, Zba */
+} MulStepKind;
+
+typedef struct {
+    MulStepKind kind;
+    int k;
+} MulStep;
+
+#define MUL_CHAIN_MAX_COST 8
+
+static int mul_step_cost(MulStepKind kind, int k) {
+    if (kind == MC_ADD_SHL) return (riscv_ext_zba && k <= 3) ? 1 : 2;
+    if (kind == MC_SUB_SHL) return 2;
+    return 1;
+}
+
+/* Find steps computing c * x from x within budget; *n receives their count. */
+static int mul_chain_search(long long c, int budget, MulStep *steps, int *n);
+
+static int mul_chain_try(long long m, int budget, MulStepKind kind, int k, MulStep *steps, int *n) {
+    budget -= mul_step_cost(kind, k);
+    if (budget < 0 || !mul_chain_search(m, budget, steps, n)) return 0;
+    steps[*n].kind = kind;
+    steps[*n].k = k;
+    (*n)++;
+    return 1;
+}
+
+static int mul_chain_search(long long c, int budget, MulStep *steps, int *n) {
+    if (c == 1) { *n = 0; return 1; }
+    if (budget <= 0 || c == 0 || c > (1LL << 40) || c < -(1LL << 40)) return 0;
+    if (c < 0)
+        return mul_chain_try(-c, budget, MC_NEG, 0, steps, n) ||
+               mul_chain_try(1 - c, budget, MC_RSUB_X, 0, steps, n);
+    if (!(c & 1)) {
+        int k = 0;
+        while (!((c >> k) & 1)) k++;
+        return mul_chain_try(c >> k, budget, MC_SHL, k, steps, n);
+    }
+    if (mul_chain_try(c - 1, budget, MC_ADD_X, 0, steps, n)) return 1;
+    if (mul_chain_try(c + 1, budget, MC_SUB_X, 0, steps, n)) return 1;
+    for (int k = 1; k < 32; k++) {
+        long long f = (1LL << k) + 1;
+        if (f > c) break;
+        if (c % f == 0 && mul_chain_try(c / f, budget, MC_ADD_SHL, k, steps, n)) return 1;
+        f = (1LL << k) - 1;
+        if (k > 1 && c % f == 0 && mul_chain_try(c / f, budget, MC_SUB_SHL, k, steps, n)) return 1;
+    }
+    if (riscv_ext_zba) {
+        for (int k = 1; k <= 3; k++) {
+            if (((c - 1) & ((1LL << k) - 1)) == 0 &&
+                mul_chain_try((c - 1) >> k, budget, MC_SHADD_X, k, steps, n)) return 1;
+            if (c > (1LL << k) && mul_chain_try(c - (1LL << k), budget, MC_X_SHADD, k, steps, n)) return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * dst := x * c with a shift/add chain if the cost model prefers it;
+ * returns 0 (emitting nothing) if li + mul is the better choice.
+ * dst, x and tmp must be distinct registers; x is preserved.
+ */
+static int emit_mul_by_const(FILE *out, const char *dst, const char *x, const char *tmp, long long c) {
+    MulStep steps[MUL_CHAIN_MAX_COST];
+    int n = 0;
+    int found = 0;
+    int max_cost = cur_tune->mul_latency < MUL_CHAIN_MAX_COST ? cur_tune->mul_latency : MUL_CHAIN_MAX_COST;
+    for (int budget = 0; budget <= max_cost && !found; budget++)
+        found = mul_chain_search(c, budget, steps, &n);
+    if (!found) return 0;
+
+    const char *t = x;
+    for (int i = 0; i < n; i++) {
+        int k = steps[i].k;
+        switch (steps[i].kind) {
+            case MC_SHL:    fprintf(out, "  slli %s, %s, %d\n", dst, t, k); break;
+            case MC_ADD_X:  fprintf(out, "  add %s, %s, %s\n", dst, t, x); break;
+            case MC_SUB_X:  fprintf(out, "  sub %s, %s, %s\n", dst, t, x); break;
+            case MC_RSUB_X: fprintf(out, "  sub %s, %s, %s\n", dst, x, t); break;
+            case MC_NEG:    fprintf(out, "  neg %s, %s\n", dst, t); break;
+            case MC_ADD_SHL:
+                if (riscv_ext_zba && k <= 3) {
+                    fprintf(out, "  sh%dadd %s, %s, %s\n", k, dst, t, t);
+                } else {
+                    fprintf(out, "  slli %s, %s, %d\n", tmp, t, k);
+                    fprintf(out, "  add %s, %s, %s\n", dst, tmp, t);
+                }
+                break;
+            case MC_SUB_SHL:
+                fprintf(out, "  slli %s, %s, %d\n", tmp, t, k);
+                fprintf(out, "  sub %s, %s, %s\n", dst, tmp, t);
+                break;
+            case MC_SHADD_X: fprintf(out, "  sh%dadd %s, %s, %s\n", k, dst, t, x); break;
+            case MC_X_SHADD: fprintf(out, "  sh%dadd %s, %s, %s\n", k, dst, x, t); break;
+        }
+        t = dst;
+    }
+    if (n == 0) fprintf(out, "  mv %s, %s\n", dst, x);
+    return 1;
+}
+
+/* -----------------------------------------------------------------------
+ * Multiway branch (IR_SWITCH)
+ *
+ * The sorted case values are split into clusters: runs dense enough for a
+ * bounds-checked jump table in .rodata, and single cases. A balanced
+ * binary tree of signed compares on the cluster boundaries picks the
+ * cluster; a few single cases are just tested in a row. A dense switch is
+ * therefore one range check and an indirect jump, a sparse one costs
+ * log2(n) compares, and mixed ones get both.
+ * ----------------------------------------------------------------------- */
+
+#define SWITCH_TABLE_MIN_CASES   4
+#define SWITCH_TABLE_MIN_DENSITY 40    /* percent of table slots that are cases */
+#define SWITCH_TABLE_MAX_SLOTS   4096
+#define SWITCH_LINEAR_MAX        3
+
+typedef struct {
+    int val;
+    const char *label;
+} SwitchCase;
+
+typedef struct {
+    int first, count;   /* slice of the sorted cases */
+    int is_table;
+} SwitchCluster;
+
+static int switch_label_counter = 0;
+
+static int cmp_switch_case(const void *a, const void *b) {
+    int x = ((const SwitchCase *)a)->val, y = ((const SwitchCase *)b)->val;
+    return (x > y) - (x < y);
+}
+
+/* Greedy left-to-right clustering: from each case, take the longest run
+ * that still fills enough of its table. */
+static int cluster_switch_cases(SwitchCase *cases, int n, SwitchCluster *out) {
+    int nc = 0;
+    for (int i = 0; i < n; ) {
+        int best = i;
+        for (int j = i + SWITCH_TABLE_MIN_CASES - 1; j < n; j++) {
+            long slots = (long)cases[j].val - cases[i].val + 1;
+            if (slots > SWITCH_TABLE_MAX_SLOTS) break;
+            if ((long)(j - i + 1) * 100 >= slots * SWITCH_TABLE_MIN_DENSITY) best = j;
+        }
+        out[nc].first = i;
+        out[nc].count = best - i + 1;
+        out[nc].is_table = best > i;
+        nc++;
+        i = best + 1;
+    }
+    return nc;
+}
+
+/* Discriminant in t0. Leaves through a jump in every case. */
+static void emit_jump_table(FILE *out, SwitchCase *cases, SwitchCluster *c, const char *dflt) {
+    int lo = cases[c->first].val;
+    int hi = cases[c->first + c->count - 1].val;
+    int id = switch_label_counter++;
+    const char *idx = "t0";
+    if (lo != 0) {
+        if (lo >= -2047 && lo <= 2048) {
+            fprintf(out, "  addi t1, t0, %d\n", -lo);
+        } else {
+            fprintf(out, "  li t1, %d\n", lo);
+            fprintf(out, "  sub t1, t0, t1\n");
+        }
+        idx = "t1";
+    }
+    /* One unsigned compare rejects values on both sides of the table. */
+    fprintf(out, "  li t2, %ld\n", (long)hi - lo + 1);
+    fprintf(out, "  bgeu %s, t2, %s\n", idx, dflt);
+    fprintf(out, "  slli t1, %s, 3\n", idx);
+    fprintf(out, "  la t2, .LJT%d\n", id);
+    fprintf(out, "  add t2, t2, t1\n");
+    fprintf(out, "  ld t2, 0(t2)\n");
+    fprintf(out, "  jr t2\n");
+    fprintf(out, "  .section .rodata\n");
+    fprintf(out, "  .balign 8\n");
+    fprintf(out, ".LJT%d:\n", id);
+    int k = c->first;
+    for (long v = lo; v <= hi; v++) {
+        if (cases[k].val == v) fprintf(out, "  .dword %s\n", cases[k++].label);
+        else                   fprintf(out, "  .dword %s\n", dflt);
+    }
+    fprintf(out, "  .text\n");
+}
+
+/* t1_pivot: the first cluster's value is already in t1 (right after a split). */
+static void emit_switch_tree(FILE *out, SwitchCase *cases, SwitchCluster *cl, int lo, int hi,
+                             const char *dflt, int t1_pivot) {
+    int singles = 1;
+    for (int i = lo; i <= hi; i++) singles &= !cl[i].is_table;
+    if (singles && hi - lo + 1 <= SWITCH_LINEAR_MAX) {
+        for (int i = lo; i <= hi; i++) {
+            if (!(i == lo && t1_pivot))
+                fprintf(out, "  li t1, %d\n", cases[cl[i].first].val);
+            fprintf(out, "  beq t0, t1, %s\n", cases[cl[i].first].label);
+        }
+        fprintf(out, "  j %s\n", dflt);
+        return;
+    }
+    if (lo == hi) {
+        emit_jump_table(out, cases, &cl[lo], dflt);
+        return;
+    }
+    int mid = (lo + hi + 1) / 2;
+    int id = switch_label_counter++;
+    fprintf(out, "  li t1, %d\n", cases[cl[mid].first].val);
+    fprintf(out, "  blt t0, t1, .Lsw%d\n", id);
+    emit_switch_tree(out, cases, cl, mid, hi, dflt, 1);
+    fprintf(out, ".Lsw%d:\n", id);
+    emit_switch_tree(out, cases, cl, lo, mid - 1, dflt, 0);
+}
+
+static void emit_switch(FILE *out, IRInstr *instr) {
+    int n = instr->case_count;
+    SwitchCase *cases = malloc(sizeof(SwitchCase) * (n > 0 ? n : 1));
+    SwitchCluster *clusters = malloc(sizeof(SwitchCluster) * (n > 0 ? n : 1));
+    for (int i = 0; i < n; i++) {
+        cases[i].val = instr->case_vals[i];
+        cases[i].label = instr->case_labels[i];
+    }
+    qsort(cases, n, sizeof(SwitchCase), cmp_switch_case);
+
+    load_operand(out, instr->src, "t0");
+    if (n == 0) {
+        fprintf(out, "  j %s\n", instr->label);
+    } else {
+        int nc = cluster_switch_cases(cases, n, clusters);
+        emit_switch_tree(out, cases, clusters, 0, nc - 1, instr->label, 0);
+    }
+    free(clusters);
+    free(cases);
+}
+
 /* -----------------------------------------------------------------------
  * Prologue / Epilogue helpers
  * ----------------------------------------------------------------------- */
@@ -337,6 +805,387 @@ static int has_tail_calls(IRFunc *func) {
     return 0;
 }
 
+/* -----------------------------------------------------------------------
+ * Vector kernels (-march=rv64gcv)
+ *
+ * A VecKernel (see ir.h) becomes a leaf function, a0 = i, a1 = end and
+ * its other params in a2..a7:
+ *
+ *         sub t3, a1, a0                elements left
+ *         blez t3, done
+ *     loop:
+ *         vsetvli t0, t3, e32, mN, ta, ma
+ *         slli t1, a0, 2                byte offset of element i
+ *         body: vle32.v, v<op>.vv/.vx/.vi, vse32.v on register groups
+ *         add a0, a0, t0
+ *         sub t3, t3, t0
+ *         bnez t3, loop
+ *     done:
+ *         ret
+ *
+ * Each value of the body gets a register group slot by a linear scan
+ * over the body, freed after its last use. LMUL is then the largest of
+ * 8, 4, 2, 1 for which the slots fit; group 0 is left for the scalar of
+ * a reduction. A reduction keeps per-lane partial sums in its own group
+ * under a tail-undisturbed policy, so a short last strip leaves the other
+ * lanes alone, and folds them with vredsum.vs at the end. The code does
+ * not depend on VLEN.
+ * ----------------------------------------------------------------------- */
+
+int riscv_ext_v = 0;
+
+int riscv_set_march(const char *arch) {
+    if (strncmp(arch, "rv64gc", 6) != 0) return 0;
+    const char *p = arch + 6;
+    int v = 0, zba = 0, zicond = 0;
+    if (*p == 'v') { v = 1; p++; }
+    while (*p) {
+        if (strncmp(p, "_zba", 4) == 0 && (p[4] == '_' || !p[4])) { zba = 1; p += 4; }
+        else if (strncmp(p, "_zicond", 7) == 0 && (p[7] == '_' || !p[7])) { zicond = 1; p += 7; }
+        else return 0;
+    }
+    riscv_ext_v = v;
+    riscv_ext_zba |= zba;
+    riscv_ext_zicond |= zicond;
+    return 1;
+}
+
+#define VEC_SLOTS 31
+
+typedef struct {
+    char kind;      /* 'v' vector slot, 's' scalar param, 'c' constant */
+    int n;          /* slot, param index or value */
+} VecOperand;
+
+typedef struct {
+    VecKernel *k;
+    IRInstr **body;
+    int count;
+    int *slot;      /* result slot of each body instruction, -1 if none */
+    int *scratch;   /* slot a scalar operand is splatted into, -1 if none */
+    int *last_use;  /* last body position reading the result as a value */
+    int *index_def; /* result is i + k, used only as an index */
+    int acc_slot, iv_slot;
+    int lmul;
+} VecGen;
+
+static int vec_param_index(VecKernel *k, const char *name) {
+    for (int i = 0; i < k->param_count; i++)
+        if (strcmp(k->params[i], name) == 0) return i;
+    return -1;
+}
+
+static int vec_same_name(IROperand *op, const char *name) {
+    return !op->is_const && op->name && name && strcmp(op->name, name) == 0;
+}
+
+/* Position of the body instruction whose result `op` reads at `pos`. */
+static int vec_reaching_def(VecGen *g, IROperand *op, int pos) {
+    if (op->is_const || !op->name) return -1;
+    for (int j = pos - 1; j >= 0; j--)
+        if (g->body[j]->result && strcmp(g->body[j]->result, op->name) == 0) return j;
+    return -1;
+}
+
+static VecOperand vec_operand(VecGen *g, IROperand *op, int pos) {
+    VecOperand r = { 'c', op->const_val };
+    if (op->is_const || !op->name) return r;
+    if (strcmp(op->name, g->k->ivar) == 0) {
+        r.kind = 'v';
+        r.n = g->iv_slot;
+        return r;
+    }
+    int d = vec_reaching_def(g, op, pos);
+    if (d >= 0) {
+        r.kind = 'v';
+        r.n = g->slot[d];
+        return r;
+    }
+    r.kind = 's';
+    r.n = vec_param_index(g->k, op->name);
+    return r;
+}
+
+static int vec_is_reduction(VecGen *g, IRInstr *ins) {
+    return g->k->reduction && ins->result && strcmp(ins->result, g->k->reduction) == 0;
+}
+
+static int vec_commutative(int op) {
+    return op == '+' || op == '*' || op == '&' || op == '|' || op == '^';
+}
+
+/* Does instruction j need a scratch group for a splatted scalar? */
+static int vec_needs_scratch(VecGen *g, int j) {
+    IRInstr *ins = g->body[j];
+    if (ins->kind == IR_STORE) return vec_operand(g, &ins->store_val, j).kind != 'v';
+    if (ins->kind != IR_BINOP || vec_is_reduction(g, ins)) return 0;
+    VecOperand l = vec_operand(g, &ins->left, j), r = vec_operand(g, &ins->right, j);
+    return l.kind != 'v' && r.kind == 'v' && !vec_commutative(ins->binop) && ins->binop != '-';
+}
+
+static int vec_alloc_slot(int *used, int *high) {
+    for (int s = 0; s < VEC_SLOTS; s++) {
+        if (!used[s]) {
+            used[s] = 1;
+            if (s + 1 > *high) *high = s + 1;
+            return s;
+        }
+    }
+    return VEC_SLOTS - 1;
+}
+
+/* Give every value a slot; returns the number of slots used. */
+static int vec_assign_slots(VecGen *g) {
+    int used[VEC_SLOTS] = {0}, high = 0;
+    int n = g->count;
+    for (int j = 0; j < n; j++) {
+        g->slot[j] = g->scratch[j] = g->last_use[j] = -1;
+        g->index_def[j] = 0;
+    }
+
+    /* Last value use of each result, and which results only feed indices. */
+    int iv_used = 0;
+    for (int j = 0; j < n; j++) {
+        IRInstr *ins = g->body[j];
+        IROperand *ops[2];
+        int c = 0;
+        if (ins->kind == IR_ASSIGN) ops[c++] = &ins->src;
+        else if (ins->kind == IR_BINOP) { ops[c++] = &ins->left; ops[c++] = &ins->right; }
+        else if (ins->kind == IR_UNOP) ops[c++] = &ins->unop_src;
+        else if (ins->kind == IR_STORE) ops[c++] = &ins->store_val;
+        for (int i = 0; i < c; i++) {
+            if (vec_is_reduction(g, ins) && vec_same_name(ops[i], g->k->reduction)) continue;
+            int d = vec_reaching_def(g, ops[i], j);
+            if (d >= 0) g->last_use[d] = j;
+            else if (vec_same_name(ops[i], g->k->ivar)) iv_used = 1;
+        }
+    }
+    for (int j = 0; j < n; j++) {
+        IRInstr *ins = g->body[j];
+        g->index_def[j] = ins->kind == IR_BINOP && ins->binop == '+' && g->last_use[j] < 0 &&
+                          vec_same_name(&ins->left, g->k->ivar);
+    }
+
+    g->acc_slot = g->k->reduction ? vec_alloc_slot(used, &high) : -1;
+    g->iv_slot = iv_used ? vec_alloc_slot(used, &high) : -1;
+    for (int j = 0; j < n; j++) {
+        IRInstr *ins = g->body[j];
+        if (vec_needs_scratch(g, j)) g->scratch[j] = vec_alloc_slot(used, &high);
+        /* Operands dying here may share their group with the result. */
+        for (int d = 0; d < j; d++)
+            if (g->last_use[d] == j && g->slot[d] >= 0) used[g->slot[d]] = 0;
+        if (g->scratch[j] >= 0) used[g->scratch[j]] = 0;
+        if (ins->result && ins->kind != IR_STORE && !vec_is_reduction(g, ins) && !g->index_def[j]) {
+            g->slot[j] = vec_alloc_slot(used, &high);
+            if (g->last_use[j] < 0) used[g->slot[j]] = 0;
+        }
+    }
+    return high;
+}
+
+static const char* vec_vreg(VecGen *g, int slot, char *buf) {
+    sprintf(buf, "v%d", (slot + 1) * g->lmul);
+    return buf;
+}
+
+static int vec_simm5(int v) { return v >= -16 && v <= 15; }
+
+/* dst := splat of a scalar or constant operand. */
+static void vec_emit_splat(FILE *out, VecGen *g, const char *dst, VecOperand o) {
+    (void)g;
+    if (o.kind == 's') fprintf(out, "  vmv.v.x %s, a%d\n", dst, o.n);
+    else if (vec_simm5(o.n)) fprintf(out, "  vmv.v.i %s, %d\n", dst, o.n);
+    else fprintf(out, "  li t4, %d\n  vmv.v.x %s, t4\n", o.n, dst);
+}
+
+/* dst := src op o for a scalar or constant o, using .vi where it exists. */
+static void vec_emit_op_scalar(FILE *out, const char *mn, const char *dst, const char *src, VecOperand o,
+                               int has_vi, int uimm) {
+    if (o.kind == 'c' && has_vi && (uimm ? (o.n >= 0 && o.n <= 31) : vec_simm5(o.n))) {
+        fprintf(out, "  %s.vi %s, %s, %d\n", mn, dst, src, o.n);
+    } else if (o.kind == 's') {
+        fprintf(out, "  %s.vx %s, %s, a%d\n", mn, dst, src, o.n);
+    } else {
+        fprintf(out, "  li t4, %d\n  %s.vx %s, %s, t4\n", o.n, mn, dst, src);
+    }
+}
+
+static const char* vec_mnemonic(int op, int *has_vi, int *uimm) {
+    *has_vi = 0;
+    *uimm = 0;
+    switch (op) {
+        case '+': *has_vi = 1; return "vadd";
+        case '-': return "vsub";
+        case '*': return "vmul";
+        case '/': return "vdiv";
+        case '%': return "vrem";
+        case '&': *has_vi = 1; return "vand";
+        case '|': *has_vi = 1; return "vor";
+        case '^': *has_vi = 1; return "vxor";
+        case T_SHL: *has_vi = 1; *uimm = 1; return "vsll";
+        case T_SHR: *has_vi = 1; *uimm = 1; return "vsra";
+        default: return NULL;
+    }
+}
+
+/* Address of base[i + k + off] into t2 (t1 holds i * 4). */
+static void vec_emit_address(FILE *out, VecGen *g, IRInstr *ins, int pos) {
+    int base = vec_param_index(g->k, ins->base.name);
+    int kparam = -1, off = 0;
+    int d = vec_same_name(&ins->index, g->k->ivar) ? -1 : vec_reaching_def(g, &ins->index, pos);
+    if (d >= 0) {
+        IRInstr *def = g->body[d];
+        if (def->right.is_const) off = def->right.const_val;
+        else kparam = vec_param_index(g->k, def->right.name);
+    }
+    if (kparam < 0) {
+        fprintf(out, "  add t2, a%d, t1\n", base);
+    } else {
+        fprintf(out, "  add t2, a0, a%d\n", kparam);
+        fprintf(out, "  slli t2, t2, 2\n");
+        fprintf(out, "  add t2, t2, a%d\n", base);
+    }
+    long bytes = (long)off * 4;
+    if (bytes >= -2048 && bytes <= 2047) {
+        if (bytes) fprintf(out, "  addi t2, t2, %ld\n", bytes);
+    } else {
+        fprintf(out, "  li t4, %ld\n  add t2, t2, t4\n", bytes);
+    }
+}
+
+static void vec_emit_instr(FILE *out, VecGen *g, int j) {
+    IRInstr *ins = g->body[j];
+    char d[8], a[8], b[8], s[8];
+    int has_vi, uimm;
+
+    if (vec_is_reduction(g, ins)) {
+        IROperand *v = vec_same_name(&ins->left, g->k->reduction) ? &ins->right : &ins->left;
+        VecOperand o = vec_operand(g, v, j);
+        vec_vreg(g, g->acc_slot, d);
+        if (o.kind == 'v') fprintf(out, "  vadd.vv %s, %s, %s\n", d, d, vec_vreg(g, o.n, a));
+        else vec_emit_op_scalar(out, "vadd", d, d, o, 1, 0);
+        return;
+    }
+    if (g->index_def[j]) return;
+
+    switch (ins->kind) {
+        case IR_LOAD:
+            vec_emit_address(out, g, ins, j);
+            fprintf(out, "  vle32.v %s, (t2)\n", vec_vreg(g, g->slot[j], d));
+            break;
+        case IR_STORE: {
+            VecOperand o = vec_operand(g, &ins->store_val, j);
+            const char *src;
+            if (o.kind == 'v') {
+                src = vec_vreg(g, o.n, a);
+            } else {
+                src = vec_vreg(g, g->scratch[j], a);
+                vec_emit_splat(out, g, src, o);
+            }
+            vec_emit_address(out, g, ins, j);
+            fprintf(out, "  vse32.v %s, (t2)\n", src);
+            break;
+        }
+        case IR_ASSIGN: {
+            VecOperand o = vec_operand(g, &ins->src, j);
+            vec_vreg(g, g->slot[j], d);
+            if (o.kind == 'v') fprintf(out, "  vmv.v.v %s, %s\n", d, vec_vreg(g, o.n, a));
+            else vec_emit_splat(out, g, d, o);
+            break;
+        }
+        case IR_UNOP: {
+            VecOperand o = vec_operand(g, &ins->unop_src, j);
+            vec_vreg(g, g->slot[j], d);
+            const char *src = d;
+            if (o.kind == 'v') src = vec_vreg(g, o.n, a);
+            else vec_emit_splat(out, g, d, o);
+            if (ins->unop == '-') fprintf(out, "  vrsub.vi %s, %s, 0\n", d, src);
+            else fprintf(out, "  vxor.vi %s, %s, -1\n", d, src);
+            break;
+        }
+        case IR_BINOP: {
+            VecOperand l = vec_operand(g, &ins->left, j), r = vec_operand(g, &ins->right, j);
+            const char *mn = vec_mnemonic(ins->binop, &has_vi, &uimm);
+            vec_vreg(g, g->slot[j], d);
+            if (l.kind != 'v' && r.kind == 'v') {
+                if (vec_commutative(ins->binop)) {
+                    VecOperand t = l; l = r; r = t;
+                } else if (ins->binop == '-') {
+                    vec_emit_op_scalar(out, "vrsub", d, vec_vreg(g, r.n, b), l, 1, 0);
+                    break;
+                } else {
+                    vec_vreg(g, g->scratch[j], s);
+                    vec_emit_splat(out, g, s, l);
+                    fprintf(out, "  %s.vv %s, %s, %s\n", mn, d, s, vec_vreg(g, r.n, b));
+                    break;
+                }
+            }
+            const char *lhs = d;
+            if (l.kind == 'v') lhs = vec_vreg(g, l.n, a);
+            else vec_emit_splat(out, g, d, l);
+            if (r.kind == 'v') {
+                fprintf(out, "  %s.vv %s, %s, %s\n", mn, d, lhs, vec_vreg(g, r.n, b));
+            } else if (ins->binop == '-' && r.kind == 'c' && r.n != INT_MIN && vec_simm5(-r.n)) {
+                fprintf(out, "  vadd.vi %s, %s, %d\n", d, lhs, -r.n);
+            } else {
+                vec_emit_op_scalar(out, mn, d, lhs, r, has_vi, uimm);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+static void emit_vec_kernel(FILE *out, VecKernel *k) {
+    int n = 0;
+    for (IRInstr *i = k->body; i; i = i->next) n++;
+    IRInstr *body[n > 0 ? n : 1];
+    int slot[n + 1], scratch[n + 1], last_use[n + 1], index_def[n + 1];
+    n = 0;
+    for (IRInstr *i = k->body; i; i = i->next) body[n++] = i;
+
+    VecGen g = { k, body, n, slot, scratch, last_use, index_def, -1, -1, 1 };
+    int slots = vec_assign_slots(&g);
+    g.lmul = slots <= 3 ? 8 : slots <= 7 ? 4 : slots <= 15 ? 2 : 1;
+
+    int uses_t1 = 0;
+    for (int j = 0; j < n; j++)
+        if ((body[j]->kind == IR_LOAD || body[j]->kind == IR_STORE) && !g.index_def[j] &&
+            (vec_same_name(&body[j]->index, k->ivar) ||
+             body[vec_reaching_def(&g, &body[j]->index, j)]->right.is_const))
+            uses_t1 = 1;
+
+    char acc[8], iv[8];
+    fprintf(out, "%s:\n", k->name);
+    fprintf(out, "  sub t3, a1, a0\n");
+    if (k->reduction) {
+        fprintf(out, "  vsetvli t0, zero, e32, m%d, ta, ma\n", g.lmul);
+        fprintf(out, "  vmv.v.i %s, 0\n", vec_vreg(&g, g.acc_slot, acc));
+    }
+    fprintf(out, "  blez t3, .L%s_done\n", k->name);
+    fprintf(out, ".L%s_loop:\n", k->name);
+    fprintf(out, "  vsetvli t0, t3, e32, m%d, %s, ma\n", g.lmul, k->reduction ? "tu" : "ta");
+    if (uses_t1) fprintf(out, "  slli t1, a0, 2\n");
+    if (g.iv_slot >= 0) {
+        vec_vreg(&g, g.iv_slot, iv);
+        fprintf(out, "  vid.v %s\n", iv);
+        fprintf(out, "  vadd.vx %s, %s, a0\n", iv, iv);
+    }
+    for (int j = 0; j < n; j++) vec_emit_instr(out, &g, j);
+    fprintf(out, "  add a0, a0, t0\n");
+    fprintf(out, "  sub t3, t3, t0\n");
+    fprintf(out, "  bnez t3, .L%s_loop\n", k->name);
+    fprintf(out, ".L%s_done:\n", k->name);
+    if (k->reduction) {
+        fprintf(out, "  vsetvli t0, zero, e32, m%d, ta, ma\n", g.lmul);
+        fprintf(out, "  vmv.s.x v0, zero\n");
+        fprintf(out, "  vredsum.vs v0, %s, v0\n", acc);
+        fprintf(out, "  vmv.x.s a0, v0\n");
+    }
+    fprintf(out, "  ret\n\n");
+}
+
 /* -----------------------------------------------------------------------
  * Main code generation entry point
  * ----------------------------------------------------------------------- */
@@ -391,6 +1240,8 @@ void riscv_generate(IRProgram *prog, RegAllocResult **ra_results, const char *fi
     }
     if (vtables) free(vtables);
 
+    profile_emit_data(out);
+
     IRFunc *func = prog->funcs;
     int func_idx = 0;
 
@@ -499,8 +1350,52 @@ void riscv_generate(IRProgram *prog, RegAllocResult **ra_results, const char *fi
                     break;
 
                 case IR_BINOP:
-                    fprintf(out, "%s = ... %c ...\n", instr->result, instr->binop);
+                    fprintf(out, "%s = ... %s ...\n", instr->result, ir_binop_str(instr->binop));
                     load_operand(out, instr->left,  "t0");
+
+                    /* Small constant addends (IV and pointer steps) fold into addi. */
+                    if ((instr->binop == '+' || instr->binop == '-') && instr->right.is_const &&
+                        instr->right.const_val >= -2047 && instr->right.const_val <= 2047) {
+                        int imm = instr->binop == '+' ? instr->right.const_val : -instr->right.const_val;
+                        fprintf(out, "  addi t2, t0, %d\n", imm);
+                        store_result(out, instr->result, "t2");
+                        break;
+                    }
+                    if ((instr->binop == '/' || instr->binop == '%') && instr->right.is_const &&
+                        instr->right.const_val != 0 && instr->right.const_val != 1 &&
+                        instr->right.const_val != -1) {
+                        emit_div_by_const(out, instr->binop, instr->right.const_val);
+                        store_result(out, instr->result, "t2");
+                        break;
+                    }
+                    if (instr->binop == '*' && (instr->right.is_const || instr->left.is_const)) {
+                        IROperand var = instr->right.is_const ? instr->left : instr->right;
+                        long long c = instr->right.is_const ? instr->right.const_val : instr->left.const_val;
+                        if (!instr->right.is_const) load_operand(out, var, "t0");
+                        if (emit_mul_by_const(out, "t2", "t0", "t1", c)) {
+                            store_result(out, instr->result, "t2");
+                            break;
+                        }
+                        fprintf(out, "  li t1, %lld\n", c);
+                        fprintf(out, "  mul t2, t0, t1\n");
+                        store_result(out, instr->result, "t2");
+                        break;
+                    }
+                    /* Masks and shift counts that fit take the immediate forms. Shifts
+                       are full-width like the other arithmetic, so x << k == x * 2^k. */
+                    if ((instr->binop == '&' || instr->binop == '|' || instr->binop == '^') &&
+                        instr->right.is_const && instr->right.const_val >= -2048 && instr->right.const_val <= 2047) {
+                        const char *mn = instr->binop == '&' ? "andi" : (instr->binop == '|' ? "ori" : "xori");
+                        fprintf(out, "  %s t2, t0, %d\n", mn, instr->right.const_val);
+                        store_result(out, instr->result, "t2");
+                        break;
+                    }
+                    if ((instr->binop == T_SHL || instr->binop == T_SHR) && instr->right.is_const) {
+                        fprintf(out, "  %s t2, t0, %d\n", instr->binop == T_SHL ? "slli" : "srai",
+                                instr->right.const_val & 63);
+                        store_result(out, instr->result, "t2");
+                        break;
+                    }
                     load_operand(out, instr->right, "t1");
 
                     if      (instr->binop == '+') fprintf(out, "  add t2, t0, t1\n");
@@ -508,6 +1403,11 @@ void riscv_generate(IRProgram *prog, RegAllocResult **ra_results, const char *fi
                     else if (instr->binop == '*') fprintf(out, "  mul t2, t0, t1\n");
                     else if (instr->binop == '/') fprintf(out, "  div t2, t0, t1\n");
                     else if (instr->binop == '%') fprintf(out, "  rem t2, t0, t1\n");
+                    else if (instr->binop == '&') fprintf(out, "  and t2, t0, t1\n");
+                    else if (instr->binop == '|') fprintf(out, "  or t2, t0, t1\n");
+                    else if (instr->binop == '^') fprintf(out, "  xor t2, t0, t1\n");
+                    else if (instr->binop == T_SHL) fprintf(out, "  sll t2, t0, t1\n");
+                    else if (instr->binop == T_SHR) fprintf(out, "  sra t2, t0, t1\n");
 
                     store_result(out, instr->result, "t2");
                     break;
@@ -520,6 +1420,7 @@ void riscv_generate(IRProgram *prog, RegAllocResult **ra_results, const char *fi
                         load_operand(out, instr->unop_src, "t0");
                         if      (instr->unop == '-') fprintf(out, "  neg t1, t0\n");
                         else if (instr->unop == '!') fprintf(out, "  seqz t1, t0\n");
+                        else if (instr->unop == '~') fprintf(out, "  not t1, t0\n");
                         else                         fprintf(out, "  mv t1, t0\n");
                     }
                     store_result(out, instr->result, "t1");
@@ -540,6 +1441,16 @@ void riscv_generate(IRProgram *prog, RegAllocResult **ra_results, const char *fi
                     }
                     break;
 
+                case IR_SELECT:
+                    fprintf(out, "%s = select ...\n", instr->result);
+                    emit_select(out, instr);
+                    break;
+
+                case IR_SWITCH:
+                    fprintf(out, "switch (%d cases) default %s\n", instr->case_count, instr->label);
+                    emit_switch(out, instr);
+                    break;
+
                 case IR_GOTO:
                     fprintf(out, "goto %s\n", instr->label);
                     fprintf(out, "  j %s\n", instr->label);
@@ -550,26 +1461,16 @@ void riscv_generate(IRProgram *prog, RegAllocResult **ra_results, const char *fi
                     fprintf(out, "%s:\n", instr->label);
                     break;
 
-                case IR_LOAD:
+                case IR_LOAD: {
                     fprintf(out, "Load Array/Pointer\n");
-                    load_address(out, instr->base,  "t0");
-                    load_operand(out, instr->index, "t1");
-                    if (instr->scale == 2) {
-                        fprintf(out, "  slli t1, t1, 1\n");
-                    } else if (instr->scale == 4) {
-                        fprintf(out, "  slli t1, t1, 2\n");
-                    } else if (instr->scale == 8) {
-                        fprintf(out, "  slli t1, t1, 3\n");
-                    } else if (instr->scale > 1) {
-                        fprintf(out, "  li t2, %d\n  mul t1, t1, t2\n", instr->scale);
-                    }
-                    fprintf(out, "  add t2, t0, t1\n");
+                    int disp = emit_element_address(out, instr);
                     if (instr->scale == 8)
-                        fprintf(out, "  ld t2, 0(t2)\n");
+                        fprintf(out, "  ld t2, %d(t0)\n", disp);
                     else
-                        fprintf(out, "  lw t2, 0(t2)\n");
+                        fprintf(out, "  lw t2, %d(t0)\n", disp);
                     store_result(out, instr->result, "t2");
                     break;
+                }
 
                 case IR_ALLOCA:
                     fprintf(out, "Dynamic stack allocation (VLA)\n");
@@ -582,26 +1483,16 @@ void riscv_generate(IRProgram *prog, RegAllocResult **ra_results, const char *fi
                     store_result(out, instr->result, "t1");
                     break;
 
-                case IR_STORE:
+                case IR_STORE: {
                     fprintf(out, "Store Array/Pointer\n");
-                    load_address(out, instr->base,      "t0");
-                    load_operand(out, instr->index,     "t1");
-                    if (instr->scale == 2) {
-                        fprintf(out, "  slli t1, t1, 1\n");
-                    } else if (instr->scale == 4) {
-                        fprintf(out, "  slli t1, t1, 2\n");
-                    } else if (instr->scale == 8) {
-                        fprintf(out, "  slli t1, t1, 3\n");
-                    } else if (instr->scale > 1) {
-                        fprintf(out, "  li t2, %d\n  mul t1, t1, t2\n", instr->scale);
-                    }
+                    int disp = emit_element_address(out, instr);
                     load_operand(out, instr->store_val, "t2");
-                    fprintf(out, "  add t0, t0, t1\n");
                     if (instr->scale == 8)
-                        fprintf(out, "  sd t2, 0(t0)\n");
+                        fprintf(out, "  sd t2, %d(t0)\n", disp);
                     else
-                        fprintf(out, "  sw t2, 0(t0)\n");
+                        fprintf(out, "  sw t2, %d(t0)\n", disp);
                     break;
+                }
 
                 case IR_PARAM:
                     fprintf(out, "Param\n");
@@ -679,8 +1570,10 @@ void riscv_generate(IRProgram *prog, RegAllocResult **ra_results, const char *fi
                     fprintf(out, "return\n");
                     if (instr->src.name || instr->src.is_const)
                         load_operand(out, instr->src, "a0");
-                    
-                    fprintf(out, "  j %s\n", exit_label);
+
+                    /* The epilogue follows the last instruction. */
+                    if (instr->next)
+                        fprintf(out, "  j %s\n", exit_label);
                     break;
 
                 case IR_TRY_BEGIN:
@@ -702,6 +1595,35 @@ void riscv_generate(IRProgram *prog, RegAllocResult **ra_results, const char *fi
                     fprintf(out, "  call __paninic_throw\n");
                     break;
 
+                case IR_PROFILE_COUNTER: {
+                    /* t0/t1 are free between IR instructions. */
+                    int off = 8 * (instr->prof_block - 1);
+                    fprintf(out, "profile counter %d\n", instr->prof_block);
+                    fprintf(out, "  la t0, __prof_counters\n");
+                    if (off > 2047) {
+                        fprintf(out, "  li t1, %d\n", off);
+                        fprintf(out, "  add t0, t0, t1\n");
+                        off = 0;
+                    }
+                    fprintf(out, "  ld t1, %d(t0)\n", off);
+                    fprintf(out, "  addi t1, t1, 1\n");
+                    fprintf(out, "  sd t1, %d(t0)\n", off);
+                    break;
+                }
+
+                case IR_PREFETCH: {
+                    /* Zicbop: an ori to x0 on cores without it. The offset
+                       must be a multiple of 32. */
+                    fprintf(out, "Prefetch\n");
+                    int disp = emit_element_address(out, instr);
+                    if (disp % 32) {
+                        fprintf(out, "  addi t0, t0, %d\n", disp);
+                        disp = 0;
+                    }
+                    fprintf(out, "  prefetch.%c %d(t0)\n", instr->prefetch_write ? 'w' : 'r', disp);
+                    break;
+                }
+
                 default:
                     fprintf(out, "  # Unimplemented IR instruction\n");
                     break;
@@ -747,6 +1669,8 @@ void riscv_generate(IRProgram *prog, RegAllocResult **ra_results, const char *fi
         func_idx++;
     }
 
+    for (VecKernel *k = prog->vec_kernels; k; k = k->next) emit_vec_kernel(out, k);
+
     cur_ra = NULL;
     fclose(out);
 }
\ No newline at end of file
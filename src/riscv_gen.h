@@ -11,4 +11,16 @@
  */
 void riscv_generate(IRProgram *prog, RegAllocResult **ra_results, const char *filename);
 
+/* Optional ISA extensions the backend may use (0 = base RV64IM). */
+extern int riscv_ext_zicond;   /* -mzicond: czero.eqz / czero.nez */
+extern int riscv_ext_zba;      /* -mzba: sh1add / sh2add / sh3add */
+extern int riscv_ext_v;        /* -march=rv64gcv: RVV 1.0 vector loops */
+
+/* -march=rv64gc[v][_zba][_zicond]: set the extensions above. Returns 0 if
+ * the string is not of that form. */
+int riscv_set_march(const char *arch);
+
+/* -mtune=NAME: select the cost model for a core. Returns 0 if unknown. */
+int riscv_set_tune(const char *name);
+
 #endif /* RISCV_GEN_H */
\ No newline at end of file
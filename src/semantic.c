@@ -743,7 +743,9 @@ void analyze_declaration(ASTNode *node) {
     sym->struct_def = decl_struct_def;
 
     int size = get_type_size(decl_type, sym->pointer_level, sym->struct_def);
-    if (sym->is_array && sym->array_size > 0) {
+    if (sym->is_vla) {
+        size = 8; /* the frame slot holds the pointer returned by alloca */
+    } else if (sym->is_array && sym->array_size > 0) {
         size = size * sym->array_size;
     } else if (sym->is_array && sym->array_dim_count > 0) {
         int total_elements = 1;
@@ -968,6 +970,20 @@ void analyze_binary(ASTNode *node) {
 
     if (node->left->data_type == TYPE_VOID || node->right->data_type == TYPE_VOID) return;
 
+    /* Bitwise operators and shifts: integer operands (char promotes), int result */
+    if (node->int_val == '&' || node->int_val == '|' || node->int_val == '^' ||
+        node->int_val == T_SHL || node->int_val == T_SHR) {
+        if (node->left->pointer_level > 0 || node->right->pointer_level > 0 ||
+            (node->left->data_type != TYPE_INT && node->left->data_type != TYPE_CHAR) ||
+            (node->right->data_type != TYPE_INT && node->right->data_type != TYPE_CHAR)) {
+            semantic_error(node->line_number, "Bitwise operator requires integer operands");
+        }
+        node->data_type = TYPE_INT;
+        node->pointer_level = 0;
+        node->struct_def = NULL;
+        return;
+    }
+
     /* For arithmetic operators, require exact type match */
     if (node->left->data_type == node->right->data_type &&
         node->left->pointer_level == node->right->pointer_level) {
@@ -1012,6 +1028,14 @@ void analyze_unary(ASTNode *node) {
                 semantic_error(node->line_number, "Cannot dereference non-pointer type");
                 node->pointer_level = 0;
             }
+        } else if (node->int_val == '~') {
+            if (node->left->pointer_level > 0 ||
+                (node->left->data_type != TYPE_INT && node->left->data_type != TYPE_CHAR))
+                semantic_error(node->line_number, "Bitwise complement requires an integer operand");
+            node->pointer_level = 0;
+            node->data_type = TYPE_INT;
+            node->struct_def = NULL;
+            return;
         } else {
             node->pointer_level = node->left->pointer_level;
         }
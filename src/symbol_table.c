@@ -84,6 +84,7 @@ Symbol *create_symbol(char *name, DataType type,
     /* Default: not an array symbol */
     sym->is_array = 0;
     sym->array_size = 0;
+    sym->is_vla = 0;
 
     /* Struct-related */
     sym->struct_def = NULL;
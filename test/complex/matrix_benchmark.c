@@ -0,0 +1,37 @@
+int main() {
+    int n;
+    scanf("%d", &n);
+    int A[n][n], B[n][n], C[n][n];
+    int i, j, k;
+
+    for (i = 0; i < n; i++) {
+        for (j = 0; j < n; j++) {
+            A[i][j] = (i * 7 + j * 3) % 17 - 8;
+            B[i][j] = (i * 5 + j * 11) % 13 - 6;
+        }
+    }
+
+    // Textbook i-j-k order: B is walked down its columns.
+    for (i = 0; i < n; i++) {
+        for (j = 0; j < n; j++) {
+            C[i][j] = 0;
+            for (k = 0; k < n; k++) {
+                C[i][j] = C[i][j] + A[i][k] * B[k][j];
+            }
+        }
+    }
+
+    // Column-major checksums.
+    int trace = 0;
+    int check = 0;
+    for (j = 0; j < n; j++) {
+        for (i = 0; i < n; i++) {
+            check = check + C[i][j] * (i + 2 * j + 1);
+        }
+    }
+    for (i = 0; i < n; i++)
+        trace = trace + C[i][i];
+
+    printf("n=%d trace=%d check=%d\n", n, trace, check);
+    return 0;
+}
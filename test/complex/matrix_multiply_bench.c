@@ -0,0 +1,53 @@
+int main() {
+    int n; // size of the square arrays
+    scanf("%d", &n);
+    int A[n][n], B[n][n], C[n][n], S[n][n];
+    int i, j, k;
+    int temp_mul, temp_add;
+
+    // --- Matrices A and B, generated instead of read ---
+    for (i = 0; i < n; i++) {
+        for (j = 0; j < n; j++) {
+            A[i][j] = (i * 13 + j * 5) % 19 - 9;
+            B[i][j] = (i * 3 + j * 17) % 23 - 11;
+        }
+    }
+
+    // --- Matrix Multiplication Logic ---
+    for (i = 0; i < n; i++) {
+        for (j = 0; j < n; j++) {
+            C[i][j] = 0; // Initialize result cell
+            for (k = 0; k < n; k++) {
+                temp_mul = A[i][k] * B[k][j];
+                temp_add = C[i][j] + temp_mul;
+                C[i][j] = temp_add;
+            }
+        }
+    }
+
+    // --- Five-point smoothing: each row reads its neighbours above and below ---
+    for (i = 0; i < n; i++) {
+        S[i][0] = C[i][0];
+        S[i][n - 1] = C[i][n - 1];
+        S[0][i] = C[0][i];
+        S[n - 1][i] = C[n - 1][i];
+    }
+    for (i = 1; i < n - 1; i++) {
+        for (j = 1; j < n - 1; j++) {
+            S[i][j] = (C[i - 1][j] + C[i + 1][j] + C[i][j - 1] + C[i][j + 1] + 4 * C[i][j]) / 8;
+        }
+    }
+
+    // --- Checksums of both results ---
+    int trace = 0;
+    int check = 0;
+    for (i = 0; i < n; i++) {
+        trace = trace + C[i][i];
+        for (j = 0; j < n; j++) {
+            check = check + S[i][j] * ((i + 3 * j) % 7 - 3);
+        }
+    }
+
+    printf("n=%d trace=%d check=%d\n", n, trace, check);
+    return 0;
+}
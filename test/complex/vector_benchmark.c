@@ -0,0 +1,37 @@
+/* Vector benchmark: element-wise kernels and reductions over n-element
+   arrays, repeated so the loops dominate. Compare
+   -O2 against -O2 -march=rv64gcv (see scripts/vector_bench.sh). */
+
+int dot(int *x, int *y, int n) {
+    int i, s = 0;
+    for (i = 0; i < n; i++) s = s + x[i] * y[i];
+    return s;
+}
+
+void saxpy(int *y, int *x, int k, int n) {
+    int i;
+    for (i = 0; i < n; i++) y[i] = y[i] + k * x[i];
+}
+
+int main() {
+    int n, i, r, check = 0;
+    scanf("%d", &n);
+    int *a = malloc(n * 4), *b = malloc(n * 4), *c = malloc(n * 4);
+
+    for (i = 0; i < n; i++) {
+        a[i] = i % 97 - 48;
+        b[i] = (i * 13) & 255;
+    }
+    for (r = 0; r < 20; r++) {
+        for (i = 0; i < n; i++) c[i] = (a[i] * b[i] + r) >> 3;
+        for (i = 0; i < n; i++) c[i] = c[i] - (a[i] ^ r);
+        check = check + dot(c, b, n);
+        saxpy(c, a, r, n);
+        check = check ^ dot(c, c, n);
+    }
+
+    int s = 0;
+    for (i = 0; i < n; i++) s = s + c[i];
+    printf("n=%d check=%d sum=%d\n", n, check, s);
+    return 0;
+}
@@ -0,0 +1,68 @@
+/* Bitwise and shift operators: precedence, folding, immediate and
+   register forms, in the places they usually show up. */
+
+/* djb2-style hash over character codes, kept to 24 bits. */
+int hash(int n) {
+    int s[16];
+    int i;
+    int h = 5381;
+    for (i = 0; i < n; i++) s[i] = 97 + (i * 7) % 26;
+    for (i = 0; i < n; i++) {
+        h = ((h << 5) + h) ^ s[i];
+        h = h & 16777215;
+    }
+    return h;
+}
+
+int popcount(int x) {
+    int c = 0;
+    while (x) {
+        x = x & (x - 1);
+        c++;
+    }
+    return c;
+}
+
+/* Sieve of Eratosthenes over a bitset of 32-bit words. */
+int primes_below(int n) {
+    int bits[32];
+    int i, j;
+    int count = 0;
+    for (i = 0; i < 32; i++) bits[i] = 0;
+    for (i = 2; i < n; i++) {
+        if ((bits[i >> 5] >> (i & 31)) & 1) continue;
+        count++;
+        for (j = i * i; j < n; j = j + i)
+            bits[j >> 5] = bits[j >> 5] | (1 << (j & 31));
+    }
+    return count;
+}
+
+/* Q16 fixed point: Newton's method for sqrt(2). */
+int fix_sqrt2() {
+    int one = 1 << 16;
+    int two = 2 << 16;
+    int x = one;
+    int k;
+    for (k = 0; k < 6; k++)
+        x = (x + ((two << 8) / (x >> 8))) >> 1;
+    return (x * 1000) >> 16;
+}
+
+int scale(int x, int n) {
+    return (x << n) - (x >> n) + x * 64 + x * 4096;
+}
+
+int main() {
+    int a = 1 + 2 << 3;
+    int b = 6 & 3 == 3;
+    int c = 5 | 2 ^ 3 & 1;
+    int d = (1 << 10) | 7;
+    int m = 12345;
+    printf("%d %d %d %d %d %d ", a, b, c, d, ~5, -16 >> 2);
+    printf("%d %d %d ", m & 255, m | 4096, m ^ m);
+    printf("%d %d %d ", hash(13), popcount(m), popcount(255 << 4));
+    printf("%d %d ", primes_below(1000), fix_sqrt2());
+    printf("%d %d\n", scale(3, 4), scale(-100, 2));
+    return 0;
+}
@@ -0,0 +1,28 @@
+int sum_to(int n) {
+    if (n == 0) {
+        return 0;
+    }
+    return sum_to(n - 1) + n;
+}
+
+int power(int base, int e) {
+    if (e == 0) {
+        return 1;
+    }
+    if (e > 100) {
+        return power(base, e - 100);
+    }
+    return base * power(base, e - 1);
+}
+
+int zigzag(int a, int b) {
+    if (a <= 0) {
+        return b;
+    }
+    return a + zigzag(b - 1, a - 1);
+}
+
+int main() {
+    printf("sum=%d pow=%d zz=%d", sum_to(100000), power(3, 5), zigzag(6, 4));
+    return 0;
+}
@@ -0,0 +1,38 @@
+/* Locals whose address is taken only for scanf, for helpers that read
+   and write through the pointer, or for a local pointer that is only
+   dereferenced. They live in registers between those uses; one whose
+   address escapes stays in memory. */
+
+void minmax(int *lo, int *hi, int v) {
+    if (v < *lo) *lo = v;
+    if (v > *hi) *hi = v;
+}
+
+int *pass(int *p) {
+    return p;
+}
+
+int main() {
+    int n, i, x;
+    int lo = 1000000, hi = -1000000;
+    int s = 0;
+    scanf("%d", &n);
+    for (i = 0; i < n; i++) {
+        scanf("%d", &x);
+        s = s + x * (i + 1);
+        minmax(&lo, &hi, x);
+    }
+
+    /* Only ever dereferenced: becomes a plain register. */
+    int acc = 0;
+    int *p = &acc;
+    for (i = 0; i < 100; i++) *p = *p + i * s % 7;
+
+    /* Escapes through the return value: writes via q must show in e. */
+    int e = 5;
+    int *q = pass(&e);
+    for (i = 0; i < 10; i++) *q = *q + e;
+
+    printf("%d %d %d %d %d\n", s, lo, hi, acc, e);
+    return 0;
+}
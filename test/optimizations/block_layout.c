@@ -0,0 +1,49 @@
+/* Block placement: rarely taken branches inside hot loops, a throw site
+   and a catch handler move out of line; every edge they had must still
+   land in the right place once the blocks are reordered. */
+
+int checked_div(int a, int b) {
+    if (b == 0) throw 1;
+    return a / b;
+}
+
+int safe_div(int a, int b) {
+    int r = 0;
+    try {
+        if (b == 0) throw 1;
+        r = a / b;
+    } catch () {
+        r = -1;
+    }
+    return r;
+}
+
+int classify(int v) {
+    if (v < 0) return -1;
+    if (v > 100000) return 2;
+    return v % 3;
+}
+
+int main() {
+    int n, i, s = 0, errors = 0, big = 0;
+    scanf("%d", &n);
+    for (i = 0; i < n; i++) {
+        int c = classify(i * 37 - 5);
+        if (c < 0) {
+            errors = errors + 1;
+            continue;
+        }
+        if (c == 2) big = big + 1;
+        s = s + c + checked_div(i, i % 50 + 1);
+    }
+
+    int caught = 0;
+    for (i = 0; i < 6; i++) {
+        int q = safe_div(100, i % 3);
+        if (q < 0) caught = caught + 1;
+        else s = s + q;
+    }
+
+    printf("%d %d %d %d\n", s, errors, big, caught);
+    return 0;
+}
@@ -0,0 +1,138 @@
+/* Division and remainder by literal divisors, which the backend lowers to
+   multiply-high or shift sequences, checked against the hardware divide
+   (the divisor arrives as a runtime value there) on edge values and a
+   pseudo-random sweep of the 32-bit range. */
+
+int divisor(int k) {
+    switch (k) {
+        case 0: return 3;
+        case 1: return 5;
+        case 2: return 7;
+        case 3: return 10;
+        case 4: return 12;
+        case 5: return 25;
+        case 6: return 641;
+        case 7: return 1000;
+        case 8: return 65537;
+        case 9: return 1000003;
+        case 10: return 2147483647;
+        case 11: return -3;
+        case 12: return -7;
+        case 13: return -1000;
+        case 14: return 2;
+        case 15: return 8;
+        case 16: return 1024;
+        case 17: return 4096;
+        case 18: return 65536;
+        case 19: return -16;
+        case 20: return 1073741824;
+        case 21: return -2147483647;
+    }
+    return 1;
+}
+
+int fast_q(int x, int k) {
+    switch (k) {
+        case 0: return x / 3;
+        case 1: return x / 5;
+        case 2: return x / 7;
+        case 3: return x / 10;
+        case 4: return x / 12;
+        case 5: return x / 25;
+        case 6: return x / 641;
+        case 7: return x / 1000;
+        case 8: return x / 65537;
+        case 9: return x / 1000003;
+        case 10: return x / 2147483647;
+        case 11: return x / -3;
+        case 12: return x / -7;
+        case 13: return x / -1000;
+        case 14: return x / 2;
+        case 15: return x / 8;
+        case 16: return x / 1024;
+        case 17: return x / 4096;
+        case 18: return x / 65536;
+        case 19: return x / -16;
+        case 20: return x / 1073741824;
+        case 21: return x / -2147483647;
+    }
+    return x;
+}
+
+int fast_r(int x, int k) {
+    switch (k) {
+        case 0: return x % 3;
+        case 1: return x % 5;
+        case 2: return x % 7;
+        case 3: return x % 10;
+        case 4: return x % 12;
+        case 5: return x % 25;
+        case 6: return x % 641;
+        case 7: return x % 1000;
+        case 8: return x % 65537;
+        case 9: return x % 1000003;
+        case 10: return x % 2147483647;
+        case 11: return x % -3;
+        case 12: return x % -7;
+        case 13: return x % -1000;
+        case 14: return x % 2;
+        case 15: return x % 8;
+        case 16: return x % 1024;
+        case 17: return x % 4096;
+        case 18: return x % 65536;
+        case 19: return x % -16;
+        case 20: return x % 1073741824;
+        case 21: return x % -2147483647;
+    }
+    return 0;
+}
+
+/* 1 if either lowered result differs from the hardware divide. */
+int check(int x, int k) {
+    int d = divisor(k);
+    int bad = 0;
+    if (fast_q(x, k) != x / d) bad = 1;
+    if (fast_r(x, k) != x % d) bad = 1;
+    return bad;
+}
+
+int main() {
+    int k, j;
+    int checks = 0;
+    int bad = 0;
+    int sum = 0;
+    int edge[12];
+    edge[0] = 0;           edge[1] = 1;
+    edge[2] = -1;          edge[3] = 2;
+    edge[4] = -2;          edge[5] = 2147483647;
+    edge[6] = -2147483647; edge[7] = -2147483647 - 1;
+    edge[8] = 2147483646;  edge[9] = 1073741823;
+    edge[10] = -1073741825; edge[11] = 999999;
+
+    for (k = 0; k < 22; k++) {
+        int d = divisor(k);
+        for (j = 0; j < 12; j++) {
+            bad = bad + check(edge[j], k);
+            checks++;
+        }
+        /* Either side of every multiple boundary near zero. */
+        bad = bad + check(d, k) + check(d - 1, k) + check(-d, k) + check(1 - d, k);
+        checks = checks + 4;
+    }
+
+    /* Two Lehmer generators glued into a value spanning the 32-bit range. */
+    int s = 1;
+    int t = 7;
+    for (j = 0; j < 400; j++) {
+        s = (s * 75) % 65537;
+        t = (t * 279) % 65521;
+        int x = (s - 32769) * 65536 + t;
+        for (k = 0; k < 22; k++) {
+            bad = bad + check(x, k);
+            checks++;
+            sum = (sum * 7 + fast_q(x, k) % 9973 + fast_r(x, k) % 9973) % 1000003;
+        }
+    }
+    printf("%d %d %d\n", checks, bad, sum);
+    return 0;
+}
@@ -0,0 +1,105 @@
+/* Multiplications by literal constants, which the backend turns into
+   shift/add chains when they beat mul, checked against the hardware
+   multiply (the factor arrives as a runtime value there), plus 2D arrays
+   whose row sizes are not powers of two. */
+
+int factor(int k) {
+    switch (k) {
+        case 0: return 3;
+        case 1: return 5;
+        case 2: return 6;
+        case 3: return 7;
+        case 4: return 9;
+        case 5: return 10;
+        case 6: return 12;
+        case 7: return 15;
+        case 8: return 24;
+        case 9: return 25;
+        case 10: return 31;
+        case 11: return 40;
+        case 12: return 45;
+        case 13: return 100;
+        case 14: return 641;
+        case 15: return 65535;
+        case 16: return 2147483647;
+        case 17: return -1;
+        case 18: return -3;
+        case 19: return -6;
+        case 20: return -7;
+        case 21: return -100;
+        case 22: return 1048576;
+        case 23: return 1;
+    }
+    return 0;
+}
+
+int fast(int x, int k) {
+    switch (k) {
+        case 0: return x * 3;
+        case 1: return x * 5;
+        case 2: return x * 6;
+        case 3: return x * 7;
+        case 4: return x * 9;
+        case 5: return x * 10;
+        case 6: return x * 12;
+        case 7: return x * 15;
+        case 8: return x * 24;
+        case 9: return x * 25;
+        case 10: return x * 31;
+        case 11: return 40 * x;
+        case 12: return x * 45;
+        case 13: return x * 100;
+        case 14: return x * 641;
+        case 15: return x * 65535;
+        case 16: return x * 2147483647;
+        case 17: return x * -1;
+        case 18: return x * -3;
+        case 19: return -6 * x;
+        case 20: return x * -7;
+        case 21: return x * -100;
+        case 22: return x * 1048576;
+        case 23: return x * 1;
+    }
+    return 0;
+}
+
+/* Row-major tables with 3, 5 and 12 columns. */
+int tables(int n) {
+    int a[4][3];
+    int b[4][5];
+    int c[4][12];
+    int i, j;
+    int s = 0;
+    for (i = 0; i < 4; i++) {
+        for (j = 0; j < 3; j++) a[i][j] = i * 10 + j + n;
+        for (j = 0; j < 5; j++) b[i][j] = i * 100 + j - n;
+        for (j = 0; j < 12; j++) c[i][j] = i - j * n;
+    }
+    for (i = 3; i >= 0; i--) {
+        for (j = 0; j < 3; j++) s = s + a[i][j] * (j + 1);
+        for (j = 0; j < 5; j++) s = s + b[i][4 - j];
+        for (j = 0; j < 12; j++) s = s - c[i][j];
+    }
+    return s;
+}
+
+/* Mismatches against the hardware multiply over n multiplicands. */
+int sweep(int n) {
+    int k, j;
+    int bad = 0;
+    int x = 1;
+    for (j = 0; j < n; j++) {
+        /* Small, large and negative multiplicands, overflowing ones too. */
+        x = (x * 75) % 65537;
+        int v = (x - 32768) * (j % 7 + 1);
+        if (j % 5 == 0) v = v * 30011;
+        for (k = 0; k < 24; k++)
+            if (fast(v, k) != v * factor(k)) bad++;
+    }
+    return bad;
+}
+
+int main() {
+    printf("%d %d %d\n", sweep(300), tables(2), tables(-5));
+    return 0;
+}
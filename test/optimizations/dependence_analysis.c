@@ -0,0 +1,72 @@
+/* Dependence analysis: subscripts that never meet (a GCD or range
+   argument), dependences whose direction survives interchange or
+   distribution, and ones that must keep their order. */
+
+int main() {
+    int n, i, j, k;
+    int P[10][12], S[10][8];
+    int R[10];
+    int v[64], w[64], e[40], f[40];
+    scanf("%d", &n);
+
+    /* (=, <) down the columns: the nest is interchanged, the i - 1 reads
+       still see this sweep's values. */
+    for (i = 0; i < 10; i++)
+        for (j = 0; j < 12; j++)
+            P[i][j] = i + j;
+    for (j = 0; j < 12; j++)
+        for (i = 1; i < 10; i++)
+            P[i][j] = P[i - 1][j] * 2 + j;
+    int p = 0;
+    for (i = 0; i < 10; i++)
+        for (j = 0; j < 12; j++)
+            p = p + P[i][j] * (i + 1) - j;
+
+    /* The inner loops read R[j - 1], set one j earlier: distributed. The
+       R[j + 1] reads see the previous sweep's value and must not be. */
+    for (j = 0; j < 10; j++) R[j] = j;
+    for (j = 1; j < 10; j++) {
+        R[j] = R[j] + n;
+        for (k = 0; k < 8; k++)
+            S[j][k] = R[j - 1] * k;
+    }
+    for (j = 0; j < 9; j++) {
+        R[j] = j * 3;
+        for (k = 0; k < 8; k++)
+            S[j][k] = S[j][k] + R[j + 1];
+    }
+    int q = 0;
+    for (j = 1; j < 9; j++)
+        for (k = 0; k < 8; k++)
+            q = q + S[j][k] * (k + j);
+
+    /* Halves that never overlap: a copy and a vector loop. Shifting by
+       one element in place stays in order. */
+    for (i = 0; i < 64; i++) {
+        v[i] = i * 7 - n;
+        w[i] = i ^ n;
+    }
+    for (i = 0; i < 32; i++) v[i + 32] = v[i] * 3 + 1;
+    for (i = 0; i < 32; i++) w[i + 32] = w[i];
+    for (i = 0; i < 40; i++) w[i + 1] = w[i] + v[i];
+    int r = 0;
+    for (i = 0; i < 64; i++) r = r + v[i] * (i + 1) - w[i];
+
+    /* Running down: f[i + 20] and f[i] never meet while i < 20, so the
+       loop may run upwards; e[i + 1] feeds the next iteration's e[i] and
+       must not. Even and odd elements never meet (GCD); 2 * i and i + 5
+       do, in other iterations. */
+    for (i = 0; i < 40; i++) {
+        e[i] = i * i;
+        f[i] = 40 - i;
+    }
+    for (i = 19; i >= 0; i--) f[i + 20] = f[i] * 3 - i;
+    for (i = 38; i >= 0; i--) e[i] = e[i + 1] + i;
+    for (i = 15; i >= 0; i--) e[2 * i] = e[2 * i + 1] + i;
+    for (i = 9; i >= 0; i--) f[2 * i] = f[i + 5] * 2;
+    int t = 0;
+    for (i = 0; i < 40; i++) t = t + e[i] * (i + 1) + f[i] * i;
+
+    printf("%d %d %d %d\n", p, q, r, t);
+    return 0;
+}
@@ -0,0 +1,67 @@
+/* Small diamonds and triangles that -O2 turns into branch-free selects,
+   plus guarded work that must stay behind its branch. */
+int min2(int a, int b) {
+    int m;
+    if (a < b) m = a; else m = b;
+    return m;
+}
+
+int max2(int a, int b) {
+    int m = a;
+    if (b > m) m = b;
+    return m;
+}
+
+int abs1(int x) {
+    if (x < 0) x = -x;
+    return x;
+}
+
+/* Nested diamonds: the inner one is converted first. */
+int clamp(int x, int lo, int hi) {
+    int r;
+    if (x < lo) {
+        r = lo;
+    } else {
+        if (x > hi) r = hi; else r = x;
+    }
+    return r;
+}
+
+/* Both arms write both names, and the condition reads one of them. */
+int order(int a, int b) {
+    if (a > b) {
+        int t = a;
+        a = b;
+        b = t;
+    }
+    return a * 100 + b;
+}
+
+/* Division and loads may trap or fault: they stay guarded. */
+int safe_div(int x, int d) {
+    int q = 0;
+    if (d != 0) q = x / d;
+    return q;
+}
+
+int main() {
+    int a[16];
+    int i;
+    int hits = 0;
+    int s = 0;
+    for (i = 0; i < 16; i++)
+        a[i] = (i * 7) % 11 - 5;
+    /* Data-dependent branch in a loop body. */
+    for (i = 0; i < 16; i++) {
+        int v = a[i];
+        if (v > 0) hits = hits + 1;
+        s = s + abs1(v) + max2(v, 2) - min2(v, -1);
+    }
+    printf("%d %d %d %d ", min2(3, 9), min2(9, 3), max2(-4, -7), abs1(-12));
+    printf("%d %d %d ", clamp(-5, 0, 10), clamp(15, 0, 10), clamp(7, 0, 10));
+    printf("%d %d ", order(8, 3), order(2, 6));
+    printf("%d %d ", safe_div(17, 5), safe_div(17, 0));
+    printf("%d %d\n", hits, s);
+    return 0;
+}
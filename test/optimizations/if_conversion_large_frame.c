@@ -0,0 +1,31 @@
+/* If-conversion in a frame over 2 KiB: the arms of the select live in
+   stack slots beyond the 12-bit offset range, so loading them needs an
+   address register of its own. */
+int *saved;
+
+int keep(int *p) {
+    saved = p;
+    return p[0];
+}
+
+int work(int v) {
+    return v + 1;
+}
+
+int main() {
+    int big[1000];
+    int i, t, s, n;
+    scanf("%d", &n);
+    for (i = 0; i < 1000; i++) big[i] = i % 11;
+    int x = 3;
+    int y = 40;
+    keep(&x);
+    keep(&y);
+    s = 0;
+    for (i = 0; i < n; i++) {
+        if (big[i] > 5) t = x; else t = y;
+        s = s + t + work(i);
+    }
+    printf("%d\n", s);
+    return 0;
+}
@@ -0,0 +1,92 @@
+/* Loops with internal branches: the case that got the old IVE pass disabled. */
+int branchy_fill(int *a, int n) {
+    int i;
+    for (i = 0; i < n; i = i + 1) {
+        if (i % 3 == 0) {
+            a[i] = i * 10;
+        } else {
+            if (i % 3 == 1) {
+                continue;
+            }
+            a[i] = 0 - i;
+        }
+    }
+    return i;
+}
+
+/* Exit test is `!=`, so the loop is not unrolled and the test is replaced. */
+int sum_until(int *a, int n) {
+    int s = 0;
+    int i = 0;
+    while (i != n) {
+        if (a[i] > 0) {
+            s = s + a[i];
+        } else {
+            s = s - 1;
+        }
+        i = i + 1;
+    }
+    return s;
+}
+
+/* Neighbour offsets and a stride of 2 on a counter that is used afterwards. */
+int smooth(int *a, int *b, int n) {
+    int i = 1;
+    while (i != n - 1) {
+        b[i] = a[i - 1] + a[i] + a[i + 1];
+        if (b[i] < 0) {
+            b[i] = 0;
+        }
+        i = i + 2;
+    }
+    return i;
+}
+
+/* Decrementing counter with the update in the middle of the body. */
+int reverse_copy(int *a, int *b, int n) {
+    int j = n - 1;
+    int k = 0;
+    while (j != 0 - 1) {
+        int v = a[j];
+        j = j - 1;
+        b[k] = v + a[j + 1];
+        k = k + 1;
+    }
+    return b[0] + b[n - 1];
+}
+
+int g;
+
+/* The bound is a global the loop also counts down through a pointer, so
+   the test cannot be replaced by one against a limit fixed up front. */
+int fill_to_global(int *a, int n) {
+    int *p = &g;
+    int i = 0;
+    g = n;
+    while (i < g) {
+        a[i] = 9;
+        p[0] = p[0] - 1;
+        i = i + 1;
+    }
+    return g;
+}
+
+int main() {
+    int *a = malloc(80);
+    int *b = malloc(80);
+    int i;
+    for (i = 0; i < 20; i = i + 1) {
+        a[i] = 7;
+        b[i] = 0;
+    }
+    int last = branchy_fill(a, 20);
+    int s = sum_until(a, 20);
+    int sm = smooth(a, b, 20);
+    int rc = reverse_copy(a, b, 20);
+    int *c = malloc(80);
+    for (i = 0; i < 20; i = i + 1) c[i] = 0;
+    int fg = fill_to_global(c, 10);
+    printf("last=%d s=%d a=%d,%d,%d ", last, s, a[3], a[4], a[5]);
+    printf("sm=%d b=%d,%d rc=%d fg=%d,%d\n", sm, b[1], b[3], rc, fg, c[4] + c[5]);
+    return 0;
+}
@@ -0,0 +1,74 @@
+/* Branches whose outcome an earlier branch or assignment already fixes;
+   -O2 threads the predecessors straight to the right target. */
+int touch(int *p) {
+    *p = *p + 1;
+    return 0;
+}
+
+/* The same test twice in a row. */
+int twice(int x) {
+    int s = 0;
+    if (x > 0)
+        s = s + 1;
+    if (x > 0)
+        s = s + 10;
+    if (x <= 0)
+        s = s + 100;
+    return s;
+}
+
+/* A flag set on one arm and tested after the join. */
+int flagged(int a, int b) {
+    int found = 0;
+    int r = 0;
+    if (a == b) {
+        found = 1;
+        r = a * 2;
+    }
+    if (found)
+        r = r + 5;
+    else
+        r = r - 5;
+    return r;
+}
+
+/* State machine over a small input loop. */
+int run_states(int n) {
+    int state = 0;
+    int i;
+    int count = 0;
+    for (i = 0; i < n; i++) {
+        if (state == 0) {
+            state = 1;
+        } else if (state == 1) {
+            if (i % 3 == 0)
+                state = 2;
+        } else {
+            state = 0;
+        }
+        if (state == 2)
+            count = count + 1;
+    }
+    return count * 100 + state;
+}
+
+/* A call in between may change the flag through its address: the second
+   test stays. */
+int escaped_test() {
+    int s = 0;
+    int g = 0;
+    if (g == 0)
+        touch(&g);
+    if (g == 0)
+        s = 1;
+    else
+        s = 2;
+    return s;
+}
+
+int main() {
+    printf("%d %d ", twice(3), twice(-3));
+    printf("%d %d ", flagged(4, 4), flagged(4, 5));
+    printf("%d %d\n", run_states(20), escaped_test());
+    return 0;
+}
@@ -0,0 +1,53 @@
+/* Loop idioms: zero, fill and copy loops become runtime calls, with odd
+   counts, odd start offsets, empty ranges and the counter used after the
+   loop; overlapping copies and pointers that may alias stay loops. */
+
+int copy_params(int *d, int *s, int n) {
+    int i;
+    for (i = 0; i < n; i++) d[i] = s[i];
+    return d[n - 1];
+}
+
+int main() {
+    int n, v, i, k;
+    int a[100], b[100], c[101];
+    scanf("%d %d", &n, &v);
+
+    for (i = 0; i < 100; i++) a[i] = 0;
+    for (i = 0; i < 100; i++) b[i] = 0;
+    for (i = 0; i <= 100; i++) c[i] = 0;
+    for (i = 0; i < n; i++) b[i] = v;
+    for (i = 3; i <= n; i++) a[i] = i * 3 - v;
+    for (i = 0; i < n; i++) c[i + 1] = a[i];
+    int last = i;
+    for (i = 1; i < n; i++) b[i - 1] = c[i];
+
+    int s = 0;
+    for (i = 0; i < 100; i++) s = s + a[i] * (i + 1) - b[i] + c[i];
+
+    /* Empty range: the counter keeps its value. */
+    k = 5;
+    for (i = k; i < n - 60; i++) a[i] = 1;
+    int empty = i;
+
+    /* Fresh blocks from malloc do not overlap. */
+    int *p = malloc(n * 4);
+    int *q = malloc(n * 4);
+    for (i = 0; i < n; i++) p[i] = i * i;
+    for (i = 0; i < n; i++) q[i] = v + 2;
+    for (i = 2; i < n; i++) q[i - 2] = p[i];
+    int t = 0;
+    for (i = 0; i < n; i++) t = t + q[i];
+
+    /* A shifted copy within one array runs as written. */
+    for (i = 0; i < n - 1; i++) p[i] = p[i + 1];
+    t = t + p[0] + p[n - 2] + copy_params(q, p, n);
+
+    int m = n + 3;
+    int w[m];
+    for (i = 0; i < m; i++) w[i] = -v;
+    t = t + w[0] + w[m - 1];
+
+    printf("%d %d %d %d\n", s, last, empty, t);
+    return 0;
+}
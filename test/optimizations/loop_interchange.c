@@ -0,0 +1,58 @@
+/* Loop nests the -O2 nest restructuring interchanges, tiles or must leave alone. */
+int main() {
+    int n;
+    int m;
+    int i, j, k;
+    n = 9;
+    m = 7;
+    int A[n][m], B[m][n], C[n][n];
+    int X[12][12];
+
+    /* Column-major walks: interchanged so j runs along the rows. */
+    for (j = 0; j < m; j++)
+        for (i = 0; i < n; i++)
+            A[i][j] = i * 3 - j;
+    for (j = 0; j < n; j++)
+        for (i = 0; i < m; i++)
+            B[i][j] = i + 2 * j;
+
+    /* Integer sum reduction over a column-major walk, inclusive bounds. */
+    int s = 0;
+    for (j = 0; j <= m - 1; j++)
+        for (i = 0; i <= n - 1; i++)
+            s = s + A[i][j] * (j + 1);
+
+    /* Matrix multiply: the zeroing is split off and (k, j) is interchanged. */
+    int t;
+    for (i = 0; i < n; i++) {
+        for (j = 0; j < n; j++) {
+            C[i][j] = 0;
+            for (k = 0; k < m; k++) {
+                t = A[i][k] * B[k][j];
+                C[i][j] = C[i][j] + t;
+            }
+        }
+    }
+    int c = 0;
+    for (i = 0; i < n; i++)
+        for (j = 0; j < n; j++)
+            c = c + C[i][j] * (i - j);
+
+    /* Anti-diagonal dependence (<, >): interchange would be illegal. */
+    for (i = 0; i < 12; i++)
+        for (j = 0; j < 12; j++)
+            X[i][j] = i + j;
+    for (j = 0; j < 11; j++)
+        for (i = 1; i < 12; i++)
+            X[i][j] = X[i - 1][j + 1] + 1;
+    int d = X[11][0] * 100 + X[5][3];
+
+    /* Zero-trip inner loop: the IVs must keep their original exit values. */
+    int z = 0;
+    for (j = 0; j < 4; j++)
+        for (i = 0; i < z; i++)
+            A[i][j] = 0;
+
+    printf("s=%d c=%d d=%d t=%d ij=%d,%d\n", s, c, d, t, i, j);
+    return 0;
+}
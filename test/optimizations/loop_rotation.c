@@ -0,0 +1,48 @@
+int first_zero(int *a, int n) {
+    int i = 0;
+    while (i < n && a[i] != 0) {
+        i = i + 1;
+    }
+    return i;
+}
+
+int skip_multiples(int n) {
+    int sum = 0;
+    int i;
+    for (i = 0; i < n; i = i + 1) {
+        if (i % 4 == 0) {
+            continue;
+        }
+        if (sum > 1000) {
+            break;
+        }
+        sum = sum + i;
+    }
+    return sum;
+}
+
+int triangle(int n) {
+    int total = 0;
+    int i;
+    int j;
+    for (i = 0; i < n; i = i + 1) {
+        j = 0;
+        while (j < i) {
+            total = total + j;
+            j = j + 1;
+        }
+    }
+    return total;
+}
+
+int main() {
+    int *a = malloc(24);
+    int k;
+    for (k = 0; k < 6; k = k + 1) {
+        a[k] = 5 - k;
+    }
+    printf("z=%d e=%d s=%d b=%d t=%d n=%d\n",
+           first_zero(a, 6), first_zero(a, 0), skip_multiples(20),
+           skip_multiples(200), triangle(7), triangle(0));
+    return 0;
+}
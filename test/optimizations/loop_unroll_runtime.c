@@ -0,0 +1,67 @@
+int sum_upto(int n) {
+    int sum = 0;
+    int i = 0;
+    while (i < n) {
+        sum = sum + i;
+        i = i + 1;
+    }
+    return sum;
+}
+
+int sum_even_inclusive(int n) {
+    int sum = 0;
+    int i;
+    for (i = 0; i <= n; i = i + 2) {
+        sum = sum + i;
+    }
+    return sum;
+}
+
+int count_down(int start, int stop) {
+    int steps = 0;
+    int i = start;
+    while (i > stop) {
+        if ((i % 3) == 0) {
+            steps = steps + 10;
+        } else {
+            steps = steps + 1;
+        }
+        i = i - 1;
+    }
+    return steps;
+}
+
+int fill_and_sum(int n) {
+    int a[16];
+    int i;
+    for (i = 0; i < n; i++) {
+        a[i] = i * i;
+    }
+    int total = 0;
+    for (i = 0; i < n; i++) {
+        total = total + a[i];
+    }
+    return total;
+}
+
+/* Constant bound at the edge of int: bound - 3 would wrap, so stay rolled. */
+int near_int_min(int start) {
+    int steps = 0;
+    int i = start;
+    while (i < -2147483647) {
+        steps = steps + 1;
+        i = i + 1;
+    }
+    return steps;
+}
+
+int main() {
+    int n;
+    int acc = 0;
+    for (n = 0; n < 10; n++) {
+        acc = acc + sum_upto(n) + sum_even_inclusive(n) + count_down(n, 0) + fill_and_sum(n);
+    }
+    printf("u=%d e=%d d=%d f=%d acc=%d m=%d", sum_upto(37), sum_even_inclusive(13), count_down(20, -3), fill_and_sum(13), acc,
+           near_int_min(-2147483647 - 1));
+    return 0;
+}
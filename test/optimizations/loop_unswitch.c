@@ -0,0 +1,74 @@
+/* Loops branching on a loop-invariant flag; -O2 unswitches them. */
+int bump(int *p) {
+    *p = *p + 1;
+    return *p;
+}
+
+/* Flag parameter: one copy adds, the other subtracts. */
+int signed_sum(int n, int mode) {
+    int i;
+    int a[10];
+    for (i = 0; i < n; i++)
+        a[i] = i * i - 3;
+    int s = 0;
+    for (i = 0; i < n; i++) {
+        if (mode > 0)
+            s = s + a[i];
+        else
+            s = s - a[i];
+    }
+    return s;
+}
+
+/* Invariant early exit: only one copy keeps the break. */
+int first_run(int n, int stop) {
+    int i;
+    int a[10];
+    for (i = 0; i < n; i++)
+        a[i] = i * i - 3;
+    int s = 0;
+    for (i = 0; i < n; i++) {
+        if (stop == 1)
+            break;
+        s = s + a[i] * i;
+    }
+    return s + i;
+}
+
+/* Two invariant conditions and an inner loop. */
+int nest(int n, int x, int y) {
+    int i, j;
+    int s = 0;
+    for (i = 0; i < n; i++) {
+        for (j = 0; j < n; j++) {
+            if (x != 0)
+                s = s + i;
+            if (y < 3)
+                s = s + j * 2;
+        }
+    }
+    return s;
+}
+
+/* The callee changes the flag through its address: the test must stay put. */
+int escaped_flag(int n) {
+    int i;
+    int s = 0;
+    int g = 0;
+    for (i = 0; i < n; i++) {
+        if (g < 3)
+            s = s + 10;
+        else
+            s = s + 1;
+        bump(&g);
+    }
+    return s;
+}
+
+int main() {
+    printf("%d %d ", signed_sum(10, 1), signed_sum(10, 0));
+    printf("%d %d ", first_run(10, 1), first_run(10, 0));
+    printf("%d %d %d ", nest(5, 1, 1), nest(5, 0, 1), nest(5, 1, 7));
+    printf("%d\n", escaped_flag(6));
+    return 0;
+}
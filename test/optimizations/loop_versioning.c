@@ -0,0 +1,61 @@
+/* Loop versioning: loops over pointer parameters run a checked copy when
+   the ranges they touch do not overlap, and the original loop when they
+   do (same pointer twice, a scale factor inside the destination, a
+   pointer to a local array). */
+
+void saxpy(int *y, int *x, int a, int n) {
+    int i;
+    for (i = 0; i < n; i++) y[i] = y[i] + a * x[i];
+}
+
+void scale_by(int *d, int *s, int *k, int n) {
+    int i;
+    for (i = 0; i < n; i++) d[i] = s[i] * k[0] + k[1];
+}
+
+void copy(int *d, int *s, int n) {
+    int i;
+    for (i = 0; i < n; i++) d[i] = s[i + 1];
+}
+
+int sum(int *p, int n) {
+    int i, s = 0;
+    for (i = 0; i < n; i++) s = s * 7 + p[i];
+    return s;
+}
+
+int main() {
+    int n, i;
+    scanf("%d", &n);
+    int *p = malloc(n * 4 + 8);
+    int *q = malloc(n * 4 + 8);
+    for (i = 0; i < n + 2; i++) {
+        p[i] = i * 3 - 7;
+        q[i] = 5 - i;
+    }
+
+    saxpy(p, q, 3, n);
+    int a = sum(p, n);
+    saxpy(q, q, 2, n);          /* y and x the same: in place */
+    int b = sum(q, n);
+
+    scale_by(p, q, q, n);       /* k inside the source only */
+    int c = sum(p, n);
+    scale_by(p, q, p, n);       /* k[0] is d[0]: changes after the first store */
+    int d = sum(p, n);
+
+    copy(q, p, n);
+    int e = sum(q, n);
+    copy(p, p, n);              /* shifts left by one */
+    int f = sum(p, n);
+
+    int loc[40];
+    int *r = &loc;
+    for (i = 0; i < 40; i++) loc[i] = i;
+    for (i = 0; i < 39; i++) loc[i + 1] = r[i] + 2;
+    scale_by(r, r, r, 20);
+
+    printf("%d %d %d %d ", a, b, c, d);
+    printf("%d %d %d %d\n", e, f, loc[39], loc[5]);
+    return 0;
+}
@@ -0,0 +1,48 @@
+/* Profile-guided build: the same program with block counters and then
+   with their counts. A hot loop under register pressure next to a cold
+   error path, a loop the training run never enters and one that only
+   runs a couple of trips per entry. */
+
+int mix(int n, int seed) {
+    int a = seed, b = seed + 1, c = seed + 2, d = seed + 3;
+    int e = seed * 2, f = seed * 3, g = seed * 5, h = seed * 7;
+    int p = 1, q = 2, r = 3, s = 4, u = 5, v = 6, w = 7, x = 8;
+    int i;
+    for (i = 0; i < n; i++) {
+        a = (a + b * i) & 65535;
+        b = b ^ (c + i);
+        c = (c + (d >> 1)) & 4095;
+        d = (d - e + i) % 1000;
+        e = e + (f & 255);
+        f = (f + g % 7) & 1023;
+        g = (g + h) % 777;
+        h = h - a % 5;
+        if (a == 123456789) {
+            /* Never taken: everything below is cold. */
+            p = p + a * b; q = q + c * d; r = r + e * f; s = s + g * h;
+            u = u + p * q; v = v + r * s; w = w + u * v; x = x + w * p;
+        }
+    }
+    return a + b + c + d + e + f + g + h + p + q + r + s + u + v + w + x;
+}
+
+int rarely(int n) {
+    int i, t = 0;
+    if (n > 1000)
+        for (i = 0; i < n; i++) t = t + i * i;
+    return t;
+}
+
+int short_trips(int n) {
+    int i, j, t = 0;
+    for (i = 0; i < n; i++)
+        for (j = 0; j < i % 3; j++) t = t + j + i;
+    return t;
+}
+
+int main() {
+    int n;
+    scanf("%d", &n);
+    printf("%d %d %d\n", mix(n, 3), rarely(n), short_trips(n));
+    return 0;
+}
@@ -0,0 +1,64 @@
+/* Software prefetching: reads and writes through strength-reduced
+   pointers, a global array indexed by the counter, a loop running
+   downwards, a column walk whose stride is larger than the distance, a
+   pointer the loop itself advances and a conditional store. The hints
+   reach past the ends of the arrays; that must not fault. */
+
+int g[600];
+
+int dot(int *a, int *b, int n) {
+    int i, s = 0;
+    for (i = 0; i < n; i++) s = s + a[i] * b[2 * i];
+    return s;
+}
+
+int walk(int *p, int *end) {
+    int s = 0;
+    while (p < end) {
+        s = s + *p;
+        p = p + 3;
+    }
+    return s;
+}
+
+int main() {
+    int n, i, j, r;
+    int m[40][40];
+    scanf("%d", &n);
+    r = 40;
+    if (n < r) r = n;
+    int *a = malloc(n * 8);
+    int *b = malloc(n * 8);
+
+    for (i = 0; i < 2 * n; i++) {
+        a[i] = i % 17 - 8;
+        b[i] = i % 5 + 1;
+    }
+    int d = dot(a, b, n);
+
+    for (i = 0; i < 2 * n; i++) g[i] = i * 7 % 23;
+    int h = 0;
+    for (i = 2 * n - 1; i >= 0; i--) h = h * 3 + g[i];
+
+    for (i = 0; i < r; i++)
+        for (j = 0; j < r; j++)
+            m[i][j] = i - j;
+    int col = 0;
+    for (j = 0; j < r; j++)
+        for (i = 0; i < r; i++)
+            col = col + m[i][j] * (j + 1);
+
+    int w = walk(a, a + 2 * n);
+
+    int k = 0;
+    for (i = 0; i < n; i++)
+        if (a[i] > 0) {
+            b[k] = a[i] * 2;
+            k++;
+        }
+    int t = 0;
+    for (i = 0; i < k; i++) t = t + b[i];
+
+    printf("%d %d %d %d %d %d\n", d, h, col, w, k, t);
+    return 0;
+}
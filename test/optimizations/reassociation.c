@@ -0,0 +1,60 @@
+/* Associative chains that only fold once they are regrouped: constants
+   spread over several operations, terms that cancel, operand orders that
+   differ between otherwise equal expressions, and loop-invariant terms
+   mixed with ones that change every iteration. */
+
+int chains(int x, int a, int b) {
+    int p = (x + 1) + 2;
+    int q = x * 4 * 2;
+    int r = a + b - a;
+    int s = (x - 5) + (7 - x) * 3;
+    int t = -(x - a) + (a - b);
+    int u = (x << 2) + x * 3 - (x << 3);
+    return p + q * 10 + r * 100 + s * 1000 + t * 10000 + u;
+}
+
+int bits(int x, int y, int z) {
+    int a = x ^ y ^ z ^ x;
+    int b = (x & 255) & (y & 15) & x;
+    int c = (x | 1) | (z | 2) | 4;
+    int d = x * y * 3 * z * 2;
+    return a + b * 7 + c * 13 + d;
+}
+
+/* a + b and b + a, c * a * b and b * c * a: one computation each after CSE. */
+int orders(int a, int b, int c) {
+    int u = (a + b) + c;
+    int v = c + (b + a);
+    int w = c * a * b;
+    int z = b * c * a;
+    return u * v - w + z;
+}
+
+/* The a and b terms are invariant in both loops and get hoisted. */
+int sweep(int a, int b, int n) {
+    int i, j;
+    int s = 0;
+    for (i = 0; i < n; i++) {
+        s = s + (i + a) + b;
+        s = s - (b + i * 3 + a * 5) + 7;
+        for (j = 0; j < n; j++)
+            s = s + (j + a + i) * 2 - (i + 1) + (b ^ 3);
+    }
+    return s;
+}
+
+/* A leaf living in memory is not read past a store to it. */
+int through_pointer(int x) {
+    int v = x;
+    int *p = &v;
+    int t = v + 1;
+    *p = 100;
+    return t + 2 + v;
+}
+
+int main() {
+    printf("%d %d %d ", chains(6, 11, -4), chains(-3, 0, 9), bits(1000, 345, 77));
+    printf("%d %d ", bits(-1, 7, -20), orders(3, -8, 5));
+    printf("%d %d %d\n", sweep(3, 5, 20), sweep(-2, 9, 7), through_pointer(41));
+    return 0;
+}
@@ -0,0 +1,60 @@
+/* Scalar evolution: counters that run down, step by more than one, move
+   through temps or twice per iteration, and indices derived from them
+   (2 * i + 1, r * m + k). A loop running down whose order matters (a
+   shift in place) must stay as it is, and so must a bound the loop
+   changes through memory. */
+
+int lim;
+
+int main() {
+    int a[64];
+    int b[64];
+    int c[128];
+    int g[48];
+    int n, m, i, k, r, s = 0, t = 0, x = 0;
+    scanf("%d %d", &n, &m);
+
+    /* Down-counting fill and copy, then a sum running down. */
+    for (i = n - 1; i >= 0; i--) a[i] = i * 3 + 1;
+    for (i = n; i > 0; i--) b[i - 1] = a[i - 1];
+    for (i = n - 1; i >= 0; i = i - 1) s = s + b[i];
+    int left = i;
+
+    /* Order matters here: each element takes its left neighbour's value. */
+    for (i = n - 1; i > 0; i--) a[i] = a[i - 1];
+    for (i = 0; i < n; i++) t = t * 3 + a[i];
+
+    /* Two updates per iteration, a step of 2 through a temp. */
+    i = 0;
+    if (n > 100) x = 1;
+    while (i < 24) {
+        c[i] = i + x;
+        i = i + 1;
+        c[i] = 100 - i;
+        int next = i + 1;
+        i = next;
+    }
+    int pairs = 0;
+    for (i = 0; i < 12; i++) pairs = pairs + c[2 * i] * c[2 * i + 1];
+
+    /* A row of a flattened matrix: r * m is invariant in the inner loop. */
+    for (i = 0; i < 6 * m; i++) g[i] = i % 7;
+    int rows = 0;
+    for (r = 0; r < 6; r++)
+        for (k = 0; k < m; k++) rows = rows + g[r * m + k] * (r + 1);
+
+    printf("%d %d %d %d ", s, left, t, i);
+
+    /* A constant bound the loop lowers through a pointer is no constant
+       trip count. */
+    int *lp = &lim;
+    int done = 0;
+    lim = 10;
+    for (i = 0; i < lim; i++) {
+        done = done + i;
+        lp[0] = lp[0] - 1;
+    }
+
+    printf("%d %d %d %d\n", pairs, rows, i, done);
+    return 0;
+}
@@ -0,0 +1,69 @@
+/* Scalar promotion in loops: global accumulators and counters, a loop
+   that leaves early through break, nested loops, fields reached through
+   a struct pointer, a scalar also written through a pointer in the loop
+   and a loop that calls printf (kept in memory). */
+
+struct stat {
+    int cnt;
+    int sum;
+};
+
+int total;
+int hits;
+int seen;
+
+void count(struct stat *st, int n) {
+    int i;
+    st->cnt = 0;
+    for (i = 0; i < n; i++) {
+        st->cnt = st->cnt + 1;
+        if (i % 3 == 0) st->sum = st->sum + i;
+    }
+}
+
+int main() {
+    int n, i, j;
+    scanf("%d", &n);
+    int *a = malloc(n * 4);
+    for (i = 0; i < n; i++) a[i] = i * 7 % 11;
+
+    total = 0;
+    hits = 0;
+    for (i = 0; i < n; i++) {
+        total = total + a[i];
+        if (a[i] > 3) hits++;
+    }
+    printf("%d %d", total, hits);
+
+    seen = 0;
+    for (i = 0; i < n; i++) {
+        if (a[i] > 9) break;
+        seen = seen + 1;
+    }
+    printf(" %d %d", i, seen);
+
+    struct stat *st = malloc(8);
+    st->sum = 5;
+    count(st, n);
+    printf(" %d %d", st->cnt, st->sum);
+
+    for (i = 0; i < n / 10; i++)
+        for (j = 0; j < i; j++)
+            total = total + i * j;
+    printf(" %d", total);
+
+    int s = 0;
+    int *w = &s;
+    for (i = 0; i < n; i++) {
+        s = s + 1;
+        *w = *w + a[i];
+    }
+    printf(" %d", s);
+
+    for (i = 0; i < 3; i++) {
+        seen = seen + i;
+        printf(" %d", seen);
+    }
+    printf("\n");
+    return 0;
+}
@@ -0,0 +1,89 @@
+/* Local structs whose address never escapes are split into one scalar per
+   field; the ones that do escape, and char fields, stay in memory. */
+
+struct Point { int x; int y; };
+struct Iter { int pos; int end; int step; };
+struct Tagged { char tag; int n; int k; };
+
+/* Iterator walked in a loop: every field access was a load or a store. */
+int walk(int n) {
+    struct Iter it;
+    int s = 0;
+    it.pos = 0;
+    it.end = n;
+    it.step = 3;
+    while (it.pos < it.end) {
+        s = s + it.pos;
+        it.pos = it.pos + it.step;
+    }
+    return s;
+}
+
+/* Fibonacci with a pair that is rotated each step. */
+int fib(int n) {
+    struct Point f;
+    int i, t;
+    f.x = 0;
+    f.y = 1;
+    for (i = 0; i < n; i++) {
+        t = f.x + f.y;
+        f.x = f.y;
+        f.y = t % 1000007;
+    }
+    return f.x;
+}
+
+/* The char field stays in memory, the int fields are split. */
+int tagged(int k) {
+    struct Tagged m;
+    m.tag = 'q';
+    m.n = k;
+    m.k = 3;
+    m.n = m.n * m.k + m.k;
+    return m.n * 10 + (m.tag == 'q');
+}
+
+/* Reached through a pointer as well: left alone. */
+int escapes(int v) {
+    struct Point p;
+    struct Point *q;
+    q = &p;
+    p.x = v;
+    q->y = v * 2;
+    return p.x + p.y;
+}
+
+/* Copied whole, then read through a pointer: the copy fills memory. */
+int peek(struct Point *p) {
+    return p->x + p->y;
+}
+
+int copied(int v) {
+    struct Point a, b;
+    a.x = v;
+    a.y = v * 2;
+    b = a;
+    return peek(&b);
+}
+
+/* Bounding box of a walk on a grid. */
+int bbox(int n) {
+    struct Point lo, hi, cur;
+    int i;
+    cur.x = 0; cur.y = 0;
+    lo = cur; hi = cur;
+    for (i = 0; i < n; i++) {
+        cur.x = cur.x + (i * 7) % 5 - 2;
+        cur.y = cur.y + (i * 3) % 7 - 3;
+        if (cur.x < lo.x) lo.x = cur.x;
+        if (cur.y < lo.y) lo.y = cur.y;
+        if (cur.x > hi.x) hi.x = cur.x;
+        if (cur.y > hi.y) hi.y = cur.y;
+    }
+    return (hi.x - lo.x + 1) * (hi.y - lo.y + 1);
+}
+
+int main() {
+    printf("%d %d %d %d %d %d\n", walk(100), fib(40), tagged(5), escapes(21), bbox(50), copied(10));
+    return 0;
+}
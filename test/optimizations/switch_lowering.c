@@ -0,0 +1,93 @@
+/* Switches the backend lowers three ways: a jump table for dense cases,
+   a compare tree for sparse ones, and both for mixed case sets. */
+
+/* Dense: a small stack-machine interpreter dispatching on opcodes 0..9. */
+int run(int n) {
+    int code[24];
+    int stack[8];
+    int sp = 0;
+    int pc = 0;
+    int acc = 0;
+    /* acc = sum over i of (i * 3 + 1), counting i down from n. */
+    code[0] = 1;  code[1] = 0;     /* push 0        */
+    code[2] = 7;                   /* store acc     */
+    code[3] = 8;                   /* load i        */
+    code[4] = 1;  code[5] = 3;     /* push 3        */
+    code[6] = 4;                   /* mul           */
+    code[7] = 1;  code[8] = 1;     /* push 1        */
+    code[9] = 2;                   /* add           */
+    code[10] = 6;                  /* acc += top    */
+    code[11] = 9;                  /* i--, loop if i > 0 */
+    code[12] = 3;                  /* nop           */
+    code[13] = 5;                  /* halt          */
+    int i = n;
+    int running = 1;
+    int steps = 0;
+    while (running) {
+        int op = code[pc];
+        steps++;
+        switch (op) {
+            case 0: running = 0; break;
+            case 1: stack[sp] = code[pc + 1]; sp++; pc = pc + 2; break;
+            case 2: sp--; stack[sp - 1] = stack[sp - 1] + stack[sp]; pc++; break;
+            case 3: pc++; break;
+            case 4: sp--; stack[sp - 1] = stack[sp - 1] * stack[sp]; pc++; break;
+            case 5: running = 0; break;
+            case 6: sp--; acc = acc + stack[sp]; pc++; break;
+            case 7: sp--; acc = stack[sp]; pc++; break;
+            case 8: stack[sp] = i; sp++; pc++; break;
+            case 9:
+                i--;
+                if (i > 0) pc = 3; else pc++;
+                break;
+            default: running = 0; acc = -1; break;
+        }
+    }
+    return acc * 1000 + steps;
+}
+
+/* Sparse: values far apart; no default. */
+int sparse(int x) {
+    int r = 0;
+    switch (x) {
+        case 2: r = 1; break;
+        case 9: r = 2; break;
+        case 17: r = 3; break;
+        case 100: r = 4; break;
+        case 1000: r = 5; break;
+        case 4096: r = 6; break;
+        case 65536: r = 7; break;
+        case 1000000: r = 8; break;
+    }
+    return r;
+}
+
+/* Mixed: a dense run with holes, plus outliers on both sides; fall through. */
+int mixed(int x) {
+    int r = 0;
+    switch (x) {
+        case 0: r = 100;
+        case 10: r = r + 1; break;
+        case 11: r = 2; break;
+        case 12: r = 3; break;
+        case 14: r = 4; break;
+        case 15: r = 5; break;
+        case 17: r = 6; break;
+        case 5000: r = 7; break;
+        case 5001: r = 8; break;
+        default: r = -1; break;
+    }
+    return r;
+}
+
+int main() {
+    int i;
+    int s = 0;
+    int t = 0;
+    printf("%d ", run(5));
+    for (i = 0; i < 40; i++) s = s + (i + 1) * (sparse(i * i) + sparse(i * i * i));
+    printf("%d %d %d %d ", s, sparse(-2), sparse(65536), sparse(1000001));
+    for (i = 0; i < 20; i++) t = t * 3 + mixed(i);
+    printf("%d %d %d %d\n", t, mixed(-10), mixed(5001), mixed(4999));
+    return 0;
+}
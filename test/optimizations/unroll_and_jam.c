@@ -0,0 +1,76 @@
+/* Unroll and jam: outer loops copied into their inner loop, with the
+   element the copies share kept in a temp. Trip counts that leave a
+   remainder, <= bounds, reductions and private temps; a nest whose
+   dependence runs backwards in the inner loop stays as it is. */
+
+int main() {
+    int n, i, j, k;
+    int A[13][9], B[9][11], C[13][11], D[12][12];
+    int x[11], y[13];
+    scanf("%d", &n);
+
+    for (i = 0; i < 13; i++)
+        for (j = 0; j < 9; j++)
+            A[i][j] = (i * 5 + j * 3) % 11 - 5 + n;
+    for (i = 0; i < 9; i++)
+        for (j = 0; j < 11; j++)
+            B[i][j] = (i * 7 + j) % 13 - 6;
+
+    /* C[i][j] is the same element for every k: one load and one store per
+       block of k iterations. 9 is not a multiple of the factor. */
+    for (i = 0; i < 13; i++) {
+        for (j = 0; j < 11; j++) {
+            C[i][j] = 0;
+            for (k = 0; k < 9; k++) {
+                int t = A[i][k] * B[k][j];
+                C[i][j] = C[i][j] + t;
+            }
+        }
+    }
+    int c = 0;
+    for (i = 0; i < 13; i++)
+        for (j = 0; j < 11; j++)
+            c = c + C[i][j] * (i - j);
+
+    /* x[j] is shared by every row; the sum is a reduction. */
+    for (j = 0; j < 11; j++) x[j] = j * j - n;
+    int s = 0;
+    for (i = 0; i <= 12; i++)
+        for (j = 0; j < 11; j++)
+            s = s + C[i][j] * x[j] + i;
+
+    /* Rows i - 1 and i + 1 of the stencil are row i of the copies. */
+    for (i = 0; i < 12; i++)
+        for (j = 0; j < 12; j++)
+            D[i][j] = (i * 3 + j * 5) % 7;
+    for (i = 1; i < n + 6; i++)
+        for (j = 1; j < 11; j++)
+            D[i][j] = D[i][j] + (C[i - 1][j] + C[i + 1][j] - 2 * C[i][j]) / 4;
+    int d = 0;
+    for (i = 0; i < 12; i++)
+        for (j = 0; j < 12; j++)
+            d = d + D[i][j] * (j + 1);
+
+    /* D[i][j] reads D[i - 1][j + 1], written one row and one column
+       back: (<, >), so rows cannot be interleaved. */
+    for (i = 1; i < 12; i++)
+        for (j = 0; j < 11; j++)
+            D[i][j] = D[i - 1][j + 1] + x[j];
+    int e = 0;
+    for (i = 0; i < 12; i++)
+        for (j = 0; j < 12; j++)
+            e = e + D[i][j] * (i + 2);
+
+    /* No outer iterations, then no inner ones: the counters' exit values. */
+    for (i = 0; i < 13; i++) y[i] = i;
+    for (i = n; i < 2; i++)
+        for (j = 0; j < 11; j++)
+            y[i] = y[i] + x[j];
+    int zi = i;
+    for (i = 0; i < 13; i++)
+        for (j = n; j < 3; j++)
+            y[i] = y[i] + x[j] * C[i][j];
+
+    printf("c=%d s=%d d=%d e=%d z=%d,%d,%d\n", c, s, d, e, zi, i, j);
+    return 0;
+}
@@ -0,0 +1,33 @@
+/* Fixed-size loop nests at -O2: only innermost loops with small unrolled
+   size are fully unrolled, so compile time and code size stay bounded
+   (a 64x64 nest, a 23x20 nest around a while loop, an 8x8x8 nest). */
+
+int main() {
+    int M[8][8];
+    int i, j, k, s, t;
+    for (i = 0; i < 8; i++)
+        for (j = 0; j < 8; j++)
+            M[i][j] = i * 8 + j;
+
+    s = 0;
+    for (i = 0; i < 64; i++)
+        for (j = 0; j < 64; j++)
+            s = s + M[i % 8][j % 8] * (i - j);
+
+    t = 0;
+    for (i = 0; i < 23; i++)
+        for (j = 0; j < 20; j++) {
+            k = i + j;
+            while (k > 3) k = k - 3;
+            t = t + k * i - j;
+        }
+
+    int u = 0;
+    for (i = 0; i < 8; i++)
+        for (j = 0; j < 8; j++)
+            for (k = 0; k < 8; k++)
+                u = u + M[i][k] * M[k][j];
+
+    printf("%d %d %d", s, t, u);
+    return 0;
+}
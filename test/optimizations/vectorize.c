@@ -0,0 +1,49 @@
+/* Loop vectorization: element-wise loops over arrays and pointers, offsets,
+   sum and dot-product reductions, a row of a 2D array and an inclusive
+   bound. A loop reading what the previous iteration stored, and stores
+   through pointers that may overlap, stay scalar. Trip counts are not
+   multiples of any strip length. */
+
+int dot(int *x, int *y, int n) {
+    int i, s = 0;
+    for (i = 0; i < n; i++) s = s + x[i] * y[i];
+    return s;
+}
+
+void axpy(int *y, int *x, int k, int n) {
+    int i;
+    for (i = 0; i < n; i++) y[i] = y[i] + k * x[i];
+}
+
+int main() {
+    int a[100], b[100], c[100], m[8][40];
+    int i, j, n, k, s, t;
+    scanf("%d", &n);
+    k = n / 4;
+
+    for (i = 0; i < n; i++) {
+        a[i] = i * 7 - 50;
+        b[i] = (i & 3) + 1;
+    }
+    for (i = 0; i < n; i++)
+        c[i] = (a[i] / b[i]) ^ (a[i] % b[i] << 3) | -a[i] & ~k;
+    s = 0;
+    for (i = 0; i < n; i++) s = s + c[i];
+
+    int *p = malloc(400), *q = malloc(400);
+    for (i = 0; i < n; i++) p[i] = (a[i] >> 2) - k + 100;
+    for (i = 0; i <= n - 2; i++) p[i] = p[i + 1] - p[i];
+    for (i = 0; i < n; i++) q[i] = 3 - p[i];
+    axpy(q, p, k, n);
+    t = dot(p, q, n);
+
+    for (i = 1; i < n; i++) b[i] = b[i - 1] + b[i];
+
+    for (i = 0; i < 8; i++)
+        for (j = 0; j < 37; j++) m[i][j] = i * j + a[j + 1];
+    int r = 0;
+    for (i = 0; i < 8; i++) r = r + m[i][i * 4];
+
+    printf("%d %d %d %d %d %d\n", s, t, b[n - 1], r, i, p[n - 1]);
+    return 0;
+}